@@ -315,7 +315,7 @@ struct activity io_act = {
 /* Memory and swap space utilization activity */
 struct activity memory_act = {
 	.id		= A_MEMORY,
-	.options	= AO_COLLECTED + AO_MULTIPLE_OUTPUTS,
+	.options	= AO_COLLECTED + AO_MULTIPLE_OUTPUTS + AO_GAUGE,
 	.magic		= ACTIVITY_MAGIC_BASE + 1,
 	.group		= G_DEFAULT,
 #ifdef SOURCE_SADC
@@ -357,7 +357,7 @@ struct activity memory_act = {
 /* Kernel tables activity */
 struct activity ktables_act = {
 	.id		= A_KTABLES,
-	.options	= AO_COLLECTED,
+	.options	= AO_COLLECTED + AO_GAUGE,
 	.magic		= ACTIVITY_MAGIC_BASE + 1,
 	.group		= G_DEFAULT,
 #ifdef SOURCE_SADC
@@ -398,7 +398,7 @@ struct activity ktables_act = {
 /* Queue and load activity */
 struct activity queue_act = {
 	.id		= A_QUEUE,
-	.options	= AO_COLLECTED,
+	.options	= AO_COLLECTED + AO_GAUGE,
 	.magic		= ACTIVITY_MAGIC_BASE + 2,
 	.group		= G_DEFAULT,
 #ifdef SOURCE_SADC
@@ -687,7 +687,7 @@ struct activity net_nfsd_act = {
 /* Network sockets activity */
 struct activity net_sock_act = {
 	.id		= A_NET_SOCK,
-	.options	= AO_COLLECTED,
+	.options	= AO_COLLECTED + AO_GAUGE,
 	.magic		= ACTIVITY_MAGIC_BASE,
 	.group		= G_DEFAULT,
 #ifdef SOURCE_SADC
@@ -1017,7 +1017,7 @@ struct activity net_udp_act = {
 /* IPv6 sockets activity */
 struct activity net_sock6_act = {
 	.id		= A_NET_SOCK6,
-	.options	= AO_NULL,
+	.options	= AO_GAUGE,
 	.magic		= ACTIVITY_MAGIC_BASE,
 	.group		= G_IPV6,
 #ifdef SOURCE_SADC
@@ -1268,7 +1268,7 @@ struct activity net_udp6_act = {
 /* CPU frequency */
 struct activity pwr_cpufreq_act = {
 	.id		= A_PWR_CPU,
-	.options	= AO_COUNTED + AO_GRAPH_PER_ITEM,
+	.options	= AO_COUNTED + AO_GRAPH_PER_ITEM + AO_GAUGE,
 	.magic		= ACTIVITY_MAGIC_BASE,
 	.group		= G_POWER,
 #ifdef SOURCE_SADC
@@ -1309,13 +1309,14 @@ struct activity pwr_cpufreq_act = {
 /* Fan */
 struct activity pwr_fan_act = {
 	.id		= A_PWR_FAN,
-	.options	= AO_COUNTED + AO_GRAPH_PER_ITEM,
+	.options	= AO_COUNTED + AO_GRAPH_PER_ITEM + AO_SLOW,
 	.magic		= ACTIVITY_MAGIC_BASE,
 	.group		= G_POWER,
 #ifdef SOURCE_SADC
 	.f_count_index	= 5,	/* wrap_get_fan_nr() */
 	.f_count2	= NULL,
 	.f_read		= wrap_read_fan,
+	.timeout	= 200,
 #endif
 #ifdef SOURCE_SAR
 	.f_print	= print_pwr_fan_stats,
@@ -1350,13 +1351,14 @@ struct activity pwr_fan_act = {
 /* Temperature */
 struct activity pwr_temp_act = {
 	.id		= A_PWR_TEMP,
-	.options	= AO_COUNTED + AO_GRAPH_PER_ITEM,
+	.options	= AO_COUNTED + AO_GRAPH_PER_ITEM + AO_SLOW,
 	.magic		= ACTIVITY_MAGIC_BASE,
 	.group		= G_POWER,
 #ifdef SOURCE_SADC
 	.f_count_index	= 6,	/* wrap_get_temp_nr() */
 	.f_count2	= NULL,
 	.f_read		= wrap_read_temp,
+	.timeout	= 200,
 #endif
 #ifdef SOURCE_SAR
 	.f_print	= print_pwr_temp_stats,
@@ -1391,13 +1393,14 @@ struct activity pwr_temp_act = {
 /* Voltage inputs */
 struct activity pwr_in_act = {
 	.id		= A_PWR_IN,
-	.options	= AO_COUNTED + AO_GRAPH_PER_ITEM,
+	.options	= AO_COUNTED + AO_GRAPH_PER_ITEM + AO_SLOW,
 	.magic		= ACTIVITY_MAGIC_BASE,
 	.group		= G_POWER,
 #ifdef SOURCE_SADC
 	.f_count_index	= 7,	/* wrap_get_in_nr() */
 	.f_count2	= NULL,
 	.f_read		= wrap_read_in,
+	.timeout	= 200,
 #endif
 #ifdef SOURCE_SAR
 	.f_print	= print_pwr_in_stats,
@@ -1432,7 +1435,7 @@ struct activity pwr_in_act = {
 /* Hugepages activity */
 struct activity huge_act = {
 	.id		= A_HUGE,
-	.options	= AO_COLLECTED,
+	.options	= AO_COLLECTED + AO_GAUGE,
 	.magic		= ACTIVITY_MAGIC_BASE + 1,
 	.group		= G_DEFAULT,
 #ifdef SOURCE_SADC
@@ -1514,13 +1517,14 @@ struct activity pwr_wghfreq_act = {
 /* USB devices plugged into the system */
 struct activity pwr_usb_act = {
 	.id		= A_PWR_USB,
-	.options	= AO_COUNTED + AO_CLOSE_MARKUP,
+	.options	= AO_COUNTED + AO_CLOSE_MARKUP + AO_SLOW,
 	.magic		= ACTIVITY_MAGIC_BASE,
 	.group		= G_POWER,
 #ifdef SOURCE_SADC
 	.f_count_index	= 8,	/* wrap_get_usb_nr() */
 	.f_count2	= NULL,
 	.f_read		= wrap_read_bus_usb_dev,
+	.timeout	= 200,
 #endif
 #ifdef SOURCE_SAR
 	.f_print	= print_pwr_usb_stats,
@@ -1555,13 +1559,14 @@ struct activity pwr_usb_act = {
 /* Filesystem usage activity */
 struct activity filesystem_act = {
 	.id		= A_FS,
-	.options	= AO_COUNTED + AO_GRAPH_PER_ITEM + AO_MULTIPLE_OUTPUTS,
+	.options	= AO_COUNTED + AO_GRAPH_PER_ITEM + AO_MULTIPLE_OUTPUTS + AO_SLOW + AO_GAUGE,
 	.magic		= ACTIVITY_MAGIC_BASE + 1,
 	.group		= G_XDISK,
 #ifdef SOURCE_SADC
 	.f_count_index	= 9,	/* wrap_get_filesystem_nr() */
 	.f_count2	= NULL,
 	.f_read		= wrap_read_filesystem,
+	.timeout	= 500,
 #endif
 #ifdef SOURCE_SAR
 	.f_print	= print_filesystem_stats,
@@ -1597,13 +1602,14 @@ struct activity filesystem_act = {
 /* Fibre Channel HBA usage activity */
 struct activity fchost_act = {
 	.id		= A_NET_FC,
-	.options	= AO_COUNTED + AO_GRAPH_PER_ITEM,
+	.options	= AO_COUNTED + AO_GRAPH_PER_ITEM + AO_SLOW,
 	.magic		= ACTIVITY_MAGIC_BASE,
 	.group		= G_DISK,
 #ifdef SOURCE_SADC
 	.f_count_index	= 10,	/* wrap_get_fchost_nr() */
 	.f_count2	= NULL,
 	.f_read		= wrap_read_fchost,
+	.timeout	= 200,
 #endif
 #ifdef SOURCE_SAR
 	.f_print	= print_fchost_stats,
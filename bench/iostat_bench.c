@@ -0,0 +1,204 @@
+/*
+ * iostat_bench: Measure the time needed by iostat to read /proc/diskstats
+ * and save the stats of a large number of devices.
+ * (C) 2026 by the sysstat developers
+ *
+ ***************************************************************************
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published  by  the *
+ * Free Software Foundation; either version 2 of the License, or (at  your *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it  will  be  useful,  but *
+ * WITHOUT ANY WARRANTY; without the implied warranty  of  MERCHANTABILITY *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License *
+ * for more details.                                                       *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA              *
+ ***************************************************************************
+ *
+ * iostat is linked with this program (its main() function being renamed)
+ * so that its functions can be called with synthetic /proc/diskstats
+ * files instead of the real one: fopen() is wrapped at link time to open
+ * them in place of DISKSTATS. A set of files is generated, each containing
+ * <devices> entries. With option -c, <churn> devices disappear from one
+ * file to the next one and are replaced with new ones, so that free entries
+ * have to be recycled. Files are then read in turn by read_diskstats_stat()
+ * <count> times.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "common.h"
+#include "iostat.h"
+
+/* Variables and functions of iostat */
+extern int flags;
+extern int iodev_nr;
+extern struct io_stats *st_iodev[2];
+extern struct io_hdr_stats *st_hdr_iodev;
+
+void init_stats
+	(void);
+void io_sys_free
+	(void);
+void read_diskstats_stat
+	(int);
+void salloc_device
+	(int);
+
+FILE *__real_fopen
+	(const char *, const char *);
+
+/* Synthetic file read by iostat instead of DISKSTATS */
+char *bench_diskstats;
+
+#define BENCH_COUNT	100
+#define BENCH_DEVICES	10000
+#define BENCH_FILES	8
+
+/*
+ ***************************************************************************
+ * Create synthetic /proc/diskstats files.
+ *
+ * IN:
+ * @dir		Directory where files are to be created.
+ * @dev_nr	Number of devices in each file.
+ * @churn	Number of devices replaced from one file to the next one.
+ * @files	Array where the names of the files will be saved.
+ ***************************************************************************
+ */
+void create_files(char *dir, int dev_nr, int churn, char *files[])
+{
+	FILE *fp;
+	char name[MAX_PF_NAME];
+	int f, d, id;
+
+	for (f = 0; f < BENCH_FILES; f++) {
+		snprintf(name, sizeof(name), "%s/diskstats.%d", dir, f);
+		if ((files[f] = strdup(name)) == NULL) {
+			perror("strdup");
+			exit(4);
+		}
+		if ((fp = fopen(name, "w")) == NULL) {
+			perror(name);
+			exit(2);
+		}
+		for (d = 0; d < dev_nr; d++) {
+			/* The first <churn> devices are different in each file */
+			id = (d < churn) ? d + (f + 1) * dev_nr : d;
+			fprintf(fp, "%4d %7d dev%d %d 0 %d %d %d 0 %d %d 0 %d %d\n",
+				254, id % 1000000, id,
+				f + d, 8 * (f + d), f, 2 * f + d, 16 * (2 * f + d),
+				3 * f, 4 * f, 5 * f);
+		}
+		fclose(fp);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Open a file. Called by iostat instead of fopen(): The synthetic file is
+ * opened when DISKSTATS is requested.
+ *
+ * IN:
+ * @name	Name of file to open.
+ * @mode	Opening mode.
+ *
+ * RETURNS:
+ * Stream opened, or NULL on error.
+ ***************************************************************************
+ */
+FILE *__wrap_fopen(const char *name, const char *mode)
+{
+	if (bench_diskstats && !strcmp(name, DISKSTATS))
+		return __real_fopen(bench_diskstats, mode);
+
+	return __real_fopen(name, mode);
+}
+
+/*
+ ***************************************************************************
+ * Main entry to the program.
+ ***************************************************************************
+ */
+int main(int argc, char **argv)
+{
+	char dir[] = "/tmp/iostat_benchXXXXXX";
+	char *files[BENCH_FILES];
+	int count = BENCH_COUNT, dev_nr = BENCH_DEVICES, churn = 0;
+	int i, opt, curr = 0, used = 0;
+	unsigned long long sum = 0;
+	struct timespec t0, t1;
+	double t;
+
+	while ((opt = getopt(argc, argv, "c:d:n:")) != -1) {
+		switch (opt) {
+		case 'c':
+			churn = atoi(optarg);
+			break;
+		case 'd':
+			dev_nr = atoi(optarg);
+			break;
+		case 'n':
+			count = atoi(optarg);
+			break;
+		default:
+			fprintf(stderr, "Usage: %s [ -c <churn> ] [ -d <devices> ] [ -n <count> ]\n",
+				argv[0]);
+			exit(1);
+		}
+	}
+	if ((count <= 0) || (dev_nr <= 0) || (churn < 0) || (churn > dev_nr)) {
+		fprintf(stderr, "Invalid parameters\n");
+		exit(1);
+	}
+
+	if (mkdtemp(dir) == NULL) {
+		perror("mkdtemp");
+		exit(2);
+	}
+	create_files(dir, dev_nr, churn, files);
+
+	/* Same as "iostat -p ALL": No need to check devices in /sys */
+	flags = I_D_DISK + I_D_EXTENDED + I_D_PARTITIONS + I_D_PART_ALL + I_F_HAS_DISKSTATS;
+	iodev_nr = dev_nr + churn + NR_DEV_PREALLOC;
+	init_stats();
+	salloc_device(iodev_nr);
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (i = 0; i < count; i++) {
+		bench_diskstats = files[i % BENCH_FILES];
+		read_diskstats_stat(curr);
+		curr ^= 1;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	t = (t1.tv_sec - t0.tv_sec) * 1000000.0 + (t1.tv_nsec - t0.tv_nsec) / 1000.0;
+
+	/* Checksum, to make sure that different versions give the same results */
+	for (i = 0; i < iodev_nr; i++) {
+		if (st_hdr_iodev[i].used) {
+			used++;
+			sum = sum * 31 + i + st_iodev[!curr][i].rd_ios + st_iodev[curr][i].wr_sectors;
+		}
+	}
+
+	printf("%d devices, %d replaced per sample: %.2f us per sample"
+	       " (%d entries used, checksum %llx)\n",
+	       dev_nr, churn, t / count, used, sum);
+
+	for (i = 0; i < BENCH_FILES; i++) {
+		unlink(files[i]);
+		free(files[i]);
+	}
+	rmdir(dir);
+	io_sys_free();
+
+	return 0;
+}
@@ -0,0 +1,421 @@
+/*
+ * rd_parse_bench: Measure the time needed to parse /proc/stat,
+ * /proc/diskstats and /proc/net/dev with sysstat's reading functions.
+ * (C) 2026 by the sysstat developers
+ *
+ ***************************************************************************
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published  by  the *
+ * Free Software Foundation; either version 2 of the License, or (at  your *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it  will  be  useful,  but *
+ * WITHOUT ANY WARRANTY; without the implied warranty  of  MERCHANTABILITY *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License *
+ * for more details.                                                       *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA              *
+ ***************************************************************************
+ *
+ * Snapshots of the three files are read from a directory (bench/proc by
+ * default) and their per-item lines (cpuN, disks, interfaces) are
+ * replicated <scale> times to simulate a large machine. The resulting
+ * contents are then parsed <count> times with the functions from
+ * rd_stats.c and with the sscanf() based code they replaced. Results
+ * from both versions are checked to be identical.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "common.h"
+#include "rd_stats.h"
+
+extern struct cached_file cached_files[];
+extern int cached_files_nr;
+
+#define BENCH_COUNT	1000
+#define BENCH_SCALE	64
+
+/*
+ ***************************************************************************
+ * Reference versions of the reading functions, using sscanf().
+ ***************************************************************************
+ */
+__nr_t ref_read_stat_cpu(struct stats_cpu *st_cpu, __nr_t nr_alloc)
+{
+	FILE *fp;
+	struct stats_cpu *st_cpu_i;
+	struct stats_cpu sc;
+	char line[8192];
+	int proc_nr;
+	__nr_t cpu_read = 0;
+
+	if ((fp = fopen_cached(STAT)) == NULL)
+		return 0;
+
+	while (fgets(line, sizeof(line), fp) != NULL) {
+
+		if (!strncmp(line, "cpu ", 4)) {
+			memset(st_cpu, 0, STATS_CPU_SIZE);
+			sscanf(line + 5, "%llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
+			       &st_cpu->cpu_user,
+			       &st_cpu->cpu_nice,
+			       &st_cpu->cpu_sys,
+			       &st_cpu->cpu_idle,
+			       &st_cpu->cpu_iowait,
+			       &st_cpu->cpu_hardirq,
+			       &st_cpu->cpu_softirq,
+			       &st_cpu->cpu_steal,
+			       &st_cpu->cpu_guest,
+			       &st_cpu->cpu_guest_nice);
+			if (!cpu_read) {
+				cpu_read = 1;
+			}
+		}
+
+		else if (!strncmp(line, "cpu", 3)) {
+			memset(&sc, 0, STATS_CPU_SIZE);
+			sscanf(line + 3, "%d %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
+			       &proc_nr,
+			       &sc.cpu_user,
+			       &sc.cpu_nice,
+			       &sc.cpu_sys,
+			       &sc.cpu_idle,
+			       &sc.cpu_iowait,
+			       &sc.cpu_hardirq,
+			       &sc.cpu_softirq,
+			       &sc.cpu_steal,
+			       &sc.cpu_guest,
+			       &sc.cpu_guest_nice);
+
+			if (proc_nr + 2 > nr_alloc) {
+				cpu_read = -1;
+				break;
+			}
+			st_cpu_i = st_cpu + proc_nr + 1;
+			*st_cpu_i = sc;
+			if (proc_nr + 2 > cpu_read) {
+				cpu_read = proc_nr + 2;
+			}
+		}
+	}
+
+	fclose(fp);
+	return cpu_read;
+}
+
+__nr_t ref_read_diskstats_disk(struct stats_disk *st_disk, __nr_t nr_alloc)
+{
+	FILE *fp;
+	char line[1024];
+	char dev_name[MAX_NAME_LEN];
+	struct stats_disk *st_disk_i;
+	unsigned int major, minor, rd_ticks, wr_ticks, tot_ticks, rq_ticks;
+	unsigned long rd_ios, wr_ios, rd_sec, wr_sec;
+	__nr_t dsk_read = 0;
+
+	if ((fp = fopen_cached(DISKSTATS)) == NULL)
+		return 0;
+
+	while (fgets(line, sizeof(line), fp) != NULL) {
+
+		if (sscanf(line, "%u %u %s %lu %*u %lu %u %lu %*u %lu"
+			   " %u %*u %u %u",
+			   &major, &minor, dev_name,
+			   &rd_ios, &rd_sec, &rd_ticks, &wr_ios, &wr_sec, &wr_ticks,
+			   &tot_ticks, &rq_ticks) == 11) {
+
+			if (!rd_ios && !wr_ios)
+				continue;
+			if (dsk_read + 1 > nr_alloc) {
+				dsk_read = -1;
+				break;
+			}
+			st_disk_i = st_disk + dsk_read++;
+			st_disk_i->major     = major;
+			st_disk_i->minor     = minor;
+			st_disk_i->nr_ios    = (unsigned long long) rd_ios + (unsigned long long) wr_ios;
+			st_disk_i->rd_sect   = rd_sec;
+			st_disk_i->wr_sect   = wr_sec;
+			st_disk_i->rd_ticks  = rd_ticks;
+			st_disk_i->wr_ticks  = wr_ticks;
+			st_disk_i->tot_ticks = tot_ticks;
+			st_disk_i->rq_ticks  = rq_ticks;
+		}
+	}
+
+	fclose(fp);
+	return dsk_read;
+}
+
+__nr_t ref_read_net_dev(struct stats_net_dev *st_net_dev, __nr_t nr_alloc)
+{
+	FILE *fp;
+	struct stats_net_dev *st_net_dev_i;
+	char line[256];
+	char iface[MAX_IFACE_LEN];
+	__nr_t dev_read = 0;
+	int pos;
+
+	if ((fp = fopen_cached(NET_DEV)) == NULL)
+		return 0;
+
+	while (fgets(line, sizeof(line), fp) != NULL) {
+
+		pos = strcspn(line, ":");
+		if (pos < strlen(line)) {
+
+			if (dev_read + 1 > nr_alloc) {
+				dev_read = -1;
+				break;
+			}
+			st_net_dev_i = st_net_dev + dev_read++;
+			strncpy(iface, line, MINIMUM(pos, MAX_IFACE_LEN - 1));
+			iface[MINIMUM(pos, MAX_IFACE_LEN - 1)] = '\0';
+			sscanf(iface, "%s", st_net_dev_i->interface);
+			sscanf(line + pos + 1, "%llu %llu %*u %*u %*u %*u %llu %llu %llu %llu "
+			       "%*u %*u %*u %*u %*u %llu",
+			       &st_net_dev_i->rx_bytes,
+			       &st_net_dev_i->rx_packets,
+			       &st_net_dev_i->rx_compressed,
+			       &st_net_dev_i->multicast,
+			       &st_net_dev_i->tx_bytes,
+			       &st_net_dev_i->tx_packets,
+			       &st_net_dev_i->tx_compressed);
+		}
+	}
+
+	fclose(fp);
+	return dev_read;
+}
+
+/*
+ ***************************************************************************
+ * Read a snapshot file, replicate its per-item lines and save the result
+ * into an unlinked temporary file registered as a cached system file, so
+ * that fopen_cached(@name) reads it.
+ *
+ * IN:
+ * @dir		Directory containing the snapshots.
+ * @file	Name of snapshot file.
+ * @name	Name of the system file that the snapshot replaces.
+ * @scale	Number of times per-item lines are replicated.
+ ***************************************************************************
+ */
+void load_snapshot(char *dir, char *file, char *name, int scale)
+{
+	FILE *ifp, *ofp;
+	char path[MAX_PF_NAME], line[8192], word[MAX_NAME_LEN];
+	char *p;
+	int k, nr, cpu_nr = 0, ncpu = 0;
+	long pos;
+
+	snprintf(path, sizeof(path), "%s/%s", dir, file);
+	if ((ifp = fopen(path, "r")) == NULL) {
+		perror(path);
+		exit(2);
+	}
+	/* Count CPU so that replicated cpuN lines can be renumbered */
+	while (fgets(line, sizeof(line), ifp) != NULL) {
+		if (!strncmp(line, "cpu", 3) && (line[3] != ' ')) {
+			ncpu++;
+		}
+	}
+	rewind(ifp);
+
+	if ((ofp = tmpfile()) == NULL) {
+		perror("tmpfile");
+		exit(2);
+	}
+
+	while (fgets(line, sizeof(line), ifp) != NULL) {
+
+		if (!strncmp(line, "cpu", 3) && (line[3] != ' ')) {
+			/* cpuN line from /proc/stat */
+			p = line + 3;
+			strtol(p, &p, 10);
+			for (k = 0; k < scale; k++) {
+				fprintf(ofp, "cpu%d%s", k * ncpu + cpu_nr, p);
+			}
+			cpu_nr++;
+		}
+		else if ((p = strchr(line, ':')) != NULL) {
+			/* Interface line from /proc/net/dev */
+			*p = '\0';
+			sscanf(line, "%15s", word);
+			for (k = 0; k < scale; k++) {
+				if (k) {
+					fprintf(ofp, "%7.7s_%d:%s", word, k, p + 1);
+				}
+				else {
+					fprintf(ofp, "%9s:%s", word, p + 1);
+				}
+			}
+		}
+		else if (sscanf(line, "%*u %*u %n%s", &nr, word) == 1) {
+			/* Device line from /proc/diskstats */
+			pos = nr + strlen(word);
+			for (k = 0; k < scale; k++) {
+				fprintf(ofp, "%.*s%s_%d%s", nr, line, word, k, line + pos);
+			}
+		}
+		else {
+			fputs(line, ofp);
+		}
+	}
+	fclose(ifp);
+	fflush(ofp);
+
+	if (cached_files_nr >= MAX_CACHED_FILES) {
+		fprintf(stderr, "Too many cached files\n");
+		exit(2);
+	}
+	cached_files[cached_files_nr].name = name;
+	cached_files[cached_files_nr].fd   = dup(fileno(ofp));
+	cached_files[cached_files_nr].buf  = NULL;
+	cached_files[cached_files_nr].size = 0;
+	cached_files_nr++;
+	fclose(ofp);
+}
+
+/*
+ ***************************************************************************
+ * Return current time in microseconds.
+ ***************************************************************************
+ */
+double now_usec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+/*
+ ***************************************************************************
+ * Display the time spent per reading for both versions of a function.
+ ***************************************************************************
+ */
+void print_result(char *name, int nr, double t_ref, double t_new, int count)
+{
+	printf("%-20s %6d items  sscanf: %9.2f us  new: %9.2f us  speedup: %.2fx\n",
+	       name, nr, t_ref / count, t_new / count, t_ref / t_new);
+}
+
+/*
+ ***************************************************************************
+ * Main entry to the program.
+ ***************************************************************************
+ */
+int main(int argc, char **argv)
+{
+	char *dir = "bench/proc";
+	int count = BENCH_COUNT, scale = BENCH_SCALE;
+	int i, opt, nr_cpu, nr_disk, nr_dev;
+	double t0, t_ref, t_new;
+	struct stats_cpu *cpu_ref, *cpu_new;
+	struct stats_disk *disk_ref, *disk_new;
+	struct stats_net_dev *dev_ref, *dev_new;
+	__nr_t n_ref, n_new;
+
+	while ((opt = getopt(argc, argv, "n:x:")) != -1) {
+		switch (opt) {
+		case 'n':
+			count = atoi(optarg);
+			break;
+		case 'x':
+			scale = atoi(optarg);
+			break;
+		default:
+			fprintf(stderr, "Usage: %s [ -n <count> ] [ -x <scale> ] [ <dir> ]\n",
+				argv[0]);
+			exit(1);
+		}
+	}
+	if (optind < argc) {
+		dir = argv[optind];
+	}
+	if ((count <= 0) || (scale <= 0)) {
+		fprintf(stderr, "Invalid count or scale\n");
+		exit(1);
+	}
+
+	load_snapshot(dir, "stat", STAT, scale);
+	load_snapshot(dir, "diskstats", DISKSTATS, scale);
+	load_snapshot(dir, "net_dev", NET_DEV, scale);
+
+	/* Allocate structures large enough for any item number */
+	nr_cpu = nr_disk = nr_dev = 4096 * scale;
+	cpu_ref  = calloc(nr_cpu, STATS_CPU_SIZE);
+	cpu_new  = calloc(nr_cpu, STATS_CPU_SIZE);
+	disk_ref = calloc(nr_disk, STATS_DISK_SIZE);
+	disk_new = calloc(nr_disk, STATS_DISK_SIZE);
+	dev_ref  = calloc(nr_dev, STATS_NET_DEV_SIZE);
+	dev_new  = calloc(nr_dev, STATS_NET_DEV_SIZE);
+	if (!cpu_ref || !cpu_new || !disk_ref || !disk_new || !dev_ref || !dev_new) {
+		perror("calloc");
+		exit(4);
+	}
+
+	/* /proc/stat */
+	t0 = now_usec();
+	for (i = 0; i < count; i++) {
+		n_ref = ref_read_stat_cpu(cpu_ref, nr_cpu);
+	}
+	t_ref = now_usec() - t0;
+	t0 = now_usec();
+	for (i = 0; i < count; i++) {
+		n_new = read_stat_cpu(cpu_new, nr_cpu);
+	}
+	t_new = now_usec() - t0;
+	if ((n_ref != n_new) || memcmp(cpu_ref, cpu_new, STATS_CPU_SIZE * n_new)) {
+		fprintf(stderr, "read_stat_cpu: Results differ\n");
+		exit(3);
+	}
+	print_result("read_stat_cpu", n_new, t_ref, t_new, count);
+
+	/* /proc/diskstats */
+	t0 = now_usec();
+	for (i = 0; i < count; i++) {
+		n_ref = ref_read_diskstats_disk(disk_ref, nr_disk);
+	}
+	t_ref = now_usec() - t0;
+	t0 = now_usec();
+	for (i = 0; i < count; i++) {
+		n_new = read_diskstats_disk(disk_new, nr_disk, TRUE);
+	}
+	t_new = now_usec() - t0;
+	if ((n_ref != n_new) || memcmp(disk_ref, disk_new, STATS_DISK_SIZE * n_new)) {
+		fprintf(stderr, "read_diskstats_disk: Results differ\n");
+		exit(3);
+	}
+	print_result("read_diskstats_disk", n_new, t_ref, t_new, count);
+
+	/* /proc/net/dev */
+	t0 = now_usec();
+	for (i = 0; i < count; i++) {
+		n_ref = ref_read_net_dev(dev_ref, nr_dev);
+	}
+	t_ref = now_usec() - t0;
+	t0 = now_usec();
+	for (i = 0; i < count; i++) {
+		n_new = read_net_dev(dev_new, nr_dev);
+	}
+	t_new = now_usec() - t0;
+	if ((n_ref != n_new) || memcmp(dev_ref, dev_new, STATS_NET_DEV_SIZE * n_new)) {
+		fprintf(stderr, "read_net_dev: Results differ\n");
+		exit(3);
+	}
+	print_result("read_net_dev", n_new, t_ref, t_new, count);
+
+	close_cached_files();
+
+	return 0;
+}
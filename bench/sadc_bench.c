@@ -0,0 +1,132 @@
+/*
+ * sadc_bench: Measure the time needed by sadc to take one sample, i.e. to
+ * read the statistics of the collected activities and build the record
+ * that will be written. This tells which sub-second intervals a machine
+ * can afford.
+ * (C) 2026 by the sysstat developers
+ *
+ ***************************************************************************
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published  by  the *
+ * Free Software Foundation; either version 2 of the License, or (at  your *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it  will  be  useful,  but *
+ * WITHOUT ANY WARRANTY; without the implied warranty  of  MERCHANTABILITY *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License *
+ * for more details.                                                       *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA              *
+ ***************************************************************************
+ *
+ * sadc is linked with this program (its main() function being renamed)
+ * so that its functions can be called directly. Activities are selected
+ * with option -S, using the same syntax as sadc (default is the activities
+ * collected by sadc without option -S). <count> samples are then taken
+ * back to back.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "sa.h"
+
+/* Variables and functions of sadc */
+extern struct activity *act[];
+extern struct record_header record_hdr;
+
+size_t fill_stats_record
+	(char *, unsigned char []);
+size_t get_max_record_size
+	(void);
+void parse_sadc_S_option
+	(char * [], int);
+void read_stats
+	(unsigned char []);
+void reset_stats
+	(void);
+void sa_sys_free
+	(void);
+void sa_sys_init
+	(void);
+
+#define BENCH_COUNT	1000
+
+/*
+ ***************************************************************************
+ * Main entry to the program.
+ ***************************************************************************
+ */
+int main(int argc, char **argv)
+{
+	char *s_argv[2] = {NULL, NULL};
+	char *buf = NULL;
+	int count = BENCH_COUNT;
+	int i, opt;
+	size_t len = 0;
+	struct tm rectime;
+	struct timespec t0, t1, t2;
+	double t, t_tot = 0, t_max = 0;
+
+	while ((opt = getopt(argc, argv, "n:S:")) != -1) {
+		switch (opt) {
+		case 'n':
+			count = atoi(optarg);
+			break;
+		case 'S':
+			s_argv[1] = optarg;
+			break;
+		default:
+			fprintf(stderr, "Usage: %s [ -n <count> ] [ -S <activities> ]\n",
+				argv[0]);
+			exit(1);
+		}
+	}
+	if (count <= 0) {
+		fprintf(stderr, "Invalid parameters\n");
+		exit(1);
+	}
+
+	if (s_argv[1]) {
+		parse_sadc_S_option(s_argv, 1);
+	}
+	sa_sys_init();
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	t1 = t0;
+	for (i = 0; i < count; i++) {
+		/* Same as one iteration of rw_sa_stat_loop() */
+		reset_stats();
+		record_hdr.ust_time = (unsigned long long) get_time_msec(&rectime, &record_hdr.ust_msec);
+		record_hdr.record_type = R_STATS;
+		read_stats(NULL);
+
+		/* Buffers may have been reallocated */
+		SREALLOC(buf, char, get_max_record_size());
+		len = fill_stats_record(buf, NULL);
+
+		clock_gettime(CLOCK_MONOTONIC, &t2);
+		t = (t2.tv_sec - t1.tv_sec) * 1000000.0 + (t2.tv_nsec - t1.tv_nsec) / 1000.0;
+		if (t > t_max) {
+			t_max = t;
+		}
+		t1 = t2;
+	}
+	t_tot = (t1.tv_sec - t0.tv_sec) * 1000000.0 + (t1.tv_nsec - t0.tv_nsec) / 1000.0;
+
+	printf("%d activities, %zu bytes per record: %.2f us per sample (max %.2f us)\n",
+	       get_activity_nr(act, AO_COLLECTED, COUNT_ACTIVITIES), len,
+	       t_tot / count, t_max);
+	printf("Share of a 100 ms interval: %.2f%%, of a 250 ms interval: %.2f%%\n",
+	       t_tot / count / 1000, t_tot / count / 2500);
+
+	free(buf);
+	sa_sys_free();
+
+	return 0;
+}
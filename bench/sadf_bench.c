@@ -0,0 +1,229 @@
+/*
+ * sadf_bench: Measure the time needed by sadf to display the statistics
+ * saved in data files in db, ppc, XML and JSON formats.
+ * (C) 2026 by the sysstat developers
+ *
+ ***************************************************************************
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published  by  the *
+ * Free Software Foundation; either version 2 of the License, or (at  your *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it  will  be  useful,  but *
+ * WITHOUT ANY WARRANTY; without the implied warranty  of  MERCHANTABILITY *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License *
+ * for more details.                                                       *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA              *
+ ***************************************************************************
+ *
+ * sadf is linked with this program (its main() function being renamed)
+ * so that its functions can be called directly. Values are first converted
+ * <values> times with the output functions (the output being written to
+ * /dev/null) and with snprintf(). Then each data file given on the command
+ * line (default is tests/data-ppc-11.7.2) is displayed <count> times with
+ * "sadf -d", "sadf -p", "sadf -x" and "sadf -j" (all activities), each
+ * time by a new process. Output is written to a temporary file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "sa_out.h"
+
+/* Main function of sadf */
+int sadf_main
+	(int, char **);
+
+/* Number of values converted between two flushes of the output buffer */
+#define BENCH_FLUSH	1024
+
+#define BENCH_COUNT	20
+#define BENCH_VALUES	10000000
+#define BENCH_FILE	"tests/data-ppc-11.7.2"
+
+/*
+ ***************************************************************************
+ * Return the time elapsed between two dates, in seconds.
+ ***************************************************************************
+ */
+double elapsed(struct timespec *t0, struct timespec *t1)
+{
+	return (t1->tv_sec - t0->tv_sec) + (t1->tv_nsec - t0->tv_nsec) / 1e9;
+}
+
+/*
+ ***************************************************************************
+ * Convert values with the output functions and with snprintf().
+ *
+ * IN:
+ * @nr		Number of values to convert.
+ ***************************************************************************
+ */
+void bench_values(long nr)
+{
+	char str[OUT_NUM_LEN];
+	struct timespec t0, t1, t2, t3, t4;
+	unsigned long long sum = 0;
+	long i;
+	int fd, null_fd;
+
+	/* Output of the output functions is written to /dev/null */
+	fflush(stdout);
+	if (((fd = dup(STDOUT_FILENO)) < 0) ||
+	    ((null_fd = open("/dev/null", O_WRONLY)) < 0) ||
+	    (dup2(null_fd, STDOUT_FILENO) < 0)) {
+		perror("/dev/null");
+		exit(2);
+	}
+	close(null_fd);
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (i = 0; i < nr; i++) {
+		sum += snprintf(str, sizeof(str), "%.2f", (double) i / 7.0);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	for (i = 0; i < nr; i++) {
+		out_fixed((double) i / 7.0, 2);
+		if (!(i % BENCH_FLUSH)) {
+			out_flush();
+		}
+	}
+	out_flush();
+	clock_gettime(CLOCK_MONOTONIC, &t2);
+	for (i = 0; i < nr; i++) {
+		sum += snprintf(str, sizeof(str), "%llu", (unsigned long long) i * 1000003ULL);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t3);
+	for (i = 0; i < nr; i++) {
+		out_ull((unsigned long long) i * 1000003ULL);
+		if (!(i % BENCH_FLUSH)) {
+			out_flush();
+		}
+	}
+	out_flush();
+	clock_gettime(CLOCK_MONOTONIC, &t4);
+
+	fflush(stdout);
+	dup2(fd, STDOUT_FILENO);
+	close(fd);
+
+	printf("%ld values: %%.2f %.1f ns (snprintf: %.1f ns), %%llu %.1f ns (snprintf: %.1f ns) [%llu]\n",
+	       nr,
+	       elapsed(&t1, &t2) * 1e9 / nr, elapsed(&t0, &t1) * 1e9 / nr,
+	       elapsed(&t3, &t4) * 1e9 / nr, elapsed(&t2, &t3) * 1e9 / nr,
+	       sum);
+}
+
+/*
+ ***************************************************************************
+ * Display a data file <count> times in selected format.
+ *
+ * IN:
+ * @file	Data file to display.
+ * @fmt_opt	sadf option selecting the output format.
+ * @count	Number of times the file is displayed.
+ ***************************************************************************
+ */
+void bench_file(char *file, char *fmt_opt, int count)
+{
+	char *argv[] = {"sadf", fmt_opt, file, "--", "-A", NULL};
+	struct timespec t0, t1;
+	FILE *fp;
+	pid_t pid;
+	off_t size;
+	int i, status;
+
+	if ((fp = tmpfile()) == NULL) {
+		perror("tmpfile");
+		exit(2);
+	}
+	fflush(stdout);
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (i = 0; i < count; i++) {
+		if ((pid = fork()) < 0) {
+			perror("fork");
+			exit(2);
+		}
+		if (!pid) {
+			/* Child process: Display the file */
+			if ((ftruncate(fileno(fp), 0) < 0) ||
+			    (dup2(fileno(fp), STDOUT_FILENO) < 0)) {
+				perror("dup2");
+				_exit(2);
+			}
+			lseek(STDOUT_FILENO, 0, SEEK_SET);
+			sadf_main(5, argv);
+			fflush(stdout);
+			_exit(0);
+		}
+		if ((waitpid(pid, &status, 0) < 0) ||
+		    !WIFEXITED(status) || WEXITSTATUS(status)) {
+			fprintf(stderr, "sadf %s %s failed\n", fmt_opt, file);
+			exit(2);
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	size = lseek(fileno(fp), 0, SEEK_END);
+	fclose(fp);
+
+	printf("sadf %s %s -- -A: %.2f ms per run (%lld bytes)\n",
+	       fmt_opt, file, elapsed(&t0, &t1) * 1e3 / count, (long long) size);
+}
+
+/*
+ ***************************************************************************
+ * Main entry to the program.
+ ***************************************************************************
+ */
+int main(int argc, char **argv)
+{
+	char *fmt_opts[] = {"-d", "-p", "-x", "-j"};
+	char *bench_file_dfl[] = {BENCH_FILE};
+	char **files = bench_file_dfl;
+	int count = BENCH_COUNT, files_nr = 1;
+	long values = BENCH_VALUES;
+	int i, j, opt;
+
+	while ((opt = getopt(argc, argv, "n:v:")) != -1) {
+		switch (opt) {
+		case 'n':
+			count = atoi(optarg);
+			break;
+		case 'v':
+			values = atol(optarg);
+			break;
+		default:
+			fprintf(stderr, "Usage: %s [ -n <count> ] [ -v <values> ] [ <datafile> ... ]\n",
+				argv[0]);
+			exit(1);
+		}
+	}
+	if ((count <= 0) || (values <= 0)) {
+		fprintf(stderr, "Invalid parameters\n");
+		exit(1);
+	}
+	if (optind < argc) {
+		files = argv + optind;
+		files_nr = argc - optind;
+	}
+
+	bench_values(values);
+
+	for (i = 0; i < files_nr; i++) {
+		for (j = 0; j < 4; j++) {
+			bench_file(files[i], fmt_opts[j], count);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,206 @@
+/*
+ * svg_bench: Measure the time needed by sadf to render SVG graphs for a
+ * long series of records (default is one day of records saved every
+ * second).
+ * (C) 2026 by the sysstat developers
+ *
+ ***************************************************************************
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published  by  the *
+ * Free Software Foundation; either version 2 of the License, or (at  your *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it  will  be  useful,  but *
+ * WITHOUT ANY WARRANTY; without the implied warranty  of  MERCHANTABILITY *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License *
+ * for more details.                                                       *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA              *
+ ***************************************************************************
+ *
+ * sadf is linked with this program (its main() function being renamed)
+ * so that its functions can be called directly.
+ * Synthetic statistics are generated for CPU activity (as with option
+ * -P ALL, for <cpus> processors) and for queue length and load averages.
+ * They are passed to the SVG functions as if <count> records had been
+ * read from a data file. Graphs are written to a temporary file.
+ * Option -p <points> is the same as sadf option -O points=<points>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "sa.h"
+#include "rd_stats.h"
+
+/* Variables of sadf */
+extern struct activity *act[];
+extern struct file_header file_hdr;
+extern struct record_header record_hdr[];
+extern unsigned int svg_points;
+
+#define BENCH_COUNT	86400
+#define BENCH_CPUS	4
+#define BENCH_TIME	1514764800ULL
+
+/*
+ ***************************************************************************
+ * Fill the statistics of a record with synthetic values.
+ *
+ * IN:
+ * @a_cpu	CPU activity.
+ * @a_queue	Queue length and load averages activity.
+ * @curr	Index in array for current sample statistics.
+ * @i		Record number.
+ ***************************************************************************
+ */
+void fill_stats(struct activity *a_cpu, struct activity *a_queue, int curr, int i)
+{
+	struct stats_cpu *scc, *scp;
+	struct stats_queue *sq;
+	unsigned long long user, sys, iowait;
+	int j;
+
+	for (j = 0; j < a_cpu->nr_ini; j++) {
+		scc = (struct stats_cpu *) ((char *) a_cpu->buf[curr]  + j * a_cpu->msize);
+		scp = (struct stats_cpu *) ((char *) a_cpu->buf[!curr] + j * a_cpu->msize);
+
+		/* Each CPU spends 100 jiffies per second */
+		user   = (i * 7 + j * 13) % 40;
+		sys    = (i * 3 + j) % 20;
+		iowait = (i + j * 5) % 10;
+
+		*scc = *scp;
+		scc->cpu_user   += user;
+		scc->cpu_sys    += sys;
+		scc->cpu_iowait += iowait;
+		scc->cpu_idle   += 100 - user - sys - iowait;
+	}
+
+	sq = (struct stats_queue *) a_queue->buf[curr];
+	sq->nr_running    = i % 17;
+	sq->procs_blocked = i % 3;
+	sq->nr_threads    = 300 + i % 50;
+	sq->load_avg_1    = (i * 37) % 800;
+	sq->load_avg_5    = (i * 11) % 600;
+	sq->load_avg_15   = (i * 5) % 400;
+}
+
+/*
+ ***************************************************************************
+ * Main entry to the program.
+ ***************************************************************************
+ */
+int main(int argc, char **argv)
+{
+	struct svg_parm parm;
+	struct activity *a[2];
+	FILE *fp;
+	int count = BENCH_COUNT, cpu_nr = BENCH_CPUS;
+	int i, j, k, opt, fd, curr = 1;
+	off_t size;
+	struct timespec t0, t1, t2;
+
+	while ((opt = getopt(argc, argv, "c:n:p:")) != -1) {
+		switch (opt) {
+		case 'c':
+			cpu_nr = atoi(optarg);
+			break;
+		case 'n':
+			count = atoi(optarg);
+			break;
+		case 'p':
+			svg_points = atoi(optarg);
+			break;
+		default:
+			fprintf(stderr, "Usage: %s [ -c <cpus> ] [ -n <count> ] [ -p <points> ]\n",
+				argv[0]);
+			exit(1);
+		}
+	}
+	if ((count <= 0) || (cpu_nr <= 0) || (cpu_nr >= NR_CPUS) ||
+	    (svg_points == 1)) {
+		fprintf(stderr, "Invalid parameters\n");
+		exit(1);
+	}
+
+	allocate_bitmaps(act);
+	a[0] = act[get_activity_position(act, A_CPU, EXIT_IF_NOT_FOUND)];
+	a[1] = act[get_activity_position(act, A_QUEUE, EXIT_IF_NOT_FOUND)];
+	a[0]->nr_ini = cpu_nr + 1;
+	a[1]->nr_ini = 1;
+	allocate_structures(act);
+	for (j = 0; j < 2; j++) {
+		a[j]->nr2 = 1;
+		for (k = 0; k < 3; k++) {
+			a[j]->nr[k] = a[j]->nr_ini;
+			memset(a[j]->buf[k], 0, (size_t) a[j]->msize * (size_t) a[j]->nr_ini);
+		}
+	}
+	/* Same as option -P ALL */
+	memset(a[0]->bitmap->b_array, ~0, BITMAP_SIZE(a[0]->bitmap->b_size));
+
+	/* Graphs are written to a temporary file */
+	if (((fp = tmpfile()) == NULL) || ((fd = dup(STDOUT_FILENO)) < 0) ||
+	    (dup2(fileno(fp), STDOUT_FILENO) < 0)) {
+		perror("tmpfile");
+		exit(2);
+	}
+
+	memset(&parm, 0, sizeof(parm));
+	parm.ust_time_ref = parm.ust_time_first = BENCH_TIME;
+	parm.restart = TRUE;
+	parm.file_hdr = &file_hdr;
+	parm.dt = 1;
+	record_hdr[!curr].ust_time = BENCH_TIME;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+
+	for (j = 0; j < 2; j++) {
+		parm.nr_max = a[j]->nr_ini;
+		(*a[j]->f_svg_print)(a[j], !curr, F_BEGIN, &parm, 0, &record_hdr[!curr]);
+	}
+
+	for (i = 1; i <= count; i++) {
+		fill_stats(a[0], a[1], curr, i);
+		record_hdr[curr].ust_time = BENCH_TIME + i;
+		record_hdr[curr].uptime_cs = (unsigned long long) i * 100;
+
+		for (j = 0; j < 2; j++) {
+			parm.nr_max = a[j]->nr_ini;
+			(*a[j]->f_svg_print)(a[j], curr, F_MAIN, &parm, 100, &record_hdr[curr]);
+		}
+		parm.restart = FALSE;
+		parm.ust_time_end = record_hdr[curr].ust_time;
+		curr ^= 1;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	for (j = 0; j < 2; j++) {
+		parm.nr_max = a[j]->nr_ini;
+		(*a[j]->f_svg_print)(a[j], !curr, F_END, &parm, 0, &record_hdr[!curr]);
+	}
+	fflush(stdout);
+	clock_gettime(CLOCK_MONOTONIC, &t2);
+
+	size = lseek(STDOUT_FILENO, 0, SEEK_END);
+	dup2(fd, STDOUT_FILENO);
+	close(fd);
+	fclose(fp);
+
+	printf("%d records, %d CPUs: %.3f s to build graphs, %.3f s to draw them (%lld bytes)\n",
+	       count, cpu_nr,
+	       (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9,
+	       (t2.tv_sec - t1.tv_sec) + (t2.tv_nsec - t1.tv_nsec) / 1e9,
+	       (long long) size);
+
+	free_structures(act);
+	free_bitmaps(act);
+
+	return 0;
+}
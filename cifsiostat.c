@@ -57,7 +57,8 @@ int flags = 0;		/* Flag for common options and system state */
 long interval = 0;
 char timestamp[TIMESTAMP_LEN];
 
-struct sigaction alrm_act;
+/* Deadlines of the samples */
+struct sched_timer sched;
 
 /*
  ***************************************************************************
@@ -82,19 +83,6 @@ void usage(char *progname)
 	exit(1);
 }
 
-/*
- ***************************************************************************
- * SIGALRM signal handler.
- *
- * IN:
- * @sig	Signal number.
- ***************************************************************************
- */
-void alarm_handler(int sig)
-{
-	alarm(interval);
-}
-
 /*
  ***************************************************************************
  * Find number of CIFS-mounted points that are registered in
@@ -566,10 +554,13 @@ void rw_io_stat_loop(long int count, struct tm *rectime)
 
 		if (count) {
 			curr ^= 1;
-			pause();
+			sched_wait(&sched);
 		}
 	}
 	while (count);
+
+	/* Display lateness of the samples if requested */
+	sched_report(&sched);
 }
 
 /*
@@ -691,11 +682,8 @@ int main(int argc, char **argv)
 	}
 	printf("\n");
 
-	/* Set a handler for SIGALRM */
-	memset(&alrm_act, 0, sizeof(alrm_act));
-	alrm_act.sa_handler = alarm_handler;
-	sigaction(SIGALRM, &alrm_act, NULL);
-	alarm(interval);
+	/* Set deadlines of the samples */
+	sched_init(&sched, interval * 1000);
 
 	/* Main loop */
 	rw_io_stat_loop(count, &rectime);
@@ -137,19 +137,14 @@ time_t get_gmtime(struct tm *rectime, int d_off)
 
 /*
  ***************************************************************************
- * Get date and time and take into account <ENV_TIME_DEFTM> variable.
- *
- * IN:
- * @d_off	Day offset (number of days to go back in the past).
- *
- * OUT:
- * @rectime	Current date and time.
+ * Tell whether date and time should be expressed in UTC, according to
+ * <ENV_TIME_DEFTM> variable.
  *
  * RETURNS:
- * Value of time in seconds since the Epoch.
+ * TRUE if date and time should be expressed in UTC.
  ***************************************************************************
  */
-time_t get_time(struct tm *rectime, int d_off)
+int use_utc_time(void)
 {
 	static int utc = 0;
 	char *e;
@@ -162,12 +157,280 @@ time_t get_time(struct tm *rectime, int d_off)
 		utc++;
 	}
 
-	if (utc == 2)
+	return (utc == 2);
+}
+
+/*
+ ***************************************************************************
+ * Get date and time and take into account <ENV_TIME_DEFTM> variable.
+ *
+ * IN:
+ * @d_off	Day offset (number of days to go back in the past).
+ *
+ * OUT:
+ * @rectime	Current date and time.
+ *
+ * RETURNS:
+ * Value of time in seconds since the Epoch.
+ ***************************************************************************
+ */
+time_t get_time(struct tm *rectime, int d_off)
+{
+	if (use_utc_time())
 		return get_gmtime(rectime, d_off);
 	else
 		return get_localtime(rectime, d_off);
 }
 
+/*
+ ***************************************************************************
+ * Get current date and time with a millisecond resolution, and take into
+ * account <ENV_TIME_DEFTM> variable.
+ *
+ * OUT:
+ * @rectime	Current date and time.
+ * @msec	Millisecond part of current time (0-999).
+ *
+ * RETURNS:
+ * Value of time in seconds since the Epoch.
+ ***************************************************************************
+ */
+time_t get_time_msec(struct tm *rectime, unsigned int *msec)
+{
+	struct timespec ts;
+	struct tm *ltm;
+	time_t timer;
+
+	if (clock_gettime(CLOCK_REALTIME, &ts) < 0) {
+		*msec = 0;
+		return get_time(rectime, 0);
+	}
+	timer = ts.tv_sec;
+	*msec = (unsigned int) (ts.tv_nsec / 1000000);
+
+	if (use_utc_time()) {
+		ltm = gmtime(&timer);
+	}
+	else {
+		ltm = localtime(&timer);
+	}
+	if (ltm) {
+		*rectime = *ltm;
+	}
+	return timer;
+}
+
+/*
+ ***************************************************************************
+ * Parse an interval of time entered on the command line. The interval is
+ * a number of seconds which may have a fractional part with up to three
+ * digits (e.g. "0.25").
+ *
+ * IN:
+ * @arg		String containing the interval.
+ *
+ * RETURNS:
+ * Interval in milliseconds, or -1 if the string is not a valid interval.
+ ***************************************************************************
+ */
+long parse_interval(char *arg)
+{
+	char *p;
+	long sec, msec = 0;
+	int n;
+
+	n = strspn(arg, DIGITS);
+	if (!n || (n > 9))
+		return -1;
+	sec = atol(arg);
+
+	p = arg + n;
+	if (*p == '.') {
+		p++;
+		n = strspn(p, DIGITS);
+		if (!n || (n > 3) || p[n])
+			return -1;
+		msec = atol(p);
+		/* "0.1" is 100 ms, "0.01" is 10 ms */
+		for (; n < 3; n++) {
+			msec *= 10;
+		}
+	}
+	else if (*p)
+		return -1;
+
+	return sec * 1000 + msec;
+}
+
+/*
+ ***************************************************************************
+ * Get current monotonic time.
+ *
+ * RETURNS:
+ * Monotonic time in nanoseconds.
+ ***************************************************************************
+ */
+unsigned long long sched_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (unsigned long long) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/*
+ ***************************************************************************
+ * Init scheduler used by a sampling loop. The first deadline is the first
+ * multiple of the interval in wall-clock time which is at least
+ * SCHED_MIN_DELAY away, so that samples taken on different hosts (or by
+ * different commands) can be aligned. The first interval is thus never
+ * longer than the requested one (plus SCHED_MIN_DELAY). Following deadlines are then set at regular
+ * intervals, whatever the time needed to take each sample.
+ *
+ * IN:
+ * @st		Scheduler.
+ * @interval	Interval between two samples, in milliseconds. Nothing is
+ *		scheduled if interval is zero.
+ ***************************************************************************
+ */
+void sched_init(struct sched_timer *st, long interval)
+{
+	struct timespec ts;
+	unsigned long long now, delay;
+
+	memset(st, 0, sizeof(struct sched_timer));
+	st->report = (getenv(ENV_LATENESS) != NULL);
+
+	if (interval <= 0)
+		return;
+	st->interval = (unsigned long long) interval * 1000000;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	now = (unsigned long long) ts.tv_sec * 1000000000 + ts.tv_nsec;
+	delay = st->interval - (now + SCHED_MIN_DELAY) % st->interval
+		+ SCHED_MIN_DELAY;
+
+	st->next = sched_now() + delay;
+}
+
+/*
+ ***************************************************************************
+ * Account for a deadline that has been reached: Save the lateness of
+ * current tick, count the deadlines that have been entirely missed (because
+ * taking previous sample took too long) and set next deadline.
+ * Lateness is displayed on STDERR if requested.
+ *
+ * IN:
+ * @st		Scheduler.
+ ***************************************************************************
+ */
+void sched_tick(struct sched_timer *st)
+{
+	unsigned long long now, missed;
+
+	now = sched_now();
+	if (!st->interval || (now < st->next))
+		return;
+
+	st->late = now - st->next;
+	missed = st->late / st->interval;
+
+	st->ticks++;
+	st->missed += missed;
+	st->late_sum += st->late;
+	if (st->late > st->late_max) {
+		st->late_max = st->late;
+	}
+	st->next += (missed + 1) * st->interval;
+
+	if (st->report) {
+		fprintf(stderr, "Tick %llu: %llu us late", st->ticks, st->late / 1000);
+		if (missed) {
+			fprintf(stderr, ", %llu deadline(s) missed", missed);
+		}
+		fprintf(stderr, "\n");
+	}
+}
+
+/*
+ ***************************************************************************
+ * Get time remaining until next deadline.
+ *
+ * IN:
+ * @st		Scheduler.
+ *
+ * OUT:
+ * @ts		Time remaining until next deadline.
+ *
+ * RETURNS:
+ * 0 if next deadline has been reached, 1 otherwise.
+ ***************************************************************************
+ */
+int sched_timeout(struct sched_timer *st, struct timespec *ts)
+{
+	unsigned long long now;
+
+	now = sched_now();
+	if (now >= st->next) {
+		ts->tv_sec = ts->tv_nsec = 0;
+		return 0;
+	}
+
+	ts->tv_sec  = (st->next - now) / 1000000000;
+	ts->tv_nsec = (st->next - now) % 1000000000;
+
+	return 1;
+}
+
+/*
+ ***************************************************************************
+ * Wait until next deadline. Return immediately if it has already been
+ * reached.
+ *
+ * IN:
+ * @st		Scheduler.
+ *
+ * RETURNS:
+ * 0 if next deadline has been reached, -1 if a signal has been caught
+ * before.
+ ***************************************************************************
+ */
+int sched_wait(struct sched_timer *st)
+{
+	struct timespec ts;
+
+	if (st->interval) {
+		ts.tv_sec  = st->next / 1000000000;
+		ts.tv_nsec = st->next % 1000000000;
+
+		if (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+			return -1;
+	}
+	sched_tick(st);
+
+	return 0;
+}
+
+/*
+ ***************************************************************************
+ * Display a summary of the lateness of the ticks on STDERR, if requested.
+ *
+ * IN:
+ * @st		Scheduler.
+ ***************************************************************************
+ */
+void sched_report(struct sched_timer *st)
+{
+	if (!st->report || !st->ticks)
+		return;
+
+	fprintf(stderr, "Ticks: %llu, deadlines missed: %llu, "
+		"lateness: avg %llu us, max %llu us\n",
+		st->ticks, st->missed,
+		st->late_sum / st->ticks / 1000, st->late_max / 1000);
+}
+
 #ifdef USE_NLS
 /*
  ***************************************************************************
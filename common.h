@@ -100,6 +100,10 @@
 #define ENV_TIME_DEFTM		"S_TIME_DEF_TIME"
 #define ENV_COLORS		"S_COLORS"
 #define ENV_COLORS_SGR		"S_COLORS_SGR"
+#define ENV_LATENESS		"S_LATENESS"
+
+/* Min delay before the first deadline of a sampling loop (in ns) */
+#define SCHED_MIN_DELAY		10000000ULL
 
 #define C_NEVER			"never"
 #define C_ALWAYS		"always"
@@ -160,6 +164,7 @@
 				} while (0)
 
 #define MINIMUM(a,b)	((a) < (b) ? (a) : (b))
+#define MAXIMUM(a,b)	((a) > (b) ? (a) : (b))
 
 #define PANIC(m)	sysstat_panic(__FUNCTION__, m)
 
@@ -212,6 +217,27 @@ extern char persistent_name_type[MAX_FILE_LEN];
  ***************************************************************************
  */
 
+/*
+ * Scheduler used by sampling loops. Deadlines are taken from the monotonic
+ * clock and are aligned to multiples of the interval in wall-clock time.
+ * Times are expressed in nanoseconds.
+ */
+struct sched_timer {
+	/* Interval between two deadlines */
+	unsigned long long interval;
+	/* Next deadline (monotonic time) */
+	unsigned long long next;
+	/* Number of deadlines reached, and number of those entirely missed */
+	unsigned long long ticks;
+	unsigned long long missed;
+	/* Lateness of last tick, max and total lateness */
+	unsigned long long late;
+	unsigned long long late_max;
+	unsigned long long late_sum;
+	/* TRUE if lateness should be reported (see ENV_LATENESS) */
+	int report;
+};
+
 /* Structure used for extended disk statistics */
 struct ext_disk_stats {
 	double util;
@@ -235,12 +261,30 @@ time_t get_localtime
 	(struct tm *, int);
 time_t get_time
 	(struct tm *, int);
+time_t get_time_msec
+	(struct tm *, unsigned int *);
 void init_nls
 	(void);
 int is_device
 	(char *, int);
+long parse_interval
+	(char *);
 void sysstat_panic
 	(const char *, int);
+int use_utc_time
+	(void);
+void sched_init
+	(struct sched_timer *, long);
+unsigned long long sched_now
+	(void);
+void sched_report
+	(struct sched_timer *);
+void sched_tick
+	(struct sched_timer *);
+int sched_timeout
+	(struct sched_timer *, struct timespec *);
+int sched_wait
+	(struct sched_timer *);
 
 #ifndef SOURCE_SADC
 int count_bits
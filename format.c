@@ -140,6 +140,32 @@ struct report_format raw_fmt = {
 	.f_comment	= print_raw_comment
 };
 
+/*
+ * Roll a datafile up to a coarser interval.
+ */
+struct report_format rollup_fmt = {
+	.id		= F_ROLLUP_OUTPUT,
+	.options	= 0,
+	.f_header	= NULL,
+	.f_statistics	= NULL,
+	.f_timestamp	= NULL,
+	.f_restart	= NULL,
+	.f_comment	= NULL
+};
+
+/*
+ * Columnar binary output.
+ */
+struct report_format col_fmt = {
+	.id		= F_COL_OUTPUT,
+	.options	= 0,
+	.f_header	= print_col_header,
+	.f_statistics	= NULL,
+	.f_timestamp	= NULL,
+	.f_restart	= NULL,
+	.f_comment	= NULL
+};
+
 /*
  * Array of output formats.
  */
@@ -151,7 +177,9 @@ struct report_format *fmt[NR_FMT] = {
 	&json_fmt,
 	&conv_fmt,
 	&svg_fmt,
-	&raw_fmt
+	&raw_fmt,
+	&rollup_fmt,
+	&col_fmt
 };
 #endif
 
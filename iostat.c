@@ -58,6 +58,14 @@ unsigned long long tot_jiffies[2] = {0, 0};
 struct io_stats *st_iodev[2];
 struct io_hdr_stats *st_hdr_iodev;
 struct io_dlist *st_dev_list;
+/*
+ * Hash table used to find devices by name in st_hdr_iodev: iodev_hash[h]
+ * is the index of the first entry whose name hashes to h, iodev_hnext[i]
+ * the index of the next entry with the same hash value (-1: none).
+ */
+int *iodev_hash = NULL;
+int *iodev_hnext = NULL;
+unsigned int iodev_hash_size = 0;
 
 /* Last group name entered on the command line */
 char group_name[MAX_NAME_LEN];
@@ -66,13 +74,15 @@ int iodev_nr = 0;	/* Nb of devices and partitions found. Includes nb of device g
 int group_nr = 0;	/* Nb of device groups */
 int cpu_nr = 0;		/* Nb of processors on the machine */
 int dlist_idx = 0;	/* Nb of devices entered on the command line */
+int iodev_free = 0;	/* Entries before this one are known to be used */
 int flags = 0;		/* Flag for common options and system state */
 unsigned int dm_major;	/* Device-mapper major number */
 
 long interval = 0;
 char timestamp[TIMESTAMP_LEN];
 
-struct sigaction alrm_act;
+/* Deadlines of the samples */
+struct sched_timer sched;
 
 /*
  ***************************************************************************
@@ -121,19 +131,6 @@ void set_disk_output_unit(void)
 	}
 }
 
-/*
- ***************************************************************************
- * SIGALRM signal handler. No need to reset the handler here.
- *
- * IN:
- * @sig	Signal number.
- ***************************************************************************
- */
-void alarm_handler(int sig)
-{
-	alarm(interval);
-}
-
 /*
  ***************************************************************************
  * Initialize stats common structures.
@@ -173,6 +170,9 @@ void set_entries_unregistered(int iodev_nr, struct io_hdr_stats *st_hdr_iodev)
 			shi->status = DISK_UNREGISTERED;
 		}
 	}
+
+	/* Entries may have been freed since last sample */
+	iodev_free = 0;
 }
 
 /*
@@ -196,6 +196,92 @@ void free_unregistered_entries(int iodev_nr, struct io_hdr_stats *st_hdr_iodev)
 	}
 }
 
+/*
+ ***************************************************************************
+ * Compute hash value for a device name.
+ *
+ * IN:
+ * @name	Name of the device/partition.
+ *
+ * RETURNS:
+ * Index in hash table.
+ ***************************************************************************
+ */
+unsigned int hash_dev_name(char *name)
+{
+	unsigned int h = 2166136261U;
+
+	/* FNV-1a */
+	while (*name) {
+		h ^= (unsigned char) *name++;
+		h *= 16777619U;
+	}
+
+	return h & (iodev_hash_size - 1);
+}
+
+/*
+ ***************************************************************************
+ * Add an entry to the hash table, using its current name.
+ *
+ * IN:
+ * @i	Index of the entry in st_hdr_iodev.
+ ***************************************************************************
+ */
+void add_dev_hash(int i)
+{
+	unsigned int h = hash_dev_name(st_hdr_iodev[i].name);
+
+	iodev_hnext[i] = iodev_hash[h];
+	iodev_hash[h] = i;
+}
+
+/*
+ ***************************************************************************
+ * Remove an entry from the hash table. Should be called before the
+ * entry's name is changed.
+ *
+ * IN:
+ * @i	Index of the entry in st_hdr_iodev.
+ ***************************************************************************
+ */
+void del_dev_hash(int i)
+{
+	int *pi;
+
+	for (pi = &iodev_hash[hash_dev_name(st_hdr_iodev[i].name)];
+	     *pi >= 0; pi = &iodev_hnext[*pi]) {
+		if (*pi == i) {
+			*pi = iodev_hnext[i];
+			break;
+		}
+	}
+	iodev_hnext[i] = -1;
+}
+
+/*
+ ***************************************************************************
+ * Look for a device in st_hdr_iodev using its name.
+ *
+ * IN:
+ * @name	Name of the device/partition.
+ *
+ * RETURNS:
+ * Index of the entry, or -1 if not found.
+ ***************************************************************************
+ */
+int find_dev_hash(char *name)
+{
+	int i;
+
+	for (i = iodev_hash[hash_dev_name(name)]; i >= 0; i = iodev_hnext[i]) {
+		if (!strcmp(st_hdr_iodev[i].name, name))
+			break;
+	}
+
+	return i;
+}
+
 /*
  ***************************************************************************
  * Allocate and init I/O device structures.
@@ -224,6 +310,18 @@ void salloc_device(int dev_nr)
 		exit(4);
 	}
 	memset(st_hdr_iodev, 0, IO_HDR_STATS_SIZE * dev_nr);
+
+	/* Allocate hash table: No entry has been named yet */
+	for (iodev_hash_size = MIN_DEV_HASH_SIZE; iodev_hash_size < dev_nr;
+	     iodev_hash_size <<= 1);
+
+	if (((iodev_hash = (int *) malloc(sizeof(int) * iodev_hash_size)) == NULL) ||
+	    ((iodev_hnext = (int *) malloc(sizeof(int) * dev_nr)) == NULL)) {
+		perror("malloc");
+		exit(4);
+	}
+	memset(iodev_hash, -1, sizeof(int) * iodev_hash_size);
+	memset(iodev_hnext, -1, sizeof(int) * dev_nr);
 }
 
 /*
@@ -366,6 +464,7 @@ void presave_device_list(void)
 		for (i = 0; (i < dlist_idx) && (i < iodev_nr); i++, shi++, sdli++) {
 			strncpy(shi->name, sdli->dev_name, MAX_NAME_LEN);
 			shi->name[MAX_NAME_LEN - 1] = '\0';
+			add_dev_hash(i);
 			shi->used = TRUE;
 			if (shi->name[0] == ' ') {
 				/* Current device name is in fact the name of a group */
@@ -386,6 +485,7 @@ void presave_device_list(void)
 		shi += iodev_nr - 1;
 		strncpy(shi->name, group_name, MAX_NAME_LEN);
 		shi->name[MAX_NAME_LEN - 1] = '\0';
+		add_dev_hash(iodev_nr - 1);
 		shi->used = TRUE;
 		shi->status = DISK_GROUP;
 	}
@@ -409,6 +509,8 @@ void io_sys_free(void)
 	}
 
 	free(st_hdr_iodev);
+	free(iodev_hash);
+	free(iodev_hnext);
 }
 
 /*
@@ -434,30 +536,29 @@ void save_stats(char *name, int curr, void *st_io, int iodev_nr,
 	struct io_stats *st_iodev_i;
 
 	/* Look for device in data table */
-	for (i = 0; i < iodev_nr; i++) {
-		st_hdr_iodev_i = st_hdr_iodev + i;
-		if (!strcmp(st_hdr_iodev_i->name, name)) {
-			break;
-		}
-	}
-
-	if (i == iodev_nr) {
+	if ((i = find_dev_hash(name)) < 0) {
 		/*
 		 * This is a new device: Look for an unused entry to store it.
 		 * Thus we are able to handle dynamically registered devices.
 		 */
-		for (i = 0; i < iodev_nr; i++) {
+		for (i = iodev_free; i < iodev_nr; i++) {
 			st_hdr_iodev_i = st_hdr_iodev + i;
 			if (!st_hdr_iodev_i->used) {
 				/* Unused entry found... */
 				st_hdr_iodev_i->used = TRUE; /* Indicate it is now used */
+				if (st_hdr_iodev_i->name[0]) {
+					/* Entry was used by another device */
+					del_dev_hash(i);
+				}
 				strncpy(st_hdr_iodev_i->name, name, MAX_NAME_LEN - 1);
 				st_hdr_iodev_i->name[MAX_NAME_LEN - 1] = '\0';
+				add_dev_hash(i);
 				st_iodev_i = st_iodev[!curr] + i;
 				memset(st_iodev_i, 0, IO_STATS_SIZE);
 				break;
 			}
 		}
+		iodev_free = i;
 	}
 	if (i < iodev_nr) {
 		st_hdr_iodev_i = st_hdr_iodev + i;
@@ -685,12 +786,10 @@ void read_diskstats_stat(int curr)
 {
 	FILE *fp;
 	char line[256], dev_name[MAX_NAME_LEN];
-	char *dm_name;
+	char *dm_name, *p;
 	struct io_stats sdev;
 	int i;
-	unsigned int ios_pgr, tot_ticks, rq_ticks, wr_ticks;
-	unsigned long rd_ios, rd_merges_or_rd_sec, rd_ticks_or_wr_sec, wr_ios;
-	unsigned long wr_merges, rd_sec_or_wr_ios, wr_sec;
+	unsigned long long val[11];
 	char *ioc_dname;
 	unsigned int major, minor;
 
@@ -703,27 +802,32 @@ void read_diskstats_stat(int curr)
 	while (fgets(line, sizeof(line), fp) != NULL) {
 
 		/* major minor name rio rmerge rsect ruse wio wmerge wsect wuse running use aveq */
-		i = sscanf(line, "%u %u %s %lu %lu %lu %lu %lu %lu %lu %u %u %u %u",
-			   &major, &minor, dev_name,
-			   &rd_ios, &rd_merges_or_rd_sec, &rd_sec_or_wr_ios, &rd_ticks_or_wr_sec,
-			   &wr_ios, &wr_merges, &wr_sec, &wr_ticks, &ios_pgr, &tot_ticks, &rq_ticks);
+		p = line;
+		if ((next_ull_fields(&p, val, 2) < 2) ||
+		    !next_word(&p, dev_name, MAX_NAME_LEN))
+			/* Unknown entry: Ignore it */
+			continue;
+		major = (unsigned int) val[0];
+		minor = (unsigned int) val[1];
+
+		i = 3 + next_ull_fields(&p, val, 11);
 
 		if (i == 14) {
 			/* Device or partition */
 			if (!dlist_idx && !DISPLAY_PARTITIONS(flags) &&
 			    !is_device(dev_name, ACCEPT_VIRTUAL_DEVICES))
 				continue;
-			sdev.rd_ios     = rd_ios;
-			sdev.rd_merges  = rd_merges_or_rd_sec;
-			sdev.rd_sectors = rd_sec_or_wr_ios;
-			sdev.rd_ticks   = (unsigned int) rd_ticks_or_wr_sec;
-			sdev.wr_ios     = wr_ios;
-			sdev.wr_merges  = wr_merges;
-			sdev.wr_sectors = wr_sec;
-			sdev.wr_ticks   = wr_ticks;
-			sdev.ios_pgr    = ios_pgr;
-			sdev.tot_ticks  = tot_ticks;
-			sdev.rq_ticks   = rq_ticks;
+			sdev.rd_ios     = (unsigned long) val[0];
+			sdev.rd_merges  = (unsigned long) val[1];
+			sdev.rd_sectors = (unsigned long) val[2];
+			sdev.rd_ticks   = (unsigned int) val[3];
+			sdev.wr_ios     = (unsigned long) val[4];
+			sdev.wr_merges  = (unsigned long) val[5];
+			sdev.wr_sectors = (unsigned long) val[6];
+			sdev.wr_ticks   = (unsigned int) val[7];
+			sdev.ios_pgr    = (unsigned int) val[8];
+			sdev.tot_ticks  = (unsigned int) val[9];
+			sdev.rq_ticks   = (unsigned int) val[10];
 		}
 		else if (i == 7) {
 			/* Partition without extended statistics */
@@ -731,10 +835,10 @@ void read_diskstats_stat(int curr)
 			    (!dlist_idx && !DISPLAY_PARTITIONS(flags)))
 				continue;
 
-			sdev.rd_ios     = rd_ios;
-			sdev.rd_sectors = rd_merges_or_rd_sec;
-			sdev.wr_ios     = rd_sec_or_wr_ios;
-			sdev.wr_sectors = rd_ticks_or_wr_sec;
+			sdev.rd_ios     = (unsigned long) val[0];
+			sdev.rd_sectors = (unsigned long) val[1];
+			sdev.wr_ios     = (unsigned long) val[2];
+			sdev.wr_sectors = (unsigned long) val[3];
 		}
 		else
 			/* Unknown entry: Ignore it */
@@ -1699,11 +1803,14 @@ void rw_io_stat_loop(long int count, struct tm *rectime)
 
 		if (count) {
 			curr ^= 1;
-			pause();
+			sched_wait(&sched);
 		}
 	}
 	while (count);
 
+	/* Display lateness of the samples if requested */
+	sched_report(&sched);
+
 	if (DISPLAY_JSON_OUTPUT(flags)) {
 		printf("\t\t\t]\n\t\t}\n\t]\n}}\n");
 	}
@@ -2045,11 +2152,8 @@ int main(int argc, char **argv)
 		printf("\n");
 	}
 
-	/* Set a handler for SIGALRM */
-	memset(&alrm_act, 0, sizeof(alrm_act));
-	alrm_act.sa_handler = alarm_handler;
-	sigaction(SIGALRM, &alrm_act, NULL);
-	alarm(interval);
+	/* Set deadlines of the samples */
+	sched_init(&sched, interval * 1000);
 
 	/* Main loop */
 	rw_io_stat_loop(count, &rectime);
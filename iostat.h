@@ -58,6 +58,9 @@
 /* Preallocation constants */
 #define NR_DEV_PREALLOC		4
 
+/* Minimum number of buckets in the hash table used to find devices by name */
+#define MIN_DEV_HASH_SIZE	64
+
 /* Environment variable */
 #define ENV_POSIXLY_CORRECT	"POSIXLY_CORRECT"
 
@@ -26,6 +26,7 @@
 #include "sa.h"
 #include "ioconf.h"
 #include "json_stats.h"
+#include "sa_out.h"
 
 #ifdef USE_NLS
 #include <locale.h>
@@ -57,12 +58,12 @@ void json_markup_network(int tab, int action)
 
 	if (action == OPEN_JSON_MARKUP) {
 		/* Open markup */
-		xprintf(tab, "\"network\": {");
+		out_xprintf(tab, "\"network\": {");
 	}
 	else {
 		/* Close markup */
-		printf("\n");
-		xprintf0(tab, "}");
+		out_puts("\n");
+		out_xprintf0(tab, "}");
 	}
 }
 
@@ -85,12 +86,12 @@ void json_markup_power_management(int tab, int action)
 
 	if (action == OPEN_JSON_MARKUP) {
 		/* Open markup */
-		xprintf(tab, "\"power-management\": {");
+		out_xprintf(tab, "\"power-management\": {");
 	}
 	else {
 		/* Close markup */
-		printf("\n");
-		xprintf0(tab, "}");
+		out_puts("\n");
+		out_xprintf0(tab, "}");
 	}
 }
 
@@ -116,7 +117,7 @@ __print_funct_t json_print_cpu_stats(struct activity *a, int curr, int tab,
 	unsigned char offline_cpu_bitmap[BITMAP_SIZE(NR_CPUS)] = {0};
 	char cpuno[8];
 
-	xprintf(tab++, "\"cpu-load\": [");
+	out_xprintf(tab++, "\"cpu-load\": [");
 
 	/* @nr[curr] cannot normally be greater than @nr_ini */
 	if (a->nr[curr] > a->nr_ini) {
@@ -144,7 +145,7 @@ __print_funct_t json_print_cpu_stats(struct activity *a, int curr, int tab,
 		scp = (struct stats_cpu *) ((char *) a->buf[!curr] + i * a->msize);
 
 		if (sep) {
-			printf(",\n");
+			out_puts(",\n");
 		}
 		sep = TRUE;
 
@@ -176,90 +177,90 @@ __print_funct_t json_print_cpu_stats(struct activity *a, int curr, int tab,
 			if (!deltot_jiffies) {
 				/* Current CPU is tickless */
 				if (DISPLAY_CPU_DEF(a->opt_flags)) {
-					xprintf0(tab, "{\"cpu\": \"%d\", "
-						 "\"user\": %.2f, "
-						 "\"nice\": %.2f, "
-						 "\"system\": %.2f, "
-						 "\"iowait\": %.2f, "
-						 "\"steal\": %.2f, "
-						 "\"idle\": %.2f}",
-						 i - 1, 0.0, 0.0, 0.0, 0.0, 0.0, 100.0);
+					out_xprintf0(tab, "{\"cpu\": \"%d\", "
+						     "\"user\": %.2f, "
+						     "\"nice\": %.2f, "
+						     "\"system\": %.2f, "
+						     "\"iowait\": %.2f, "
+						     "\"steal\": %.2f, "
+						     "\"idle\": %.2f}",
+						     i - 1, 0.0, 0.0, 0.0, 0.0, 0.0, 100.0);
 				}
 				else if (DISPLAY_CPU_ALL(a->opt_flags)) {
-					xprintf0(tab, "{\"cpu\": \"%d\", "
-						 "\"usr\": %.2f, "
-						 "\"nice\": %.2f, "
-						 "\"sys\": %.2f, "
-						 "\"iowait\": %.2f, "
-						 "\"steal\": %.2f, "
-						 "\"irq\": %.2f, "
-						 "\"soft\": %.2f, "
-						 "\"guest\": %.2f, "
-						 "\"gnice\": %.2f, "
-						 "\"idle\": %.2f}",
-						 i - 1, 0.0, 0.0, 0.0, 0.0,
-						 0.0, 0.0, 0.0, 0.0, 0.0, 100.0);
+					out_xprintf0(tab, "{\"cpu\": \"%d\", "
+						     "\"usr\": %.2f, "
+						     "\"nice\": %.2f, "
+						     "\"sys\": %.2f, "
+						     "\"iowait\": %.2f, "
+						     "\"steal\": %.2f, "
+						     "\"irq\": %.2f, "
+						     "\"soft\": %.2f, "
+						     "\"guest\": %.2f, "
+						     "\"gnice\": %.2f, "
+						     "\"idle\": %.2f}",
+						     i - 1, 0.0, 0.0, 0.0, 0.0,
+						     0.0, 0.0, 0.0, 0.0, 0.0, 100.0);
 				}
 				continue;
 			}
 		}
 
 		if (DISPLAY_CPU_DEF(a->opt_flags)) {
-			xprintf0(tab, "{\"cpu\": \"%s\", "
-				 "\"user\": %.2f, "
-				 "\"nice\": %.2f, "
-				 "\"system\": %.2f, "
-				 "\"iowait\": %.2f, "
-				 "\"steal\": %.2f, "
-				 "\"idle\": %.2f}",
-				 cpuno,
-				 ll_sp_value(scp->cpu_user, scc->cpu_user, deltot_jiffies),
-				 ll_sp_value(scp->cpu_nice, scc->cpu_nice, deltot_jiffies),
-				 ll_sp_value(scp->cpu_sys + scp->cpu_hardirq + scp->cpu_softirq,
-					     scc->cpu_sys + scc->cpu_hardirq + scc->cpu_softirq,
-					     deltot_jiffies),
-				 ll_sp_value(scp->cpu_iowait, scc->cpu_iowait, deltot_jiffies),
-				 ll_sp_value(scp->cpu_steal, scc->cpu_steal, deltot_jiffies),
-				 scc->cpu_idle < scp->cpu_idle ?
-				 0.0 :
-				 ll_sp_value(scp->cpu_idle, scc->cpu_idle, deltot_jiffies));
+			out_xprintf0(tab, "{\"cpu\": \"%s\", "
+				     "\"user\": %.2f, "
+				     "\"nice\": %.2f, "
+				     "\"system\": %.2f, "
+				     "\"iowait\": %.2f, "
+				     "\"steal\": %.2f, "
+				     "\"idle\": %.2f}",
+				     cpuno,
+				     ll_sp_value(scp->cpu_user, scc->cpu_user, deltot_jiffies),
+				     ll_sp_value(scp->cpu_nice, scc->cpu_nice, deltot_jiffies),
+				     ll_sp_value(scp->cpu_sys + scp->cpu_hardirq + scp->cpu_softirq,
+						 scc->cpu_sys + scc->cpu_hardirq + scc->cpu_softirq,
+						 deltot_jiffies),
+				     ll_sp_value(scp->cpu_iowait, scc->cpu_iowait, deltot_jiffies),
+				     ll_sp_value(scp->cpu_steal, scc->cpu_steal, deltot_jiffies),
+				     scc->cpu_idle < scp->cpu_idle ?
+				     0.0 :
+				     ll_sp_value(scp->cpu_idle, scc->cpu_idle, deltot_jiffies));
 		}
 		else if (DISPLAY_CPU_ALL(a->opt_flags)) {
-			xprintf0(tab, "{\"cpu\": \"%s\", "
-				 "\"usr\": %.2f, "
-				 "\"nice\": %.2f, "
-				 "\"sys\": %.2f, "
-				 "\"iowait\": %.2f, "
-				 "\"steal\": %.2f, "
-				 "\"irq\": %.2f, "
-				 "\"soft\": %.2f, "
-				 "\"guest\": %.2f, "
-				 "\"gnice\": %.2f, "
-				 "\"idle\": %.2f}",
-				 cpuno,
-				 (scc->cpu_user - scc->cpu_guest) < (scp->cpu_user - scp->cpu_guest) ?
-				 0.0 :
-				 ll_sp_value(scp->cpu_user - scp->cpu_guest,
-					     scc->cpu_user - scc->cpu_guest, deltot_jiffies),
-				 (scc->cpu_nice - scc->cpu_guest_nice) < (scp->cpu_nice - scp->cpu_guest_nice) ?
-				 0.0 :
-				 ll_sp_value(scp->cpu_nice - scp->cpu_guest_nice,
-					     scc->cpu_nice - scc->cpu_guest_nice, deltot_jiffies),
-				 ll_sp_value(scp->cpu_sys, scc->cpu_sys, deltot_jiffies),
-				 ll_sp_value(scp->cpu_iowait, scc->cpu_iowait, deltot_jiffies),
-				 ll_sp_value(scp->cpu_steal, scc->cpu_steal, deltot_jiffies),
-				 ll_sp_value(scp->cpu_hardirq, scc->cpu_hardirq, deltot_jiffies),
-				 ll_sp_value(scp->cpu_softirq, scc->cpu_softirq, deltot_jiffies),
-				 ll_sp_value(scp->cpu_guest, scc->cpu_guest, deltot_jiffies),
-				 ll_sp_value(scp->cpu_guest_nice, scc->cpu_guest_nice, deltot_jiffies),
-				 scc->cpu_idle < scp->cpu_idle ?
-				 0.0 :
-				 ll_sp_value(scp->cpu_idle, scc->cpu_idle, deltot_jiffies));
+			out_xprintf0(tab, "{\"cpu\": \"%s\", "
+				     "\"usr\": %.2f, "
+				     "\"nice\": %.2f, "
+				     "\"sys\": %.2f, "
+				     "\"iowait\": %.2f, "
+				     "\"steal\": %.2f, "
+				     "\"irq\": %.2f, "
+				     "\"soft\": %.2f, "
+				     "\"guest\": %.2f, "
+				     "\"gnice\": %.2f, "
+				     "\"idle\": %.2f}",
+				     cpuno,
+				     (scc->cpu_user - scc->cpu_guest) < (scp->cpu_user - scp->cpu_guest) ?
+				     0.0 :
+				     ll_sp_value(scp->cpu_user - scp->cpu_guest,
+						 scc->cpu_user - scc->cpu_guest, deltot_jiffies),
+				     (scc->cpu_nice - scc->cpu_guest_nice) < (scp->cpu_nice - scp->cpu_guest_nice) ?
+				     0.0 :
+				     ll_sp_value(scp->cpu_nice - scp->cpu_guest_nice,
+						 scc->cpu_nice - scc->cpu_guest_nice, deltot_jiffies),
+				     ll_sp_value(scp->cpu_sys, scc->cpu_sys, deltot_jiffies),
+				     ll_sp_value(scp->cpu_iowait, scc->cpu_iowait, deltot_jiffies),
+				     ll_sp_value(scp->cpu_steal, scc->cpu_steal, deltot_jiffies),
+				     ll_sp_value(scp->cpu_hardirq, scc->cpu_hardirq, deltot_jiffies),
+				     ll_sp_value(scp->cpu_softirq, scc->cpu_softirq, deltot_jiffies),
+				     ll_sp_value(scp->cpu_guest, scc->cpu_guest, deltot_jiffies),
+				     ll_sp_value(scp->cpu_guest_nice, scc->cpu_guest_nice, deltot_jiffies),
+				     scc->cpu_idle < scp->cpu_idle ?
+				     0.0 :
+				     ll_sp_value(scp->cpu_idle, scc->cpu_idle, deltot_jiffies));
 		}
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	out_puts("\n");
+	out_xprintf0(--tab, "]");
 }
 
 /*
@@ -281,11 +282,11 @@ __print_funct_t json_print_pcsw_stats(struct activity *a, int curr, int tab,
 		*spp = (struct stats_pcsw *) a->buf[!curr];
 
 	/* proc/s and cswch/s */
-	xprintf0(tab, "\"process-and-context-switch\": {"
-		 "\"proc\": %.2f, "
-		 "\"cswch\": %.2f}",
-		 S_VALUE(spp->processes, spc->processes, itv),
-		 S_VALUE(spp->context_switch, spc->context_switch, itv));
+	out_xprintf0(tab, "\"process-and-context-switch\": {"
+		     "\"proc\": %.2f, "
+		     "\"cswch\": %.2f}",
+		     S_VALUE(spp->processes, spc->processes, itv),
+		     S_VALUE(spp->context_switch, spc->context_switch, itv));
 }
 
 /*
@@ -307,7 +308,7 @@ __print_funct_t json_print_irq_stats(struct activity *a, int curr, int tab,
 	int sep = FALSE;
 	char irqno[8];
 
-	xprintf(tab++, "\"interrupts\": [");
+	out_xprintf(tab++, "\"interrupts\": [");
 
 	for (i = 0; (i < a->nr[curr]) && (i < a->bitmap->b_size + 1); i++) {
 
@@ -320,7 +321,7 @@ __print_funct_t json_print_irq_stats(struct activity *a, int curr, int tab,
 			/* Yes: Display it */
 
 			if (sep) {
-				printf(",\n");
+				out_puts(",\n");
 			}
 			sep = TRUE;
 
@@ -332,15 +333,15 @@ __print_funct_t json_print_irq_stats(struct activity *a, int curr, int tab,
 				sprintf(irqno, "%d", i - 1);
 			}
 
-			xprintf0(tab, "{\"intr\": \"%s\", "
-				 "\"value\": %.2f}",
-				 irqno,
-				 S_VALUE(sip->irq_nr, sic->irq_nr, itv));
+			out_xprintf0(tab, "{\"intr\": \"%s\", "
+				     "\"value\": %.2f}",
+				     irqno,
+				     S_VALUE(sip->irq_nr, sic->irq_nr, itv));
 		}
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	out_puts("\n");
+	out_xprintf0(--tab, "]");
 }
 
 /*
@@ -361,11 +362,11 @@ __print_funct_t json_print_swap_stats(struct activity *a, int curr, int tab,
 		*ssc = (struct stats_swap *) a->buf[curr],
 		*ssp = (struct stats_swap *) a->buf[!curr];
 
-	xprintf0(tab, "\"swap-pages\": {"
-		 "\"pswpin\": %.2f, "
-		 "\"pswpout\": %.2f}",
-		 S_VALUE(ssp->pswpin,  ssc->pswpin,  itv),
-		 S_VALUE(ssp->pswpout, ssc->pswpout, itv));
+	out_xprintf0(tab, "\"swap-pages\": {"
+		     "\"pswpin\": %.2f, "
+		     "\"pswpout\": %.2f}",
+		     S_VALUE(ssp->pswpin,  ssc->pswpin,  itv),
+		     S_VALUE(ssp->pswpout, ssc->pswpout, itv));
 }
 
 /*
@@ -386,29 +387,29 @@ __print_funct_t json_print_paging_stats(struct activity *a, int curr, int tab,
 		*spc = (struct stats_paging *) a->buf[curr],
 		*spp = (struct stats_paging *) a->buf[!curr];
 
-	xprintf0(tab, "\"paging\": {"
-		 "\"pgpgin\": %.2f, "
-		 "\"pgpgout\": %.2f, "
-		 "\"fault\": %.2f, "
-		 "\"majflt\": %.2f, "
-		 "\"pgfree\": %.2f, "
-		 "\"pgscank\": %.2f, "
-		 "\"pgscand\": %.2f, "
-		 "\"pgsteal\": %.2f, "
-		 "\"vmeff-percent\": %.2f}",
-		 S_VALUE(spp->pgpgin,        spc->pgpgin,        itv),
-		 S_VALUE(spp->pgpgout,       spc->pgpgout,       itv),
-		 S_VALUE(spp->pgfault,       spc->pgfault,       itv),
-		 S_VALUE(spp->pgmajfault,    spc->pgmajfault,    itv),
-		 S_VALUE(spp->pgfree,        spc->pgfree,        itv),
-		 S_VALUE(spp->pgscan_kswapd, spc->pgscan_kswapd, itv),
-		 S_VALUE(spp->pgscan_direct, spc->pgscan_direct, itv),
-		 S_VALUE(spp->pgsteal,       spc->pgsteal,       itv),
-		 (spc->pgscan_kswapd + spc->pgscan_direct -
-		  spp->pgscan_kswapd - spp->pgscan_direct) ?
-		 SP_VALUE(spp->pgsteal, spc->pgsteal,
-			  spc->pgscan_kswapd + spc->pgscan_direct -
-			  spp->pgscan_kswapd - spp->pgscan_direct) : 0.0);
+	out_xprintf0(tab, "\"paging\": {"
+		     "\"pgpgin\": %.2f, "
+		     "\"pgpgout\": %.2f, "
+		     "\"fault\": %.2f, "
+		     "\"majflt\": %.2f, "
+		     "\"pgfree\": %.2f, "
+		     "\"pgscank\": %.2f, "
+		     "\"pgscand\": %.2f, "
+		     "\"pgsteal\": %.2f, "
+		     "\"vmeff-percent\": %.2f}",
+		     S_VALUE(spp->pgpgin,        spc->pgpgin,        itv),
+		     S_VALUE(spp->pgpgout,       spc->pgpgout,       itv),
+		     S_VALUE(spp->pgfault,       spc->pgfault,       itv),
+		     S_VALUE(spp->pgmajfault,    spc->pgmajfault,    itv),
+		     S_VALUE(spp->pgfree,        spc->pgfree,        itv),
+		     S_VALUE(spp->pgscan_kswapd, spc->pgscan_kswapd, itv),
+		     S_VALUE(spp->pgscan_direct, spc->pgscan_direct, itv),
+		     S_VALUE(spp->pgsteal,       spc->pgsteal,       itv),
+		     (spc->pgscan_kswapd + spc->pgscan_direct -
+		      spp->pgscan_kswapd - spp->pgscan_direct) ?
+		     SP_VALUE(spp->pgsteal, spc->pgsteal,
+			      spc->pgscan_kswapd + spc->pgscan_direct -
+			      spp->pgscan_kswapd - spp->pgscan_direct) : 0.0);
 }
 
 /*
@@ -429,30 +430,30 @@ __print_funct_t json_print_io_stats(struct activity *a, int curr, int tab,
 		*sic = (struct stats_io *) a->buf[curr],
 		*sip = (struct stats_io *) a->buf[!curr];
 
-	xprintf0(tab, "\"io\": {"
-		 "\"tps\": %.2f, "
-		 "\"io-reads\": {"
-		 "\"rtps\": %.2f, "
-		 "\"bread\": %.2f}, "
-		 "\"io-writes\": {"
-		 "\"wtps\": %.2f, "
-		 "\"bwrtn\": %.2f}}",
-		 /*
-		  * If we get negative values, this is probably because
-		  * one or more devices/filesystems have been unmounted.
-		  * We display 0.0 in this case though we should rather tell
-		  * the user that the value cannot be calculated here.
-		  */
-		 sic->dk_drive < sip->dk_drive ? 0.0 :
-		 S_VALUE(sip->dk_drive, sic->dk_drive, itv),
-		 sic->dk_drive_rio < sip->dk_drive_rio ? 0.0 :
-		 S_VALUE(sip->dk_drive_rio, sic->dk_drive_rio, itv),
-		 sic->dk_drive_rblk < sip->dk_drive_rblk ? 0.0 :
-		 S_VALUE(sip->dk_drive_rblk, sic->dk_drive_rblk, itv),
-		 sic->dk_drive_wio < sip->dk_drive_wio ? 0.0 :
-		 S_VALUE(sip->dk_drive_wio, sic->dk_drive_wio, itv),
-		 sic->dk_drive_wblk < sip->dk_drive_wblk ? 0.0 :
-		 S_VALUE(sip->dk_drive_wblk, sic->dk_drive_wblk, itv));
+	out_xprintf0(tab, "\"io\": {"
+		     "\"tps\": %.2f, "
+		     "\"io-reads\": {"
+		     "\"rtps\": %.2f, "
+		     "\"bread\": %.2f}, "
+		     "\"io-writes\": {"
+		     "\"wtps\": %.2f, "
+		     "\"bwrtn\": %.2f}}",
+		     /*
+		      * If we get negative values, this is probably because
+		      * one or more devices/filesystems have been unmounted.
+		      * We display 0.0 in this case though we should rather tell
+		      * the user that the value cannot be calculated here.
+		      */
+		     sic->dk_drive < sip->dk_drive ? 0.0 :
+		     S_VALUE(sip->dk_drive, sic->dk_drive, itv),
+		     sic->dk_drive_rio < sip->dk_drive_rio ? 0.0 :
+		     S_VALUE(sip->dk_drive_rio, sic->dk_drive_rio, itv),
+		     sic->dk_drive_rblk < sip->dk_drive_rblk ? 0.0 :
+		     S_VALUE(sip->dk_drive_rblk, sic->dk_drive_rblk, itv),
+		     sic->dk_drive_wio < sip->dk_drive_wio ? 0.0 :
+		     S_VALUE(sip->dk_drive_wio, sic->dk_drive_wio, itv),
+		     sic->dk_drive_wblk < sip->dk_drive_wblk ? 0.0 :
+		     S_VALUE(sip->dk_drive_wblk, sic->dk_drive_wblk, itv));
 }
 
 /*
@@ -473,78 +474,78 @@ __print_funct_t json_print_memory_stats(struct activity *a, int curr, int tab,
 		*smc = (struct stats_memory *) a->buf[curr];
 	int sep = FALSE;
 
-	xprintf0(tab, "\"memory\": {");
+	out_xprintf0(tab, "\"memory\": {");
 
 	if (DISPLAY_MEMORY(a->opt_flags)) {
 
 		sep = TRUE;
 
-		printf("\"memfree\": %llu, "
-		       "\"avail\": %llu, "
-		       "\"memused\": %llu, "
-		       "\"memused-percent\": %.2f, "
-		       "\"buffers\": %llu, "
-		       "\"cached\": %llu, "
-		       "\"commit\": %llu, "
-		       "\"commit-percent\": %.2f, "
-		       "\"active\": %llu, "
-		       "\"inactive\": %llu, "
-		       "\"dirty\": %llu",
-		       smc->frmkb,
-		       smc->availablekb,
-		       smc->tlmkb - smc->frmkb,
-		       smc->tlmkb ?
-		       SP_VALUE(smc->frmkb, smc->tlmkb, smc->tlmkb) :
-		       0.0,
-		       smc->bufkb,
-		       smc->camkb,
-		       smc->comkb,
-		       (smc->tlmkb + smc->tlskb) ?
-		       SP_VALUE(0, smc->comkb, smc->tlmkb + smc->tlskb) :
-		       0.0,
-		       smc->activekb,
-		       smc->inactkb,
-		       smc->dirtykb);
+		out_printf("\"memfree\": %llu, "
+			   "\"avail\": %llu, "
+			   "\"memused\": %llu, "
+			   "\"memused-percent\": %.2f, "
+			   "\"buffers\": %llu, "
+			   "\"cached\": %llu, "
+			   "\"commit\": %llu, "
+			   "\"commit-percent\": %.2f, "
+			   "\"active\": %llu, "
+			   "\"inactive\": %llu, "
+			   "\"dirty\": %llu",
+			   smc->frmkb,
+			   smc->availablekb,
+			   smc->tlmkb - smc->frmkb,
+			   smc->tlmkb ?
+			   SP_VALUE(smc->frmkb, smc->tlmkb, smc->tlmkb) :
+			   0.0,
+			   smc->bufkb,
+			   smc->camkb,
+			   smc->comkb,
+			   (smc->tlmkb + smc->tlskb) ?
+			   SP_VALUE(0, smc->comkb, smc->tlmkb + smc->tlskb) :
+			   0.0,
+			   smc->activekb,
+			   smc->inactkb,
+			   smc->dirtykb);
 
 		if (DISPLAY_MEM_ALL(a->opt_flags)) {
 			/* Display extended memory stats */
-			printf(", \"anonpg\": %llu, "
-			       "\"slab\": %llu, "
-			       "\"kstack\": %llu, "
-			       "\"pgtbl\": %llu, "
-			       "\"vmused\": %llu",
-			       smc->anonpgkb,
-			       smc->slabkb,
-			       smc->kstackkb,
-			       smc->pgtblkb,
-			       smc->vmusedkb);
+			out_printf(", \"anonpg\": %llu, "
+				   "\"slab\": %llu, "
+				   "\"kstack\": %llu, "
+				   "\"pgtbl\": %llu, "
+				   "\"vmused\": %llu",
+				   smc->anonpgkb,
+				   smc->slabkb,
+				   smc->kstackkb,
+				   smc->pgtblkb,
+				   smc->vmusedkb);
 		}
 	}
 
 	if (DISPLAY_SWAP(a->opt_flags)) {
 
 		if (sep) {
-			printf(", ");
+			out_puts(", ");
 		}
 		sep = TRUE;
 
-		printf("\"swpfree\": %llu, "
-		       "\"swpused\": %llu, "
-		       "\"swpused-percent\": %.2f, "
-		       "\"swpcad\": %llu, "
-		       "\"swpcad-percent\": %.2f",
-		       smc->frskb,
-		       smc->tlskb - smc->frskb,
-		       smc->tlskb ?
-		       SP_VALUE(smc->frskb, smc->tlskb, smc->tlskb) :
-		       0.0,
-		       smc->caskb,
-		       (smc->tlskb - smc->frskb) ?
-		       SP_VALUE(0, smc->caskb, smc->tlskb - smc->frskb) :
-		       0.0);
+		out_printf("\"swpfree\": %llu, "
+			   "\"swpused\": %llu, "
+			   "\"swpused-percent\": %.2f, "
+			   "\"swpcad\": %llu, "
+			   "\"swpcad-percent\": %.2f",
+			   smc->frskb,
+			   smc->tlskb - smc->frskb,
+			   smc->tlskb ?
+			   SP_VALUE(smc->frskb, smc->tlskb, smc->tlskb) :
+			   0.0,
+			   smc->caskb,
+			   (smc->tlskb - smc->frskb) ?
+			   SP_VALUE(0, smc->caskb, smc->tlskb - smc->frskb) :
+			   0.0);
 	}
 
-	printf("}");
+	out_puts("}");
 }
 
 /*
@@ -564,15 +565,15 @@ __print_funct_t json_print_ktables_stats(struct activity *a, int curr, int tab,
 	struct stats_ktables
 		*skc = (struct stats_ktables *) a->buf[curr];
 
-	xprintf0(tab, "\"kernel\": {"
-		 "\"dentunusd\": %llu, "
-		 "\"file-nr\": %llu, "
-		 "\"inode-nr\": %llu, "
-		 "\"pty-nr\": %llu}",
-		 skc->dentry_stat,
-		 skc->file_used,
-		 skc->inode_used,
-		 skc->pty_nr);
+	out_xprintf0(tab, "\"kernel\": {"
+		     "\"dentunusd\": %llu, "
+		     "\"file-nr\": %llu, "
+		     "\"inode-nr\": %llu, "
+		     "\"pty-nr\": %llu}",
+		     skc->dentry_stat,
+		     skc->file_used,
+		     skc->inode_used,
+		     skc->pty_nr);
 }
 
 /*
@@ -592,19 +593,19 @@ __print_funct_t json_print_queue_stats(struct activity *a, int curr, int tab,
 	struct stats_queue
 		*sqc = (struct stats_queue *) a->buf[curr];
 
-	xprintf0(tab, "\"queue\": {"
-		 "\"runq-sz\": %llu, "
-		 "\"plist-sz\": %llu, "
-		 "\"ldavg-1\": %.2f, "
-		 "\"ldavg-5\": %.2f, "
-		 "\"ldavg-15\": %.2f, "
-		 "\"blocked\": %llu}",
-		 sqc->nr_running,
-		 sqc->nr_threads,
-		 (double) sqc->load_avg_1 / 100,
-		 (double) sqc->load_avg_5 / 100,
-		 (double) sqc->load_avg_15 / 100,
-		 sqc->procs_blocked);
+	out_xprintf0(tab, "\"queue\": {"
+		     "\"runq-sz\": %llu, "
+		     "\"plist-sz\": %llu, "
+		     "\"ldavg-1\": %.2f, "
+		     "\"ldavg-5\": %.2f, "
+		     "\"ldavg-15\": %.2f, "
+		     "\"blocked\": %llu}",
+		     sqc->nr_running,
+		     sqc->nr_threads,
+		     (double) sqc->load_avg_1 / 100,
+		     (double) sqc->load_avg_5 / 100,
+		     (double) sqc->load_avg_15 / 100,
+		     sqc->procs_blocked);
 }
 
 /*
@@ -625,7 +626,7 @@ __print_funct_t json_print_serial_stats(struct activity *a, int curr, int tab,
 	struct stats_serial *ssc, *ssp;
 	int sep = FALSE;
 
-	xprintf(tab++, "\"serial\": [");
+	out_xprintf(tab++, "\"serial\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 
@@ -660,28 +661,28 @@ __print_funct_t json_print_serial_stats(struct activity *a, int curr, int tab,
 			continue;
 
 		if (sep) {
-			printf(",\n");
+			out_puts(",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"line\": %d, "
-			 "\"rcvin\": %.2f, "
-			 "\"xmtin\": %.2f, "
-			 "\"framerr\": %.2f, "
-			 "\"prtyerr\": %.2f, "
-			 "\"brk\": %.2f, "
-			 "\"ovrun\": %.2f}",
-			 ssc->line,
-			 S_VALUE(ssp->rx,      ssc->rx,      itv),
-			 S_VALUE(ssp->tx,      ssc->tx,      itv),
-			 S_VALUE(ssp->frame,   ssc->frame,   itv),
-			 S_VALUE(ssp->parity,  ssc->parity,  itv),
-			 S_VALUE(ssp->brk,     ssc->brk,     itv),
-			 S_VALUE(ssp->overrun, ssc->overrun, itv));
+		out_xprintf0(tab, "{\"line\": %d, "
+			     "\"rcvin\": %.2f, "
+			     "\"xmtin\": %.2f, "
+			     "\"framerr\": %.2f, "
+			     "\"prtyerr\": %.2f, "
+			     "\"brk\": %.2f, "
+			     "\"ovrun\": %.2f}",
+			     ssc->line,
+			     S_VALUE(ssp->rx,      ssc->rx,      itv),
+			     S_VALUE(ssp->tx,      ssc->tx,      itv),
+			     S_VALUE(ssp->frame,   ssc->frame,   itv),
+			     S_VALUE(ssp->parity,  ssc->parity,  itv),
+			     S_VALUE(ssp->brk,     ssc->brk,     itv),
+			     S_VALUE(ssp->overrun, ssc->overrun, itv));
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	out_puts("\n");
+	out_xprintf0(--tab, "]");
 }
 
 /*
@@ -706,7 +707,7 @@ __print_funct_t json_print_disk_stats(struct activity *a, int curr, int tab,
 
 	memset(&sdpzero, 0, STATS_DISK_SIZE);
 
-	xprintf(tab++, "\"disk\": [");
+	out_xprintf(tab++, "\"disk\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 
@@ -746,42 +747,42 @@ __print_funct_t json_print_disk_stats(struct activity *a, int curr, int tab,
 		}
 
 		if (sep) {
-			printf(",\n");
+			out_puts(",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"disk-device\": \"%s\", "
-			 "\"tps\": %.2f, "
-			 "\"rd_sec\": %.2f, "
-			 "\"wr_sec\": %.2f, "
-			 "\"rkB\": %.2f, "
-			 "\"wkB\": %.2f, "
-			 "\"avgrq-sz\": %.2f, "
-			 "\"areq-sz\": %.2f, "
-			 "\"avgqu-sz\": %.2f, "
-			 "\"aqu-sz\": %.2f, "
-			 "\"await\": %.2f, "
-			 "\"svctm\": %.2f, "
-			 "\"util-percent\": %.2f}",
-			 /* Confusion possible here between index and minor numbers */
-			 dev_name,
-			 S_VALUE(sdp->nr_ios, sdc->nr_ios, itv),
-			 S_VALUE(sdp->rd_sect, sdc->rd_sect, itv), /* Unit = sectors (for backward compatibility) */
-			 S_VALUE(sdp->wr_sect, sdc->wr_sect, itv),
-			 S_VALUE(sdp->rd_sect, sdc->rd_sect, itv) / 2,
-			 S_VALUE(sdp->wr_sect, sdc->wr_sect, itv) / 2,
-			 /* See iostat for explanations */
-			 xds.arqsz,	/* Unit = sectors (for backward compatibility) */
-			 xds.arqsz / 2,
-			 S_VALUE(sdp->rq_ticks, sdc->rq_ticks, itv) / 1000.0,	/* For backward compatibility */
-			 S_VALUE(sdp->rq_ticks, sdc->rq_ticks, itv) / 1000.0,
-			 xds.await,
-			 xds.svctm,
-			 xds.util / 10.0);
+		out_xprintf0(tab, "{\"disk-device\": \"%s\", "
+			     "\"tps\": %.2f, "
+			     "\"rd_sec\": %.2f, "
+			     "\"wr_sec\": %.2f, "
+			     "\"rkB\": %.2f, "
+			     "\"wkB\": %.2f, "
+			     "\"avgrq-sz\": %.2f, "
+			     "\"areq-sz\": %.2f, "
+			     "\"avgqu-sz\": %.2f, "
+			     "\"aqu-sz\": %.2f, "
+			     "\"await\": %.2f, "
+			     "\"svctm\": %.2f, "
+			     "\"util-percent\": %.2f}",
+			     /* Confusion possible here between index and minor numbers */
+			     dev_name,
+			     S_VALUE(sdp->nr_ios, sdc->nr_ios, itv),
+			     S_VALUE(sdp->rd_sect, sdc->rd_sect, itv), /* Unit = sectors (for backward compatibility) */
+			     S_VALUE(sdp->wr_sect, sdc->wr_sect, itv),
+			     S_VALUE(sdp->rd_sect, sdc->rd_sect, itv) / 2,
+			     S_VALUE(sdp->wr_sect, sdc->wr_sect, itv) / 2,
+			     /* See iostat for explanations */
+			     xds.arqsz,	/* Unit = sectors (for backward compatibility) */
+			     xds.arqsz / 2,
+			     S_VALUE(sdp->rq_ticks, sdc->rq_ticks, itv) / 1000.0,	/* For backward compatibility */
+			     S_VALUE(sdp->rq_ticks, sdc->rq_ticks, itv) / 1000.0,
+			     xds.await,
+			     xds.svctm,
+			     xds.util / 10.0);
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	out_puts("\n");
+	out_xprintf0(--tab, "]");
 }
 
 /*
@@ -811,7 +812,7 @@ __print_funct_t json_print_net_dev_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"net-dev\": [");
+	out_xprintf(tab++, "\"net-dev\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 
@@ -827,7 +828,7 @@ __print_funct_t json_print_net_dev_stats(struct activity *a, int curr, int tab,
 		}
 
 		if (sep) {
-			printf(",\n");
+			out_puts(",\n");
 		}
 		sep = TRUE;
 
@@ -835,28 +836,28 @@ __print_funct_t json_print_net_dev_stats(struct activity *a, int curr, int tab,
 		txkb = S_VALUE(sndp->tx_bytes, sndc->tx_bytes, itv);
 		ifutil = compute_ifutil(sndc, rxkb, txkb);
 
-		xprintf0(tab, "{\"iface\": \"%s\", "
-			 "\"rxpck\": %.2f, "
-			 "\"txpck\": %.2f, "
-			 "\"rxkB\": %.2f, "
-			 "\"txkB\": %.2f, "
-			 "\"rxcmp\": %.2f, "
-			 "\"txcmp\": %.2f, "
-			 "\"rxmcst\": %.2f, "
-			 "\"ifutil-percent\": %.2f}",
-			 sndc->interface,
-			 S_VALUE(sndp->rx_packets,    sndc->rx_packets,    itv),
-			 S_VALUE(sndp->tx_packets,    sndc->tx_packets,    itv),
-			 rxkb / 1024,
-			 txkb / 1024,
-			 S_VALUE(sndp->rx_compressed, sndc->rx_compressed, itv),
-			 S_VALUE(sndp->tx_compressed, sndc->tx_compressed, itv),
-			 S_VALUE(sndp->multicast,     sndc->multicast,     itv),
-			 ifutil);
+		out_xprintf0(tab, "{\"iface\": \"%s\", "
+			     "\"rxpck\": %.2f, "
+			     "\"txpck\": %.2f, "
+			     "\"rxkB\": %.2f, "
+			     "\"txkB\": %.2f, "
+			     "\"rxcmp\": %.2f, "
+			     "\"txcmp\": %.2f, "
+			     "\"rxmcst\": %.2f, "
+			     "\"ifutil-percent\": %.2f}",
+			     sndc->interface,
+			     S_VALUE(sndp->rx_packets,    sndc->rx_packets,    itv),
+			     S_VALUE(sndp->tx_packets,    sndc->tx_packets,    itv),
+			     rxkb / 1024,
+			     txkb / 1024,
+			     S_VALUE(sndp->rx_compressed, sndc->rx_compressed, itv),
+			     S_VALUE(sndp->tx_compressed, sndc->tx_compressed, itv),
+			     S_VALUE(sndp->multicast,     sndc->multicast,     itv),
+			     ifutil);
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	out_puts("\n");
+	out_xprintf0(--tab, "]");
 
 	tab--;
 
@@ -892,7 +893,7 @@ __print_funct_t json_print_net_edev_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"net-edev\": [");
+	out_xprintf(tab++, "\"net-edev\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 
@@ -908,34 +909,34 @@ __print_funct_t json_print_net_edev_stats(struct activity *a, int curr, int tab,
 		}
 
 		if (sep) {
-			printf(",\n");
+			out_puts(",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"iface\": \"%s\", "
-			 "\"rxerr\": %.2f, "
-			 "\"txerr\": %.2f, "
-			 "\"coll\": %.2f, "
-			 "\"rxdrop\": %.2f, "
-			 "\"txdrop\": %.2f, "
-			 "\"txcarr\": %.2f, "
-			 "\"rxfram\": %.2f, "
-			 "\"rxfifo\": %.2f, "
-			 "\"txfifo\": %.2f}",
-			 snedc->interface,
-			 S_VALUE(snedp->rx_errors,         snedc->rx_errors,         itv),
-			 S_VALUE(snedp->tx_errors,         snedc->tx_errors,         itv),
-			 S_VALUE(snedp->collisions,        snedc->collisions,        itv),
-			 S_VALUE(snedp->rx_dropped,        snedc->rx_dropped,        itv),
-			 S_VALUE(snedp->tx_dropped,        snedc->tx_dropped,        itv),
-			 S_VALUE(snedp->tx_carrier_errors, snedc->tx_carrier_errors, itv),
-			 S_VALUE(snedp->rx_frame_errors,   snedc->rx_frame_errors,   itv),
-			 S_VALUE(snedp->rx_fifo_errors,    snedc->rx_fifo_errors,    itv),
-			 S_VALUE(snedp->tx_fifo_errors,    snedc->tx_fifo_errors,    itv));
+		out_xprintf0(tab, "{\"iface\": \"%s\", "
+			     "\"rxerr\": %.2f, "
+			     "\"txerr\": %.2f, "
+			     "\"coll\": %.2f, "
+			     "\"rxdrop\": %.2f, "
+			     "\"txdrop\": %.2f, "
+			     "\"txcarr\": %.2f, "
+			     "\"rxfram\": %.2f, "
+			     "\"rxfifo\": %.2f, "
+			     "\"txfifo\": %.2f}",
+			     snedc->interface,
+			     S_VALUE(snedp->rx_errors,         snedc->rx_errors,         itv),
+			     S_VALUE(snedp->tx_errors,         snedc->tx_errors,         itv),
+			     S_VALUE(snedp->collisions,        snedc->collisions,        itv),
+			     S_VALUE(snedp->rx_dropped,        snedc->rx_dropped,        itv),
+			     S_VALUE(snedp->tx_dropped,        snedc->tx_dropped,        itv),
+			     S_VALUE(snedp->tx_carrier_errors, snedc->tx_carrier_errors, itv),
+			     S_VALUE(snedp->rx_frame_errors,   snedc->rx_frame_errors,   itv),
+			     S_VALUE(snedp->rx_fifo_errors,    snedc->rx_fifo_errors,    itv),
+			     S_VALUE(snedp->tx_fifo_errors,    snedc->tx_fifo_errors,    itv));
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	out_puts("\n");
+	out_xprintf0(--tab, "]");
 
 	tab--;
 
@@ -969,19 +970,19 @@ __print_funct_t json_print_net_nfs_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-nfs\": {"
-		 "\"call\": %.2f, "
-		 "\"retrans\": %.2f, "
-		 "\"read\": %.2f, "
-		 "\"write\": %.2f, "
-		 "\"access\": %.2f, "
-		 "\"getatt\": %.2f}",
-		 S_VALUE(snnp->nfs_rpccnt,     snnc->nfs_rpccnt,     itv),
-		 S_VALUE(snnp->nfs_rpcretrans, snnc->nfs_rpcretrans, itv),
-		 S_VALUE(snnp->nfs_readcnt,    snnc->nfs_readcnt,    itv),
-		 S_VALUE(snnp->nfs_writecnt,   snnc->nfs_writecnt,   itv),
-		 S_VALUE(snnp->nfs_accesscnt,  snnc->nfs_accesscnt,  itv),
-		 S_VALUE(snnp->nfs_getattcnt,  snnc->nfs_getattcnt,  itv));
+	out_xprintf0(tab, "\"net-nfs\": {"
+		     "\"call\": %.2f, "
+		     "\"retrans\": %.2f, "
+		     "\"read\": %.2f, "
+		     "\"write\": %.2f, "
+		     "\"access\": %.2f, "
+		     "\"getatt\": %.2f}",
+		     S_VALUE(snnp->nfs_rpccnt,     snnc->nfs_rpccnt,     itv),
+		     S_VALUE(snnp->nfs_rpcretrans, snnc->nfs_rpcretrans, itv),
+		     S_VALUE(snnp->nfs_readcnt,    snnc->nfs_readcnt,    itv),
+		     S_VALUE(snnp->nfs_writecnt,   snnc->nfs_writecnt,   itv),
+		     S_VALUE(snnp->nfs_accesscnt,  snnc->nfs_accesscnt,  itv),
+		     S_VALUE(snnp->nfs_getattcnt,  snnc->nfs_getattcnt,  itv));
 	tab--;
 
 close_json_markup:
@@ -1014,29 +1015,29 @@ __print_funct_t json_print_net_nfsd_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-nfsd\": {"
-		 "\"scall\": %.2f, "
-		 "\"badcall\": %.2f, "
-		 "\"packet\": %.2f, "
-		 "\"udp\": %.2f, "
-		 "\"tcp\": %.2f, "
-		 "\"hit\": %.2f, "
-		 "\"miss\": %.2f, "
-		 "\"sread\": %.2f, "
-		 "\"swrite\": %.2f, "
-		 "\"saccess\": %.2f, "
-		 "\"sgetatt\": %.2f}",
-		 S_VALUE(snndp->nfsd_rpccnt,    snndc->nfsd_rpccnt,    itv),
-		 S_VALUE(snndp->nfsd_rpcbad,    snndc->nfsd_rpcbad,    itv),
-		 S_VALUE(snndp->nfsd_netcnt,    snndc->nfsd_netcnt,    itv),
-		 S_VALUE(snndp->nfsd_netudpcnt, snndc->nfsd_netudpcnt, itv),
-		 S_VALUE(snndp->nfsd_nettcpcnt, snndc->nfsd_nettcpcnt, itv),
-		 S_VALUE(snndp->nfsd_rchits,    snndc->nfsd_rchits,    itv),
-		 S_VALUE(snndp->nfsd_rcmisses,  snndc->nfsd_rcmisses,  itv),
-		 S_VALUE(snndp->nfsd_readcnt,   snndc->nfsd_readcnt,   itv),
-		 S_VALUE(snndp->nfsd_writecnt,  snndc->nfsd_writecnt,  itv),
-		 S_VALUE(snndp->nfsd_accesscnt, snndc->nfsd_accesscnt, itv),
-		 S_VALUE(snndp->nfsd_getattcnt, snndc->nfsd_getattcnt, itv));
+	out_xprintf0(tab, "\"net-nfsd\": {"
+		     "\"scall\": %.2f, "
+		     "\"badcall\": %.2f, "
+		     "\"packet\": %.2f, "
+		     "\"udp\": %.2f, "
+		     "\"tcp\": %.2f, "
+		     "\"hit\": %.2f, "
+		     "\"miss\": %.2f, "
+		     "\"sread\": %.2f, "
+		     "\"swrite\": %.2f, "
+		     "\"saccess\": %.2f, "
+		     "\"sgetatt\": %.2f}",
+		     S_VALUE(snndp->nfsd_rpccnt,    snndc->nfsd_rpccnt,    itv),
+		     S_VALUE(snndp->nfsd_rpcbad,    snndc->nfsd_rpcbad,    itv),
+		     S_VALUE(snndp->nfsd_netcnt,    snndc->nfsd_netcnt,    itv),
+		     S_VALUE(snndp->nfsd_netudpcnt, snndc->nfsd_netudpcnt, itv),
+		     S_VALUE(snndp->nfsd_nettcpcnt, snndc->nfsd_nettcpcnt, itv),
+		     S_VALUE(snndp->nfsd_rchits,    snndc->nfsd_rchits,    itv),
+		     S_VALUE(snndp->nfsd_rcmisses,  snndc->nfsd_rcmisses,  itv),
+		     S_VALUE(snndp->nfsd_readcnt,   snndc->nfsd_readcnt,   itv),
+		     S_VALUE(snndp->nfsd_writecnt,  snndc->nfsd_writecnt,  itv),
+		     S_VALUE(snndp->nfsd_accesscnt, snndc->nfsd_accesscnt, itv),
+		     S_VALUE(snndp->nfsd_getattcnt, snndc->nfsd_getattcnt, itv));
 	tab--;
 
 close_json_markup:
@@ -1068,19 +1069,19 @@ __print_funct_t json_print_net_sock_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-sock\": {"
-		 "\"totsck\": %u, "
-		 "\"tcpsck\": %u, "
-		 "\"udpsck\": %u, "
-		 "\"rawsck\": %u, "
-		 "\"ip-frag\": %u, "
-		 "\"tcp-tw\": %u}",
-		 snsc->sock_inuse,
-		 snsc->tcp_inuse,
-		 snsc->udp_inuse,
-		 snsc->raw_inuse,
-		 snsc->frag_inuse,
-		 snsc->tcp_tw);
+	out_xprintf0(tab, "\"net-sock\": {"
+		     "\"totsck\": %u, "
+		     "\"tcpsck\": %u, "
+		     "\"udpsck\": %u, "
+		     "\"rawsck\": %u, "
+		     "\"ip-frag\": %u, "
+		     "\"tcp-tw\": %u}",
+		     snsc->sock_inuse,
+		     snsc->tcp_inuse,
+		     snsc->udp_inuse,
+		     snsc->raw_inuse,
+		     snsc->frag_inuse,
+		     snsc->tcp_tw);
 	tab--;
 
 close_json_markup:
@@ -1113,23 +1114,23 @@ __print_funct_t json_print_net_ip_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-ip\": {"
-		 "\"irec\": %.2f, "
-		 "\"fwddgm\": %.2f, "
-		 "\"idel\": %.2f, "
-		 "\"orq\": %.2f, "
-		 "\"asmrq\": %.2f, "
-		 "\"asmok\": %.2f, "
-		 "\"fragok\": %.2f, "
-		 "\"fragcrt\": %.2f}",
-		 S_VALUE(snip->InReceives,    snic->InReceives,    itv),
-		 S_VALUE(snip->ForwDatagrams, snic->ForwDatagrams, itv),
-		 S_VALUE(snip->InDelivers,    snic->InDelivers,    itv),
-		 S_VALUE(snip->OutRequests,   snic->OutRequests,   itv),
-		 S_VALUE(snip->ReasmReqds,    snic->ReasmReqds,    itv),
-		 S_VALUE(snip->ReasmOKs,      snic->ReasmOKs,      itv),
-		 S_VALUE(snip->FragOKs,       snic->FragOKs,       itv),
-		 S_VALUE(snip->FragCreates,   snic->FragCreates,   itv));
+	out_xprintf0(tab, "\"net-ip\": {"
+		     "\"irec\": %.2f, "
+		     "\"fwddgm\": %.2f, "
+		     "\"idel\": %.2f, "
+		     "\"orq\": %.2f, "
+		     "\"asmrq\": %.2f, "
+		     "\"asmok\": %.2f, "
+		     "\"fragok\": %.2f, "
+		     "\"fragcrt\": %.2f}",
+		     S_VALUE(snip->InReceives,    snic->InReceives,    itv),
+		     S_VALUE(snip->ForwDatagrams, snic->ForwDatagrams, itv),
+		     S_VALUE(snip->InDelivers,    snic->InDelivers,    itv),
+		     S_VALUE(snip->OutRequests,   snic->OutRequests,   itv),
+		     S_VALUE(snip->ReasmReqds,    snic->ReasmReqds,    itv),
+		     S_VALUE(snip->ReasmOKs,      snic->ReasmOKs,      itv),
+		     S_VALUE(snip->FragOKs,       snic->FragOKs,       itv),
+		     S_VALUE(snip->FragCreates,   snic->FragCreates,   itv));
 	tab--;
 
 close_json_markup:
@@ -1162,23 +1163,23 @@ __print_funct_t json_print_net_eip_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-eip\": {"
-		 "\"ihdrerr\": %.2f, "
-		 "\"iadrerr\": %.2f, "
-		 "\"iukwnpr\": %.2f, "
-		 "\"idisc\": %.2f, "
-		 "\"odisc\": %.2f, "
-		 "\"onort\": %.2f, "
-		 "\"asmf\": %.2f, "
-		 "\"fragf\": %.2f}",
-		 S_VALUE(sneip->InHdrErrors,     sneic->InHdrErrors,     itv),
-		 S_VALUE(sneip->InAddrErrors,    sneic->InAddrErrors,    itv),
-		 S_VALUE(sneip->InUnknownProtos, sneic->InUnknownProtos, itv),
-		 S_VALUE(sneip->InDiscards,      sneic->InDiscards,      itv),
-		 S_VALUE(sneip->OutDiscards,     sneic->OutDiscards,     itv),
-		 S_VALUE(sneip->OutNoRoutes,     sneic->OutNoRoutes,     itv),
-		 S_VALUE(sneip->ReasmFails,      sneic->ReasmFails,      itv),
-		 S_VALUE(sneip->FragFails,       sneic->FragFails,       itv));
+	out_xprintf0(tab, "\"net-eip\": {"
+		     "\"ihdrerr\": %.2f, "
+		     "\"iadrerr\": %.2f, "
+		     "\"iukwnpr\": %.2f, "
+		     "\"idisc\": %.2f, "
+		     "\"odisc\": %.2f, "
+		     "\"onort\": %.2f, "
+		     "\"asmf\": %.2f, "
+		     "\"fragf\": %.2f}",
+		     S_VALUE(sneip->InHdrErrors,     sneic->InHdrErrors,     itv),
+		     S_VALUE(sneip->InAddrErrors,    sneic->InAddrErrors,    itv),
+		     S_VALUE(sneip->InUnknownProtos, sneic->InUnknownProtos, itv),
+		     S_VALUE(sneip->InDiscards,      sneic->InDiscards,      itv),
+		     S_VALUE(sneip->OutDiscards,     sneic->OutDiscards,     itv),
+		     S_VALUE(sneip->OutNoRoutes,     sneic->OutNoRoutes,     itv),
+		     S_VALUE(sneip->ReasmFails,      sneic->ReasmFails,      itv),
+		     S_VALUE(sneip->FragFails,       sneic->FragFails,       itv));
 	tab--;
 
 close_json_markup:
@@ -1211,35 +1212,35 @@ __print_funct_t json_print_net_icmp_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-icmp\": {"
-		 "\"imsg\": %.2f, "
-		 "\"omsg\": %.2f, "
-		 "\"iech\": %.2f, "
-		 "\"iechr\": %.2f, "
-		 "\"oech\": %.2f, "
-		 "\"oechr\": %.2f, "
-		 "\"itm\": %.2f, "
-		 "\"itmr\": %.2f, "
-		 "\"otm\": %.2f, "
-		 "\"otmr\": %.2f, "
-		 "\"iadrmk\": %.2f, "
-		 "\"iadrmkr\": %.2f, "
-		 "\"oadrmk\": %.2f, "
-		 "\"oadrmkr\": %.2f}",
-		 S_VALUE(snip->InMsgs,           snic->InMsgs,           itv),
-		 S_VALUE(snip->OutMsgs,          snic->OutMsgs,          itv),
-		 S_VALUE(snip->InEchos,          snic->InEchos,          itv),
-		 S_VALUE(snip->InEchoReps,       snic->InEchoReps,       itv),
-		 S_VALUE(snip->OutEchos,         snic->OutEchos,         itv),
-		 S_VALUE(snip->OutEchoReps,      snic->OutEchoReps,      itv),
-		 S_VALUE(snip->InTimestamps,     snic->InTimestamps,     itv),
-		 S_VALUE(snip->InTimestampReps,  snic->InTimestampReps,  itv),
-		 S_VALUE(snip->OutTimestamps,    snic->OutTimestamps,    itv),
-		 S_VALUE(snip->OutTimestampReps, snic->OutTimestampReps, itv),
-		 S_VALUE(snip->InAddrMasks,      snic->InAddrMasks,      itv),
-		 S_VALUE(snip->InAddrMaskReps,   snic->InAddrMaskReps,   itv),
-		 S_VALUE(snip->OutAddrMasks,     snic->OutAddrMasks,     itv),
-		 S_VALUE(snip->OutAddrMaskReps,  snic->OutAddrMaskReps,  itv));
+	out_xprintf0(tab, "\"net-icmp\": {"
+		     "\"imsg\": %.2f, "
+		     "\"omsg\": %.2f, "
+		     "\"iech\": %.2f, "
+		     "\"iechr\": %.2f, "
+		     "\"oech\": %.2f, "
+		     "\"oechr\": %.2f, "
+		     "\"itm\": %.2f, "
+		     "\"itmr\": %.2f, "
+		     "\"otm\": %.2f, "
+		     "\"otmr\": %.2f, "
+		     "\"iadrmk\": %.2f, "
+		     "\"iadrmkr\": %.2f, "
+		     "\"oadrmk\": %.2f, "
+		     "\"oadrmkr\": %.2f}",
+		     S_VALUE(snip->InMsgs,           snic->InMsgs,           itv),
+		     S_VALUE(snip->OutMsgs,          snic->OutMsgs,          itv),
+		     S_VALUE(snip->InEchos,          snic->InEchos,          itv),
+		     S_VALUE(snip->InEchoReps,       snic->InEchoReps,       itv),
+		     S_VALUE(snip->OutEchos,         snic->OutEchos,         itv),
+		     S_VALUE(snip->OutEchoReps,      snic->OutEchoReps,      itv),
+		     S_VALUE(snip->InTimestamps,     snic->InTimestamps,     itv),
+		     S_VALUE(snip->InTimestampReps,  snic->InTimestampReps,  itv),
+		     S_VALUE(snip->OutTimestamps,    snic->OutTimestamps,    itv),
+		     S_VALUE(snip->OutTimestampReps, snic->OutTimestampReps, itv),
+		     S_VALUE(snip->InAddrMasks,      snic->InAddrMasks,      itv),
+		     S_VALUE(snip->InAddrMaskReps,   snic->InAddrMaskReps,   itv),
+		     S_VALUE(snip->OutAddrMasks,     snic->OutAddrMasks,     itv),
+		     S_VALUE(snip->OutAddrMaskReps,  snic->OutAddrMaskReps,  itv));
 	tab--;
 
 close_json_markup:
@@ -1272,31 +1273,31 @@ __print_funct_t json_print_net_eicmp_stats(struct activity *a, int curr, int tab
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-eicmp\": {"
-		 "\"ierr\": %.2f, "
-		 "\"oerr\": %.2f, "
-		 "\"idstunr\": %.2f, "
-		 "\"odstunr\": %.2f, "
-		 "\"itmex\": %.2f, "
-		 "\"otmex\": %.2f, "
-		 "\"iparmpb\": %.2f, "
-		 "\"oparmpb\": %.2f, "
-		 "\"isrcq\": %.2f, "
-		 "\"osrcq\": %.2f, "
-		 "\"iredir\": %.2f, "
-		 "\"oredir\": %.2f}",
-		 S_VALUE(sneip->InErrors,        sneic->InErrors,        itv),
-		 S_VALUE(sneip->OutErrors,       sneic->OutErrors,       itv),
-		 S_VALUE(sneip->InDestUnreachs,  sneic->InDestUnreachs,  itv),
-		 S_VALUE(sneip->OutDestUnreachs, sneic->OutDestUnreachs, itv),
-		 S_VALUE(sneip->InTimeExcds,     sneic->InTimeExcds,     itv),
-		 S_VALUE(sneip->OutTimeExcds,    sneic->OutTimeExcds,    itv),
-		 S_VALUE(sneip->InParmProbs,     sneic->InParmProbs,     itv),
-		 S_VALUE(sneip->OutParmProbs,    sneic->OutParmProbs,    itv),
-		 S_VALUE(sneip->InSrcQuenchs,    sneic->InSrcQuenchs,    itv),
-		 S_VALUE(sneip->OutSrcQuenchs,   sneic->OutSrcQuenchs,   itv),
-		 S_VALUE(sneip->InRedirects,     sneic->InRedirects,     itv),
-		 S_VALUE(sneip->OutRedirects,    sneic->OutRedirects,    itv));
+	out_xprintf0(tab, "\"net-eicmp\": {"
+		     "\"ierr\": %.2f, "
+		     "\"oerr\": %.2f, "
+		     "\"idstunr\": %.2f, "
+		     "\"odstunr\": %.2f, "
+		     "\"itmex\": %.2f, "
+		     "\"otmex\": %.2f, "
+		     "\"iparmpb\": %.2f, "
+		     "\"oparmpb\": %.2f, "
+		     "\"isrcq\": %.2f, "
+		     "\"osrcq\": %.2f, "
+		     "\"iredir\": %.2f, "
+		     "\"oredir\": %.2f}",
+		     S_VALUE(sneip->InErrors,        sneic->InErrors,        itv),
+		     S_VALUE(sneip->OutErrors,       sneic->OutErrors,       itv),
+		     S_VALUE(sneip->InDestUnreachs,  sneic->InDestUnreachs,  itv),
+		     S_VALUE(sneip->OutDestUnreachs, sneic->OutDestUnreachs, itv),
+		     S_VALUE(sneip->InTimeExcds,     sneic->InTimeExcds,     itv),
+		     S_VALUE(sneip->OutTimeExcds,    sneic->OutTimeExcds,    itv),
+		     S_VALUE(sneip->InParmProbs,     sneic->InParmProbs,     itv),
+		     S_VALUE(sneip->OutParmProbs,    sneic->OutParmProbs,    itv),
+		     S_VALUE(sneip->InSrcQuenchs,    sneic->InSrcQuenchs,    itv),
+		     S_VALUE(sneip->OutSrcQuenchs,   sneic->OutSrcQuenchs,   itv),
+		     S_VALUE(sneip->InRedirects,     sneic->InRedirects,     itv),
+		     S_VALUE(sneip->OutRedirects,    sneic->OutRedirects,    itv));
 	tab--;
 
 close_json_markup:
@@ -1329,15 +1330,15 @@ __print_funct_t json_print_net_tcp_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-tcp\": {"
-		 "\"active\": %.2f, "
-		 "\"passive\": %.2f, "
-		 "\"iseg\": %.2f, "
-		 "\"oseg\": %.2f}",
-		 S_VALUE(sntp->ActiveOpens,  sntc->ActiveOpens,  itv),
-		 S_VALUE(sntp->PassiveOpens, sntc->PassiveOpens, itv),
-		 S_VALUE(sntp->InSegs,       sntc->InSegs,       itv),
-		 S_VALUE(sntp->OutSegs,      sntc->OutSegs,      itv));
+	out_xprintf0(tab, "\"net-tcp\": {"
+		     "\"active\": %.2f, "
+		     "\"passive\": %.2f, "
+		     "\"iseg\": %.2f, "
+		     "\"oseg\": %.2f}",
+		     S_VALUE(sntp->ActiveOpens,  sntc->ActiveOpens,  itv),
+		     S_VALUE(sntp->PassiveOpens, sntc->PassiveOpens, itv),
+		     S_VALUE(sntp->InSegs,       sntc->InSegs,       itv),
+		     S_VALUE(sntp->OutSegs,      sntc->OutSegs,      itv));
 	tab--;
 
 close_json_markup:
@@ -1370,17 +1371,17 @@ __print_funct_t json_print_net_etcp_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-etcp\": {"
-		 "\"atmptf\": %.2f, "
-		 "\"estres\": %.2f, "
-		 "\"retrans\": %.2f, "
-		 "\"isegerr\": %.2f, "
-		 "\"orsts\": %.2f}",
-		 S_VALUE(snetp->AttemptFails, snetc->AttemptFails,  itv),
-		 S_VALUE(snetp->EstabResets,  snetc->EstabResets,  itv),
-		 S_VALUE(snetp->RetransSegs,  snetc->RetransSegs,  itv),
-		 S_VALUE(snetp->InErrs,       snetc->InErrs,  itv),
-		 S_VALUE(snetp->OutRsts,      snetc->OutRsts,  itv));
+	out_xprintf0(tab, "\"net-etcp\": {"
+		     "\"atmptf\": %.2f, "
+		     "\"estres\": %.2f, "
+		     "\"retrans\": %.2f, "
+		     "\"isegerr\": %.2f, "
+		     "\"orsts\": %.2f}",
+		     S_VALUE(snetp->AttemptFails, snetc->AttemptFails,  itv),
+		     S_VALUE(snetp->EstabResets,  snetc->EstabResets,  itv),
+		     S_VALUE(snetp->RetransSegs,  snetc->RetransSegs,  itv),
+		     S_VALUE(snetp->InErrs,       snetc->InErrs,  itv),
+		     S_VALUE(snetp->OutRsts,      snetc->OutRsts,  itv));
 	tab--;
 
 close_json_markup:
@@ -1413,15 +1414,15 @@ __print_funct_t json_print_net_udp_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-udp\": {"
-		 "\"idgm\": %.2f, "
-		 "\"odgm\": %.2f, "
-		 "\"noport\": %.2f, "
-		 "\"idgmerr\": %.2f}",
-		 S_VALUE(snup->InDatagrams,  snuc->InDatagrams,  itv),
-		 S_VALUE(snup->OutDatagrams, snuc->OutDatagrams, itv),
-		 S_VALUE(snup->NoPorts,      snuc->NoPorts,      itv),
-		 S_VALUE(snup->InErrors,     snuc->InErrors,     itv));
+	out_xprintf0(tab, "\"net-udp\": {"
+		     "\"idgm\": %.2f, "
+		     "\"odgm\": %.2f, "
+		     "\"noport\": %.2f, "
+		     "\"idgmerr\": %.2f}",
+		     S_VALUE(snup->InDatagrams,  snuc->InDatagrams,  itv),
+		     S_VALUE(snup->OutDatagrams, snuc->OutDatagrams, itv),
+		     S_VALUE(snup->NoPorts,      snuc->NoPorts,      itv),
+		     S_VALUE(snup->InErrors,     snuc->InErrors,     itv));
 	tab--;
 
 close_json_markup:
@@ -1453,15 +1454,15 @@ __print_funct_t json_print_net_sock6_stats(struct activity *a, int curr, int tab
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-sock6\": {"
-		 "\"tcp6sck\": %u, "
-		 "\"udp6sck\": %u, "
-		 "\"raw6sck\": %u, "
-		 "\"ip6-frag\": %u}",
-		 snsc->tcp6_inuse,
-		 snsc->udp6_inuse,
-		 snsc->raw6_inuse,
-		 snsc->frag6_inuse);
+	out_xprintf0(tab, "\"net-sock6\": {"
+		     "\"tcp6sck\": %u, "
+		     "\"udp6sck\": %u, "
+		     "\"raw6sck\": %u, "
+		     "\"ip6-frag\": %u}",
+		     snsc->tcp6_inuse,
+		     snsc->udp6_inuse,
+		     snsc->raw6_inuse,
+		     snsc->frag6_inuse);
 	tab--;
 
 close_json_markup:
@@ -1494,27 +1495,27 @@ __print_funct_t json_print_net_ip6_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-ip6\": {"
-		 "\"irec6\": %.2f, "
-		 "\"fwddgm6\": %.2f, "
-		 "\"idel6\": %.2f, "
-		 "\"orq6\": %.2f, "
-		 "\"asmrq6\": %.2f, "
-		 "\"asmok6\": %.2f, "
-		 "\"imcpck6\": %.2f, "
-		 "\"omcpck6\": %.2f, "
-		 "\"fragok6\": %.2f, "
-		 "\"fragcr6\": %.2f}",
-		 S_VALUE(snip->InReceives6,       snic->InReceives6,       itv),
-		 S_VALUE(snip->OutForwDatagrams6, snic->OutForwDatagrams6, itv),
-		 S_VALUE(snip->InDelivers6,       snic->InDelivers6,       itv),
-		 S_VALUE(snip->OutRequests6,      snic->OutRequests6,      itv),
-		 S_VALUE(snip->ReasmReqds6,       snic->ReasmReqds6,       itv),
-		 S_VALUE(snip->ReasmOKs6,         snic->ReasmOKs6,         itv),
-		 S_VALUE(snip->InMcastPkts6,      snic->InMcastPkts6,      itv),
-		 S_VALUE(snip->OutMcastPkts6,     snic->OutMcastPkts6,     itv),
-		 S_VALUE(snip->FragOKs6,          snic->FragOKs6,          itv),
-		 S_VALUE(snip->FragCreates6,      snic->FragCreates6,      itv));
+	out_xprintf0(tab, "\"net-ip6\": {"
+		     "\"irec6\": %.2f, "
+		     "\"fwddgm6\": %.2f, "
+		     "\"idel6\": %.2f, "
+		     "\"orq6\": %.2f, "
+		     "\"asmrq6\": %.2f, "
+		     "\"asmok6\": %.2f, "
+		     "\"imcpck6\": %.2f, "
+		     "\"omcpck6\": %.2f, "
+		     "\"fragok6\": %.2f, "
+		     "\"fragcr6\": %.2f}",
+		     S_VALUE(snip->InReceives6,       snic->InReceives6,       itv),
+		     S_VALUE(snip->OutForwDatagrams6, snic->OutForwDatagrams6, itv),
+		     S_VALUE(snip->InDelivers6,       snic->InDelivers6,       itv),
+		     S_VALUE(snip->OutRequests6,      snic->OutRequests6,      itv),
+		     S_VALUE(snip->ReasmReqds6,       snic->ReasmReqds6,       itv),
+		     S_VALUE(snip->ReasmOKs6,         snic->ReasmOKs6,         itv),
+		     S_VALUE(snip->InMcastPkts6,      snic->InMcastPkts6,      itv),
+		     S_VALUE(snip->OutMcastPkts6,     snic->OutMcastPkts6,     itv),
+		     S_VALUE(snip->FragOKs6,          snic->FragOKs6,          itv),
+		     S_VALUE(snip->FragCreates6,      snic->FragCreates6,      itv));
 	tab--;
 
 close_json_markup:
@@ -1547,29 +1548,29 @@ __print_funct_t json_print_net_eip6_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-eip6\": {"
-		 "\"ihdrer6\": %.2f, "
-		 "\"iadrer6\": %.2f, "
-		 "\"iukwnp6\": %.2f, "
-		 "\"i2big6\": %.2f, "
-		 "\"idisc6\": %.2f, "
-		 "\"odisc6\": %.2f, "
-		 "\"inort6\": %.2f, "
-		 "\"onort6\": %.2f, "
-		 "\"asmf6\": %.2f, "
-		 "\"fragf6\": %.2f, "
-		 "\"itrpck6\": %.2f}",
-		 S_VALUE(sneip->InHdrErrors6,     sneic->InHdrErrors6,     itv),
-		 S_VALUE(sneip->InAddrErrors6,    sneic->InAddrErrors6,    itv),
-		 S_VALUE(sneip->InUnknownProtos6, sneic->InUnknownProtos6, itv),
-		 S_VALUE(sneip->InTooBigErrors6,  sneic->InTooBigErrors6,  itv),
-		 S_VALUE(sneip->InDiscards6,      sneic->InDiscards6,      itv),
-		 S_VALUE(sneip->OutDiscards6,     sneic->OutDiscards6,     itv),
-		 S_VALUE(sneip->InNoRoutes6,      sneic->InNoRoutes6,      itv),
-		 S_VALUE(sneip->OutNoRoutes6,     sneic->OutNoRoutes6,     itv),
-		 S_VALUE(sneip->ReasmFails6,      sneic->ReasmFails6,      itv),
-		 S_VALUE(sneip->FragFails6,       sneic->FragFails6,       itv),
-		 S_VALUE(sneip->InTruncatedPkts6, sneic->InTruncatedPkts6, itv));
+	out_xprintf0(tab, "\"net-eip6\": {"
+		     "\"ihdrer6\": %.2f, "
+		     "\"iadrer6\": %.2f, "
+		     "\"iukwnp6\": %.2f, "
+		     "\"i2big6\": %.2f, "
+		     "\"idisc6\": %.2f, "
+		     "\"odisc6\": %.2f, "
+		     "\"inort6\": %.2f, "
+		     "\"onort6\": %.2f, "
+		     "\"asmf6\": %.2f, "
+		     "\"fragf6\": %.2f, "
+		     "\"itrpck6\": %.2f}",
+		     S_VALUE(sneip->InHdrErrors6,     sneic->InHdrErrors6,     itv),
+		     S_VALUE(sneip->InAddrErrors6,    sneic->InAddrErrors6,    itv),
+		     S_VALUE(sneip->InUnknownProtos6, sneic->InUnknownProtos6, itv),
+		     S_VALUE(sneip->InTooBigErrors6,  sneic->InTooBigErrors6,  itv),
+		     S_VALUE(sneip->InDiscards6,      sneic->InDiscards6,      itv),
+		     S_VALUE(sneip->OutDiscards6,     sneic->OutDiscards6,     itv),
+		     S_VALUE(sneip->InNoRoutes6,      sneic->InNoRoutes6,      itv),
+		     S_VALUE(sneip->OutNoRoutes6,     sneic->OutNoRoutes6,     itv),
+		     S_VALUE(sneip->ReasmFails6,      sneic->ReasmFails6,      itv),
+		     S_VALUE(sneip->FragFails6,       sneic->FragFails6,       itv),
+		     S_VALUE(sneip->InTruncatedPkts6, sneic->InTruncatedPkts6, itv));
 	tab--;
 
 close_json_markup:
@@ -1602,41 +1603,41 @@ __print_funct_t json_print_net_icmp6_stats(struct activity *a, int curr, int tab
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-icmp6\": {"
-		 "\"imsg6\": %.2f, "
-		 "\"omsg6\": %.2f, "
-		 "\"iech6\": %.2f, "
-		 "\"iechr6\": %.2f, "
-		 "\"oechr6\": %.2f, "
-		 "\"igmbq6\": %.2f, "
-		 "\"igmbr6\": %.2f, "
-		 "\"ogmbr6\": %.2f, "
-		 "\"igmbrd6\": %.2f, "
-		 "\"ogmbrd6\": %.2f, "
-		 "\"irtsol6\": %.2f, "
-		 "\"ortsol6\": %.2f, "
-		 "\"irtad6\": %.2f, "
-		 "\"inbsol6\": %.2f, "
-		 "\"onbsol6\": %.2f, "
-		 "\"inbad6\": %.2f, "
-		 "\"onbad6\": %.2f}",
-		 S_VALUE(snip->InMsgs6,                    snic->InMsgs6,                    itv),
-		 S_VALUE(snip->OutMsgs6,                   snic->OutMsgs6,                   itv),
-		 S_VALUE(snip->InEchos6,                   snic->InEchos6,                   itv),
-		 S_VALUE(snip->InEchoReplies6,             snic->InEchoReplies6,             itv),
-		 S_VALUE(snip->OutEchoReplies6,            snic->OutEchoReplies6,            itv),
-		 S_VALUE(snip->InGroupMembQueries6,        snic->InGroupMembQueries6,        itv),
-		 S_VALUE(snip->InGroupMembResponses6,      snic->InGroupMembResponses6,      itv),
-		 S_VALUE(snip->OutGroupMembResponses6,     snic->OutGroupMembResponses6,     itv),
-		 S_VALUE(snip->InGroupMembReductions6,     snic->InGroupMembReductions6,     itv),
-		 S_VALUE(snip->OutGroupMembReductions6,    snic->OutGroupMembReductions6,    itv),
-		 S_VALUE(snip->InRouterSolicits6,          snic->InRouterSolicits6,          itv),
-		 S_VALUE(snip->OutRouterSolicits6,         snic->OutRouterSolicits6,         itv),
-		 S_VALUE(snip->InRouterAdvertisements6,    snic->InRouterAdvertisements6,    itv),
-		 S_VALUE(snip->InNeighborSolicits6,        snic->InNeighborSolicits6,        itv),
-		 S_VALUE(snip->OutNeighborSolicits6,       snic->OutNeighborSolicits6,       itv),
-		 S_VALUE(snip->InNeighborAdvertisements6,  snic->InNeighborAdvertisements6,  itv),
-		 S_VALUE(snip->OutNeighborAdvertisements6, snic->OutNeighborAdvertisements6, itv));
+	out_xprintf0(tab, "\"net-icmp6\": {"
+		     "\"imsg6\": %.2f, "
+		     "\"omsg6\": %.2f, "
+		     "\"iech6\": %.2f, "
+		     "\"iechr6\": %.2f, "
+		     "\"oechr6\": %.2f, "
+		     "\"igmbq6\": %.2f, "
+		     "\"igmbr6\": %.2f, "
+		     "\"ogmbr6\": %.2f, "
+		     "\"igmbrd6\": %.2f, "
+		     "\"ogmbrd6\": %.2f, "
+		     "\"irtsol6\": %.2f, "
+		     "\"ortsol6\": %.2f, "
+		     "\"irtad6\": %.2f, "
+		     "\"inbsol6\": %.2f, "
+		     "\"onbsol6\": %.2f, "
+		     "\"inbad6\": %.2f, "
+		     "\"onbad6\": %.2f}",
+		     S_VALUE(snip->InMsgs6,                    snic->InMsgs6,                    itv),
+		     S_VALUE(snip->OutMsgs6,                   snic->OutMsgs6,                   itv),
+		     S_VALUE(snip->InEchos6,                   snic->InEchos6,                   itv),
+		     S_VALUE(snip->InEchoReplies6,             snic->InEchoReplies6,             itv),
+		     S_VALUE(snip->OutEchoReplies6,            snic->OutEchoReplies6,            itv),
+		     S_VALUE(snip->InGroupMembQueries6,        snic->InGroupMembQueries6,        itv),
+		     S_VALUE(snip->InGroupMembResponses6,      snic->InGroupMembResponses6,      itv),
+		     S_VALUE(snip->OutGroupMembResponses6,     snic->OutGroupMembResponses6,     itv),
+		     S_VALUE(snip->InGroupMembReductions6,     snic->InGroupMembReductions6,     itv),
+		     S_VALUE(snip->OutGroupMembReductions6,    snic->OutGroupMembReductions6,    itv),
+		     S_VALUE(snip->InRouterSolicits6,          snic->InRouterSolicits6,          itv),
+		     S_VALUE(snip->OutRouterSolicits6,         snic->OutRouterSolicits6,         itv),
+		     S_VALUE(snip->InRouterAdvertisements6,    snic->InRouterAdvertisements6,    itv),
+		     S_VALUE(snip->InNeighborSolicits6,        snic->InNeighborSolicits6,        itv),
+		     S_VALUE(snip->OutNeighborSolicits6,       snic->OutNeighborSolicits6,       itv),
+		     S_VALUE(snip->InNeighborAdvertisements6,  snic->InNeighborAdvertisements6,  itv),
+		     S_VALUE(snip->OutNeighborAdvertisements6, snic->OutNeighborAdvertisements6, itv));
 	tab--;
 
 close_json_markup:
@@ -1669,29 +1670,29 @@ __print_funct_t json_print_net_eicmp6_stats(struct activity *a, int curr, int ta
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-eicmp6\": {"
-		 "\"ierr6\": %.2f, "
-		 "\"idtunr6\": %.2f, "
-		 "\"odtunr6\": %.2f, "
-		 "\"itmex6\": %.2f, "
-		 "\"otmex6\": %.2f, "
-		 "\"iprmpb6\": %.2f, "
-		 "\"oprmpb6\": %.2f, "
-		 "\"iredir6\": %.2f, "
-		 "\"oredir6\": %.2f, "
-		 "\"ipck2b6\": %.2f, "
-		 "\"opck2b6\": %.2f}",
-		 S_VALUE(sneip->InErrors6,        sneic->InErrors6,        itv),
-		 S_VALUE(sneip->InDestUnreachs6,  sneic->InDestUnreachs6,  itv),
-		 S_VALUE(sneip->OutDestUnreachs6, sneic->OutDestUnreachs6, itv),
-		 S_VALUE(sneip->InTimeExcds6,     sneic->InTimeExcds6,     itv),
-		 S_VALUE(sneip->OutTimeExcds6,    sneic->OutTimeExcds6,    itv),
-		 S_VALUE(sneip->InParmProblems6,  sneic->InParmProblems6,  itv),
-		 S_VALUE(sneip->OutParmProblems6, sneic->OutParmProblems6, itv),
-		 S_VALUE(sneip->InRedirects6,     sneic->InRedirects6,     itv),
-		 S_VALUE(sneip->OutRedirects6,    sneic->OutRedirects6,    itv),
-		 S_VALUE(sneip->InPktTooBigs6,    sneic->InPktTooBigs6,    itv),
-		 S_VALUE(sneip->OutPktTooBigs6,   sneic->OutPktTooBigs6,   itv));
+	out_xprintf0(tab, "\"net-eicmp6\": {"
+		     "\"ierr6\": %.2f, "
+		     "\"idtunr6\": %.2f, "
+		     "\"odtunr6\": %.2f, "
+		     "\"itmex6\": %.2f, "
+		     "\"otmex6\": %.2f, "
+		     "\"iprmpb6\": %.2f, "
+		     "\"oprmpb6\": %.2f, "
+		     "\"iredir6\": %.2f, "
+		     "\"oredir6\": %.2f, "
+		     "\"ipck2b6\": %.2f, "
+		     "\"opck2b6\": %.2f}",
+		     S_VALUE(sneip->InErrors6,        sneic->InErrors6,        itv),
+		     S_VALUE(sneip->InDestUnreachs6,  sneic->InDestUnreachs6,  itv),
+		     S_VALUE(sneip->OutDestUnreachs6, sneic->OutDestUnreachs6, itv),
+		     S_VALUE(sneip->InTimeExcds6,     sneic->InTimeExcds6,     itv),
+		     S_VALUE(sneip->OutTimeExcds6,    sneic->OutTimeExcds6,    itv),
+		     S_VALUE(sneip->InParmProblems6,  sneic->InParmProblems6,  itv),
+		     S_VALUE(sneip->OutParmProblems6, sneic->OutParmProblems6, itv),
+		     S_VALUE(sneip->InRedirects6,     sneic->InRedirects6,     itv),
+		     S_VALUE(sneip->OutRedirects6,    sneic->OutRedirects6,    itv),
+		     S_VALUE(sneip->InPktTooBigs6,    sneic->InPktTooBigs6,    itv),
+		     S_VALUE(sneip->OutPktTooBigs6,   sneic->OutPktTooBigs6,   itv));
 	tab--;
 
 close_json_markup:
@@ -1724,15 +1725,15 @@ __print_funct_t json_print_net_udp6_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf0(tab, "\"net-udp6\": {"
-		 "\"idgm6\": %.2f, "
-		 "\"odgm6\": %.2f, "
-		 "\"noport6\": %.2f, "
-		 "\"idgmer6\": %.2f}",
-		 S_VALUE(snup->InDatagrams6,  snuc->InDatagrams6,  itv),
-		 S_VALUE(snup->OutDatagrams6, snuc->OutDatagrams6, itv),
-		 S_VALUE(snup->NoPorts6,      snuc->NoPorts6,      itv),
-		 S_VALUE(snup->InErrors6,     snuc->InErrors6,     itv));
+	out_xprintf0(tab, "\"net-udp6\": {"
+		     "\"idgm6\": %.2f, "
+		     "\"odgm6\": %.2f, "
+		     "\"noport6\": %.2f, "
+		     "\"idgmer6\": %.2f}",
+		     S_VALUE(snup->InDatagrams6,  snuc->InDatagrams6,  itv),
+		     S_VALUE(snup->OutDatagrams6, snuc->OutDatagrams6, itv),
+		     S_VALUE(snup->NoPorts6,      snuc->NoPorts6,      itv),
+		     S_VALUE(snup->InErrors6,     snuc->InErrors6,     itv));
 	tab--;
 
 close_json_markup:
@@ -1766,7 +1767,7 @@ __print_funct_t json_print_pwr_cpufreq_stats(struct activity *a, int curr, int t
 	json_markup_power_management(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"cpu-frequency\": [");
+	out_xprintf(tab++, "\"cpu-frequency\": [");
 
 	for (i = 0; (i < a->nr[curr]) && (i < a->bitmap->b_size + 1); i++) {
 
@@ -1786,18 +1787,18 @@ __print_funct_t json_print_pwr_cpufreq_stats(struct activity *a, int curr, int t
 		}
 
 		if (sep) {
-			printf(",\n");
+			out_puts(",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"number\": \"%s\", "
-			 "\"frequency\": %.2f}",
-			 cpuno,
-			 ((double) spc->cpufreq) / 100);
+		out_xprintf0(tab, "{\"number\": \"%s\", "
+			     "\"frequency\": %.2f}",
+			     cpuno,
+			     ((double) spc->cpufreq) / 100);
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	out_puts("\n");
+	out_xprintf0(--tab, "]");
 	tab--;
 
 close_json_markup:
@@ -1830,28 +1831,28 @@ __print_funct_t json_print_pwr_fan_stats(struct activity *a, int curr, int tab,
 	json_markup_power_management(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"fan-speed\": [");
+	out_xprintf(tab++, "\"fan-speed\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 		spc = (struct stats_pwr_fan *) ((char *) a->buf[curr] + i * a->msize);
 
 		if (sep) {
-			printf(",\n");
+			out_puts(",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"number\": %d, "
-			 "\"rpm\": %llu, "
-			 "\"drpm\": %llu, "
-			 "\"device\": \"%s\"}",
-			 i + 1,
-			 (unsigned long long) spc->rpm,
-			 (unsigned long long) (spc->rpm - spc->rpm_min),
-			 spc->device);
+		out_xprintf0(tab, "{\"number\": %d, "
+			     "\"rpm\": %llu, "
+			     "\"drpm\": %llu, "
+			     "\"device\": \"%s\"}",
+			     i + 1,
+			     (unsigned long long) spc->rpm,
+			     (unsigned long long) (spc->rpm - spc->rpm_min),
+			     spc->device);
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	out_puts("\n");
+	out_xprintf0(--tab, "]");
 	tab--;
 
 close_json_markup:
@@ -1884,30 +1885,30 @@ __print_funct_t json_print_pwr_temp_stats(struct activity *a, int curr, int tab,
 	json_markup_power_management(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"temperature\": [");
+	out_xprintf(tab++, "\"temperature\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 		spc = (struct stats_pwr_temp *) ((char *) a->buf[curr] + i * a->msize);
 
 		if (sep) {
-			printf(",\n");
+			out_puts(",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"number\": %d, "
-			 "\"degC\": %.2f, "
-			 "\"percent-temp\": %.2f, "
-			 "\"device\": \"%s\"}",
-			 i + 1,
-			 spc->temp,
-			 (spc->temp_max - spc->temp_min) ?
-			 (spc->temp - spc->temp_min) / (spc->temp_max - spc->temp_min) * 100 :
-			 0.0,
-			 spc->device);
+		out_xprintf0(tab, "{\"number\": %d, "
+			     "\"degC\": %.2f, "
+			     "\"percent-temp\": %.2f, "
+			     "\"device\": \"%s\"}",
+			     i + 1,
+			     spc->temp,
+			     (spc->temp_max - spc->temp_min) ?
+			     (spc->temp - spc->temp_min) / (spc->temp_max - spc->temp_min) * 100 :
+			     0.0,
+			     spc->device);
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	out_puts("\n");
+	out_xprintf0(--tab, "]");
 	tab--;
 
 close_json_markup:
@@ -1940,30 +1941,30 @@ __print_funct_t json_print_pwr_in_stats(struct activity *a, int curr, int tab,
 	json_markup_power_management(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"voltage-input\": [");
+	out_xprintf(tab++, "\"voltage-input\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 		spc = (struct stats_pwr_in *) ((char *) a->buf[curr] + i * a->msize);
 
 		if (sep) {
-			printf(",\n");
+			out_puts(",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"number\": %d, "
-			 "\"inV\": %.2f, "
-			 "\"percent-in\": %.2f, "
-			 "\"device\": \"%s\"}",
-			 i,
-			 spc->in,
-			 (spc->in_max - spc->in_min) ?
-			 (spc->in - spc->in_min) / (spc->in_max - spc->in_min) * 100 :
-			 0.0,
-			 spc->device);
+		out_xprintf0(tab, "{\"number\": %d, "
+			     "\"inV\": %.2f, "
+			     "\"percent-in\": %.2f, "
+			     "\"device\": \"%s\"}",
+			     i,
+			     spc->in,
+			     (spc->in_max - spc->in_min) ?
+			     (spc->in - spc->in_min) / (spc->in_max - spc->in_min) * 100 :
+			     0.0,
+			     spc->device);
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	out_puts("\n");
+	out_xprintf0(--tab, "]");
 	tab--;
 
 close_json_markup:
@@ -1989,15 +1990,15 @@ __print_funct_t json_print_huge_stats(struct activity *a, int curr, int tab,
 	struct stats_huge
 		*smc = (struct stats_huge *) a->buf[curr];
 
-	xprintf0(tab, "\"hugepages\": {"
-		 "\"hugfree\": %llu, "
-		 "\"hugused\": %llu, "
-		 "\"hugused-percent\": %.2f}",
-		 smc->frhkb,
-		 smc->tlhkb - smc->frhkb,
-		 smc->tlhkb ?
-		 SP_VALUE(smc->frhkb, smc->tlhkb, smc->tlhkb) :
-		 0.0);
+	out_xprintf0(tab, "\"hugepages\": {"
+		     "\"hugfree\": %llu, "
+		     "\"hugused\": %llu, "
+		     "\"hugused-percent\": %.2f}",
+		     smc->frhkb,
+		     smc->tlhkb - smc->frhkb,
+		     smc->tlhkb ?
+		     SP_VALUE(smc->frhkb, smc->tlhkb, smc->tlhkb) :
+		     0.0);
 }
 
 /*
@@ -2026,7 +2027,7 @@ __print_funct_t json_print_pwr_wghfreq_stats(struct activity *a, int curr, int t
 	json_markup_power_management(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"cpu-weighted-frequency\": [");
+	out_xprintf(tab++, "\"cpu-weighted-frequency\": [");
 
 	for (i = 0; (i < a->nr[curr]) && (i < a->bitmap->b_size + 1); i++) {
 
@@ -2062,18 +2063,18 @@ __print_funct_t json_print_pwr_wghfreq_stats(struct activity *a, int curr, int t
 		}
 
 		if (sep) {
-			printf(",\n");
+			out_puts(",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"number\": \"%s\", "
-			 "\"weighted-frequency\": %.2f}",
-			 cpuno,
-			 tis ? ((double) tisfreq) / tis : 0.0);
+		out_xprintf0(tab, "{\"number\": \"%s\", "
+			     "\"weighted-frequency\": %.2f}",
+			     cpuno,
+			     tis ? ((double) tisfreq) / tis : 0.0);
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	out_puts("\n");
+	out_xprintf0(--tab, "]");
 	tab--;
 
 close_json_markup:
@@ -2106,32 +2107,32 @@ __print_funct_t json_print_pwr_usb_stats(struct activity *a, int curr, int tab,
 	json_markup_power_management(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"usb-devices\": [");
+	out_xprintf(tab++, "\"usb-devices\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 		suc = (struct stats_pwr_usb *) ((char *) a->buf[curr] + i * a->msize);
 
 		if (sep) {
-			printf(",\n");
+			out_puts(",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"bus_number\": %d, "
-			 "\"idvendor\": \"%x\", "
-			 "\"idprod\": \"%x\", "
-			 "\"maxpower\": %u, "
-			 "\"manufact\": \"%s\", "
-			 "\"product\": \"%s\"}",
-			 suc->bus_nr,
-			 suc->vendor_id,
-			 suc->product_id,
-			 suc->bmaxpower << 1,
-			 suc->manufacturer,
-			 suc->product);
+		out_xprintf0(tab, "{\"bus_number\": %d, "
+			     "\"idvendor\": \"%x\", "
+			     "\"idprod\": \"%x\", "
+			     "\"maxpower\": %u, "
+			     "\"manufact\": \"%s\", "
+			     "\"product\": \"%s\"}",
+			     suc->bus_nr,
+			     suc->vendor_id,
+			     suc->product_id,
+			     suc->bmaxpower << 1,
+			     suc->manufacturer,
+			     suc->product);
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	out_puts("\n");
+	out_xprintf0(--tab, "]");
 	tab--;
 
 close_json_markup:
@@ -2158,40 +2159,40 @@ __print_funct_t json_print_filesystem_stats(struct activity *a, int curr, int ta
 	struct stats_filesystem *sfc;
 	int sep = FALSE;
 
-	xprintf(tab++, "\"filesystems\": [");
+	out_xprintf(tab++, "\"filesystems\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 		sfc = (struct stats_filesystem *) ((char *) a->buf[curr] + i * a->msize);
 
 		if (sep) {
-			printf(",\n");
+			out_puts(",\n");
 		}
 		sep = TRUE;
 
-		xprintf0(tab, "{\"%s\": \"%s\", "
-			 "\"MBfsfree\": %.0f, "
-			 "\"MBfsused\": %.0f, "
-			 "\"%%fsused\": %.2f, "
-			 "\"%%ufsused\": %.2f, "
-			 "\"Ifree\": %llu, "
-			 "\"Iused\": %llu, "
-			 "\"%%Iused\": %.2f}",
-			 DISPLAY_MOUNT(a->opt_flags) ? "mountpoint" : "filesystem",
-			 DISPLAY_MOUNT(a->opt_flags) ? sfc->mountp : sfc->fs_name,
-			 (double) sfc->f_bfree / 1024 / 1024,
-			 (double) (sfc->f_blocks - sfc->f_bfree) / 1024 / 1024,
-			 sfc->f_blocks ? SP_VALUE(sfc->f_bfree, sfc->f_blocks, sfc->f_blocks)
-				     : 0.0,
-			 sfc->f_blocks ? SP_VALUE(sfc->f_bavail, sfc->f_blocks, sfc->f_blocks)
-				     : 0.0,
-			 sfc->f_ffree,
-			 sfc->f_files - sfc->f_ffree,
-			 sfc->f_files ? SP_VALUE(sfc->f_ffree, sfc->f_files, sfc->f_files)
-				    : 0.0);
+		out_xprintf0(tab, "{\"%s\": \"%s\", "
+			     "\"MBfsfree\": %.0f, "
+			     "\"MBfsused\": %.0f, "
+			     "\"%%fsused\": %.2f, "
+			     "\"%%ufsused\": %.2f, "
+			     "\"Ifree\": %llu, "
+			     "\"Iused\": %llu, "
+			     "\"%%Iused\": %.2f}",
+			     DISPLAY_MOUNT(a->opt_flags) ? "mountpoint" : "filesystem",
+			     DISPLAY_MOUNT(a->opt_flags) ? sfc->mountp : sfc->fs_name,
+			     (double) sfc->f_bfree / 1024 / 1024,
+			     (double) (sfc->f_blocks - sfc->f_bfree) / 1024 / 1024,
+			     sfc->f_blocks ? SP_VALUE(sfc->f_bfree, sfc->f_blocks, sfc->f_blocks)
+					 : 0.0,
+			     sfc->f_blocks ? SP_VALUE(sfc->f_bavail, sfc->f_blocks, sfc->f_blocks)
+					 : 0.0,
+			     sfc->f_ffree,
+			     sfc->f_files - sfc->f_ffree,
+			     sfc->f_files ? SP_VALUE(sfc->f_ffree, sfc->f_files, sfc->f_files)
+					: 0.0);
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	out_puts("\n");
+	out_xprintf0(--tab, "]");
 }
 
 /*
@@ -2218,7 +2219,7 @@ __print_funct_t json_print_fchost_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"fchosts\": [");
+	out_xprintf(tab++, "\"fchosts\": [");
 
 	for (i = 0; i < a->nr[curr]; i++) {
 
@@ -2253,24 +2254,24 @@ __print_funct_t json_print_fchost_stats(struct activity *a, int curr, int tab,
 			continue;
 
 		if (sep)
-			printf(",\n");
+			out_puts(",\n");
 
 		sep = TRUE;
 
-		xprintf0(tab, "{\"fchost\": \"%s\", "
-			 "\"fch_rxf\": %.2f, "
-			 "\"fch_txf\": %.2f, "
-			 "\"fch_rxw\": %.2f, "
-			 "\"fch_txw\": %.2f}",
-			 sfcc->fchost_name,
-			 S_VALUE(sfcp->f_rxframes, sfcc->f_rxframes, itv),
-			 S_VALUE(sfcp->f_txframes, sfcc->f_txframes, itv),
-			 S_VALUE(sfcp->f_rxwords,  sfcc->f_rxwords,  itv),
-			 S_VALUE(sfcp->f_txwords,  sfcc->f_txwords,  itv));
+		out_xprintf0(tab, "{\"fchost\": \"%s\", "
+			     "\"fch_rxf\": %.2f, "
+			     "\"fch_txf\": %.2f, "
+			     "\"fch_rxw\": %.2f, "
+			     "\"fch_txw\": %.2f}",
+			     sfcc->fchost_name,
+			     S_VALUE(sfcp->f_rxframes, sfcc->f_rxframes, itv),
+			     S_VALUE(sfcp->f_txframes, sfcc->f_txframes, itv),
+			     S_VALUE(sfcp->f_rxwords,  sfcc->f_rxwords,  itv),
+			     S_VALUE(sfcp->f_txwords,  sfcc->f_txwords,  itv));
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	out_puts("\n");
+	out_xprintf0(--tab, "]");
 
 	tab --;
 
@@ -2306,7 +2307,7 @@ __print_funct_t json_print_softnet_stats(struct activity *a, int curr, int tab,
 	json_markup_network(tab, OPEN_JSON_MARKUP);
 	tab++;
 
-	xprintf(tab++, "\"softnet\": [");
+	out_xprintf(tab++, "\"softnet\": [");
 
 	/* @nr[curr] cannot normally be greater than @nr_ini */
 	if (a->nr[curr] > a->nr_ini) {
@@ -2341,7 +2342,7 @@ __print_funct_t json_print_softnet_stats(struct activity *a, int curr, int tab,
                 ssnp = (struct stats_softnet *) ((char *) a->buf[!curr] + i * a->msize);
 
 		if (sep) {
-			printf(",\n");
+			out_puts(",\n");
 		}
 		sep = TRUE;
 
@@ -2353,22 +2354,22 @@ __print_funct_t json_print_softnet_stats(struct activity *a, int curr, int tab,
 			sprintf(cpuno, "%d", i - 1);
 		}
 
-		xprintf0(tab, "{\"cpu\": \"%s\", "
-			 "\"total\": %.2f, "
-			 "\"dropd\": %.2f, "
-			 "\"squeezd\": %.2f, "
-			 "\"rx_rps\": %.2f, "
-			 "\"flw_lim\": %.2f}",
-			 cpuno,
-			 S_VALUE(ssnp->processed,    ssnc->processed,    itv),
-			 S_VALUE(ssnp->dropped,      ssnc->dropped,      itv),
-			 S_VALUE(ssnp->time_squeeze, ssnc->time_squeeze, itv),
-			 S_VALUE(ssnp->received_rps, ssnc->received_rps, itv),
-			 S_VALUE(ssnp->flow_limit,   ssnc->flow_limit,   itv));
+		out_xprintf0(tab, "{\"cpu\": \"%s\", "
+			     "\"total\": %.2f, "
+			     "\"dropd\": %.2f, "
+			     "\"squeezd\": %.2f, "
+			     "\"rx_rps\": %.2f, "
+			     "\"flw_lim\": %.2f}",
+			     cpuno,
+			     S_VALUE(ssnp->processed,    ssnc->processed,    itv),
+			     S_VALUE(ssnp->dropped,      ssnc->dropped,      itv),
+			     S_VALUE(ssnp->time_squeeze, ssnc->time_squeeze, itv),
+			     S_VALUE(ssnp->received_rps, ssnc->received_rps, itv),
+			     S_VALUE(ssnp->flow_limit,   ssnc->flow_limit,   itv));
 	}
 
-	printf("\n");
-	xprintf0(--tab, "]");
+	out_puts("\n");
+	out_xprintf0(--tab, "]");
 
 	tab --;
 
@@ -114,7 +114,10 @@ int irqcpu_nr = 0;
 /* Nb of soft interrupts per processor */
 int softirqcpu_nr = 0;
 
-struct sigaction alrm_act, int_act;
+struct sigaction int_act;
+
+/* Deadlines of the samples */
+struct sched_timer sched;
 int sigint_caught = 0;
 
 /*
@@ -136,19 +139,6 @@ void usage(char *progname)
 	exit(1);
 }
 
-/*
- ***************************************************************************
- * SIGALRM signal handler. No need to reset the handler here.
- *
- * IN:
- * @sig	Signal number.
- ***************************************************************************
- */
-void alarm_handler(int sig)
-{
-	alarm(interval);
-}
-
 /*
  ***************************************************************************
  * SIGINT signal handler.
@@ -1850,11 +1840,8 @@ void rw_mpstat_loop(int dis_hdr, int rows)
 		exit(0);
 	}
 
-	/* Set a handler for SIGALRM */
-	memset(&alrm_act, 0, sizeof(alrm_act));
-	alrm_act.sa_handler = alarm_handler;
-	sigaction(SIGALRM, &alrm_act, NULL);
-	alarm(interval);
+	/* Set deadlines of the samples */
+	sched_init(&sched, interval * 1000);
 
 	/* Save the first stats collected. Will be used to compute the average */
 	mp_tstamp[2] = mp_tstamp[0];
@@ -1875,7 +1862,7 @@ void rw_mpstat_loop(int dis_hdr, int rows)
 		sigaction(SIGINT, &int_act, NULL);
 	}
 
-	pause();
+	sched_wait(&sched);
 
 	if (sigint_caught)
 		/* SIGINT signal caught during first interval: Exit immediately */
@@ -1932,7 +1919,7 @@ void rw_mpstat_loop(int dis_hdr, int rows)
 			if (DISPLAY_JSON_OUTPUT(flags)) {
 				printf(",\n");
 			}
-			pause();
+			sched_wait(&sched);
 
 			if (sigint_caught) {
 				/* SIGINT signal caught => Display average stats */
@@ -1946,6 +1933,9 @@ void rw_mpstat_loop(int dis_hdr, int rows)
 	}
 	while (count);
 
+	/* Display lateness of the samples if requested */
+	sched_report(&sched);
+
 	/* Write stats average */
 	if (DISPLAY_JSON_OUTPUT(flags)) {
 		printf("\n\t\t\t]\n\t\t}\n\t]\n}}\n");
@@ -31,7 +31,12 @@
 #include <pwd.h>
 #include <sys/utsname.h>
 #include <regex.h>
+#include <pthread.h>
+#include <sys/socket.h>
 #include <linux/sched.h>
+#include <linux/netlink.h>
+#include <linux/genetlink.h>
+#include <linux/taskstats.h>
 
 #include "version.h"
 #include "pidstat.h"
@@ -55,6 +60,8 @@ char *sccsid(void) { return (SCCSID); }
 unsigned long long tot_jiffies[3] = {0, 0, 0};
 unsigned long long uptime_cs[3] = {0, 0, 0};
 struct pid_stats *st_pid_list[3] = {NULL, NULL, NULL};
+struct pid_hash_entry *pid_hash[3] = {NULL, NULL, NULL};
+unsigned int pid_hash_size = 0;	/* Nb of entries in hash tables (power of 2) */
 unsigned int *pid_array = NULL;
 struct pid_stats st_pid_null;
 struct tm ps_tstamp[3];
@@ -62,6 +69,10 @@ char commstr[MAX_COMM_LEN];
 char userstr[MAX_USER_LEN];
 char procstr[MAX_COMM_LEN];
 int show_threads = FALSE;
+int read_thr_nr = 1;		/* Nb of threads used to read tasks stats (0: AUTO) */
+int taskstats_fd[MAX_READ_THR];	/* Netlink socket used by each thread */
+unsigned int taskstats_seq[MAX_READ_THR];
+unsigned short taskstats_family = 0;	/* Taskstats generic netlink family ID */
 
 unsigned int pid_nr = 0;	/* Nb of PID to display */
 unsigned int pid_array_nr = 0;
@@ -73,7 +84,10 @@ unsigned int pidflag = 0;	/* General flags */
 unsigned int tskflag = 0;	/* TASK/CHILD stats */
 unsigned int actflag = 0;	/* Activity flag */
 
-struct sigaction alrm_act, int_act, chld_act;
+struct sigaction int_act, chld_act;
+
+/* Deadlines of the samples */
+struct sched_timer sched;
 int signal_caught = 0;
 
 /*
@@ -92,23 +106,11 @@ void usage(char *progname)
 	fprintf(stderr, _("Options are:\n"
 			  "[ -d ] [ -H ] [ -h ] [ -I ] [ -l ] [ -R ] [ -r ] [ -s ] [ -t ] [ -U [ <username> ] ]\n"
 			  "[ -u ] [ -V ] [ -v ] [ -w ] [ -C <command> ] [ -G <process_name> ] [ --human ]\n"
-			  "[ -p { <pid> [,...] | SELF | ALL } ] [ -T { TASK | CHILD | ALL } ]\n"));
+			  "[ -j { <threads> | AUTO } ] [ -p { <pid> [,...] | SELF | ALL } ]\n"
+			  "[ -T { TASK | CHILD | ALL } ] [ --taskstats ]\n"));
 	exit(1);
 }
 
-/*
- ***************************************************************************
- * SIGALRM signal handler. No need to resert the handler here.
- *
- * IN:
- * @sig	Signal number.
- ***************************************************************************
- */
-void alarm_handler(int sig)
-{
-	alarm(interval);
-}
-
 /*
  ***************************************************************************
  * SIGINT and SIGCHLD signals handler.
@@ -149,6 +151,97 @@ void salloc_pid_array(unsigned int len)
 	memset(pid_array, 0, sizeof(int) * len);
 }
 
+/*
+ ***************************************************************************
+ * Fill the hash table used to find the stats of a task in a given sample.
+ *
+ * IN:
+ * @curr	Index in array for sample statistics.
+ ***************************************************************************
+ */
+void fill_pid_hash(int curr)
+{
+	unsigned int p, h, mask = pid_hash_size - 1;
+	struct pid_stats *pst;
+	struct pid_hash_entry *phe;
+
+	memset(pid_hash[curr], 0, PID_HASH_ENTRY_SIZE * pid_hash_size);
+
+	for (p = 0; p < pid_nr; p++) {
+		pst = st_pid_list[curr] + p;
+		if (!pst->pid)
+			continue;
+
+		for (h = PID_HASH(pst->pid, pst->tgid) & mask; ; h = (h + 1) & mask) {
+			phe = pid_hash[curr] + h;
+			if (!phe->pid)
+				break;
+			if ((phe->pid == pst->pid) && (phe->tgid == pst->tgid))
+				/* Keep first occurrence of the task in the list */
+				break;
+		}
+		if (!phe->pid) {
+			phe->pid = pst->pid;
+			phe->tgid = pst->tgid;
+			phe->p = p;
+		}
+	}
+}
+
+/*
+ ***************************************************************************
+ * Allocate (or reallocate) hash tables so that they can index @pid_nr
+ * tasks, and fill them again.
+ ***************************************************************************
+ */
+void salloc_pid_hash(void)
+{
+	short i;
+	unsigned int size = 64;
+
+	while (size < 2 * pid_nr) {
+		size <<= 1;
+	}
+	if (size == pid_hash_size)
+		return;
+	pid_hash_size = size;
+
+	for (i = 0; i < 3; i++) {
+		if ((pid_hash[i] = (struct pid_hash_entry *) realloc(pid_hash[i], PID_HASH_ENTRY_SIZE * size)) == NULL) {
+			perror("realloc");
+			exit(4);
+		}
+		fill_pid_hash(i);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Look for the stats of a task in a given sample.
+ *
+ * IN:
+ * @curr	Index in array for sample statistics.
+ * @pid		Task number.
+ * @tgid	If !=0, process number of the thread.
+ *
+ * RETURNS:
+ * Pointer on task's stats, or NULL if task is not found in sample.
+ ***************************************************************************
+ */
+struct pid_stats *find_pid_hash(int curr, unsigned int pid, unsigned int tgid)
+{
+	unsigned int h, mask = pid_hash_size - 1;
+	struct pid_hash_entry *phe;
+
+	for (h = PID_HASH(pid, tgid) & mask; ; h = (h + 1) & mask) {
+		phe = pid_hash[curr] + h;
+		if (!phe->pid)
+			return NULL;
+		if ((phe->pid == pid) && (phe->tgid == tgid))
+			return st_pid_list[curr] + phe->p;
+	}
+}
+
 /*
  ***************************************************************************
  * Allocate structures for PIDs to read.
@@ -167,6 +260,8 @@ void salloc_pid(unsigned int len)
 			exit(4);
 		}
 	}
+
+	salloc_pid_hash();
 }
 
 /*
@@ -188,6 +283,9 @@ void realloc_pid(void)
 	}
 
 	pid_nr = new_size;
+
+	/* Hash tables must be enlarged too */
+	salloc_pid_hash();
 }
 
 /*
@@ -201,6 +299,7 @@ void sfree_pid(void)
 
 	for (i = 0; i < 3; i++) {
 		free(st_pid_list[i]);
+		free(pid_hash[i]);
 	}
 }
 
@@ -353,7 +452,7 @@ int read_proc_pid_stat(unsigned int pid, struct pid_stats *pst,
 {
 	int fd, sz, rc, commsz;
 	char filename[128];
-	static char buffer[1024 + 1];
+	char buffer[1024 + 1];
 	char *start, *end;
 
 	if (tgid) {
@@ -435,7 +534,7 @@ int read_proc_pid_sched(unsigned int pid, struct pid_stats *pst,
 {
 	int fd, sz, rc = 0;
 	char filename[128];
-	static char buffer[1024 + 1];
+	char buffer[1024 + 1];
 	unsigned long long wtime = 0;
 
 	if (tgid) {
@@ -762,6 +861,282 @@ int read_proc_pid_fd(unsigned int pid, struct pid_stats *pst,
 	return 0;
 }
 
+/*
+ ***************************************************************************
+ * Build a generic netlink request with one attribute.
+ *
+ * IN:
+ * @buf		Buffer where the request will be saved.
+ * @type	Generic netlink family ID.
+ * @cmd		Command.
+ * @seq		Sequence number of the request.
+ * @attr	Attribute type.
+ * @data	Attribute value.
+ * @len		Size of attribute value.
+ *
+ * RETURNS:
+ * Size of the request.
+ ***************************************************************************
+ */
+int put_genl_req(char *buf, unsigned short type, unsigned char cmd,
+		 unsigned int seq, unsigned short attr, void *data, int len)
+{
+	struct nlmsghdr *nlh = (struct nlmsghdr *) buf;
+	struct genlmsghdr *gnlh;
+	struct nlattr *na;
+
+	memset(buf, 0, NLMSG_LENGTH(GENL_HDRLEN) + NLA_ALIGN(NLA_HDRLEN + len));
+
+	nlh->nlmsg_len = NLMSG_LENGTH(GENL_HDRLEN) + NLA_ALIGN(NLA_HDRLEN + len);
+	nlh->nlmsg_type = type;
+	nlh->nlmsg_flags = NLM_F_REQUEST;
+	nlh->nlmsg_seq = seq;
+	nlh->nlmsg_pid = 0;
+
+	gnlh = (struct genlmsghdr *) NLMSG_DATA(nlh);
+	gnlh->cmd = cmd;
+	gnlh->version = (type == GENL_ID_CTRL) ? 1 : TASKSTATS_GENL_VERSION;
+
+	na = (struct nlattr *) ((char *) gnlh + GENL_HDRLEN);
+	na->nla_type = attr;
+	na->nla_len = NLA_HDRLEN + len;
+	memcpy((char *) na + NLA_HDRLEN, data, len);
+
+	return nlh->nlmsg_len;
+}
+
+/*
+ ***************************************************************************
+ * Look for an attribute in a list of netlink attributes.
+ *
+ * IN:
+ * @na		First attribute of the list.
+ * @len		Size of the list.
+ * @type	Type of attribute to look for.
+ *
+ * RETURNS:
+ * Pointer on attribute, or NULL if not found.
+ ***************************************************************************
+ */
+struct nlattr *find_nlattr(struct nlattr *na, int len, unsigned short type)
+{
+	while ((len >= NLA_HDRLEN) && (na->nla_len >= NLA_HDRLEN) &&
+	       (na->nla_len <= len)) {
+		if ((na->nla_type & NLA_TYPE_MASK) == type)
+			return na;
+		len -= NLA_ALIGN(na->nla_len);
+		na = (struct nlattr *) ((char *) na + NLA_ALIGN(na->nla_len));
+	}
+
+	return NULL;
+}
+
+/*
+ ***************************************************************************
+ * Open a generic netlink socket to use the taskstats interface. Get the
+ * taskstats family ID if not already known.
+ *
+ * RETURNS:
+ * Socket descriptor, or -1 if the interface is not available.
+ ***************************************************************************
+ */
+int open_taskstats(void)
+{
+	int fd, len;
+	char req[NLMSG_LENGTH(GENL_HDRLEN) + NLA_ALIGN(NLA_HDRLEN + GENL_NAMSIZ)];
+	char ans[TASKSTATS_ANS_LEN];
+	struct sockaddr_nl addr;
+	struct timeval tv;
+	struct nlmsghdr *nlh = (struct nlmsghdr *) ans;
+	struct nlattr *na;
+
+	if ((fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_GENERIC)) < 0)
+		return -1;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.nl_family = AF_NETLINK;
+	tv.tv_sec = TASKSTATS_TIMEOUT;
+	tv.tv_usec = 0;
+	if ((bind(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0) ||
+	    (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) < 0))
+		goto err;
+
+	if (taskstats_family)
+		return fd;
+
+	/* Get taskstats family ID */
+	len = put_genl_req(req, GENL_ID_CTRL, CTRL_CMD_GETFAMILY, 0,
+			   CTRL_ATTR_FAMILY_NAME, TASKSTATS_GENL_NAME,
+			   strlen(TASKSTATS_GENL_NAME) + 1);
+	if (send(fd, req, len, 0) != len)
+		goto err;
+
+	if (((len = recv(fd, ans, sizeof(ans), 0)) <= 0) ||
+	    !NLMSG_OK(nlh, len) || (nlh->nlmsg_type == NLMSG_ERROR))
+		goto err;
+
+	na = (struct nlattr *) ((char *) NLMSG_DATA(nlh) + GENL_HDRLEN);
+	if ((na = find_nlattr(na, NLMSG_PAYLOAD(nlh, GENL_HDRLEN),
+			      CTRL_ATTR_FAMILY_ID)) == NULL)
+		goto err;
+	taskstats_family = *((unsigned short *) ((char *) na + NLA_HDRLEN));
+
+	return fd;
+
+err:
+	close(fd);
+	return -1;
+}
+
+/*
+ ***************************************************************************
+ * Read stats for a range of tasks in process list using the taskstats
+ * netlink interface. A request is sent for each task, all of them at
+ * once, then answers are received. This replaces reading files
+ * /proc/#[/task/##]/schedstat and /proc/#[/task/##]/status for these
+ * tasks. Tasks for which no answer has been received will have these
+ * files read as usual.
+ *
+ * IN:
+ * @thr		Number of thread reading the list.
+ * @pst_list	Process list.
+ * @first	Index of first task in process list.
+ * @last	Index of last task + 1.
+ *
+ * OUT:
+ * Tasks whose stats have been read have their F_TASKSTATS flag set.
+ *
+ * RETURNS:
+ * Number of tasks whose stats have been read.
+ ***************************************************************************
+ */
+int read_taskstats(int thr, struct pid_stats *pst_list, unsigned int first,
+		   unsigned int last)
+{
+	int fd = taskstats_fd[thr];
+	int len = 0, n, req_nr = 0, read_nr = 0;
+	char req[READ_THR_CHUNK * TASKSTATS_REQ_LEN];
+	char ans[TASKSTATS_ANS_LEN];
+	unsigned int q, seq = taskstats_seq[thr];
+	struct pid_stats *pst;
+	struct nlmsghdr *nlh;
+	struct nlattr *na;
+	struct taskstats ts;
+
+	for (q = first; (q < last) && (q < first + READ_THR_CHUNK); q++) {
+		pst = pst_list + q;
+		pst->flags &= ~F_TASKSTATS;
+		if (!pst->pid)
+			continue;
+
+		len += put_genl_req(req + len, taskstats_family, TASKSTATS_CMD_GET,
+				    seq + q - first, TASKSTATS_CMD_ATTR_PID,
+				    &pst->pid, sizeof(__u32));
+		req_nr++;
+	}
+	/* Answers to previous requests that would arrive late will be ignored */
+	taskstats_seq[thr] += READ_THR_CHUNK;
+
+	if (!req_nr || (send(fd, req, len, 0) != len))
+		return 0;
+
+	while (req_nr > 0) {
+		if ((n = recv(fd, ans, sizeof(ans), 0)) <= 0)
+			/* Timeout or error */
+			break;
+
+		for (nlh = (struct nlmsghdr *) ans; NLMSG_OK(nlh, n); nlh = NLMSG_NEXT(nlh, n)) {
+			if ((nlh->nlmsg_seq < seq) || (nlh->nlmsg_seq >= seq + READ_THR_CHUNK))
+				continue;
+			req_nr--;
+			if (nlh->nlmsg_type != taskstats_family)
+				/* Error (e.g. task has terminated) */
+				continue;
+
+			pst = pst_list + first + nlh->nlmsg_seq - seq;
+
+			/* Answer is: AGGR_PID { PID, STATS } */
+			na = (struct nlattr *) ((char *) NLMSG_DATA(nlh) + GENL_HDRLEN);
+			if (((na = find_nlattr(na, NLMSG_PAYLOAD(nlh, GENL_HDRLEN),
+					       TASKSTATS_TYPE_AGGR_PID)) == NULL) ||
+			    ((na = find_nlattr((struct nlattr *) ((char *) na + NLA_HDRLEN),
+					       na->nla_len - NLA_HDRLEN,
+					       TASKSTATS_TYPE_STATS)) == NULL))
+				continue;
+
+			memset(&ts, 0, sizeof(ts));
+			memcpy(&ts, (char *) na + NLA_HDRLEN,
+			       MINIMUM(na->nla_len - NLA_HDRLEN, sizeof(ts)));
+			if (ts.ac_pid != pst->pid)
+				continue;
+
+			pst->uid = ts.ac_uid;
+			pst->nvcsw = ts.nvcsw;
+			pst->nivcsw = ts.nivcsw;
+			/* Convert ns to jiffies */
+			pst->wtime = ts.cpu_delay_total * HZ / 1000000000;
+			pst->flags |= F_TASKSTATS;
+			read_nr++;
+		}
+	}
+
+	return read_nr;
+}
+
+/*
+ ***************************************************************************
+ * Close taskstats netlink sockets.
+ ***************************************************************************
+ */
+void close_taskstats(void)
+{
+	int i;
+
+	for (i = 0; i < MAX_READ_THR; i++) {
+		if (taskstats_fd[i] >= 0) {
+			close(taskstats_fd[i]);
+			taskstats_fd[i] = -1;
+		}
+	}
+}
+
+/*
+ ***************************************************************************
+ * Open a taskstats netlink socket for each thread reading tasks stats.
+ * If the interface is not available (kernel without taskstats support,
+ * or user without CAP_NET_ADMIN capability), stats will be read from
+ * /proc as usual.
+ ***************************************************************************
+ */
+void init_taskstats(void)
+{
+	int i;
+	struct pid_stats pst;
+
+	for (i = 0; i < MAX_READ_THR; i++) {
+		taskstats_fd[i] = -1;
+	}
+	if (!USE_TASKSTATS(pidflag))
+		return;
+
+	for (i = 0; i < read_thr_nr; i++) {
+		if ((taskstats_fd[i] = open_taskstats()) < 0)
+			break;
+	}
+
+	if (i == read_thr_nr) {
+		/* Check that we are allowed to get stats for our own process */
+		memset(&pst, 0, PID_STATS_SIZE);
+		pst.pid = getpid();
+		if (read_taskstats(0, &pst, 0, 1) == 1)
+			return;
+	}
+
+	/* Taskstats interface cannot be used */
+	close_taskstats();
+	pidflag &= ~P_F_TASKSTATS;
+}
+
 /*
  ***************************************************************************
  * Read various stats for given PID.
@@ -785,19 +1160,30 @@ int read_pid_stats(unsigned int pid, struct pid_stats *pst,
 	if (read_proc_pid_stat(pid, pst, thread_nr, tgid))
 		return 1;
 
-	/*
-	 * No need to test the return code here: Not finding
-	 * the schedstat files shouldn't make pidstat stop.
-	 */
-	read_proc_pid_sched(pid, pst, thread_nr, tgid);
+	if (HAS_TASKSTATS(pst->flags)) {
+		/*
+		 * Wait time, UID and context switches have already been
+		 * read using taskstats. Number of threads is also in stat file.
+		 */
+		pst->threads = *thread_nr;
+	}
+	else {
+		/*
+		 * No need to test the return code here: Not finding
+		 * the schedstat files shouldn't make pidstat stop.
+		 */
+		read_proc_pid_sched(pid, pst, thread_nr, tgid);
+	}
 
 	if (DISPLAY_CMDLINE(pidflag)) {
 		if (read_proc_pid_cmdline(pid, pst, tgid))
 			return 1;
 	}
 
-	if (read_proc_pid_status(pid, pst, tgid))
-		return 1;
+	if (!HAS_TASKSTATS(pst->flags)) {
+		if (read_proc_pid_status(pid, pst, tgid))
+			return 1;
+	}
 
 	if (DISPLAY_STACK(actflag)) {
 		if (read_proc_pid_smap(pid, pst, tgid))
@@ -922,6 +1308,17 @@ void pid_sys_init(void)
 	/* Count nb of proc */
 	cpu_nr = get_cpu_nr(~0, FALSE);
 
+	if (!read_thr_nr) {
+		/* Option "-j AUTO": Use one thread per processor */
+		read_thr_nr = MINIMUM(cpu_nr, MAX_READ_THR);
+		if (read_thr_nr < 1) {
+			read_thr_nr = 1;
+		}
+	}
+
+	/* Use taskstats interface if requested and available */
+	init_taskstats();
+
 	if (DISPLAY_ALL_PID(pidflag)) {
 		/* Count PIDs and allocate structures */
 		pid_nr = count_pid() + NR_PID_PREALLOC;
@@ -940,24 +1337,51 @@ void pid_sys_init(void)
 
 /*
  ***************************************************************************
- * Read stats for threads in /proc/#/task directory.
+ * Save a task in process list. Its stats will be read later by
+ * read_pid_list().
  *
  * IN:
  * @curr	Index in array for current sample statistics.
- * @pid		Process number whose threads stats are to be read.
- * @index	Index in process list where stats will be saved.
+ * @pid		Process (or thread) number. 0 if the entry is unused.
+ * @tgid	If !=0, process number of the thread.
+ * @index	Index in process list where task will be saved.
  *
  * OUT:
- * @index	Index in process list where next stats will be saved.
+ * @index	Index in process list where next task will be saved.
  ***************************************************************************
  */
-void read_task_stats(int curr, unsigned int pid, unsigned int *index)
+void add_pid_list(int curr, unsigned int pid, unsigned int tgid,
+		  unsigned int *index)
+{
+	struct pid_stats *pst;
+
+	pst = st_pid_list[curr] + (*index)++;
+	pst->pid = pid;
+	pst->tgid = tgid;
+
+	if (*index >= pid_nr) {
+		realloc_pid();
+	}
+}
+
+/*
+ ***************************************************************************
+ * Save threads in /proc/#/task directory in process list.
+ *
+ * IN:
+ * @curr	Index in array for current sample statistics.
+ * @pid		Process number whose threads are to be saved.
+ * @index	Index in process list where threads will be saved.
+ *
+ * OUT:
+ * @index	Index in process list where next task will be saved.
+ ***************************************************************************
+ */
+void add_task_list(int curr, unsigned int pid, unsigned int *index)
 {
 	DIR *dir;
 	struct dirent *drp;
 	char filename[128];
-	struct pid_stats *pst;
-	unsigned int thr_nr;
 
 	/* Open /proc/#/task directory */
 	sprintf(filename, PROC_TASK, pid);
@@ -969,18 +1393,97 @@ void read_task_stats(int curr, unsigned int pid, unsigned int *index)
 			continue;
 		}
 
-		pst = st_pid_list[curr] + (*index)++;
-		if (read_pid_stats(atoi(drp->d_name), pst, &thr_nr, pid)) {
-			/* Thread no longer exists */
-			pst->pid = 0;
+		add_pid_list(curr, atoi(drp->d_name), pid, index);
+	}
+
+	closedir(dir);
+}
+
+/*
+ ***************************************************************************
+ * Read stats for tasks saved in process list. When several threads are
+ * used, the list is split into chunks of READ_THR_CHUNK entries, and
+ * thread #n reads chunks #n, #n + thr_nr, etc. Each thread writes
+ * only in its own entries, so that no locking is needed.
+ *
+ * IN:
+ * @arg		Structure indicating which entries are to be read.
+ *
+ * RETURNS:
+ * NULL.
+ ***************************************************************************
+ */
+void *read_pid_list_thr(void *arg)
+{
+	struct read_thr_arg *rta = (struct read_thr_arg *) arg;
+	struct pid_stats *pst;
+	unsigned int p, q, thr_nr;
+
+	for (p = rta->thr * READ_THR_CHUNK; p < rta->nr;
+	     p += rta->thr_nr * READ_THR_CHUNK) {
+
+		if (USE_TASKSTATS(pidflag)) {
+			/* Read stats for whole chunk with one netlink round-trip */
+			read_taskstats(rta->thr, st_pid_list[rta->curr], p,
+				       MINIMUM(p + READ_THR_CHUNK, rta->nr));
 		}
 
-		if (*index >= pid_nr) {
-			realloc_pid();
+		for (q = p; (q < p + READ_THR_CHUNK) && (q < rta->nr); q++) {
+			pst = st_pid_list[rta->curr] + q;
+
+			if (pst->pid &&
+			    read_pid_stats(pst->pid, pst, &thr_nr, pst->tgid)) {
+				/* Task has terminated */
+				pst->pid = 0;
+			}
 		}
 	}
 
-	closedir(dir);
+	return NULL;
+}
+
+/*
+ ***************************************************************************
+ * Read stats for all the tasks saved in process list, using read_thr_nr
+ * threads.
+ *
+ * IN:
+ * @curr	Index in array for current sample statistics.
+ * @nr		Number of entries saved in process list.
+ ***************************************************************************
+ */
+void read_pid_list(int curr, unsigned int nr)
+{
+	pthread_t thr[MAX_READ_THR];
+	struct read_thr_arg rta[MAX_READ_THR];
+	unsigned int i, thr_nr;
+
+	/* Don't start more threads than there are chunks to read */
+	thr_nr = MINIMUM(read_thr_nr, (nr + READ_THR_CHUNK - 1) / READ_THR_CHUNK);
+	if (!thr_nr) {
+		thr_nr = 1;
+	}
+
+	for (i = 0; i < thr_nr; i++) {
+		rta[i].curr = curr;
+		rta[i].thr = i;
+		rta[i].thr_nr = thr_nr;
+		rta[i].nr = nr;
+	}
+
+	for (i = 1; i < thr_nr; i++) {
+		if (pthread_create(&thr[i], NULL, read_pid_list_thr, &rta[i]) != 0) {
+			perror("pthread_create");
+			exit(4);
+		}
+	}
+
+	/* Main thread reads its own part of the list too */
+	read_pid_list_thr(&rta[0]);
+
+	for (i = 1; i < thr_nr; i++) {
+		pthread_join(thr[i], NULL);
+	}
 }
 
 /*
@@ -995,7 +1498,7 @@ void read_stats(int curr)
 {
 	DIR *dir;
 	struct dirent *drp;
-	unsigned int p = 0, q, pid, thr_nr;
+	unsigned int p = 0, q, pid;
 	struct pid_stats *pst;
 	struct stats_cpu *st_cpu;
 
@@ -1021,6 +1524,12 @@ void read_stats(int curr)
 			    st_cpu->cpu_steal + st_cpu->cpu_softirq;
 	free(st_cpu);
 
+	/*
+	 * First build the list of tasks whose stats are to be read, then
+	 * read their stats (possibly using several threads). Tasks are
+	 * saved in the same order as before, so that the output doesn't
+	 * depend on the number of threads used.
+	 */
 	if (DISPLAY_ALL_PID(pidflag)) {
 
 		/* Open /proc directory */
@@ -1035,19 +1544,12 @@ void read_stats(int curr)
 				continue;
 			}
 
-			pst = st_pid_list[curr] + p++;
 			pid = atoi(drp->d_name);
+			add_pid_list(curr, pid, 0, &p);
 
-			if (read_pid_stats(pid, pst, &thr_nr, 0)) {
-				/* Process has terminated */
-				pst->pid = 0;
-			} else if (DISPLAY_TID(pidflag)) {
-				/* Read stats for threads in task subdirectory */
-				read_task_stats(curr, pid, &p);
-			}
-
-			if (p >= pid_nr) {
-				realloc_pid();
+			if (DISPLAY_TID(pidflag)) {
+				/* Save threads in task subdirectory */
+				add_task_list(curr, pid, &p);
 			}
 		}
 
@@ -1058,28 +1560,24 @@ void read_stats(int curr)
 
 		/* Close /proc directory */
 		closedir(dir);
+
+		read_pid_list(curr, p);
 	}
 
 	else if (DISPLAY_PID(pidflag)) {
 		unsigned int op;
 
-		/* Read stats for each PID in the list */
+		/* Save each PID in the list */
 		for (op = 0; op < pid_array_nr; op++) {
 
 			if (p >= pid_nr)
 				break;
-			pst = st_pid_list[curr] + p++;
-
-			if (pid_array[op]) {
-				/* PID should still exist. So read its stats */
-				if (read_pid_stats(pid_array[op], pst, &thr_nr, 0)) {
-					/* PID has terminated */
-					pst->pid = 0;
-					pid_array[op] = 0;
-				}
-				else if (DISPLAY_TID(pidflag)) {
-					read_task_stats(curr, pid_array[op], &p);
-				}
+
+			/* Entry is unused if PID has terminated */
+			add_pid_list(curr, pid_array[op], 0, &p);
+
+			if (pid_array[op] && DISPLAY_TID(pidflag)) {
+				add_task_list(curr, pid_array[op], &p);
 			}
 		}
 		/* Reset remaining structures */
@@ -1088,8 +1586,26 @@ void read_stats(int curr)
 			pst->pid = 0;
 		}
 
+		read_pid_list(curr, p);
+
+		/*
+		 * Remove PID which have terminated from the list.
+		 * Entries for threads (tgid != 0) follow that of their process.
+		 */
+		for (op = 0, q = 0; (op < pid_array_nr) && (q < p); op++) {
+			pst = st_pid_list[curr] + q++;
+			if (!pst->pid) {
+				pid_array[op] = 0;
+			}
+			while ((q < p) && st_pid_list[curr][q].tgid) {
+				q++;
+			}
+		}
 	}
 	/* else unknown command */
+
+	/* Index tasks read so that next sample can find them */
+	fill_pid_hash(curr);
 }
 
 /*
@@ -1125,7 +1641,7 @@ int get_pid_to_display(int prev, int curr, int p, unsigned int activity,
 		       unsigned int pflag,
 		       struct pid_stats **pstc, struct pid_stats **pstp)
 {
-	int q, rc;
+	int rc;
 	regex_t regex;
 	struct passwd *pwdent;
 	char *pc;
@@ -1139,22 +1655,7 @@ int get_pid_to_display(int prev, int curr, int p, unsigned int activity,
 	if (DISPLAY_ALL_PID(pidflag) || DISPLAY_TID(pidflag)) {
 
 		/* Look for previous stats for same PID */
-		q = p;
-
-		do {
-			*pstp = st_pid_list[prev] + q;
-			if (((*pstp)->pid == (*pstc)->pid) &&
-			    ((*pstp)->tgid == (*pstc)->tgid))
-				break;
-			q++;
-			if (q >= pid_nr) {
-				q = 0;
-			}
-		}
-		while (q != p);
-
-		if (((*pstp)->pid != (*pstc)->pid) ||
-		    ((*pstp)->tgid != (*pstc)->tgid)) {
+		if ((*pstp = find_pid_hash(prev, (*pstc)->pid, (*pstc)->tgid)) == NULL) {
 			/* PID not found (no data previously read) */
 			*pstp = &st_pid_null;
 		}
@@ -2482,29 +2983,28 @@ void rw_pidstat_loop(int dis_hdr, int rows)
 		/* Display since boot time */
 		ps_tstamp[1] = ps_tstamp[0];
 		memset(st_pid_list[1], 0, PID_STATS_SIZE * pid_nr);
+		fill_pid_hash(1);
 		write_stats(0, DISP_HDR);
 		exit(0);
 	}
 
-	/* Set a handler for SIGALRM */
-	memset(&alrm_act, 0, sizeof(alrm_act));
-	alrm_act.sa_handler = alarm_handler;
-	sigaction(SIGALRM, &alrm_act, NULL);
-	alarm(interval);
+	/* Set deadlines of the samples */
+	sched_init(&sched, interval * 1000);
 
 	/* Save the first stats collected. Will be used to compute the average */
 	ps_tstamp[2] = ps_tstamp[0];
 	tot_jiffies[2] = tot_jiffies[0];
 	uptime_cs[2] = uptime_cs[0];
 	memcpy(st_pid_list[2], st_pid_list[0], PID_STATS_SIZE * pid_nr);
+	memcpy(pid_hash[2], pid_hash[0], PID_HASH_ENTRY_SIZE * pid_hash_size);
 
 	/* Set a handler for SIGINT */
 	memset(&int_act, 0, sizeof(int_act));
 	int_act.sa_handler = sig_handler;
 	sigaction(SIGINT, &int_act, NULL);
 
-	/* Wait for SIGALRM (or possibly SIGINT) signal */
-	pause();
+	/* Wait until next sample is due (or SIGINT is caught) */
+	sched_wait(&sched);
 
 	if (signal_caught)
 		/* SIGINT/SIGCHLD signals caught during first interval: Exit immediately */
@@ -2540,7 +3040,7 @@ void rw_pidstat_loop(int dis_hdr, int rows)
 
 		if (count) {
 
-			pause();
+			sched_wait(&sched);
 
 			if (signal_caught) {
 				/* SIGINT/SIGCHLD signals caught => Display average stats */
@@ -2554,6 +3054,9 @@ void rw_pidstat_loop(int dis_hdr, int rows)
 	}
 	while (count);
 
+	/* Display lateness of the samples if requested */
+	sched_report(&sched);
+
 	/*
 	 * The one line format uses a raw time value rather than time strings
 	 * so the average doesn't really fit.
@@ -2716,11 +3219,35 @@ int main(int argc, char **argv)
 			}
 		}
 
+		else if (!strcmp(argv[opt], "-j")) {
+			if (!argv[++opt]) {
+				usage(argv[0]);
+			}
+			if (!strcmp(argv[opt], K_AUTO)) {
+				read_thr_nr = 0;
+			}
+			else {
+				if (strspn(argv[opt], DIGITS) != strlen(argv[opt])) {
+					usage(argv[0]);
+				}
+				read_thr_nr = atoi(argv[opt]);
+				if ((read_thr_nr < 1) || (read_thr_nr > MAX_READ_THR)) {
+					usage(argv[0]);
+				}
+			}
+			opt++;
+		}
+
 		else if (!strcmp(argv[opt], "--human")) {
 			pidflag |= P_D_UNIT;
 			opt++;
 		}
 
+		else if (!strcmp(argv[opt], "--taskstats")) {
+			pidflag |= P_F_TASKSTATS;
+			opt++;
+		}
+
 		else if (!strcmp(argv[opt], "-T")) {
 			if (!argv[++opt]) {
 				usage(argv[0]);
@@ -2912,6 +3439,7 @@ int main(int argc, char **argv)
 	/* Free structures */
 	free(pid_array);
 	sfree_pid();
+	close_taskstats();
 
 	return 0;
 }
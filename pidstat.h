@@ -12,6 +12,7 @@
 #endif
 
 #define K_SELF		"SELF"
+#define K_AUTO		"AUTO"
 
 #define K_P_TASK	"TASK"
 #define K_P_CHILD	"CHILD"
@@ -19,6 +20,14 @@
 
 #define NR_PID_PREALLOC	100
 
+/*
+ * Maximum number of threads used to read tasks statistics (option -j).
+ * Each thread reads stats for chunks of READ_THR_CHUNK consecutive
+ * entries in the PID list.
+ */
+#define MAX_READ_THR	64
+#define READ_THR_CHUNK	32
+
 #ifdef _POSIX_ARG_MAX
 #define MAX_COMM_LEN    _POSIX_ARG_MAX
 #define MAX_CMDLINE_LEN _POSIX_ARG_MAX
@@ -71,6 +80,7 @@
 #define P_F_PROCSTR	0x0400
 #define P_D_UNIT	0x0800
 #define P_D_SEC_EPOCH	0x1000
+#define P_F_TASKSTATS	0x2000
 
 #define DISPLAY_PID(m)		(((m) & P_D_PID) == P_D_PID)
 #define DISPLAY_ALL_PID(m)	(((m) & P_D_ALL_PID) == P_D_ALL_PID)
@@ -85,13 +95,26 @@
 #define PROCESS_STRING(m)	(((m) & P_F_PROCSTR) == P_F_PROCSTR)
 #define DISPLAY_UNIT(m)		(((m) & P_D_UNIT) == P_D_UNIT)
 #define PRINT_SEC_EPOCH(m)	(((m) & P_D_SEC_EPOCH) == P_D_SEC_EPOCH)
+#define USE_TASKSTATS(m)	(((m) & P_F_TASKSTATS) == P_F_TASKSTATS)
 
 /* Per-process flags */
 #define F_NO_PID_IO	0x01
 #define F_NO_PID_FD	0x02
+/* UID, context switches and wait time have been read using taskstats */
+#define F_TASKSTATS	0x04
 
 #define NO_PID_IO(m)		(((m) & F_NO_PID_IO) == F_NO_PID_IO)
 #define NO_PID_FD(m)		(((m) & F_NO_PID_FD) == F_NO_PID_FD)
+#define HAS_TASKSTATS(m)	(((m) & F_TASKSTATS) == F_TASKSTATS)
+
+/*
+ * Taskstats netlink interface: Size of a TASKSTATS_CMD_GET request,
+ * size of buffer used to receive answers, and time (in seconds) to wait
+ * for an answer before reading the remaining tasks' stats from /proc.
+ */
+#define TASKSTATS_REQ_LEN	(NLMSG_LENGTH(GENL_HDRLEN) + NLA_ALIGN(NLA_HDRLEN + sizeof(__u32)))
+#define TASKSTATS_ANS_LEN	8192
+#define TASKSTATS_TIMEOUT	1
 
 
 #define PROC		"/proc"
@@ -210,4 +233,34 @@ struct pid_stats {
 
 #define PID_STATS_SIZE	(sizeof(struct pid_stats))
 
+/*
+ * Entry of the hash tables used to find the stats of a given task in a
+ * sample. Tables use open addressing with linear probing, and are indexed
+ * on (pid, tgid). Their size is a power of two at least twice the number
+ * of entries in the PID list.
+ */
+struct pid_hash_entry {
+	/* Index of the task's stats in the PID list */
+	unsigned int p;
+	/* If pid is null, the entry is empty */
+	unsigned int pid;
+	unsigned int tgid;
+};
+
+#define PID_HASH_ENTRY_SIZE	(sizeof(struct pid_hash_entry))
+
+#define PID_HASH(pid, tgid)	(((pid) * 2654435761U) ^ ((tgid) * 2246822519U))
+
+/* Structure given to each thread reading tasks statistics */
+struct read_thr_arg {
+	/* Index in array for current sample statistics */
+	int          curr;
+	/* Thread number (0 to thr_nr - 1) */
+	unsigned int thr;
+	/* Number of threads reading the PID list */
+	unsigned int thr_nr;
+	/* Number of entries to read in the PID list */
+	unsigned int nr;
+};
+
 #endif  /* _PIDSTAT_H */
@@ -29,6 +29,8 @@
 #include <sys/stat.h>
 #include <sys/statvfs.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
 
 #include "common.h"
 #include "rd_stats.h"
@@ -41,6 +43,323 @@
 #define _(string) (string)
 #endif
 
+/* System files kept open between two readings */
+struct cached_file cached_files[MAX_CACHED_FILES];
+int cached_files_nr = 0;
+
+/*
+ ***************************************************************************
+ * Open a system file (e.g. /proc/stat) and keep it open, so that it can
+ * be read again later with fopen_cached() without opening and closing it
+ * each time. Nothing is done if the file is already open or cannot be
+ * opened: It will then be opened with fopen() as usual.
+ *
+ * IN:
+ * @name	Name of file to open.
+ ***************************************************************************
+ */
+void open_cached_file(char *name)
+{
+	int i, fd;
+
+	for (i = 0; i < cached_files_nr; i++) {
+		if (!strcmp(cached_files[i].name, name))
+			return;
+	}
+
+	if ((cached_files_nr >= MAX_CACHED_FILES) ||
+	    ((fd = open(name, O_RDONLY | O_CLOEXEC)) < 0))
+		return;
+
+	cached_files[cached_files_nr].name = name;
+	cached_files[cached_files_nr].fd   = fd;
+	cached_files[cached_files_nr].buf   = NULL;
+	cached_files[cached_files_nr].size  = 0;
+	cached_files[cached_files_nr].len   = 0;
+	cached_files[cached_files_nr].valid = FALSE;
+	cached_files_nr++;
+}
+
+/*
+ ***************************************************************************
+ * Indicate that a new sample is being read: Files opened by
+ * open_cached_file() will be read again by fopen_cached(). Until next
+ * call, each of them is read only once, and all the functions using it
+ * see the same contents.
+ ***************************************************************************
+ */
+void invalidate_cached_files(void)
+{
+	int i;
+
+	for (i = 0; i < cached_files_nr; i++) {
+		cached_files[i].valid = FALSE;
+	}
+}
+
+/*
+ ***************************************************************************
+ * Close all the files opened by open_cached_file().
+ ***************************************************************************
+ */
+void close_cached_files(void)
+{
+	int i;
+
+	for (i = 0; i < cached_files_nr; i++) {
+		close(cached_files[i].fd);
+		if (cached_files[i].buf) {
+			free(cached_files[i].buf);
+		}
+	}
+	cached_files_nr = 0;
+}
+
+/*
+ ***************************************************************************
+ * Read a system file and return a stream to read its contents. If the
+ * file has been opened by open_cached_file(), its whole contents are read
+ * with pread() into a buffer which is reused each time, and the stream
+ * reads from that buffer. The file is read only once until
+ * invalidate_cached_files() is called. Otherwise the file is opened with
+ * fopen(). In both cases, the stream should be closed with fclose().
+ *
+ * IN:
+ * @name	Name of file to read.
+ *
+ * RETURNS:
+ * Stream to read from, or NULL if the file cannot be read.
+ ***************************************************************************
+ */
+FILE *fopen_cached(char *name)
+{
+	int i;
+	ssize_t n;
+	size_t len = 0;
+	struct cached_file *cf;
+
+	for (i = 0; i < cached_files_nr; i++) {
+		if (!strcmp(cached_files[i].name, name))
+			break;
+	}
+	if (i == cached_files_nr)
+		return fopen(name, "r");
+
+	cf = &cached_files[i];
+
+	if (cf->valid)
+		/* File already read for current sample */
+		return fmemopen(cf->buf, cf->len, "r");
+
+	/* Read the whole file, enlarging the buffer as needed */
+	do {
+		if (len + 1 >= cf->size) {
+			cf->size = cf->size ? cf->size * 2 : CACHED_FILE_BUFSIZE;
+			SREALLOC(cf->buf, char, cf->size);
+		}
+		n = pread(cf->fd, cf->buf + len, cf->size - len - 1, (off_t) len);
+		if (n > 0) {
+			len += n;
+		}
+	}
+	while ((n > 0) || ((n < 0) && (errno == EINTR)));
+
+	if ((n < 0) || !len) {
+		/*
+		 * File cannot be read any longer (it may have disappeared
+		 * with the module that created it) or is empty:
+		 * Use fopen() as usual.
+		 */
+		if (n < 0) {
+			close(cf->fd);
+			free(cf->buf);
+			*cf = cached_files[--cached_files_nr];
+		}
+		return fopen(name, "r");
+	}
+	cf->buf[len] = '\0';
+	cf->len = len;
+	cf->valid = TRUE;
+
+	return fmemopen(cf->buf, len, "r");
+}
+
+/*
+ ***************************************************************************
+ * Skip blank characters then read an unsigned integer from a string.
+ * Same as sscanf(*str, "%llu", val) (except that a leading sign is not
+ * accepted), but much faster since no format string needs to be parsed.
+ *
+ * IN:
+ * @str		Pointer on the string to read.
+ *
+ * OUT:
+ * @str		Pointer on the first character following the number.
+ *		Unchanged if no number has been read.
+ * @val		Number read. Unchanged if no number has been read.
+ *
+ * RETURNS:
+ * 1 if a number has been read, 0 otherwise.
+ ***************************************************************************
+ */
+int next_ull(char **str, unsigned long long *val)
+{
+	char *p = *str;
+	unsigned long long v = 0;
+
+	while (IS_BLANK(*p)) {
+		p++;
+	}
+	if (!IS_DIGIT(*p))
+		return 0;
+
+	do {
+		v = v * 10 + (*p++ - '0');
+	}
+	while (IS_DIGIT(*p));
+
+	*str = p;
+	*val = v;
+
+	return 1;
+}
+
+/*
+ ***************************************************************************
+ * Read consecutive unsigned integers separated by blank characters.
+ * Reading stops at the first field which is not a number.
+ *
+ * IN:
+ * @str		Pointer on the string to read.
+ * @n		Maximum number of integers to read.
+ *
+ * OUT:
+ * @str		Pointer on the first character following the last number
+ *		read.
+ * @val		Array containing the numbers read.
+ *
+ * RETURNS:
+ * Number of integers read.
+ ***************************************************************************
+ */
+int next_ull_fields(char **str, unsigned long long val[], int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		if (!next_ull(str, &val[i]))
+			break;
+	}
+
+	return i;
+}
+
+/*
+ ***************************************************************************
+ * Skip blank characters then read a word from a string. Same as
+ * sscanf(*str, "%s", buf), except that the word is truncated if it is
+ * too long for the buffer.
+ *
+ * IN:
+ * @str		Pointer on the string to read.
+ * @len		Size of buffer.
+ *
+ * OUT:
+ * @str		Pointer on the first character following the word.
+ * @buf		Buffer where the word is saved (as a null-terminated
+ *		string).
+ *
+ * RETURNS:
+ * 1 if a word has been read, 0 otherwise.
+ ***************************************************************************
+ */
+int next_word(char **str, char *buf, int len)
+{
+	char *p = *str;
+	int i = 0;
+
+	while (IS_BLANK(*p)) {
+		p++;
+	}
+	if (!*p)
+		return 0;
+
+	while (*p && !IS_BLANK(*p)) {
+		if (i < len - 1) {
+			buf[i++] = *p;
+		}
+		p++;
+	}
+	buf[i] = '\0';
+	*str = p;
+
+	return 1;
+}
+
+/*
+ ***************************************************************************
+ * Read the unsigned integer following the name of a field, as found in
+ * /proc/meminfo, /proc/vmstat or /proc/net/snmp6. Same as
+ * sscanf(str, "%llu", &val), except that 0 is returned if there is no
+ * number.
+ *
+ * IN:
+ * @str		String following the name of the field.
+ *
+ * RETURNS:
+ * Number read, or 0 if there is none.
+ ***************************************************************************
+ */
+unsigned long long field_ull(char *str)
+{
+	unsigned long long val = 0;
+
+	next_ull(&str, &val);
+
+	return val;
+}
+
+/*
+ ***************************************************************************
+ * Read the blank separated fields of a line of /proc/net/snmp. Contrary to
+ * next_ull_fields(), reading doesn't stop at a field which is not an
+ * unsigned integer (like Tcp MaxConn which is -1): Its value is set to 0.
+ * Values of the fields missing at the end of the line are also set to 0.
+ *
+ * IN:
+ * @str		String to read.
+ * @n		Number of fields to read.
+ *
+ * OUT:
+ * @val		Array containing the values of the fields.
+ *
+ * RETURNS:
+ * Number of fields read.
+ ***************************************************************************
+ */
+int split_ull_fields(char *str, unsigned long long val[], int n)
+{
+	int i, nr = 0;
+
+	for (i = 0; i < n; i++) {
+		val[i] = 0;
+
+		while (IS_BLANK(*str)) {
+			str++;
+		}
+		if (!*str)
+			continue;
+
+		nr++;
+		next_ull(&str, &val[i]);
+		while (*str && !IS_BLANK(*str)) {
+			str++;
+		}
+	}
+
+	return nr;
+}
+
 /*
  ***************************************************************************
  * Read CPU statistics.
@@ -68,10 +387,12 @@ __nr_t read_stat_cpu(struct stats_cpu *st_cpu, __nr_t nr_alloc)
 	struct stats_cpu *st_cpu_i;
 	struct stats_cpu sc;
 	char line[8192];
+	char *p;
+	unsigned long long val[11];
 	int proc_nr;
 	__nr_t cpu_read = 0;
 
-	if ((fp = fopen(STAT, "r")) == NULL) {
+	if ((fp = fopen_cached(STAT)) == NULL) {
 		fprintf(stderr, _("Cannot open %s: %s\n"), STAT, strerror(errno));
 		exit(2);
 	}
@@ -91,17 +412,19 @@ __nr_t read_stat_cpu(struct stats_cpu *st_cpu, __nr_t nr_alloc)
 			 * (user, nice, etc.) among all proc. CPU usage is not reduced
 			 * to one processor to avoid rounding problems.
 			 */
-			sscanf(line + 5, "%llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
-			       &st_cpu->cpu_user,
-			       &st_cpu->cpu_nice,
-			       &st_cpu->cpu_sys,
-			       &st_cpu->cpu_idle,
-			       &st_cpu->cpu_iowait,
-			       &st_cpu->cpu_hardirq,
-			       &st_cpu->cpu_softirq,
-			       &st_cpu->cpu_steal,
-			       &st_cpu->cpu_guest,
-			       &st_cpu->cpu_guest_nice);
+			p = line + 5;
+			memset(val, 0, sizeof(val));
+			next_ull_fields(&p, val, 10);
+			st_cpu->cpu_user       = val[0];
+			st_cpu->cpu_nice       = val[1];
+			st_cpu->cpu_sys        = val[2];
+			st_cpu->cpu_idle       = val[3];
+			st_cpu->cpu_iowait     = val[4];
+			st_cpu->cpu_hardirq    = val[5];
+			st_cpu->cpu_softirq    = val[6];
+			st_cpu->cpu_steal      = val[7];
+			st_cpu->cpu_guest      = val[8];
+			st_cpu->cpu_guest_nice = val[9];
 
 			if (!cpu_read) {
 				cpu_read = 1;
@@ -120,18 +443,23 @@ __nr_t read_stat_cpu(struct stats_cpu *st_cpu, __nr_t nr_alloc)
 			 * (user, nice, etc) for current proc.
 			 * This is done only on SMP machines.
 			 */
-			sscanf(line + 3, "%d %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu",
-			       &proc_nr,
-			       &sc.cpu_user,
-			       &sc.cpu_nice,
-			       &sc.cpu_sys,
-			       &sc.cpu_idle,
-			       &sc.cpu_iowait,
-			       &sc.cpu_hardirq,
-			       &sc.cpu_softirq,
-			       &sc.cpu_steal,
-			       &sc.cpu_guest,
-			       &sc.cpu_guest_nice);
+			p = line + 3;
+			if (!next_ull(&p, &val[10]))
+				/* No CPU number */
+				continue;
+			proc_nr = (int) val[10];
+			memset(val, 0, sizeof(val));
+			next_ull_fields(&p, val, 10);
+			sc.cpu_user       = val[0];
+			sc.cpu_nice       = val[1];
+			sc.cpu_sys        = val[2];
+			sc.cpu_idle       = val[3];
+			sc.cpu_iowait     = val[4];
+			sc.cpu_hardirq    = val[5];
+			sc.cpu_softirq    = val[6];
+			sc.cpu_steal      = val[7];
+			sc.cpu_guest      = val[8];
+			sc.cpu_guest_nice = val[9];
 
 			if (proc_nr + 2 > nr_alloc) {
 				cpu_read = -1;
@@ -177,7 +505,7 @@ __nr_t read_stat_irq(struct stats_irq *st_irq, __nr_t nr_alloc)
 	unsigned long long irq_nr;
 	__nr_t irq_read = 0;
 
-	if ((fp = fopen(STAT, "r")) == NULL)
+	if ((fp = fopen_cached(STAT)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
@@ -236,78 +564,78 @@ __nr_t read_meminfo(struct stats_memory *st_memory)
 	FILE *fp;
 	char line[128];
 
-	if ((fp = fopen(MEMINFO, "r")) == NULL)
+	if ((fp = fopen_cached(MEMINFO)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
 
 		if (!strncmp(line, "MemTotal:", 9)) {
 			/* Read the total amount of memory in kB */
-			sscanf(line + 9, "%llu", &st_memory->tlmkb);
+			st_memory->tlmkb = field_ull(line + 9);
 		}
 		else if (!strncmp(line, "MemFree:", 8)) {
 			/* Read the amount of free memory in kB */
-			sscanf(line + 8, "%llu", &st_memory->frmkb);
+			st_memory->frmkb = field_ull(line + 8);
 		}
 		else if (!strncmp(line, "MemAvailable:", 13)) {
 			/* Read the amount of available memory in kB */
-			sscanf(line + 13, "%llu", &st_memory->availablekb);
+			st_memory->availablekb = field_ull(line + 13);
 		}
 		else if (!strncmp(line, "Buffers:", 8)) {
 			/* Read the amount of buffered memory in kB */
-			sscanf(line + 8, "%llu", &st_memory->bufkb);
+			st_memory->bufkb = field_ull(line + 8);
 		}
 		else if (!strncmp(line, "Cached:", 7)) {
 			/* Read the amount of cached memory in kB */
-			sscanf(line + 7, "%llu", &st_memory->camkb);
+			st_memory->camkb = field_ull(line + 7);
 		}
 		else if (!strncmp(line, "SwapCached:", 11)) {
 			/* Read the amount of cached swap in kB */
-			sscanf(line + 11, "%llu", &st_memory->caskb);
+			st_memory->caskb = field_ull(line + 11);
 		}
 		else if (!strncmp(line, "Active:", 7)) {
 			/* Read the amount of active memory in kB */
-			sscanf(line + 7, "%llu", &st_memory->activekb);
+			st_memory->activekb = field_ull(line + 7);
 		}
 		else if (!strncmp(line, "Inactive:", 9)) {
 			/* Read the amount of inactive memory in kB */
-			sscanf(line + 9, "%llu", &st_memory->inactkb);
+			st_memory->inactkb = field_ull(line + 9);
 		}
 		else if (!strncmp(line, "SwapTotal:", 10)) {
 			/* Read the total amount of swap memory in kB */
-			sscanf(line + 10, "%llu", &st_memory->tlskb);
+			st_memory->tlskb = field_ull(line + 10);
 		}
 		else if (!strncmp(line, "SwapFree:", 9)) {
 			/* Read the amount of free swap memory in kB */
-			sscanf(line + 9, "%llu", &st_memory->frskb);
+			st_memory->frskb = field_ull(line + 9);
 		}
 		else if (!strncmp(line, "Dirty:", 6)) {
 			/* Read the amount of dirty memory in kB */
-			sscanf(line + 6, "%llu", &st_memory->dirtykb);
+			st_memory->dirtykb = field_ull(line + 6);
 		}
 		else if (!strncmp(line, "Committed_AS:", 13)) {
 			/* Read the amount of commited memory in kB */
-			sscanf(line + 13, "%llu", &st_memory->comkb);
+			st_memory->comkb = field_ull(line + 13);
 		}
 		else if (!strncmp(line, "AnonPages:", 10)) {
 			/* Read the amount of pages mapped into userspace page tables in kB */
-			sscanf(line + 10, "%llu", &st_memory->anonpgkb);
+			st_memory->anonpgkb = field_ull(line + 10);
 		}
 		else if (!strncmp(line, "Slab:", 5)) {
 			/* Read the amount of in-kernel data structures cache in kB */
-			sscanf(line + 5, "%llu", &st_memory->slabkb);
+			st_memory->slabkb = field_ull(line + 5);
 		}
 		else if (!strncmp(line, "KernelStack:", 12)) {
 			/* Read the kernel stack utilization in kB */
-			sscanf(line + 12, "%llu", &st_memory->kstackkb);
+			st_memory->kstackkb = field_ull(line + 12);
 		}
 		else if (!strncmp(line, "PageTables:", 11)) {
 			/* Read the amount of memory dedicated to the lowest level of page tables in kB */
-			sscanf(line + 11, "%llu", &st_memory->pgtblkb);
+			st_memory->pgtblkb = field_ull(line + 11);
 		}
 		else if (!strncmp(line, "VmallocUsed:", 12)) {
 			/* Read the amount of vmalloc area which is used in kB */
-			sscanf(line + 12, "%llu", &st_memory->vmusedkb);
+			st_memory->vmusedkb = field_ull(line + 12);
 		}
 	}
 
@@ -330,7 +658,7 @@ void read_uptime(unsigned long long *uptime)
 	unsigned long up_sec, up_cent;
 	int err = FALSE;
 
-	if ((fp = fopen(UPTIME, "r")) == NULL) {
+	if ((fp = fopen_cached(UPTIME)) == NULL) {
 		err = TRUE;
 	}
 	else if (fgets(line, sizeof(line), fp) == NULL) {
@@ -353,6 +681,33 @@ void read_uptime(unsigned long long *uptime)
 	}
 }
 
+/*
+ ***************************************************************************
+ * Read machine uptime with a microsecond resolution. /proc/uptime gives
+ * only hundredths of a second, which is too coarse to compute rates over
+ * sub-second intervals. The same clock is read with clock_gettime() instead.
+ *
+ * OUT:
+ * @uptime	Uptime value in hundredths of a second.
+ * @uptime_us	Sub-centisecond part of uptime, in microseconds.
+ ***************************************************************************
+ */
+void read_uptime_us(unsigned long long *uptime, unsigned int *uptime_us)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_BOOTTIME, &ts) < 0) {
+		/* Old kernel: Use /proc/uptime */
+		read_uptime(uptime);
+		*uptime_us = 0;
+		return;
+	}
+
+	*uptime = (unsigned long long) ts.tv_sec * 100 +
+		  (unsigned long long) ts.tv_nsec / 10000000;
+	*uptime_us = (unsigned int) ((ts.tv_nsec / 1000) % 10000);
+}
+
 /*
  ***************************************************************************
  * Compute "extended" device statistics (service time, etc.).
@@ -516,7 +871,7 @@ __nr_t read_stat_pcsw(struct stats_pcsw *st_pcsw)
 	FILE *fp;
 	char line[8192];
 
-	if ((fp = fopen(STAT, "r")) == NULL)
+	if ((fp = fopen_cached(STAT)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
@@ -557,7 +912,7 @@ __nr_t read_loadavg(struct stats_queue *st_queue)
 	unsigned int load_tmp[3];
 	int rc;
 
-	if ((fp = fopen(LOADAVG, "r")) == NULL)
+	if ((fp = fopen_cached(LOADAVG)) == NULL)
 		return 0;
 
 	/* Read load averages and queue length */
@@ -583,7 +938,7 @@ __nr_t read_loadavg(struct stats_queue *st_queue)
 	}
 
 	/* Read nr of tasks blocked from /proc/stat */
-	if ((fp = fopen(STAT, "r")) == NULL)
+	if ((fp = fopen_cached(STAT)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
@@ -618,18 +973,18 @@ __nr_t read_vmstat_swap(struct stats_swap *st_swap)
 	FILE *fp;
 	char line[128];
 
-	if ((fp = fopen(VMSTAT, "r")) == NULL)
+	if ((fp = fopen_cached(VMSTAT)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
 
 		if (!strncmp(line, "pswpin ", 7)) {
 			/* Read number of swap pages brought in */
-			sscanf(line + 7, "%lu", &st_swap->pswpin);
+			st_swap->pswpin = field_ull(line + 7);
 		}
 		else if (!strncmp(line, "pswpout ", 8)) {
 			/* Read number of swap pages brought out */
-			sscanf(line + 8, "%lu", &st_swap->pswpout);
+			st_swap->pswpout = field_ull(line + 8);
 		}
 	}
 
@@ -655,9 +1010,8 @@ __nr_t read_vmstat_paging(struct stats_paging *st_paging)
 {
 	FILE *fp;
 	char line[128];
-	unsigned long pgtmp;
 
-	if ((fp = fopen(VMSTAT, "r")) == NULL)
+	if ((fp = fopen_cached(VMSTAT)) == NULL)
 		return 0;
 
 	st_paging->pgsteal = 0;
@@ -667,38 +1021,35 @@ __nr_t read_vmstat_paging(struct stats_paging *st_paging)
 
 		if (!strncmp(line, "pgpgin ", 7)) {
 			/* Read number of pages the system paged in */
-			sscanf(line + 7, "%lu", &st_paging->pgpgin);
+			st_paging->pgpgin = field_ull(line + 7);
 		}
 		else if (!strncmp(line, "pgpgout ", 8)) {
 			/* Read number of pages the system paged out */
-			sscanf(line + 8, "%lu", &st_paging->pgpgout);
+			st_paging->pgpgout = field_ull(line + 8);
 		}
 		else if (!strncmp(line, "pgfault ", 8)) {
 			/* Read number of faults (major+minor) made by the system */
-			sscanf(line + 8, "%lu", &st_paging->pgfault);
+			st_paging->pgfault = field_ull(line + 8);
 		}
 		else if (!strncmp(line, "pgmajfault ", 11)) {
 			/* Read number of faults (major only) made by the system */
-			sscanf(line + 11, "%lu", &st_paging->pgmajfault);
+			st_paging->pgmajfault = field_ull(line + 11);
 		}
 		else if (!strncmp(line, "pgfree ", 7)) {
 			/* Read number of pages freed by the system */
-			sscanf(line + 7, "%lu", &st_paging->pgfree);
+			st_paging->pgfree = field_ull(line + 7);
 		}
 		else if (!strncmp(line, "pgsteal_", 8)) {
 			/* Read number of pages stolen by the system */
-			sscanf(strchr(line, ' '), "%lu", &pgtmp);
-			st_paging->pgsteal += pgtmp;
+			st_paging->pgsteal += field_ull(strchr(line, ' '));
 		}
 		else if (!strncmp(line, "pgscan_kswapd", 13)) {
 			/* Read number of pages scanned by the kswapd daemon */
-			sscanf(strchr(line, ' '), "%lu", &pgtmp);
-			st_paging->pgscan_kswapd += pgtmp;
+			st_paging->pgscan_kswapd += field_ull(strchr(line, ' '));
 		}
 		else if (!strncmp(line, "pgscan_direct", 13)) {
 			/* Read number of pages scanned directly */
-			sscanf(strchr(line, ' '), "%lu", &pgtmp);
-			st_paging->pgscan_direct += pgtmp;
+			st_paging->pgscan_direct += field_ull(strchr(line, ' '));
 		}
 	}
 
@@ -725,17 +1076,25 @@ __nr_t read_diskstats_io(struct stats_io *st_io)
 	FILE *fp;
 	char line[1024];
 	char dev_name[MAX_NAME_LEN];
-	unsigned int major, minor;
+	char *p;
+	unsigned long long val[9];
 	unsigned long rd_ios, wr_ios, rd_sec, wr_sec;
 
-	if ((fp = fopen(DISKSTATS, "r")) == NULL)
+	if ((fp = fopen_cached(DISKSTATS)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
 
-		if (sscanf(line, "%u %u %s %lu %*u %lu %*u %lu %*u %lu",
-			   &major, &minor, dev_name,
-			   &rd_ios, &rd_sec, &wr_ios, &wr_sec) == 7) {
+		/* major minor name rio rmerge rsect ruse wio wmerge wsect... */
+		p = line;
+		if ((next_ull_fields(&p, val, 2) == 2) &&
+		    next_word(&p, dev_name, MAX_NAME_LEN) &&
+		    (next_ull_fields(&p, val + 2, 7) == 7)) {
+
+			rd_ios = val[2];
+			rd_sec = val[4];
+			wr_ios = val[6];
+			wr_sec = val[8];
 
 			if (is_device(dev_name, IGNORE_VIRTUAL_DEVICES)) {
 				/*
@@ -779,21 +1138,34 @@ __nr_t read_diskstats_disk(struct stats_disk *st_disk, __nr_t nr_alloc,
 	FILE *fp;
 	char line[1024];
 	char dev_name[MAX_NAME_LEN];
+	char *p;
+	unsigned long long val[13];
 	struct stats_disk *st_disk_i;
 	unsigned int major, minor, rd_ticks, wr_ticks, tot_ticks, rq_ticks;
 	unsigned long rd_ios, wr_ios, rd_sec, wr_sec;
 	__nr_t dsk_read = 0;
 
-	if ((fp = fopen(DISKSTATS, "r")) == NULL)
+	if ((fp = fopen_cached(DISKSTATS)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
 
-		if (sscanf(line, "%u %u %s %lu %*u %lu %u %lu %*u %lu"
-			   " %u %*u %u %u",
-			   &major, &minor, dev_name,
-			   &rd_ios, &rd_sec, &rd_ticks, &wr_ios, &wr_sec, &wr_ticks,
-			   &tot_ticks, &rq_ticks) == 11) {
+		/* major minor name rio rmerge rsect ruse wio wmerge wsect wuse running use aveq */
+		p = line;
+		if ((next_ull_fields(&p, val, 2) == 2) &&
+		    next_word(&p, dev_name, MAX_NAME_LEN) &&
+		    (next_ull_fields(&p, val + 2, 11) == 11)) {
+
+			major     = (unsigned int) val[0];
+			minor     = (unsigned int) val[1];
+			rd_ios    = val[2];
+			rd_sec    = val[4];
+			rd_ticks  = (unsigned int) val[5];
+			wr_ios    = val[6];
+			wr_sec    = val[8];
+			wr_ticks  = (unsigned int) val[9];
+			tot_ticks = (unsigned int) val[11];
+			rq_ticks  = (unsigned int) val[12];
 
 			if (!rd_ios && !wr_ios)
 				/* Unused device: Ignore it */
@@ -847,7 +1219,7 @@ __nr_t read_tty_driver_serial(struct stats_serial *st_serial, __nr_t nr_alloc)
 	char *p;
 	__nr_t sl_read = 0;
 
-	if ((fp = fopen(SERIAL, "r")) == NULL)
+	if ((fp = fopen_cached(SERIAL)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL ) {
@@ -910,7 +1282,7 @@ __nr_t read_kernel_tables(struct stats_ktables *st_ktables)
 	int rc = 0;
 
 	/* Open /proc/sys/fs/dentry-state file */
-	if ((fp = fopen(FDENTRY_STATE, "r")) != NULL) {
+	if ((fp = fopen_cached(FDENTRY_STATE)) != NULL) {
 		rc = fscanf(fp, "%*d %llu",
 			    &st_ktables->dentry_stat);
 		fclose(fp);
@@ -920,7 +1292,7 @@ __nr_t read_kernel_tables(struct stats_ktables *st_ktables)
 	}
 
 	/* Open /proc/sys/fs/file-nr file */
-	if ((fp = fopen(FFILE_NR, "r")) != NULL) {
+	if ((fp = fopen_cached(FFILE_NR)) != NULL) {
 		rc = fscanf(fp, "%llu %llu",
 			    &st_ktables->file_used, &parm);
 		fclose(fp);
@@ -937,7 +1309,7 @@ __nr_t read_kernel_tables(struct stats_ktables *st_ktables)
 	}
 
 	/* Open /proc/sys/fs/inode-state file */
-	if ((fp = fopen(FINODE_STATE, "r")) != NULL) {
+	if ((fp = fopen_cached(FINODE_STATE)) != NULL) {
 		rc = fscanf(fp, "%llu %llu",
 			    &st_ktables->inode_used, &parm);
 		fclose(fp);
@@ -954,7 +1326,7 @@ __nr_t read_kernel_tables(struct stats_ktables *st_ktables)
 	}
 
 	/* Open /proc/sys/kernel/pty/nr file */
-	if ((fp = fopen(PTY_NR, "r")) != NULL) {
+	if ((fp = fopen_cached(PTY_NR)) != NULL) {
 		rc = fscanf(fp, "%llu",
 			    &st_ktables->pty_nr);
 		fclose(fp);
@@ -988,10 +1360,12 @@ __nr_t read_net_dev(struct stats_net_dev *st_net_dev, __nr_t nr_alloc)
 	struct stats_net_dev *st_net_dev_i;
 	char line[256];
 	char iface[MAX_IFACE_LEN];
+	char *p;
+	unsigned long long val[16];
 	__nr_t dev_read = 0;
 	int pos;
 
-	if ((fp = fopen(NET_DEV, "r")) == NULL)
+	if ((fp = fopen_cached(NET_DEV)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
@@ -1007,16 +1381,20 @@ __nr_t read_net_dev(struct stats_net_dev *st_net_dev, __nr_t nr_alloc)
 			st_net_dev_i = st_net_dev + dev_read++;
 			strncpy(iface, line, MINIMUM(pos, MAX_IFACE_LEN - 1));
 			iface[MINIMUM(pos, MAX_IFACE_LEN - 1)] = '\0';
-			sscanf(iface, "%s", st_net_dev_i->interface); /* Skip heading spaces */
-			sscanf(line + pos + 1, "%llu %llu %*u %*u %*u %*u %llu %llu %llu %llu "
-			       "%*u %*u %*u %*u %*u %llu",
-			       &st_net_dev_i->rx_bytes,
-			       &st_net_dev_i->rx_packets,
-			       &st_net_dev_i->rx_compressed,
-			       &st_net_dev_i->multicast,
-			       &st_net_dev_i->tx_bytes,
-			       &st_net_dev_i->tx_packets,
-			       &st_net_dev_i->tx_compressed);
+			p = iface;
+			next_word(&p, st_net_dev_i->interface, MAX_IFACE_LEN); /* Skip heading spaces */
+
+			/* rx: bytes packets errs drop fifo frame compressed multicast, then tx */
+			p = line + pos + 1;
+			memset(val, 0, sizeof(val));
+			next_ull_fields(&p, val, 16);
+			st_net_dev_i->rx_bytes      = val[0];
+			st_net_dev_i->rx_packets    = val[1];
+			st_net_dev_i->rx_compressed = val[6];
+			st_net_dev_i->multicast     = val[7];
+			st_net_dev_i->tx_bytes      = val[8];
+			st_net_dev_i->tx_packets    = val[9];
+			st_net_dev_i->tx_compressed = val[15];
 		}
 	}
 
@@ -1111,10 +1489,12 @@ __nr_t read_net_edev(struct stats_net_edev *st_net_edev, __nr_t nr_alloc)
 	struct stats_net_edev *st_net_edev_i;
 	static char line[256];
 	char iface[MAX_IFACE_LEN];
+	char *p;
+	unsigned long long val[16];
 	__nr_t dev_read = 0;
 	int pos;
 
-	if ((fp = fopen(NET_DEV, "r")) == NULL)
+	if ((fp = fopen_cached(NET_DEV)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
@@ -1130,18 +1510,22 @@ __nr_t read_net_edev(struct stats_net_edev *st_net_edev, __nr_t nr_alloc)
 			st_net_edev_i = st_net_edev + dev_read++;
 			strncpy(iface, line, MINIMUM(pos, MAX_IFACE_LEN - 1));
 			iface[MINIMUM(pos, MAX_IFACE_LEN - 1)] = '\0';
-			sscanf(iface, "%s", st_net_edev_i->interface); /* Skip heading spaces */
-			sscanf(line + pos + 1, "%*u %*u %llu %llu %llu %llu %*u %*u %*u %*u "
-			       "%llu %llu %llu %llu %llu",
-			       &st_net_edev_i->rx_errors,
-			       &st_net_edev_i->rx_dropped,
-			       &st_net_edev_i->rx_fifo_errors,
-			       &st_net_edev_i->rx_frame_errors,
-			       &st_net_edev_i->tx_errors,
-			       &st_net_edev_i->tx_dropped,
-			       &st_net_edev_i->tx_fifo_errors,
-			       &st_net_edev_i->collisions,
-			       &st_net_edev_i->tx_carrier_errors);
+			p = iface;
+			next_word(&p, st_net_edev_i->interface, MAX_IFACE_LEN); /* Skip heading spaces */
+
+			/* rx: bytes packets errs drop fifo frame compressed multicast, then tx */
+			p = line + pos + 1;
+			memset(val, 0, sizeof(val));
+			next_ull_fields(&p, val, 15);
+			st_net_edev_i->rx_errors         = val[2];
+			st_net_edev_i->rx_dropped        = val[3];
+			st_net_edev_i->rx_fifo_errors    = val[4];
+			st_net_edev_i->rx_frame_errors   = val[5];
+			st_net_edev_i->tx_errors         = val[10];
+			st_net_edev_i->tx_dropped        = val[11];
+			st_net_edev_i->tx_fifo_errors    = val[12];
+			st_net_edev_i->collisions        = val[13];
+			st_net_edev_i->tx_carrier_errors = val[14];
 		}
 	}
 
@@ -1169,7 +1553,7 @@ __nr_t read_net_nfs(struct stats_net_nfs *st_net_nfs)
 	char line[256];
 	unsigned int getattcnt = 0, accesscnt = 0, readcnt = 0, writecnt = 0;
 
-	if ((fp = fopen(NET_RPC_NFS, "r")) == NULL)
+	if ((fp = fopen_cached(NET_RPC_NFS)) == NULL)
 		return 0;
 
 	memset(st_net_nfs, 0, STATS_NET_NFS_SIZE);
@@ -1225,7 +1609,7 @@ __nr_t read_net_nfsd(struct stats_net_nfsd *st_net_nfsd)
 	char line[256];
 	unsigned int getattcnt = 0, accesscnt = 0, readcnt = 0, writecnt = 0;
 
-	if ((fp = fopen(NET_RPC_NFSD, "r")) == NULL)
+	if ((fp = fopen_cached(NET_RPC_NFSD)) == NULL)
 		return 0;
 
 	memset(st_net_nfsd, 0, STATS_NET_NFSD_SIZE);
@@ -1293,7 +1677,7 @@ __nr_t read_net_sock(struct stats_net_sock *st_net_sock)
 	char line[96];
 	char *p;
 
-	if ((fp = fopen(NET_SOCKSTAT, "r")) == NULL)
+	if ((fp = fopen_cached(NET_SOCKSTAT)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
@@ -1345,25 +1729,25 @@ __nr_t read_net_ip(struct stats_net_ip *st_net_ip)
 {
 	FILE *fp;
 	char line[1024];
+	unsigned long long val[19];
 	int sw = FALSE;
 
-	if ((fp = fopen(NET_SNMP, "r")) == NULL)
+	if ((fp = fopen_cached(NET_SNMP)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
 
 		if (!strncmp(line, "Ip:", 3)) {
 			if (sw) {
-				sscanf(line + 3, "%*u %*u %llu %*u %*u %llu %*u %*u "
-				       "%llu %llu %*u %*u %*u %llu %llu %*u %llu %*u %llu",
-				       &st_net_ip->InReceives,
-				       &st_net_ip->ForwDatagrams,
-				       &st_net_ip->InDelivers,
-				       &st_net_ip->OutRequests,
-				       &st_net_ip->ReasmReqds,
-				       &st_net_ip->ReasmOKs,
-				       &st_net_ip->FragOKs,
-				       &st_net_ip->FragCreates);
+				split_ull_fields(line + 3, val, 19);
+				st_net_ip->InReceives    = val[2];
+				st_net_ip->ForwDatagrams = val[5];
+				st_net_ip->InDelivers    = val[8];
+				st_net_ip->OutRequests   = val[9];
+				st_net_ip->ReasmReqds    = val[13];
+				st_net_ip->ReasmOKs      = val[14];
+				st_net_ip->FragOKs       = val[16];
+				st_net_ip->FragCreates   = val[18];
 
 				break;
 			}
@@ -1395,25 +1779,25 @@ __nr_t read_net_eip(struct stats_net_eip *st_net_eip)
 {
 	FILE *fp;
 	char line[1024];
+	unsigned long long val[18];
 	int sw = FALSE;
 
-	if ((fp = fopen(NET_SNMP, "r")) == NULL)
+	if ((fp = fopen_cached(NET_SNMP)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
 
 		if (!strncmp(line, "Ip:", 3)) {
 			if (sw) {
-				sscanf(line + 3, "%*u %*u %*u %llu %llu %*u %llu %llu "
-				       "%*u %*u %llu %llu %*u %*u %*u %llu %*u %llu",
-				       &st_net_eip->InHdrErrors,
-				       &st_net_eip->InAddrErrors,
-				       &st_net_eip->InUnknownProtos,
-				       &st_net_eip->InDiscards,
-				       &st_net_eip->OutDiscards,
-				       &st_net_eip->OutNoRoutes,
-				       &st_net_eip->ReasmFails,
-				       &st_net_eip->FragFails);
+				split_ull_fields(line + 3, val, 18);
+				st_net_eip->InHdrErrors     = val[3];
+				st_net_eip->InAddrErrors    = val[4];
+				st_net_eip->InUnknownProtos = val[6];
+				st_net_eip->InDiscards      = val[7];
+				st_net_eip->OutDiscards     = val[10];
+				st_net_eip->OutNoRoutes     = val[11];
+				st_net_eip->ReasmFails      = val[15];
+				st_net_eip->FragFails       = val[17];
 
 				break;
 			}
@@ -1445,54 +1829,43 @@ __nr_t read_net_icmp(struct stats_net_icmp *st_net_icmp)
 {
 	FILE *fp;
 	char line[1024];
-	static char format[256] = "";
+	unsigned long long val[27];
+	static int csum = -1;
 	int sw = FALSE;
 
-	if ((fp = fopen(NET_SNMP, "r")) == NULL)
+	if ((fp = fopen_cached(NET_SNMP)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
 
 		if (!strncmp(line, "Icmp:", 5)) {
 			if (sw) {
-				sscanf(line + 5, format,
-				       &st_net_icmp->InMsgs,
-				       &st_net_icmp->InEchos,
-				       &st_net_icmp->InEchoReps,
-				       &st_net_icmp->InTimestamps,
-				       &st_net_icmp->InTimestampReps,
-				       &st_net_icmp->InAddrMasks,
-				       &st_net_icmp->InAddrMaskReps,
-				       &st_net_icmp->OutMsgs,
-				       &st_net_icmp->OutEchos,
-				       &st_net_icmp->OutEchoReps,
-				       &st_net_icmp->OutTimestamps,
-				       &st_net_icmp->OutTimestampReps,
-				       &st_net_icmp->OutAddrMasks,
-				       &st_net_icmp->OutAddrMaskReps);
+				split_ull_fields(line + 5, val, 27);
+				st_net_icmp->InMsgs           = val[0];
+				st_net_icmp->InEchos          = val[7 + csum];
+				st_net_icmp->InEchoReps       = val[8 + csum];
+				st_net_icmp->InTimestamps     = val[9 + csum];
+				st_net_icmp->InTimestampReps  = val[10 + csum];
+				st_net_icmp->InAddrMasks      = val[11 + csum];
+				st_net_icmp->InAddrMaskReps   = val[12 + csum];
+				st_net_icmp->OutMsgs          = val[13 + csum];
+				st_net_icmp->OutEchos         = val[20 + csum];
+				st_net_icmp->OutEchoReps      = val[21 + csum];
+				st_net_icmp->OutTimestamps    = val[22 + csum];
+				st_net_icmp->OutTimestampReps = val[23 + csum];
+				st_net_icmp->OutAddrMasks     = val[24 + csum];
+				st_net_icmp->OutAddrMaskReps  = val[25 + csum];
 
 				break;
 			}
 			else {
-				if (!strlen(format)) {
-					if (strstr(line, "InCsumErrors")) {
-						/*
-						 * New format: InCsumErrors field exists at position #3.
-						 * Capture: 1,9,10,11,12,13,14,15,22,23,24,25,26,27.
-						 */
-						strcpy(format, "%lu %*u %*u %*u %*u %*u %*u %*u "
-							       "%lu %lu %lu %lu %lu %lu %lu %*u %*u %*u %*u "
-							       "%*u %*u %lu %lu %lu %lu %lu %lu");
-					}
-					else {
-						/*
-						 * Old format: InCsumErrors field doesn't exist.
-						 * Capture: 1,8,9,10,11,12,13,14,21,22,23,24,25,26.
-						 */
-						strcpy(format, "%lu %*u %*u %*u %*u %*u %*u "
-							       "%lu %lu %lu %lu %lu %lu %lu %*u %*u %*u %*u "
-							       "%*u %*u %lu %lu %lu %lu %lu %lu");
-					}
+				if (csum < 0) {
+					/*
+					 * New format: InCsumErrors field exists at position #3,
+					 * and following fields are shifted by one position.
+					 * Old format: InCsumErrors field doesn't exist.
+					 */
+					csum = (strstr(line, "InCsumErrors") != NULL);
 				}
 				sw = TRUE;
 			}
@@ -1521,29 +1894,29 @@ __nr_t read_net_eicmp(struct stats_net_eicmp *st_net_eicmp)
 {
 	FILE *fp;
 	char line[1024];
+	unsigned long long val[20];
 	int sw = FALSE;
 
-	if ((fp = fopen(NET_SNMP, "r")) == NULL)
+	if ((fp = fopen_cached(NET_SNMP)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
 
 		if (!strncmp(line, "Icmp:", 5)) {
 			if (sw) {
-				sscanf(line + 5, "%*u %lu %lu %lu %lu %lu %lu %*u %*u "
-				       "%*u %*u %*u %*u %*u %lu %lu %lu %lu %lu %lu",
-				       &st_net_eicmp->InErrors,
-				       &st_net_eicmp->InDestUnreachs,
-				       &st_net_eicmp->InTimeExcds,
-				       &st_net_eicmp->InParmProbs,
-				       &st_net_eicmp->InSrcQuenchs,
-				       &st_net_eicmp->InRedirects,
-				       &st_net_eicmp->OutErrors,
-				       &st_net_eicmp->OutDestUnreachs,
-				       &st_net_eicmp->OutTimeExcds,
-				       &st_net_eicmp->OutParmProbs,
-				       &st_net_eicmp->OutSrcQuenchs,
-				       &st_net_eicmp->OutRedirects);
+				split_ull_fields(line + 5, val, 20);
+				st_net_eicmp->InErrors        = val[1];
+				st_net_eicmp->InDestUnreachs  = val[2];
+				st_net_eicmp->InTimeExcds     = val[3];
+				st_net_eicmp->InParmProbs     = val[4];
+				st_net_eicmp->InSrcQuenchs    = val[5];
+				st_net_eicmp->InRedirects     = val[6];
+				st_net_eicmp->OutErrors       = val[14];
+				st_net_eicmp->OutDestUnreachs = val[15];
+				st_net_eicmp->OutTimeExcds    = val[16];
+				st_net_eicmp->OutParmProbs    = val[17];
+				st_net_eicmp->OutSrcQuenchs   = val[18];
+				st_net_eicmp->OutRedirects    = val[19];
 
 				break;
 			}
@@ -1575,21 +1948,21 @@ __nr_t read_net_tcp(struct stats_net_tcp *st_net_tcp)
 {
 	FILE *fp;
 	char line[1024];
+	unsigned long long val[11];
 	int sw = FALSE;
 
-	if ((fp = fopen(NET_SNMP, "r")) == NULL)
+	if ((fp = fopen_cached(NET_SNMP)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
 
 		if (!strncmp(line, "Tcp:", 4)) {
 			if (sw) {
-				sscanf(line + 4, "%*u %*u %*u %*d %lu %lu "
-				       "%*u %*u %*u %lu %lu",
-				       &st_net_tcp->ActiveOpens,
-				       &st_net_tcp->PassiveOpens,
-				       &st_net_tcp->InSegs,
-				       &st_net_tcp->OutSegs);
+				split_ull_fields(line + 4, val, 11);
+				st_net_tcp->ActiveOpens  = val[4];
+				st_net_tcp->PassiveOpens = val[5];
+				st_net_tcp->InSegs       = val[9];
+				st_net_tcp->OutSegs      = val[10];
 
 				break;
 			}
@@ -1621,22 +1994,22 @@ __nr_t read_net_etcp(struct stats_net_etcp *st_net_etcp)
 {
 	FILE *fp;
 	char line[1024];
+	unsigned long long val[14];
 	int sw = FALSE;
 
-	if ((fp = fopen(NET_SNMP, "r")) == NULL)
+	if ((fp = fopen_cached(NET_SNMP)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
 
 		if (!strncmp(line, "Tcp:", 4)) {
 			if (sw) {
-				sscanf(line + 4, "%*u %*u %*u %*d %*u %*u "
-				       "%lu %lu %*u %*u %*u %lu %lu %lu",
-				       &st_net_etcp->AttemptFails,
-				       &st_net_etcp->EstabResets,
-				       &st_net_etcp->RetransSegs,
-				       &st_net_etcp->InErrs,
-				       &st_net_etcp->OutRsts);
+				split_ull_fields(line + 4, val, 14);
+				st_net_etcp->AttemptFails = val[6];
+				st_net_etcp->EstabResets  = val[7];
+				st_net_etcp->RetransSegs  = val[11];
+				st_net_etcp->InErrs       = val[12];
+				st_net_etcp->OutRsts      = val[13];
 
 				break;
 			}
@@ -1668,20 +2041,21 @@ __nr_t read_net_udp(struct stats_net_udp *st_net_udp)
 {
 	FILE *fp;
 	char line[1024];
+	unsigned long long val[4];
 	int sw = FALSE;
 
-	if ((fp = fopen(NET_SNMP, "r")) == NULL)
+	if ((fp = fopen_cached(NET_SNMP)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
 
 		if (!strncmp(line, "Udp:", 4)) {
 			if (sw) {
-				sscanf(line + 4, "%lu %lu %lu %lu",
-				       &st_net_udp->InDatagrams,
-				       &st_net_udp->NoPorts,
-				       &st_net_udp->InErrors,
-				       &st_net_udp->OutDatagrams);
+				split_ull_fields(line + 4, val, 4);
+				st_net_udp->InDatagrams  = val[0];
+				st_net_udp->NoPorts      = val[1];
+				st_net_udp->InErrors     = val[2];
+				st_net_udp->OutDatagrams = val[3];
 
 				break;
 			}
@@ -1714,7 +2088,7 @@ __nr_t read_net_sock6(struct stats_net_sock6 *st_net_sock6)
 	FILE *fp;
 	char line[96];
 
-	if ((fp = fopen(NET_SOCKSTAT6, "r")) == NULL)
+	if ((fp = fopen_cached(NET_SOCKSTAT6)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
@@ -1760,40 +2134,40 @@ __nr_t read_net_ip6(struct stats_net_ip6 *st_net_ip6)
 	FILE *fp;
 	char line[128];
 
-	if ((fp = fopen(NET_SNMP6, "r")) == NULL)
+	if ((fp = fopen_cached(NET_SNMP6)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
 
 		if (!strncmp(line, "Ip6InReceives ", 14)) {
-			sscanf(line + 14, "%llu", &st_net_ip6->InReceives6);
+			st_net_ip6->InReceives6 = field_ull(line + 14);
 		}
 		else if (!strncmp(line, "Ip6OutForwDatagrams ", 20)) {
-			sscanf(line + 20, "%llu", &st_net_ip6->OutForwDatagrams6);
+			st_net_ip6->OutForwDatagrams6 = field_ull(line + 20);
 		}
 		else if (!strncmp(line, "Ip6InDelivers ", 14)) {
-			sscanf(line + 14, "%llu", &st_net_ip6->InDelivers6);
+			st_net_ip6->InDelivers6 = field_ull(line + 14);
 		}
 		else if (!strncmp(line, "Ip6OutRequests ", 15)) {
-			sscanf(line + 15, "%llu", &st_net_ip6->OutRequests6);
+			st_net_ip6->OutRequests6 = field_ull(line + 15);
 		}
 		else if (!strncmp(line, "Ip6ReasmReqds ", 14)) {
-			sscanf(line + 14, "%llu", &st_net_ip6->ReasmReqds6);
+			st_net_ip6->ReasmReqds6 = field_ull(line + 14);
 		}
 		else if (!strncmp(line, "Ip6ReasmOKs ", 12)) {
-			sscanf(line + 12, "%llu", &st_net_ip6->ReasmOKs6);
+			st_net_ip6->ReasmOKs6 = field_ull(line + 12);
 		}
 		else if (!strncmp(line, "Ip6InMcastPkts ", 15)) {
-			sscanf(line + 15, "%llu", &st_net_ip6->InMcastPkts6);
+			st_net_ip6->InMcastPkts6 = field_ull(line + 15);
 		}
 		else if (!strncmp(line, "Ip6OutMcastPkts ", 16)) {
-			sscanf(line + 16, "%llu", &st_net_ip6->OutMcastPkts6);
+			st_net_ip6->OutMcastPkts6 = field_ull(line + 16);
 		}
 		else if (!strncmp(line, "Ip6FragOKs ", 11)) {
-			sscanf(line + 11, "%llu", &st_net_ip6->FragOKs6);
+			st_net_ip6->FragOKs6 = field_ull(line + 11);
 		}
 		else if (!strncmp(line, "Ip6FragCreates ", 15)) {
-			sscanf(line + 15, "%llu", &st_net_ip6->FragCreates6);
+			st_net_ip6->FragCreates6 = field_ull(line + 15);
 		}
 	}
 
@@ -1820,43 +2194,43 @@ __nr_t read_net_eip6(struct stats_net_eip6 *st_net_eip6)
 	FILE *fp;
 	char line[128];
 
-	if ((fp = fopen(NET_SNMP6, "r")) == NULL)
+	if ((fp = fopen_cached(NET_SNMP6)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
 
 		if (!strncmp(line, "Ip6InHdrErrors ", 15)) {
-			sscanf(line + 15, "%llu", &st_net_eip6->InHdrErrors6);
+			st_net_eip6->InHdrErrors6 = field_ull(line + 15);
 		}
 		else if (!strncmp(line, "Ip6InAddrErrors ", 16)) {
-			sscanf(line + 16, "%llu", &st_net_eip6->InAddrErrors6);
+			st_net_eip6->InAddrErrors6 = field_ull(line + 16);
 		}
 		else if (!strncmp(line, "Ip6InUnknownProtos ", 19)) {
-			sscanf(line + 19, "%llu", &st_net_eip6->InUnknownProtos6);
+			st_net_eip6->InUnknownProtos6 = field_ull(line + 19);
 		}
 		else if (!strncmp(line, "Ip6InTooBigErrors ", 18)) {
-			sscanf(line + 18, "%llu", &st_net_eip6->InTooBigErrors6);
+			st_net_eip6->InTooBigErrors6 = field_ull(line + 18);
 		}
 		else if (!strncmp(line, "Ip6InDiscards ", 14)) {
-			sscanf(line + 14, "%llu", &st_net_eip6->InDiscards6);
+			st_net_eip6->InDiscards6 = field_ull(line + 14);
 		}
 		else if (!strncmp(line, "Ip6OutDiscards ", 15)) {
-			sscanf(line + 15, "%llu", &st_net_eip6->OutDiscards6);
+			st_net_eip6->OutDiscards6 = field_ull(line + 15);
 		}
 		else if (!strncmp(line, "Ip6InNoRoutes ", 14)) {
-			sscanf(line + 14, "%llu", &st_net_eip6->InNoRoutes6);
+			st_net_eip6->InNoRoutes6 = field_ull(line + 14);
 		}
 		else if (!strncmp(line, "Ip6OutNoRoutes ", 15)) {
-			sscanf(line + 15, "%llu", &st_net_eip6->OutNoRoutes6);
+			st_net_eip6->OutNoRoutes6 = field_ull(line + 15);
 		}
 		else if (!strncmp(line, "Ip6ReasmFails ", 14)) {
-			sscanf(line + 14, "%llu", &st_net_eip6->ReasmFails6);
+			st_net_eip6->ReasmFails6 = field_ull(line + 14);
 		}
 		else if (!strncmp(line, "Ip6FragFails ", 13)) {
-			sscanf(line + 13, "%llu", &st_net_eip6->FragFails6);
+			st_net_eip6->FragFails6 = field_ull(line + 13);
 		}
 		else if (!strncmp(line, "Ip6InTruncatedPkts ", 19)) {
-			sscanf(line + 19, "%llu", &st_net_eip6->InTruncatedPkts6);
+			st_net_eip6->InTruncatedPkts6 = field_ull(line + 19);
 		}
 	}
 
@@ -1883,61 +2257,61 @@ __nr_t read_net_icmp6(struct stats_net_icmp6 *st_net_icmp6)
 	FILE *fp;
 	char line[128];
 
-	if ((fp = fopen(NET_SNMP6, "r")) == NULL)
+	if ((fp = fopen_cached(NET_SNMP6)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
 
 		if (!strncmp(line, "Icmp6InMsgs ", 12)) {
-			sscanf(line + 12, "%lu", &st_net_icmp6->InMsgs6);
+			st_net_icmp6->InMsgs6 = field_ull(line + 12);
 		}
 		else if (!strncmp(line, "Icmp6OutMsgs ", 13)) {
-			sscanf(line + 13, "%lu", &st_net_icmp6->OutMsgs6);
+			st_net_icmp6->OutMsgs6 = field_ull(line + 13);
 		}
 		else if (!strncmp(line, "Icmp6InEchos ", 13)) {
-			sscanf(line + 13, "%lu", &st_net_icmp6->InEchos6);
+			st_net_icmp6->InEchos6 = field_ull(line + 13);
 		}
 		else if (!strncmp(line, "Icmp6InEchoReplies ", 19)) {
-			sscanf(line + 19, "%lu", &st_net_icmp6->InEchoReplies6);
+			st_net_icmp6->InEchoReplies6 = field_ull(line + 19);
 		}
 		else if (!strncmp(line, "Icmp6OutEchoReplies ", 20)) {
-			sscanf(line + 20, "%lu", &st_net_icmp6->OutEchoReplies6);
+			st_net_icmp6->OutEchoReplies6 = field_ull(line + 20);
 		}
 		else if (!strncmp(line, "Icmp6InGroupMembQueries ", 24)) {
-			sscanf(line + 24, "%lu", &st_net_icmp6->InGroupMembQueries6);
+			st_net_icmp6->InGroupMembQueries6 = field_ull(line + 24);
 		}
 		else if (!strncmp(line, "Icmp6InGroupMembResponses ", 26)) {
-			sscanf(line + 26, "%lu", &st_net_icmp6->InGroupMembResponses6);
+			st_net_icmp6->InGroupMembResponses6 = field_ull(line + 26);
 		}
 		else if (!strncmp(line, "Icmp6OutGroupMembResponses ", 27)) {
-			sscanf(line + 27, "%lu", &st_net_icmp6->OutGroupMembResponses6);
+			st_net_icmp6->OutGroupMembResponses6 = field_ull(line + 27);
 		}
 		else if (!strncmp(line, "Icmp6InGroupMembReductions ", 27)) {
-			sscanf(line + 27, "%lu", &st_net_icmp6->InGroupMembReductions6);
+			st_net_icmp6->InGroupMembReductions6 = field_ull(line + 27);
 		}
 		else if (!strncmp(line, "Icmp6OutGroupMembReductions ", 28)) {
-			sscanf(line + 28, "%lu", &st_net_icmp6->OutGroupMembReductions6);
+			st_net_icmp6->OutGroupMembReductions6 = field_ull(line + 28);
 		}
 		else if (!strncmp(line, "Icmp6InRouterSolicits ", 22)) {
-			sscanf(line + 22, "%lu", &st_net_icmp6->InRouterSolicits6);
+			st_net_icmp6->InRouterSolicits6 = field_ull(line + 22);
 		}
 		else if (!strncmp(line, "Icmp6OutRouterSolicits ", 23)) {
-			sscanf(line + 23, "%lu", &st_net_icmp6->OutRouterSolicits6);
+			st_net_icmp6->OutRouterSolicits6 = field_ull(line + 23);
 		}
 		else if (!strncmp(line, "Icmp6InRouterAdvertisements ", 28)) {
-			sscanf(line + 28, "%lu", &st_net_icmp6->InRouterAdvertisements6);
+			st_net_icmp6->InRouterAdvertisements6 = field_ull(line + 28);
 		}
 		else if (!strncmp(line, "Icmp6InNeighborSolicits ", 24)) {
-			sscanf(line + 24, "%lu", &st_net_icmp6->InNeighborSolicits6);
+			st_net_icmp6->InNeighborSolicits6 = field_ull(line + 24);
 		}
 		else if (!strncmp(line, "Icmp6OutNeighborSolicits ", 25)) {
-			sscanf(line + 25, "%lu", &st_net_icmp6->OutNeighborSolicits6);
+			st_net_icmp6->OutNeighborSolicits6 = field_ull(line + 25);
 		}
 		else if (!strncmp(line, "Icmp6InNeighborAdvertisements ", 30)) {
-			sscanf(line + 30, "%lu", &st_net_icmp6->InNeighborAdvertisements6);
+			st_net_icmp6->InNeighborAdvertisements6 = field_ull(line + 30);
 		}
 		else if (!strncmp(line, "Icmp6OutNeighborAdvertisements ", 31)) {
-			sscanf(line + 31, "%lu", &st_net_icmp6->OutNeighborAdvertisements6);
+			st_net_icmp6->OutNeighborAdvertisements6 = field_ull(line + 31);
 		}
 	}
 
@@ -1964,43 +2338,43 @@ __nr_t read_net_eicmp6(struct stats_net_eicmp6 *st_net_eicmp6)
 	FILE *fp;
 	char line[128];
 
-	if ((fp = fopen(NET_SNMP6, "r")) == NULL)
+	if ((fp = fopen_cached(NET_SNMP6)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
 
 		if (!strncmp(line, "Icmp6InErrors ", 14)) {
-			sscanf(line + 14, "%lu", &st_net_eicmp6->InErrors6);
+			st_net_eicmp6->InErrors6 = field_ull(line + 14);
 		}
 		else if (!strncmp(line, "Icmp6InDestUnreachs ", 20)) {
-			sscanf(line + 20, "%lu", &st_net_eicmp6->InDestUnreachs6);
+			st_net_eicmp6->InDestUnreachs6 = field_ull(line + 20);
 		}
 		else if (!strncmp(line, "Icmp6OutDestUnreachs ", 21)) {
-			sscanf(line + 21, "%lu", &st_net_eicmp6->OutDestUnreachs6);
+			st_net_eicmp6->OutDestUnreachs6 = field_ull(line + 21);
 		}
 		else if (!strncmp(line, "Icmp6InTimeExcds ", 17)) {
-			sscanf(line + 17, "%lu", &st_net_eicmp6->InTimeExcds6);
+			st_net_eicmp6->InTimeExcds6 = field_ull(line + 17);
 		}
 		else if (!strncmp(line, "Icmp6OutTimeExcds ", 18)) {
-			sscanf(line + 18, "%lu", &st_net_eicmp6->OutTimeExcds6);
+			st_net_eicmp6->OutTimeExcds6 = field_ull(line + 18);
 		}
 		else if (!strncmp(line, "Icmp6InParmProblems ", 20)) {
-			sscanf(line + 20, "%lu", &st_net_eicmp6->InParmProblems6);
+			st_net_eicmp6->InParmProblems6 = field_ull(line + 20);
 		}
 		else if (!strncmp(line, "Icmp6OutParmProblems ", 21)) {
-			sscanf(line + 21, "%lu", &st_net_eicmp6->OutParmProblems6);
+			st_net_eicmp6->OutParmProblems6 = field_ull(line + 21);
 		}
 		else if (!strncmp(line, "Icmp6InRedirects ", 17)) {
-			sscanf(line + 17, "%lu", &st_net_eicmp6->InRedirects6);
+			st_net_eicmp6->InRedirects6 = field_ull(line + 17);
 		}
 		else if (!strncmp(line, "Icmp6OutRedirects ", 18)) {
-			sscanf(line + 18, "%lu", &st_net_eicmp6->OutRedirects6);
+			st_net_eicmp6->OutRedirects6 = field_ull(line + 18);
 		}
 		else if (!strncmp(line, "Icmp6InPktTooBigs ", 18)) {
-			sscanf(line + 18, "%lu", &st_net_eicmp6->InPktTooBigs6);
+			st_net_eicmp6->InPktTooBigs6 = field_ull(line + 18);
 		}
 		else if (!strncmp(line, "Icmp6OutPktTooBigs ", 19)) {
-			sscanf(line + 19, "%lu", &st_net_eicmp6->OutPktTooBigs6);
+			st_net_eicmp6->OutPktTooBigs6 = field_ull(line + 19);
 		}
 	}
 
@@ -2027,22 +2401,22 @@ __nr_t read_net_udp6(struct stats_net_udp6 *st_net_udp6)
 	FILE *fp;
 	char line[128];
 
-	if ((fp = fopen(NET_SNMP6, "r")) == NULL)
+	if ((fp = fopen_cached(NET_SNMP6)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
 
 		if (!strncmp(line, "Udp6InDatagrams ", 16)) {
-			sscanf(line + 16, "%lu", &st_net_udp6->InDatagrams6);
+			st_net_udp6->InDatagrams6 = field_ull(line + 16);
 		}
 		else if (!strncmp(line, "Udp6OutDatagrams ", 17)) {
-			sscanf(line + 17, "%lu", &st_net_udp6->OutDatagrams6);
+			st_net_udp6->OutDatagrams6 = field_ull(line + 17);
 		}
 		else if (!strncmp(line, "Udp6NoPorts ", 12)) {
-			sscanf(line + 12, "%lu", &st_net_udp6->NoPorts6);
+			st_net_udp6->NoPorts6 = field_ull(line + 12);
 		}
 		else if (!strncmp(line, "Udp6InErrors ", 13)) {
-			sscanf(line + 13, "%lu", &st_net_udp6->InErrors6);
+			st_net_udp6->InErrors6 = field_ull(line + 13);
 		}
 	}
 
@@ -2076,7 +2450,7 @@ __nr_t read_cpuinfo(struct stats_pwr_cpufreq *st_pwr_cpufreq, __nr_t nr_alloc)
 	__nr_t cpu_read = 1;	/* For CPU "all" */
 	unsigned int proc_nr = 0, ifreq, dfreq;
 
-	if ((fp = fopen(CPUINFO, "r")) == NULL)
+	if ((fp = fopen_cached(CPUINFO)) == NULL)
 		return 0;
 
 	st_pwr_cpufreq->cpufreq = 0;
@@ -2140,7 +2514,7 @@ __nr_t read_meminfo_huge(struct stats_huge *st_huge)
 	char line[128];
 	unsigned long szhkb = 0;
 
-	if ((fp = fopen(MEMINFO, "r")) == NULL)
+	if ((fp = fopen_cached(MEMINFO)) == NULL)
 		return 0;
 
 	while (fgets(line, sizeof(line), fp) != NULL) {
@@ -2622,7 +2996,7 @@ int read_softnet(struct stats_softnet *st_softnet, __nr_t nr_alloc,
 	int cpu;
 
 	/* Open /proc/net/softnet_stat file */
-	if ((fp = fopen(NET_SOFTNET, "r")) == NULL)
+	if ((fp = fopen_cached(NET_SOFTNET)) == NULL)
 		return 0;
 
 	for (cpu = 1; cpu < nr_alloc; cpu++) {
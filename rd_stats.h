@@ -42,6 +42,10 @@
 /* Type for all functions counting items. Value can be negative (-1) */
 #define __nr_t		int
 
+/* Characters skipped or read by next_ull() and next_word() */
+#define IS_BLANK(c)	(((c) == ' ') || (((c) >= '\t') && ((c) <= '\r')))
+#define IS_DIGIT(c)	(((c) >= '0') && ((c) <= '9'))
+
 /*
  ***************************************************************************
  * System files containing statistics
@@ -693,17 +697,55 @@ struct stats_softnet {
 #define STATS_SOFTNET_UL	0
 #define STATS_SOFTNET_U		5
 
+/*
+ * System file kept open between two readings (see open_cached_file()).
+ * Its contents are read once per sample: They are read again only after
+ * invalidate_cached_files() has been called.
+ */
+struct cached_file {
+	char *name;
+	int fd;
+	/* Buffer where the file is read, and its size */
+	char *buf;
+	size_t size;
+	/* Length of file contents in buffer */
+	size_t len;
+	/* TRUE if buffer contents are those of current sample */
+	int valid;
+};
+
+#define MAX_CACHED_FILES	32
+#define CACHED_FILE_BUFSIZE	8192
+
 /*
  ***************************************************************************
  * Prototypes for functions used to read system statistics
  ***************************************************************************
  */
 
+void close_cached_files
+	(void);
 void compute_ext_disk_stats
 	(struct stats_disk *, struct stats_disk *, unsigned long long,
 	 struct ext_disk_stats *);
+FILE *fopen_cached
+	(char *);
+int next_ull
+	(char **, unsigned long long *);
+int next_ull_fields
+	(char **, unsigned long long [], int);
+int next_word
+	(char **, char *, int);
+unsigned long long field_ull
+	(char *);
+int split_ull_fields
+	(char *, unsigned long long [], int);
 unsigned long long get_per_cpu_interval
 	(struct stats_cpu *, struct stats_cpu *);
+void invalidate_cached_files
+	(void);
+void open_cached_file
+	(char *);
 __nr_t read_stat_cpu
 	(struct stats_cpu *, __nr_t);
 __nr_t read_stat_irq
@@ -712,6 +754,8 @@ __nr_t read_meminfo
 	(struct stats_memory *);
 void read_uptime
 	(unsigned long long *);
+void read_uptime_us
+	(unsigned long long *, unsigned int *);
 #ifdef SOURCE_SADC
 void oct2chr
 	(char *);
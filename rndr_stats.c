@@ -23,9 +23,11 @@
 #include <string.h>
 #include <stdarg.h>
 
-#include "sa.h"
+#include "sadf.h"
 #include "ioconf.h"
 #include "rndr_stats.h"
+#include "sa_out.h"
+#include "sa_col.h"
 
 #ifdef USE_NLS
 #include <locale.h>
@@ -39,6 +41,7 @@ char *seps[] =  {"\t", ";"};
 
 extern unsigned int flags;
 extern unsigned int dm_major;
+extern unsigned int format;
 
 /*
  ***************************************************************************
@@ -81,6 +84,86 @@ static Cons *cons(tcons t, ...)
 	return(&c);
 }
 
+/*
+ ***************************************************************************
+ * render_col():
+ *
+ * given:    rflags - PT_.... rendering flags
+ *	     pptxt - printf-format text required for ppc output
+ *	     dbtxt - printf-format text required for db output (may be null)
+ *	     mid - pptxt/dbtxt format args as a Cons.
+ *	     lluval - integer value (PT_USEINT must be set)
+ *	     dval  - double value (used unless PT_USEINT is set)
+ *	     sval - string value (PT_USESTR must be set)
+ *
+ * does:     save the value in its column (see sa_col.c). The item is the
+ *	     dbtxt of current line, and the field name is the part of pptxt
+ *	     following the tab.
+ *
+ * return:   void.
+ ***************************************************************************
+ */
+static void render_col(int rflags, const char *pptxt, const char *dbtxt,
+		       Cons *mid, unsigned long long lluval, double dval,
+		       char *sval)
+{
+	static int newline = 1;
+	static char item[COL_ITEM_LEN], fname[COL_ITEM_LEN];
+	const char *field;
+	unsigned int i;
+
+	/* Start a new line? */
+	if (newline) {
+		item[0] = '\0';
+	}
+	newline = rflags & PT_NEWLIN;
+
+	if (dbtxt) {
+		if (mid) {
+			switch(mid->t) {
+			case iv:
+				snprintf(item, sizeof(item), dbtxt, mid->a.i, mid->b.i);
+				break;
+			case sv:
+				snprintf(item, sizeof(item), dbtxt, mid->a.s, mid->b.s);
+				break;
+			}
+		}
+		else {
+			strncpy(item, dbtxt, sizeof(item) - 1);
+			item[sizeof(item) - 1] = '\0';
+		}
+	}
+
+	if ((field = strchr(pptxt, '\t')) != NULL) {
+		field++;
+	}
+	else {
+		field = pptxt;
+	}
+	if (strstr(field, "%%")) {
+		/* pptxt is a printf format: Unescape '%' characters */
+		for (i = 0; *field && (i < sizeof(fname) - 1); field++) {
+			fname[i++] = *field;
+			if ((*field == '%') && (*(field + 1) == '%')) {
+				field++;
+			}
+		}
+		fname[i] = '\0';
+		field = fname;
+	}
+
+	if (rflags & PT_USEINT) {
+		col_save_value(COL_TYPE_U64, item, field, lluval, DNOVAL, NULL);
+	}
+	else if (rflags & PT_USESTR) {
+		col_save_value(COL_TYPE_STR, item, field, NOVAL, DNOVAL, sval);
+	}
+	else {
+		col_save_value(COL_TYPE_DOUBLE, item, field, NOVAL, dval, NULL);
+	}
+}
+
 /*
  ***************************************************************************
  * render():
@@ -97,6 +180,7 @@ static Cons *cons(tcons t, ...)
  *
  * does:     print [pre<sep>]([dbtxt,arg,arg<sep>]|[pptxt,arg,arg<sep>]) \
  *                     (luval|dval)(<sep>|\n)
+ *	     to the output buffer (see sa_out.c).
  *
  * return:   void.
  ***************************************************************************
@@ -108,9 +192,15 @@ static void render(int isdb, char *pre, int rflags, const char *pptxt,
 	static int newline = 1;
 	const char *txt[]  = {pptxt, dbtxt};
 
+	if (format == F_COL_OUTPUT) {
+		/* Columnar output: No text to display */
+		render_col(rflags, pptxt, dbtxt, mid, lluval, dval, sval);
+		return;
+	}
+
 	/* Start a new line? */
 	if (newline && !DISPLAY_HORIZONTALLY(flags)) {
-		printf("%s", pre);
+		out_puts(pre);
 	}
 
 	/* Terminate this one ? ppc always gets a newline */
@@ -119,38 +209,39 @@ static void render(int isdb, char *pre, int rflags, const char *pptxt,
 	if (txt[isdb]) {
 		/* pp/dbtxt? */
 
-		printf("%s", seps[isdb]);	/* Only if something actually gets printed */
+		out_puts(seps[isdb]);	/* Only if something actually gets printed */
 
 		if (mid) {
 			/* Got format args? */
 			switch(mid->t) {
 			case iv:
-				printf(txt[isdb], mid->a.i, mid->b.i);
+				out_printf(txt[isdb], mid->a.i, mid->b.i);
 				break;
 			case sv:
-				printf(txt[isdb], mid->a.s, mid->b.s);
+				out_printf(txt[isdb], mid->a.s, mid->b.s);
 				break;
 			}
 		}
 		else {
-			printf("%s", txt[isdb]);
+			out_puts(txt[isdb]);
 		}
 	}
 
+	out_puts(seps[isdb]);
 	if (rflags & PT_USEINT) {
-		printf("%s%llu", seps[isdb], lluval);
+		out_ull(lluval);
 	}
 	else if (rflags & PT_USESTR) {
-		printf("%s%s", seps[isdb], sval);
+		out_puts(sval);
 	}
 	else if (rflags & PT_USERND) {
-		printf("%s%.0f", seps[isdb], dval);
+		out_fixed(dval, 0);
 	}
 	else {
-		printf("%s%.2f", seps[isdb], dval);
+		out_fixed(dval, 2);
 	}
 	if (newline) {
-		printf("\n");
+		out_puts("\n");
 	}
 }
 
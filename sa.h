@@ -7,6 +7,7 @@
 #define _SA_H
 
 #include <stdio.h>
+#include <pthread.h>
 
 #include "common.h"
 #include "rd_stats.h"
@@ -109,6 +110,12 @@
 #define S_F_SVG_SHOW_INFO	0x00800000
 #define S_F_HUMAN_READ		0x01000000
 #define S_F_ZERO_OMIT		0x02000000
+#define S_F_SA_INDEX		0x04000000
+#define S_F_DELTA_FORMAT	0x08000000
+#define S_F_SHM			0x10000000
+#define S_F_SOCKET		0x20000000
+#define S_F_MSEC_TIME		0x40000000
+#define S_F_SUMMARY		0x80000000
 
 #define WANT_SINCE_BOOT(m)		(((m) & S_F_SINCE_BOOT)   == S_F_SINCE_BOOT)
 #define WANT_SA_ROTAT(m)		(((m) & S_F_SA_ROTAT)     == S_F_SA_ROTAT)
@@ -137,6 +144,13 @@
 #define SET_CANVAS_HEIGHT(m)		(((m) & S_F_SVG_HEIGHT) == S_F_SVG_HEIGHT)
 #define PACK_VIEWS(m)			(((m) & S_F_SVG_PACKED) == S_F_SVG_PACKED)
 #define DISPLAY_HUMAN_READ(m)		(((m) & S_F_HUMAN_READ) == S_F_HUMAN_READ)
+#define WANT_SA_INDEX(m)		(((m) & S_F_SA_INDEX)   == S_F_SA_INDEX)
+#define WANT_DELTA_FORMAT(m)		(((m) & S_F_DELTA_FORMAT) == S_F_DELTA_FORMAT)
+#define USE_SHM(m)			(((m) & S_F_SHM)          == S_F_SHM)
+#define USE_SOCKET(m)			(((m) & S_F_SOCKET)       == S_F_SOCKET)
+#define PRINT_MSEC_TIME(m)		(((m) & S_F_MSEC_TIME)    == S_F_MSEC_TIME)
+#define WANT_SUMMARY(m)			(((m) & S_F_SUMMARY)      == S_F_SUMMARY)
+#define IS_KEYFRAME(m)			(((m) & IDX_E_KEYFRAME)   == IDX_E_KEYFRAME)
 
 #define AO_F_NULL		0x00000000
 
@@ -221,6 +235,7 @@
 #define K_DEBUG		"debug"
 #define K_HEIGHT	"height="
 #define K_PACKED	"packed"
+#define K_POINTS	"points="
 
 /* Groups of activities */
 #define G_DEFAULT	0x00
@@ -234,6 +249,12 @@
 /* sadc program */
 #define SADC		"sadc"
 
+/*
+ * Min interval between two samples (in milliseconds).
+ * Rates are computed over intervals expressed in 1/100th of a second.
+ */
+#define MIN_INTERVAL	10
+
 /* Time must have the format HH:MM:SS with HH in 24-hour format */
 #define DEF_TMSTART	"08:00:00"
 #define DEF_TMEND	"18:00:00"
@@ -261,6 +282,14 @@
 #define NR_MAX		(65536 * 4096)
 #define NR2_MAX		1024
 
+/*
+ * Number of items saved for an activity in a record where it has not been
+ * sampled (see AO_SPARSE). No statistics follow. DELTA_NOT_SAMPLED is saved
+ * instead in delta-encoded records.
+ */
+#define NR_NOT_SAMPLED		-1
+#define DELTA_NOT_SAMPLED	(NR_MAX + 1)
+
 /* Maximum number of args that can be passed to sadc */
 #define MAX_ARGV_NR	32
 
@@ -275,6 +304,8 @@
 #define C_SAR			0
 #define C_SADF			1
 #define ALL_ACTIVITIES		~0U
+/* Display every output saved in sar's track list (see struct sar_track) */
+#define ALL_TRACKS		0U
 #define EXIT_IF_NOT_FOUND	1
 #define RESUME_IF_NOT_FOUND	0
 
@@ -391,6 +422,14 @@ struct svg_hdr_parm {
 #define FORMAT_MAGIC	0x2175
 #define FORMAT_MAGIC_SWAPPED	(((FORMAT_MAGIC << 8) | (FORMAT_MAGIC >> 8)) & 0xffff)
 
+/*
+ * Format magic number of datafiles whose statistics records are
+ * delta-encoded (sadc option -z). Apart from the contents of statistics
+ * records, their format is the same as that of FORMAT_MAGIC datafiles.
+ */
+#define FORMAT_MAGIC_DELTA		0x21d5
+#define FORMAT_MAGIC_DELTA_SWAPPED	(((FORMAT_MAGIC_DELTA << 8) | (FORMAT_MAGIC_DELTA >> 8)) & 0xffff)
+
 /* Previous datafile format magic numbers used by older sysstat versions */
 #define FORMAT_MAGIC_2171		0x2171
 #define FORMAT_MAGIC_2171_SWAPPED	(((FORMAT_MAGIC_2171 << 8) | (FORMAT_MAGIC_2171 >> 8)) & 0xffff)
@@ -598,6 +637,12 @@ struct file_activity {
  * a comment.
  */
 #define R_COMMENT	4
+/*
+ * R_SUMMARY means that this is a special record containing
+ * aggregated statistics (see struct summary_header below).
+ * Such records are skipped by read_record_hdr().
+ */
+#define R_SUMMARY	5
 
 /* Maximum length of a comment */
 #define MAX_COMMENT_LEN	64
@@ -612,6 +657,15 @@ struct record_header {
 	 * Timestamp (number of seconds since the epoch).
 	 */
 	unsigned long long ust_time;
+	/*
+	 * Sub-centisecond part of machine uptime, in microseconds (0-9999).
+	 * Zero in records saved by older sysstat versions.
+	 */
+	unsigned int uptime_us;
+	/*
+	 * Millisecond part of timestamp (0-999).
+	 */
+	unsigned int ust_msec;
 	/*
 	 * Record type: R_STATS, R_RESTART,...
 	 */
@@ -629,7 +683,347 @@ struct record_header {
 #define MAX_RECORD_HEADER_SIZE	512	/* Used for sanity check */
 #define RECORD_HEADER_ULL_NR	2	/* Nr of unsigned long long in record_header structure */
 #define RECORD_HEADER_UL_NR	0	/* Nr of unsigned long in record_header structure */
-#define RECORD_HEADER_U_NR	0	/* Nr of unsigned int in record_header structure */
+#define RECORD_HEADER_U_NR	2	/* Nr of unsigned int in record_header structure */
+
+/*
+ ***************************************************************************
+ * Delta-encoded statistics records.
+ * In a FORMAT_MAGIC_DELTA datafile, the header of a statistics record
+ * (R_STATS) is followed by a byte indicating whether the record is a
+ * keyframe or not. Then for each activity in file come:
+ * - the number of items (only if the activity has a count function or is
+ *   not sampled in every record),
+ * - the size of the encoded structures,
+ * - the encoded structures.
+ * Numbers are saved as variable-length integers (7 bits per byte, least
+ * significant bits first). Each field of a structure (as described by its
+ * types_nr[] array) is saved as the zigzag-encoded difference with the
+ * same field of the same structure in the previous statistics record, or
+ * with 0 if the record is a keyframe. Remaining bytes in structure (eg.
+ * device names) follow, preceded by a byte equal to 0 if they are the same
+ * as in the previous record, or 1 otherwise.
+ * An activity that has not been sampled in a record is saved with
+ * DELTA_NOT_SAMPLED items and no structures. Its structures are then encoded
+ * against those of the last record where it was sampled, unless a keyframe
+ * has been saved in between.
+ ***************************************************************************
+ */
+
+#define DELTA_FRAME		0
+#define DELTA_KEYFRAME		1
+
+/* A keyframe is saved every DELTA_KEYFRAME_NR statistics records */
+#define DELTA_KEYFRAME_NR	60
+
+/* Maximum size of a delta-encoded structure */
+#define DELTA_MAX_SIZE(m)	(2 * (m) + 1)
+
+/* Maximum size of a variable-length integer */
+#define VARINT_MAX_SIZE		10
+
+/* Structures saved in previous statistics record for a given activity */
+struct sa_delta {
+	char *buf;
+	/* Size of buffer (in bytes) */
+	size_t size;
+	/* Number of bytes used in buffer */
+	size_t len;
+	/* Number of structures saved in buffer */
+	int nr;
+};
+
+/*
+ * Position in datafile saved before reading the same records again, with
+ * the decoding state of a delta-encoded file (see sa_save_pos()).
+ */
+struct sa_fpos {
+	off_t pos;
+	/* TRUE if structures in @dlt can be used to decode next record */
+	int dlt_valid;
+	struct sa_delta dlt[NR_ACT];
+};
+
+/*
+ ***************************************************************************
+ * Record index.
+ * sadc may maintain an index of the records saved in a daily data file
+ * (option -I). This index is saved in a separate file whose name is that
+ * of the data file followed by INDEX_SUFFIX. It is made of a header
+ * followed by one entry per record (statistics, restart or comment).
+ * Index files are always written with the endianness of the machine, and
+ * use no "long" types so that their layout doesn't depend on architecture.
+ ***************************************************************************
+ */
+
+#define INDEX_SUFFIX	".idx"
+#define INDEX_MAGIC	0x1d8a
+
+/*
+ * Index flags.
+ * IDX_F_VALID: Index is in sync with data file. Cleared by sadc when a
+ * record has been appended to the data file without being indexed.
+ * IDX_F_MONOTONIC: Records have been saved in chronological order.
+ */
+#define IDX_F_VALID	0x01
+#define IDX_F_MONOTONIC	0x02
+
+/*
+ * Index entry flags.
+ * IDX_E_KEYFRAME: Statistics record can be read without knowing the
+ * contents of the previous one (always true unless the datafile is
+ * delta-encoded).
+ */
+#define IDX_E_KEYFRAME	0x01
+
+#define INDEX_IS_VALID(m)	(((m) & IDX_F_VALID)     == IDX_F_VALID)
+#define INDEX_IS_MONOTONIC(m)	(((m) & IDX_F_MONOTONIC) == IDX_F_MONOTONIC)
+
+/* Header structure for index file */
+struct index_header {
+	/*
+	 * Timestamp of the data file (value of its @sa_ust_time field).
+	 * Used to make sure the index belongs to the data file.
+	 */
+	unsigned long long sa_ust_time;
+	/*
+	 * Offset in data file of the first record.
+	 */
+	unsigned long long data_offset;
+	/*
+	 * Set to SYSSTAT_MAGIC and INDEX_MAGIC.
+	 */
+	unsigned short sysstat_magic;
+	unsigned short index_magic;
+	/*
+	 * Size of an index entry (size of index_entry structure).
+	 */
+	unsigned int entry_size;
+	/*
+	 * IDX_F_VALID, IDX_F_MONOTONIC...
+	 */
+	unsigned int flags;
+	unsigned int reserved;
+};
+
+#define INDEX_HEADER_SIZE	(sizeof(struct index_header))
+
+/* Structure for every index entry */
+struct index_entry {
+	/*
+	 * Timestamp of the record (number of seconds since the epoch).
+	 */
+	unsigned long long ust_time;
+	/*
+	 * Offset of the record header in data file.
+	 */
+	unsigned long long offset;
+	/*
+	 * Total size of the record in data file.
+	 */
+	unsigned int size;
+	/*
+	 * Number of CPU given by the last RESTART record found in data file
+	 * up to (and including) current record, or 0 if there was none.
+	 */
+	int cpu_nr;
+	/*
+	 * Record type: R_STATS, R_RESTART or R_COMMENT.
+	 */
+	unsigned int record_type;
+	/*
+	 * IDX_E_KEYFRAME...
+	 */
+	unsigned int flags;
+};
+
+#define INDEX_ENTRY_SIZE	(sizeof(struct index_entry))
+
+/*
+ ***************************************************************************
+ * Summary records.
+ * sadc may save summary records in a daily data file (option --summary).
+ * A summary record is saved right after each statistics record that is
+ * the first one of a new hour, or the last one saved in the file before
+ * it is rotated (boundary record), and contains the gauges of activities
+ * flagged AO_GAUGE aggregated over the statistics records saved by the
+ * same sadc process since the previous boundary record
+ * (excluded) up to current one (included). The first statistics record
+ * saved by a sadc process in a file (or after another process has written
+ * to it) is also a boundary record, with no previous one. Boundary records
+ * are always saved as keyframes in a delta-encoded data file.
+ * A summary record is made of a record header (whose type is R_SUMMARY)
+ * followed by a summary_header structure, then for each activity a
+ * summary_act structure, a copy of the @nr item structures of the
+ * boundary record, the number of values aggregated for each item, and
+ * the sum, min and max values of each numeric field of each item.
+ * Aggregated values are unsigned long long integers, and are saved with
+ * the endianness of the machine, like the rest of the data file.
+ * Summary records are only used by sadf --rollup. sar doesn't use them to
+ * display average values, since those of gauges are computed by each
+ * activity's display function from the records it displays.
+ ***************************************************************************
+ */
+
+/* Duration covered by a summary record (in seconds) */
+#define SUMMARY_SPAN	3600
+
+/* Header structure for summary record */
+struct summary_header {
+	/*
+	 * Size of the data following this structure.
+	 */
+	unsigned long long size;
+	/*
+	 * Offset in data file of the boundary record followed by this summary.
+	 */
+	unsigned long long offset;
+	/*
+	 * Offset of the previous boundary record saved by the same sadc process
+	 * (i.e. that where aggregated statistics start), or 0.
+	 */
+	unsigned long long prev_offset;
+	/*
+	 * Offset of the next boundary record, or 0. This field is updated
+	 * when the next summary record is saved.
+	 */
+	unsigned long long next_offset;
+	/*
+	 * Number of statistics records aggregated.
+	 */
+	unsigned long long record_nr;
+	/*
+	 * Number of summary_act structures following.
+	 */
+	unsigned long long act_nr;
+};
+
+#define SUMMARY_HEADER_SIZE	(sizeof(struct summary_header))
+#define SUMMARY_HEADER_ULL_NR	6	/* Nr of unsigned long long in summary_header structure */
+#define SUMMARY_HEADER_UL_NR	0	/* Nr of unsigned long in summary_header structure */
+#define SUMMARY_HEADER_U_NR	0	/* Nr of [unsigned] int in summary_header structure */
+
+/* Structure preceding the aggregated statistics of an activity */
+struct summary_act {
+	/*
+	 * Activity identification.
+	 */
+	unsigned int id;
+	/*
+	 * Number of items.
+	 */
+	unsigned int nr;
+	/*
+	 * Size of an item structure.
+	 */
+	unsigned int size;
+	/*
+	 * Number of numeric fields in an item structure.
+	 */
+	unsigned int nf;
+};
+
+#define SUMMARY_ACT_SIZE	(sizeof(struct summary_act))
+#define SUMMARY_ACT_ULL_NR	0	/* Nr of unsigned long long in summary_act structure */
+#define SUMMARY_ACT_UL_NR	0	/* Nr of unsigned long in summary_act structure */
+#define SUMMARY_ACT_U_NR	4	/* Nr of [unsigned] int in summary_act structure */
+
+/*
+ * Gauges of an activity aggregated over a set of statistics records.
+ * Entries match the items of the last record aggregated.
+ */
+struct rollup_gauges {
+	/* Copy of the items, used to identify them in next record */
+	void *items;
+	unsigned long long *min;
+	unsigned long long *max;
+	unsigned long long *sum;
+	/* Number of values aggregated for each item */
+	unsigned long long *cnt;
+	/* Number of items */
+	int nr;
+	/* Number of items for which space has been allocated */
+	int nr_allocated;
+};
+
+/*
+ ***************************************************************************
+ * Subscription protocol.
+ * sadc may listen on a Unix socket for clients (option --listen). A client
+ * sends a subscription request (struct sa_sub_req) once connected. sadc
+ * answers with a struct sa_sub_ans. If the request has been accepted, the
+ * answer is followed by the same data as those sent on STDOUT (file magic
+ * header, file header, activity list then statistics records), restricted
+ * to the activities requested by the client. A record is sent every
+ * @interval milliseconds. All the clients whose records are due at the same
+ * time share the same reading of system statistics.
+ ***************************************************************************
+ */
+
+#define SA_SUB_MAGIC	0x5ab5
+
+/* Max number of clients connected to sadc */
+#define MAX_SA_CLIENTS	128
+
+/* Status of a subscription request */
+#define SUB_OK			0
+#define SUB_BAD_REQUEST		1
+#define SUB_BAD_INTERVAL	2
+#define SUB_TOO_MANY		3
+
+/* Subscription request */
+struct sa_sub_req {
+	/*
+	 * Set to SA_SUB_MAGIC.
+	 */
+	unsigned int magic;
+	/*
+	 * Interval in milliseconds. Must be a multiple of sadc's interval.
+	 * 0 means that a record should be sent at each sample.
+	 */
+	unsigned int interval;
+	/*
+	 * Number of activities requested (0 means all those collected by sadc),
+	 * followed by their identification values.
+	 */
+	unsigned int act_nr;
+	unsigned int act_id[NR_ACT];
+};
+
+#define SA_SUB_REQ_SIZE	(sizeof(struct sa_sub_req))
+
+/* Answer to a subscription request */
+struct sa_sub_ans {
+	/*
+	 * Set to SA_SUB_MAGIC.
+	 */
+	unsigned int magic;
+	/*
+	 * SUB_OK, SUB_BAD_INTERVAL...
+	 */
+	unsigned int status;
+	/*
+	 * sadc's interval in milliseconds.
+	 */
+	unsigned int interval;
+};
+
+#define SA_SUB_ANS_SIZE	(sizeof(struct sa_sub_ans))
+
+/* A client connected to sadc */
+struct sa_client {
+	int fd;
+	/* Number of bytes of subscription request received so far */
+	unsigned int req_len;
+	/* Number of samples between two records sent to the client */
+	unsigned int ticks;
+	/* TRUE if the header data should be sent again to the client */
+	int new_hdr;
+	/* Sample number when next record is due */
+	unsigned long long next_tick;
+	struct sa_sub_req req;
+	/* Activities sent to the client (indexed by position in act[] array) */
+	unsigned char want[NR_ACT];
+};
 
 
 /*
@@ -685,6 +1079,24 @@ struct record_header {
  * Indicate that this activity may have sub-items.
  */
 #define AO_MATRIX		0x80
+/*
+ * Indicate that reading this activity's statistics may be slow or may
+ * block (e.g. statvfs() on a hung NFS mount). sadc reads them with a worker
+ * thread so that they can't delay the other activities.
+ */
+#define AO_SLOW			0x100
+/*
+ * Indicate that this activity is not sampled in every record (sadc option
+ * -S A_xxx:N). Its statistics are then always preceded by the number of
+ * items in records, which is NR_NOT_SAMPLED when it has not been sampled.
+ */
+#define AO_SPARSE		0x200
+/*
+ * Indicate that this activity's statistics are instantaneous values
+ * (e.g. amount of memory used) and not ever-increasing counters. All their
+ * fields are integers. Used by sadf --rollup to aggregate them.
+ */
+#define AO_GAUGE		0x400
 
 #define IS_COLLECTED(m)		(((m) & AO_COLLECTED)        == AO_COLLECTED)
 #define IS_SELECTED(m)		(((m) & AO_SELECTED)         == AO_SELECTED)
@@ -694,6 +1106,11 @@ struct record_header {
 #define HAS_MULTIPLE_OUTPUTS(m)	(((m) & AO_MULTIPLE_OUTPUTS) == AO_MULTIPLE_OUTPUTS)
 #define ONE_GRAPH_PER_ITEM(m)	(((m) & AO_GRAPH_PER_ITEM)   == AO_GRAPH_PER_ITEM)
 #define IS_MATRIX(m)		(((m) & AO_MATRIX)           == AO_MATRIX)
+#define IS_SLOW(m)		(((m) & AO_SLOW)             == AO_SLOW)
+#define IS_SPARSE(m)		(((m) & AO_SPARSE)           == AO_SPARSE)
+#define IS_GAUGE(m)		(((m) & AO_GAUGE)            == AO_GAUGE)
+/* TRUE if statistics are preceded by the number of items in records */
+#define HAS_NR_VALUE(m)		(HAS_COUNT_FUNCTION(m) || IS_SPARSE(m))
 
 #define _buf0	buf[0]
 #define _nr0	nr[0]
@@ -765,6 +1182,17 @@ struct activity {
 	 * with statistics corresponding to given activity.
 	 */
 	__read_funct_t (*f_read) (struct activity *);
+	/*
+	 * Max time (in milliseconds) sadc waits for statistics read by the
+	 * worker thread of a slow activity (AO_SLOW). The statistics from the
+	 * last reading completed are saved if this time is exceeded.
+	 */
+	int timeout;
+	/*
+	 * Interval at which sadc samples the activity, as a multiple of its
+	 * own interval (option -S A_xxx:N). 0 or 1 means every interval.
+	 */
+	int itv_mult;
 	/*
 	 * This function displays activity statistics onto the screen.
 	 */
@@ -867,6 +1295,20 @@ struct activity {
 	 * The value may be zero for a particular sample if no items have been found.
 	 */
 	__nr_t nr[3];
+	/*
+	 * Set to TRUE if the activity has not been sampled in the record whose
+	 * statistics are in corresponding buffer (@buf: See below). In this
+	 * case, the buffer contains the statistics from the last record where
+	 * it has been sampled.
+	 */
+	int unsampled[3];
+	/*
+	 * Uptime (in 1/100th of a second) of the record where the statistics
+	 * saved in corresponding buffer have been sampled, and its
+	 * sub-centisecond part (in microseconds).
+	 */
+	unsigned long long smp_uptime[3];
+	unsigned int smp_uptime_us[3];
 	/*
 	 * Number of structures allocated in @buf[*]. This number should be greater
 	 * than or equal to @nr[*].
@@ -909,6 +1351,30 @@ struct activity {
 	struct act_bitmap *bitmap;
 };
 
+/*
+ * Worker thread reading the statistics of a slow activity (AO_SLOW).
+ * It reads them in its own copy of the activity structure, then saves
+ * the result of the last reading completed, which sadc copies to the
+ * activity buffer for each sample.
+ */
+struct sa_worker {
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	/* Activity, and copy of it used by the worker thread */
+	struct activity *a;
+	struct activity wa;
+	/* Result of the last reading completed */
+	void *last_buf;
+	__nr_t last_nr;
+	__nr_t last_allocated;
+	/* TRUE when a reading has been requested but hasn't started yet */
+	int request;
+	/* TRUE from the time a reading is requested until it is completed */
+	int busy;
+	/* TRUE once a reading has completed */
+	int ready;
+};
 
 /*
  ***************************************************************************
@@ -1053,6 +1519,40 @@ struct report_format {
 /* Block size used to allocate arrays for graphs data */
 #define CHUNKSIZE	4096
 
+/*
+ * Samples of a graph falling into the same column when option -O points=
+ * is used: First, min, max and last points (line graphs), or area covered
+ * by the rectangles and by their offsets between X coordinates @xs and
+ * @x[3] (bar graphs).
+ */
+struct svg_bucket {
+	unsigned long long x[4];
+	double y[4];
+	double area;
+	double oarea;
+	unsigned long long xs;
+	int restart;
+};
+
+/*
+ * Array of chars where the definition of a graph is saved: Size of the
+ * array and length of the definition (not including the terminating null
+ * byte). The size of the array is doubled each time it is full.
+ * With option -O points=, samples are first saved in an array of @bkt_nr
+ * columns (buckets) of @bkt_width seconds each. The graph definition is
+ * then created from these columns when the graph is drawn.
+ */
+struct svg_data {
+	int size;
+	int len;
+	struct svg_bucket *bkt;
+	int bkt_nr;
+	int bkt_size;
+	unsigned long long bkt_width;
+	int bar;
+	int dp;
+};
+
 /* Maximum number of views on a single row */
 #define MAX_VIEWS_ON_A_ROW	6
 
@@ -1097,6 +1597,67 @@ struct tstamp {
 	int use;
 };
 
+/* Structure used to read a system activity data file mapped into memory */
+struct sa_mmap {
+	/*
+	 * Descriptor of mapped file (-1 if no file is mapped).
+	 */
+	int fd;
+	/*
+	 * Start address of the mapping.
+	 */
+	char *addr;
+	/*
+	 * Size of the mapping (size of the file when it was last mapped).
+	 */
+	size_t size;
+	/*
+	 * Current position in file.
+	 */
+	size_t pos;
+};
+
+/*
+ * Maximum number of outputs that sar may display when reading a file:
+ * One per activity, and up to 8 for activities with multiple outputs.
+ */
+#define MAX_NR_TRACKS	(NR_ACT * 8)
+
+/*
+ * Structure used by sar to display all the selected activities while
+ * reading a data file only once. Each output (an activity, or one of the
+ * outputs of an activity with multiple outputs) is rendered into its own
+ * temporary file, and temporary files are then copied to stdout in the
+ * same order as if activities had been displayed one after the other.
+ */
+struct sar_track {
+	/*
+	 * Position of activity in act[] array.
+	 */
+	int p;
+	/*
+	 * Output flags (opt_flags) to use for this output.
+	 */
+	unsigned int opt_flags;
+	/*
+	 * Number of lines to add for each sample displayed when a bitmap
+	 * is used (0 otherwise).
+	 */
+	int inc;
+	/*
+	 * TRUE if a header line must be printed for this output.
+	 */
+	int dis;
+	/*
+	 * Number of lines already displayed for this output.
+	 */
+	unsigned long lines;
+	/*
+	 * Temporary file where output is saved.
+	 */
+	FILE *fp;
+};
+
 
 /*
  ***************************************************************************
@@ -1211,20 +1772,44 @@ __read_funct_t wrap_read_softnet
 	(struct activity *);
 
 /* Other functions */
+void aggregate_gauges
+	(struct activity *, struct rollup_gauges [], void *, int);
+void allocate_rollup_gauges
+	(struct activity *, struct rollup_gauges *, int);
 int check_alt_sa_dir
 	(char *, int, int);
+void copy_delta
+	(struct sa_delta *, struct sa_delta *);
+int decode_delta_struct
+	(char *, char *, unsigned int [], int, int, unsigned char *, size_t);
+size_t encode_delta_struct
+	(unsigned char *, char *, char *, unsigned int [], int);
 void enum_version_nr
 	(struct file_magic *);
+void free_rollup_gauges
+	(struct rollup_gauges [][2]);
 int get_activity_nr
 	(struct activity * [], unsigned int, int);
 int get_activity_position
 	(struct activity * [], unsigned int, int);
+char *get_field_address
+	(struct activity *, char *, int, int *, int *);
+unsigned long long get_field_value
+	(struct activity *, char *, int);
+int get_varint
+	(unsigned char *, size_t, unsigned long long *);
 void set_default_file
 	(char *, int, int);
 void handle_invalid_sa_file
 	(int, struct file_magic *, char *, int);
 void print_collect_error
 	(void);
+int put_varint
+	(unsigned char *, unsigned long long);
+int search_rollup_item
+	(struct activity *, struct rollup_gauges *, char *, int);
+void set_field_value
+	(struct activity *, char *, int, unsigned long long);
 
 #ifndef SOURCE_SADC
 void allocate_bitmaps
@@ -1256,12 +1841,20 @@ char *get_devname
 	(unsigned int, unsigned int, int);
 void get_file_timestamp_struct
 	(unsigned int, struct tm *, struct file_header *);
+int get_index_entry_time
+	(int, struct index_entry *, unsigned int, struct file_header *, int, int, struct tm *);
 unsigned long long get_global_cpu_statistics
 	(struct activity *, int, int, unsigned int, unsigned char []);
 void get_global_soft_statistics
 	(struct activity *, int, int, unsigned int, unsigned char []);
+unsigned long long get_act_itv_value
+	(struct activity *, int, int, unsigned long long);
 void get_itv_value
 	(struct record_header *, struct record_header *, unsigned long long *);
+unsigned long long get_uptime_interval
+	(unsigned long long, unsigned int, unsigned long long, unsigned int);
+void invalidate_delta_state
+	(void);
 int next_slice
 	(unsigned long long, unsigned long long, int, long);
 int parse_sar_opt
@@ -1287,30 +1880,66 @@ int print_special_record
 	 int, int, struct tm *, struct tm *, char *, int, struct file_magic *,
 	 struct file_header *, struct activity * [], struct report_format *, int, int);
 void read_file_stat_bunch
-	(struct activity * [], int, int, int, struct file_activity *, int, int,
+	(struct activity * [], int, struct record_header *, int, int,
+	 struct file_activity *, int, int, char *, struct file_magic *);
+void read_delta_structures
+	(struct activity *, struct sa_delta *, int, int, __nr_t, size_t, int, int,
 	 char *, struct file_magic *);
+int read_index_entry
+	(int, long, struct index_entry *);
 __nr_t read_nr_value
 	(int, char *, struct file_magic *, int, int, int);
+int read_any_record_hdr
+	(int, void *, struct record_header *, struct file_header *, int, int);
 int read_record_hdr
 	(int, void *, struct record_header *, struct file_header *, int, int);
+int read_summary_hdr
+	(int, struct summary_header *, int, int);
+unsigned long long read_varint_value
+	(int, char *, struct file_magic *, unsigned long long);
 void reallocate_all_buffers
 	(struct activity *, __nr_t);
 void remap_struct
 	(unsigned int [], unsigned int [], void *, unsigned int);
+void reset_delta_state
+	(int);
 void replace_nonprintable_char
 	(int, char *);
+void set_sampling_state
+	(struct activity *, int, struct record_header *, int);
+int skip_file_stat_bunch
+	(int, int, struct file_activity *, int, int, char *, struct file_magic *, int *);
 int sa_fread
 	(int, void *, size_t, int);
+void sa_close
+	(int);
 int sa_get_record_timestamp_struct
 	(unsigned int, struct record_header *, struct tm *, struct tm *);
+off_t sa_lseek
+	(int, off_t, int);
+off_t sa_restore_pos
+	(int, struct sa_fpos *);
+off_t sa_save_pos
+	(int, struct sa_fpos *);
+void sa_mmap_file
+	(int);
+ssize_t sa_mread
+	(int, void *, size_t);
+void sa_munmap_file
+	(void);
 int sa_open_read_magic
 	(int *, char *, struct file_magic *, int, int *, int);
+void sa_seek_index
+	(int, char *, unsigned int, struct tstamp *, struct activity * [], struct file_header *,
+	 int, int);
 void select_all_activities
 	(struct activity * []);
 void select_default_activity
 	(struct activity * []);
 void set_bitmap
 	(unsigned char [], unsigned char, unsigned int);
+void set_cpu_nr
+	(struct activity * [], struct file_header *, __nr_t);
 void set_hdr_rectime
 	(unsigned int, struct tm *, struct file_header *);
 void set_record_timestamp_string
@@ -0,0 +1,613 @@
+/*
+ * sa_col.c: Columnar binary output format for sadf.
+ * (C) 2026 by the sysstat developers
+ *
+ ***************************************************************************
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published  by  the *
+ * Free Software Foundation; either version 2 of the License, or (at  your *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it  will  be  useful,  but *
+ * WITHOUT ANY WARRANTY; without the implied warranty  of  MERCHANTABILITY *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License *
+ * for more details.                                                       *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA              *
+ ***************************************************************************
+ *
+ * Values are those displayed by "sadf -d" (see render() in rndr_stats.c).
+ * They are saved in columns, one for each field of each item of each
+ * activity, and written to standard output every COL_BLOCK_ROWS records.
+ * See sa_col.h for the layout of the output.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sadf.h"
+#include "sa_col.h"
+
+/* Output buffer, and buffer where the payload of a column is encoded */
+struct col_buffer col_out = {NULL, 0, 0};
+struct col_buffer col_tmp = {NULL, 0, 0};
+
+/* Columns saved so far */
+struct col_column *col_list = NULL;
+int col_nr = 0;
+int col_allocated = 0;
+
+/* Hash table used to find columns (index of first column, or -1) */
+int col_hash[COL_HASH_SIZE];
+
+/* Timestamps (in ms) and intervals (in 1/100th of a second) of the rows */
+unsigned long long col_ts[COL_BLOCK_ROWS];
+unsigned long long col_itv[COL_BLOCK_ROWS];
+
+/* Number of rows in current block */
+int col_rows = 0;
+
+/* Activity being rendered, and last column which got a value in current row */
+unsigned int col_act_id = 0;
+int col_last = -1;
+
+/*
+ ***************************************************************************
+ * Make room for new data in a buffer.
+ *
+ * IN:
+ * @b		Buffer.
+ * @len		Number of bytes needed.
+ *
+ * RETURNS:
+ * Pointer where the data can be written.
+ ***************************************************************************
+ */
+unsigned char *col_room(struct col_buffer *b, size_t len)
+{
+	unsigned char *p;
+
+	if (b->len + len > b->size) {
+		do {
+			b->size = b->size ? b->size * 2 : 65536;
+		}
+		while (b->len + len > b->size);
+		SREALLOC(b->data, unsigned char, b->size);
+	}
+	p = b->data + b->len;
+	b->len += len;
+
+	return p;
+}
+
+/*
+ ***************************************************************************
+ * Append an unsigned LEB128 varint to a buffer.
+ *
+ * IN:
+ * @b		Buffer.
+ * @v		Value to append.
+ ***************************************************************************
+ */
+void col_put_varint(struct col_buffer *b, unsigned long long v)
+{
+	unsigned char *p = col_room(b, 10);
+	int n = 0;
+
+	while (v >= 0x80) {
+		p[n++] = (unsigned char) (v | 0x80);
+		v >>= 7;
+	}
+	p[n++] = (unsigned char) v;
+	b->len -= 10 - n;
+}
+
+/*
+ ***************************************************************************
+ * Append a 64-bit value to a buffer, in little-endian byte order.
+ *
+ * IN:
+ * @b		Buffer.
+ * @v		Value to append.
+ ***************************************************************************
+ */
+void col_put_u64(struct col_buffer *b, unsigned long long v)
+{
+	unsigned char *p = col_room(b, 8);
+	int i;
+
+	for (i = 0; i < 8; i++, v >>= 8) {
+		p[i] = (unsigned char) v;
+	}
+}
+
+/*
+ ***************************************************************************
+ * Append a string (varint length followed by its characters) to a buffer.
+ *
+ * IN:
+ * @b		Buffer.
+ * @s		String to append.
+ ***************************************************************************
+ */
+void col_put_str(struct col_buffer *b, const char *s)
+{
+	size_t len = strlen(s);
+
+	col_put_varint(b, len);
+	memcpy(col_room(b, len), s, len);
+}
+
+/*
+ ***************************************************************************
+ * Append data to a buffer.
+ *
+ * IN:
+ * @b		Buffer.
+ * @data	Data to append.
+ * @len		Length of data.
+ ***************************************************************************
+ */
+void col_put_data(struct col_buffer *b, const void *data, size_t len)
+{
+	if (len) {
+		memcpy(col_room(b, len), data, len);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Write the output buffer to standard output.
+ ***************************************************************************
+ */
+void col_write(void)
+{
+	fwrite(col_out.data, 1, col_out.len, stdout);
+	col_out.len = 0;
+}
+
+/*
+ ***************************************************************************
+ * Compute hash value of a column.
+ *
+ * IN:
+ * @act_id	Activity id.
+ * @item	Item name.
+ * @field	Field name.
+ *
+ * RETURNS:
+ * Index in hash table.
+ ***************************************************************************
+ */
+unsigned int col_hash_value(unsigned int act_id, const char *item, const char *field)
+{
+	unsigned int h = 2166136261U ^ act_id;
+
+	for (; *item; item++) {
+		h = (h ^ (unsigned char) *item) * 16777619U;
+	}
+	h *= 16777619U;
+	for (; *field; field++) {
+		h = (h ^ (unsigned char) *field) * 16777619U;
+	}
+
+	return h % COL_HASH_SIZE;
+}
+
+/*
+ ***************************************************************************
+ * Tell if a column is the one identified by an activity, an item, a field
+ * and a type.
+ *
+ * IN:
+ * @c		Column.
+ * @type	Column type.
+ * @item	Item name.
+ * @field	Field name.
+ *
+ * RETURNS:
+ * TRUE if column matches.
+ ***************************************************************************
+ */
+int col_match(struct col_column *c, int type, const char *item, const char *field)
+{
+	return ((c->act_id == col_act_id) && (c->type == type) &&
+		!strcmp(c->field, field) && !strcmp(c->item, item));
+}
+
+/*
+ ***************************************************************************
+ * Find the column identified by current activity, an item, a field and a
+ * type. The column is created if it doesn't exist.
+ * Items and fields are normally displayed in the same order for each
+ * record, so the column following the last one found is tried first.
+ *
+ * IN:
+ * @type	Column type.
+ * @item	Item name.
+ * @field	Field name.
+ *
+ * RETURNS:
+ * Index of the column.
+ ***************************************************************************
+ */
+int col_find(int type, const char *item, const char *field)
+{
+	struct col_column *c;
+	unsigned int h;
+	int i;
+
+	if (col_last >= 0) {
+		i = col_list[col_last].next;
+	}
+	else {
+		i = col_nr ? 0 : -1;
+	}
+	if ((i >= 0) && col_match(&col_list[i], type, item, field))
+		return i;
+
+	h = col_hash_value(col_act_id, item, field);
+	for (i = col_hash[h]; i >= 0; i = col_list[i].hnext) {
+		if (col_match(&col_list[i], type, item, field))
+			return i;
+	}
+
+	/* Create a new column */
+	if (col_nr == col_allocated) {
+		col_allocated = col_allocated ? col_allocated * 2 : 256;
+		SREALLOC(col_list, struct col_column,
+			 sizeof(struct col_column) * col_allocated);
+	}
+	c = &col_list[col_nr];
+	memset(c, 0, sizeof(struct col_column));
+	c->act_id = col_act_id;
+	c->type = type;
+	c->next = -1;
+	if (((c->item = strdup(item)) == NULL) ||
+	    ((c->field = strdup(field)) == NULL)) {
+		perror("strdup");
+		exit(4);
+	}
+	if (type == COL_TYPE_STR) {
+		SREALLOC(c->str, char *, sizeof(char *) * COL_BLOCK_ROWS);
+	}
+	else {
+		SREALLOC(c->val, unsigned long long,
+			 sizeof(unsigned long long) * COL_BLOCK_ROWS);
+	}
+	c->hnext = col_hash[h];
+	col_hash[h] = col_nr;
+
+	return col_nr++;
+}
+
+/*
+ ***************************************************************************
+ * Start a new row, i.e. a new record. The current block is written if it
+ * is full.
+ *
+ * IN:
+ * @rec		Record header of current record.
+ * @itv		Interval of time with preceding record (in 1/100th of a
+ *		second).
+ ***************************************************************************
+ */
+void col_start_row(struct record_header *rec, unsigned long long itv)
+{
+	if (col_rows == COL_BLOCK_ROWS) {
+		col_write_block();
+	}
+	col_ts[col_rows] = rec->ust_time * 1000 + rec->ust_msec;
+	col_itv[col_rows] = itv;
+	col_rows++;
+	col_last = -1;
+}
+
+/*
+ ***************************************************************************
+ * Set the activity whose values will be saved next.
+ *
+ * IN:
+ * @act_id	Activity id.
+ ***************************************************************************
+ */
+void col_set_activity(unsigned int act_id)
+{
+	col_act_id = act_id;
+}
+
+/*
+ ***************************************************************************
+ * Save a value in current row.
+ *
+ * IN:
+ * @type	Type of the value (COL_TYPE_*).
+ * @item	Item name (empty string if the activity has no items).
+ * @field	Field name.
+ * @ullval	Value (COL_TYPE_U64).
+ * @dval	Value (COL_TYPE_DOUBLE).
+ * @sval	Value (COL_TYPE_STR).
+ ***************************************************************************
+ */
+void col_save_value(int type, const char *item, const char *field,
+		    unsigned long long ullval, double dval, const char *sval)
+{
+	struct col_column *c;
+	int i, row = col_rows - 1;
+
+	if (row < 0)
+		return;
+
+	i = col_find(type, item, field);
+	c = &col_list[i];
+	if (col_last >= 0) {
+		col_list[col_last].next = i;
+	}
+	col_last = i;
+
+	if (c->present[row >> 3] & (1 << (row & 0x07))) {
+		/* Value already saved for this row: Keep the last one */
+		if (type == COL_TYPE_STR) {
+			free(c->str[row]);
+		}
+	}
+	else {
+		c->present[row >> 3] |= 1 << (row & 0x07);
+		c->nr++;
+	}
+
+	switch (type) {
+	case COL_TYPE_U64:
+		c->val[row] = ullval;
+		break;
+	case COL_TYPE_DOUBLE:
+		memcpy(&c->val[row], &dval, sizeof(double));
+		break;
+	case COL_TYPE_STR:
+		if ((c->str[row] = strdup(sval ? sval : "")) == NULL) {
+			perror("strdup");
+			exit(4);
+		}
+		break;
+	}
+}
+
+/*
+ ***************************************************************************
+ * Encode the integer values (COL_ENC_DELTA) or the doubles (COL_ENC_XOR)
+ * of a column in the temporary buffer.
+ *
+ * IN:
+ * @val		Values.
+ * @present	Rows which have a value (NULL if all of them do).
+ * @rows	Number of rows.
+ * @enc		Encoding (COL_ENC_DELTA or COL_ENC_XOR).
+ ***************************************************************************
+ */
+void col_encode(unsigned long long *val, unsigned char *present, int rows, int enc)
+{
+	unsigned long long prev = 0, v;
+	unsigned char *p;
+	int i, lead, trail, n;
+
+	for (i = 0; i < rows; i++) {
+		if (present && !(present[i >> 3] & (1 << (i & 0x07))))
+			continue;
+
+		if (enc == COL_ENC_DELTA) {
+			v = val[i] - prev;
+			/* Zigzag encoding: Small negative differences give small numbers */
+			col_put_varint(&col_tmp, (v << 1) ^ ((v >> 63) ? ~0ULL : 0));
+		}
+		else {
+			v = val[i] ^ prev;
+			if (!v) {
+				*col_room(&col_tmp, 1) = 0x80;
+			}
+			else {
+				for (lead = 0; !(v >> (56 - 8 * lead) & 0xff); lead++);
+				for (trail = 0; !(v >> (8 * trail) & 0xff); trail++);
+				n = 8 - lead - trail;
+				p = col_room(&col_tmp, n + 1);
+				*p++ = (unsigned char) ((lead << 4) | trail);
+				for (v >>= 8 * trail; n > 0; n--, v >>= 8) {
+					*p++ = (unsigned char) v;
+				}
+			}
+		}
+		prev = val[i];
+	}
+}
+
+/*
+ ***************************************************************************
+ * Write the values of a column to the output buffer: Encoding, presence
+ * bitmap if needed, payload length and payload.
+ *
+ * IN:
+ * @type	Column type.
+ * @val		Integer and double values (NULL for strings).
+ * @str		String values (NULL for integers and doubles).
+ * @present	Rows which have a value (NULL if all of them do).
+ * @rows	Number of rows.
+ ***************************************************************************
+ */
+void col_write_values(int type, unsigned long long *val, char **str,
+		      unsigned char *present, int rows)
+{
+	int i, first = -1, nr = 0, cst = TRUE;
+
+	col_tmp.len = 0;
+
+	for (i = 0; i < rows; i++) {
+		if (present && !(present[i >> 3] & (1 << (i & 0x07))))
+			continue;
+		nr++;
+		if (first < 0) {
+			first = i;
+		}
+		else if (cst) {
+			cst = str ? !strcmp(str[i], str[first]) : (val[i] == val[first]);
+		}
+	}
+
+	if (cst) {
+		/* All the values are the same */
+		if (str) {
+			col_put_str(&col_tmp, str[first]);
+		}
+		else {
+			col_put_u64(&col_tmp, val[first]);
+		}
+		i = COL_ENC_CONST;
+	}
+	else if (str) {
+		for (i = 0; i < rows; i++) {
+			if (!present || (present[i >> 3] & (1 << (i & 0x07)))) {
+				col_put_str(&col_tmp, str[i]);
+			}
+		}
+		i = COL_ENC_RAW;
+	}
+	else {
+		i = (type == COL_TYPE_U64) ? COL_ENC_DELTA : COL_ENC_XOR;
+		col_encode(val, present, rows, i);
+
+		if (col_tmp.len >= (size_t) nr * 8) {
+			/* Encoding doesn't save anything */
+			col_tmp.len = 0;
+			for (i = 0; i < rows; i++) {
+				if (!present || (present[i >> 3] & (1 << (i & 0x07)))) {
+					col_put_u64(&col_tmp, val[i]);
+				}
+			}
+			i = COL_ENC_RAW;
+		}
+	}
+
+	if (present) {
+		*col_room(&col_out, 1) = (unsigned char) (i | COL_SPARSE);
+		col_put_data(&col_out, present, (rows + 7) >> 3);
+	}
+	else {
+		*col_room(&col_out, 1) = (unsigned char) i;
+	}
+	col_put_varint(&col_out, col_tmp.len);
+	col_put_data(&col_out, col_tmp.data, col_tmp.len);
+}
+
+/*
+ ***************************************************************************
+ * Write current block and start a new one.
+ ***************************************************************************
+ */
+void col_write_block(void)
+{
+	struct col_column *c;
+	int i, j, nr = 0;
+
+	if (!col_rows)
+		return;
+
+	for (i = 0; i < col_nr; i++) {
+		if (col_list[i].nr) {
+			nr++;
+		}
+	}
+
+	col_put_varint(&col_out, col_rows);
+	col_put_varint(&col_out, nr);
+	col_write_values(COL_TYPE_U64, col_ts, NULL, NULL, col_rows);
+	col_write_values(COL_TYPE_U64, col_itv, NULL, NULL, col_rows);
+
+	for (i = 0; i < col_nr; i++) {
+		c = &col_list[i];
+		if (!c->nr)
+			continue;
+
+		col_put_varint(&col_out, c->act_id);
+		col_put_str(&col_out, c->item);
+		col_put_str(&col_out, c->field);
+		*col_room(&col_out, 1) = (unsigned char) c->type;
+		col_write_values(c->type, c->val, c->str,
+				 (c->nr == col_rows) ? NULL : c->present, col_rows);
+
+		if (c->str) {
+			for (j = 0; j < col_rows; j++) {
+				if (c->present[j >> 3] & (1 << (j & 0x07))) {
+					free(c->str[j]);
+				}
+			}
+		}
+		memset(c->present, 0, sizeof(c->present));
+		c->nr = 0;
+	}
+
+	col_write();
+	col_rows = 0;
+	col_last = -1;
+}
+
+/*
+ ***************************************************************************
+ * Write the header of the report (columnar binary format).
+ *
+ * IN:
+ * @parm	Specific parameter (unused here).
+ * @action	Action expected from current function.
+ * @dfile	Name of system activity data file (unused here).
+ * @file_magic	System activity file magic header (unused here).
+ * @file_hdr	System activity file standard header.
+ * @act		Array of activities.
+ * @id_seq	Activity sequence (unused here).
+ * @file_actlst	List of (known or unknown) activities in file (unused here).
+ ***************************************************************************
+ */
+__printf_funct_t print_col_header(void *parm, int action, char *dfile,
+				  struct file_magic *file_magic,
+				  struct file_header *file_hdr,
+				  struct activity *act[], unsigned int id_seq[],
+				  struct file_activity *file_actlst)
+{
+	int i, nr = 0;
+
+	if (action & F_BEGIN) {
+		col_put_data(&col_out, COL_MAGIC, COL_MAGIC_LEN);
+		*col_room(&col_out, 1) = COL_VERSION;
+		col_put_str(&col_out, file_hdr->sa_sysname);
+		col_put_str(&col_out, file_hdr->sa_release);
+		col_put_str(&col_out, file_hdr->sa_nodename);
+		col_put_str(&col_out, file_hdr->sa_machine);
+		col_put_varint(&col_out,
+			       file_hdr->sa_cpu_nr > 1 ? file_hdr->sa_cpu_nr - 1 : 1);
+		col_put_varint(&col_out, file_hdr->sa_ust_time);
+
+		/* Selected activities */
+		for (i = 0; i < NR_ACT; i++) {
+			if (IS_SELECTED(act[i]->options) && (act[i]->nr_ini > 0)) {
+				nr++;
+			}
+		}
+		col_put_varint(&col_out, nr);
+		for (i = 0; i < NR_ACT; i++) {
+			if (IS_SELECTED(act[i]->options) && (act[i]->nr_ini > 0)) {
+				col_put_varint(&col_out, act[i]->id);
+				col_put_str(&col_out, act[i]->name);
+				col_put_str(&col_out, act[i]->hdr_line);
+			}
+		}
+
+		memset(col_hash, 0xff, sizeof(col_hash));
+		col_write();
+	}
+
+	if (action & F_END) {
+		/* Last block, then empty block */
+		col_write_block();
+		col_put_varint(&col_out, 0);
+		col_write();
+	}
+}
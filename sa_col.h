@@ -0,0 +1,118 @@
+/*
+ * sa_col.h: Include file for sadf columnar binary output format.
+ * (C) 2026 by the sysstat developers
+ */
+
+#ifndef _SA_COL_H
+#define _SA_COL_H
+
+#include "sa.h"
+
+/*
+ ***************************************************************************
+ * Definitions for the columnar binary output format (sadf -b).
+ *
+ * The output starts with a header: COL_MAGIC, COL_VERSION (one byte), host
+ * strings (sysname, release, nodename, machine), number of CPU, file time,
+ * then the number of activities followed by the id, name and header line
+ * of each one of them.
+ * Then come blocks of at most COL_BLOCK_ROWS records. Each block starts
+ * with its number of rows and of columns, the timestamps (milliseconds since
+ * the epoch) and the intervals (1/100th of a second) of its records,
+ * then the columns. A column contains the values of one field for one
+ * item of one activity: activity id, item (empty string if the activity
+ * has no items), field name, type, encoding, presence bitmap (only if
+ * COL_SPARSE is set) and payload length, followed by the payload.
+ * A block with 0 rows terminates the output.
+ * Integers are written as unsigned LEB128 varints, strings as a varint
+ * length followed by the characters, fixed size values in little-endian
+ * byte order.
+ ***************************************************************************
+ */
+
+/* Magic string at the beginning of the output */
+#define COL_MAGIC	"SCOL"
+#define COL_MAGIC_LEN	4
+#define COL_VERSION	1
+
+/* Max number of records in a block */
+#define COL_BLOCK_ROWS	1024
+
+/* Number of entries in the hash table used to find columns */
+#define COL_HASH_SIZE	1024
+
+/* Max length of an item name */
+#define COL_ITEM_LEN	128
+
+/* Column types */
+#define COL_TYPE_U64	1
+#define COL_TYPE_DOUBLE	2
+#define COL_TYPE_STR	3
+
+/*
+ * Column encodings.
+ * COL_ENC_CONST:	A single value, the same for all the rows.
+ * COL_ENC_RAW:		Values as they are (8 bytes each, or strings).
+ * COL_ENC_DELTA:	Integers: Difference with previous value, zigzag encoded.
+ * COL_ENC_XOR:		Doubles: XOR with previous value. A control byte gives
+ *			the number of leading (high nibble) and trailing (low
+ *			nibble) zero bytes, then come the remaining bytes.
+ */
+#define COL_ENC_CONST	0
+#define COL_ENC_RAW	1
+#define COL_ENC_DELTA	2
+#define COL_ENC_XOR	3
+
+/* Presence bitmap follows (column has no value for some rows) */
+#define COL_SPARSE	0x80
+
+/*
+ ***************************************************************************
+ * Structures used to save columns.
+ ***************************************************************************
+ */
+
+/* Growing output buffer */
+struct col_buffer {
+	unsigned char *data;
+	size_t len;
+	size_t size;
+};
+
+/* Values of one field for one item of one activity in current block */
+struct col_column {
+	/* Activity id, item and field name identifying the column */
+	unsigned int act_id;
+	char *item;
+	char *field;
+	/* COL_TYPE_* */
+	int type;
+	/* Number of values saved in current block */
+	unsigned int nr;
+	/* Index of the column which followed this one in last row */
+	int next;
+	/* Next column in hash table chain */
+	int hnext;
+	/* Values (doubles are saved as their bits), indexed by row */
+	unsigned long long *val;
+	char **str;
+	/* Rows which have a value */
+	unsigned char present[BITMAP_SIZE(COL_BLOCK_ROWS)];
+};
+
+/*
+ ***************************************************************************
+ * Prototypes for functions used to save columns.
+ ***************************************************************************
+ */
+
+void col_start_row
+	(struct record_header *, unsigned long long);
+void col_set_activity
+	(unsigned int);
+void col_save_value
+	(int, const char *, const char *, unsigned long long, double, const char *);
+void col_write_block
+	(void);
+
+#endif  /* _SA_COL_H */
@@ -31,7 +31,10 @@
 #include <libgen.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <ctype.h>
+#include <signal.h>
+#include <setjmp.h>
 
 #include "version.h"
 #include "sa.h"
@@ -52,6 +55,32 @@ unsigned int hdr_types_nr[] = {FILE_HEADER_ULL_NR, FILE_HEADER_UL_NR, FILE_HEADE
 unsigned int act_types_nr[] = {FILE_ACTIVITY_ULL_NR, FILE_ACTIVITY_UL_NR, FILE_ACTIVITY_U_NR};
 unsigned int rec_types_nr[] = {RECORD_HEADER_ULL_NR, RECORD_HEADER_UL_NR, RECORD_HEADER_U_NR};
 unsigned int nr_types_nr[]  = {0, 0, 1};
+unsigned int sum_types_nr[] = {SUMMARY_HEADER_ULL_NR, SUMMARY_HEADER_UL_NR, SUMMARY_HEADER_U_NR};
+unsigned int sact_types_nr[] = {SUMMARY_ACT_ULL_NR, SUMMARY_ACT_UL_NR, SUMMARY_ACT_U_NR};
+
+#ifndef SOURCE_SADC
+/* System activity data file currently mapped into memory */
+struct sa_mmap sa_map = {-1, NULL, 0, 0};
+
+/*
+ * Used to recover from a SIGBUS raised when a mapped data file has been
+ * truncated while being read.
+ */
+sigjmp_buf sa_map_env;
+volatile sig_atomic_t sa_map_copying = FALSE;
+struct sigaction sa_map_oldact;
+
+/*
+ * Decoding state of a delta-encoded (FORMAT_MAGIC_DELTA) data file:
+ * Structures read from previous statistics record for each activity
+ * (see sa_save_pos() and sa_restore_pos()).
+ */
+int sa_dlt_file = FALSE;
+int sa_dlt_valid = FALSE;
+struct sa_delta sa_dlt[NR_ACT];
+struct sa_delta sa_dlt_in = {NULL, 0, 0, 0};
+struct sa_delta sa_dlt_out = {NULL, 0, 0, 0};
+#endif
 
 /*
  ***************************************************************************
@@ -384,6 +413,477 @@ void enum_version_nr(struct file_magic *fm)
 	fm->sysstat_extraversion = atoi(v) & 0xff;
 }
 
+/*
+ ***************************************************************************
+ * Save a number as a variable-length integer: 7 bits are saved per byte,
+ * least significant bits first. The most significant bit of each byte is
+ * set if more bytes follow.
+ *
+ * IN:
+ * @buf		Buffer where the number will be saved. Should be at least
+ *		VARINT_MAX_SIZE bytes long.
+ * @val		Number to save.
+ *
+ * RETURNS:
+ * Number of bytes saved in buffer.
+ ***************************************************************************
+ */
+int put_varint(unsigned char *buf, unsigned long long val)
+{
+	int n = 0;
+
+	while (val >= 0x80) {
+		buf[n++] = (unsigned char) (val | 0x80);
+		val >>= 7;
+	}
+	buf[n++] = (unsigned char) val;
+
+	return n;
+}
+
+/*
+ ***************************************************************************
+ * Read a variable-length integer saved by put_varint().
+ *
+ * IN:
+ * @buf		Buffer containing the number.
+ * @len		Number of bytes available in buffer.
+ *
+ * OUT:
+ * @val		Number read from buffer.
+ *
+ * RETURNS:
+ * Number of bytes read from buffer, or 0 if buffer doesn't contain a valid
+ * number.
+ ***************************************************************************
+ */
+int get_varint(unsigned char *buf, size_t len, unsigned long long *val)
+{
+	int n = 0, shift = 0;
+
+	*val = 0;
+	while ((n < len) && (n < VARINT_MAX_SIZE)) {
+		*val |= (unsigned long long) (buf[n] & 0x7f) << shift;
+		if (!(buf[n++] & 0x80))
+			return n;
+		shift += 7;
+	}
+
+	return 0;
+}
+
+/*
+ ***************************************************************************
+ * Copy structures saved for delta-encoding or decoding.
+ *
+ * IN:
+ * @src		Structures to copy.
+ *
+ * OUT:
+ * @dest	Copy of the structures.
+ ***************************************************************************
+ */
+void copy_delta(struct sa_delta *dest, struct sa_delta *src)
+{
+	if (src->len > dest->size) {
+		SREALLOC(dest->buf, char, src->len);
+		dest->size = src->len;
+	}
+	if (src->len) {
+		memcpy(dest->buf, src->buf, src->len);
+	}
+	dest->len = src->len;
+	dest->nr  = src->nr;
+}
+
+/*
+ ***************************************************************************
+ * Delta-encode a structure containing statistics: Each field of the
+ * structure is saved as the (zigzag-encoded) difference between its current
+ * value and its previous one. See the description of FORMAT_MAGIC_DELTA
+ * datafiles in sa.h.
+ *
+ * IN:
+ * @out		Buffer where the encoded structure will be saved. Should be
+ *		at least DELTA_MAX_SIZE(@size) bytes long.
+ * @cur		Structure with current statistics.
+ * @prev	Structure with previous statistics. NULL if the structure
+ *		should be encoded as a keyframe.
+ * @types_nr	Number of fields whose type is "long long", "long" and "int"
+ *		composing the structure.
+ * @size	Size of the structure.
+ *
+ * RETURNS:
+ * Number of bytes saved in @out.
+ ***************************************************************************
+ */
+size_t encode_delta_struct(unsigned char *out, char *cur, char *prev,
+			   unsigned int types_nr[], int size)
+{
+	int i, pos = 0;
+	size_t n = 0;
+	uint64_t c64, p64 = 0;
+	uint32_t c32, p32 = 0;
+
+	/* Fields of type "long long" and "long" are 8 bytes wide */
+	for (i = 0; i < types_nr[0] + types_nr[1]; i++, pos += ULL_ALIGNMENT_WIDTH) {
+		memcpy(&c64, cur + pos, 8);
+		if (prev) {
+			memcpy(&p64, prev + pos, 8);
+		}
+		c64 -= p64;
+		n += put_varint(out + n, (c64 << 1) ^ (0 - (c64 >> 63)));
+	}
+
+	/* Fields of type "int" */
+	for (i = 0; i < types_nr[2]; i++, pos += U_ALIGNMENT_WIDTH) {
+		memcpy(&c32, cur + pos, 4);
+		if (prev) {
+			memcpy(&p32, prev + pos, 4);
+		}
+		c32 -= p32;
+		n += put_varint(out + n, (uint32_t) ((c32 << 1) ^ (0 - (c32 >> 31))));
+	}
+
+	/* Remaining bytes (e.g. device or interface name) */
+	if (pos < size) {
+		if (prev && !memcmp(cur + pos, prev + pos, size - pos)) {
+			out[n++] = 0;
+		}
+		else {
+			out[n++] = 1;
+			memcpy(out + n, cur + pos, size - pos);
+			n += size - pos;
+		}
+	}
+
+	return n;
+}
+
+/*
+ ***************************************************************************
+ * Decode a structure encoded by encode_delta_struct().
+ *
+ * IN:
+ * @prev	Structure with previous statistics, as saved in file. NULL if
+ *		the structure has been encoded as a keyframe.
+ * @types_nr	Number of fields whose type is "long long", "long" and "int"
+ *		composing the structure.
+ * @size	Size of the structure.
+ * @swap	TRUE if structures in file don't match current machine's
+ *		endianness.
+ * @in		Buffer containing the encoded structure.
+ * @len		Number of bytes available in buffer.
+ *
+ * OUT:
+ * @cur		Structure with current statistics, as saved in file (i.e.
+ *		with file's endianness).
+ *
+ * RETURNS:
+ * Number of bytes read from @in, or -1 if the buffer doesn't contain a
+ * valid encoded structure.
+ ***************************************************************************
+ */
+int decode_delta_struct(char *cur, char *prev, unsigned int types_nr[], int size,
+			int swap, unsigned char *in, size_t len)
+{
+	int i, k, pos = 0;
+	size_t n = 0;
+	unsigned long long z;
+	uint64_t c64, p64 = 0;
+	uint32_t c32, p32 = 0;
+
+	if (MAP_SIZE(types_nr) > size)
+		return -1;
+
+	for (i = 0; i < types_nr[0] + types_nr[1]; i++, pos += ULL_ALIGNMENT_WIDTH) {
+		if (!(k = get_varint(in + n, len - n, &z)))
+			return -1;
+		n += k;
+		if (prev) {
+			memcpy(&p64, prev + pos, 8);
+			if (swap) {
+				p64 = __builtin_bswap64(p64);
+			}
+		}
+		c64 = p64 + ((z >> 1) ^ (0 - (z & 1)));
+		if (swap) {
+			c64 = __builtin_bswap64(c64);
+		}
+		memcpy(cur + pos, &c64, 8);
+	}
+
+	for (i = 0; i < types_nr[2]; i++, pos += U_ALIGNMENT_WIDTH) {
+		if (!(k = get_varint(in + n, len - n, &z)) || (z > 0xffffffff))
+			return -1;
+		n += k;
+		if (prev) {
+			memcpy(&p32, prev + pos, 4);
+			if (swap) {
+				p32 = __builtin_bswap32(p32);
+			}
+		}
+		c32 = p32 + (((uint32_t) z >> 1) ^ (0 - ((uint32_t) z & 1)));
+		if (swap) {
+			c32 = __builtin_bswap32(c32);
+		}
+		memcpy(cur + pos, &c32, 4);
+	}
+
+	if (pos < size) {
+		if (n >= len)
+			return -1;
+		if (in[n++]) {
+			if (len - n < size - pos)
+				return -1;
+			memcpy(cur + pos, in + n, size - pos);
+			n += size - pos;
+		}
+		else {
+			if (!prev)
+				return -1;
+			memcpy(cur + pos, prev + pos, size - pos);
+		}
+	}
+
+	return (int) n;
+}
+
+/*
+ ***************************************************************************
+ * Get the address of a numeric field of a structure with statistics.
+ * Fields are numbered in the order given by the @gtypes_nr array of the
+ * activity: [unsigned] long long integers first, then [unsigned] long
+ * integers, and last [unsigned] integers.
+ *
+ * IN:
+ * @a		Activity.
+ * @ps		Structure with statistics.
+ * @f		Field number.
+ *
+ * OUT:
+ * @ul		TRUE if the field is an [unsigned] long integer.
+ * @u		TRUE if the field is an [unsigned] integer.
+ *
+ * RETURNS:
+ * Address of the field.
+ ***************************************************************************
+ */
+char *get_field_address(struct activity *a, char *ps, int f, int *ul, int *u)
+{
+	*ul = *u = FALSE;
+
+	if (f < a->gtypes_nr[0])
+		return ps + f * ULL_ALIGNMENT_WIDTH;
+
+	ps += a->gtypes_nr[0] * ULL_ALIGNMENT_WIDTH;
+	f -= a->gtypes_nr[0];
+	if (f < a->gtypes_nr[1]) {
+		*ul = TRUE;
+		return ps + f * UL_ALIGNMENT_WIDTH;
+	}
+
+	ps += a->gtypes_nr[1] * UL_ALIGNMENT_WIDTH;
+	f -= a->gtypes_nr[1];
+	*u = TRUE;
+	return ps + f * U_ALIGNMENT_WIDTH;
+}
+
+/*
+ ***************************************************************************
+ * Get the value of a numeric field of a structure with statistics.
+ *
+ * IN:
+ * @a		Activity.
+ * @ps		Structure with statistics.
+ * @f		Field number.
+ *
+ * RETURNS:
+ * Value of the field.
+ ***************************************************************************
+ */
+unsigned long long get_field_value(struct activity *a, char *ps, int f)
+{
+	int ul, u;
+	char *pf = get_field_address(a, ps, f, &ul, &u);
+
+	if (ul)
+		return (unsigned long long) *((unsigned long *) pf);
+	if (u)
+		return (unsigned long long) *((unsigned int *) pf);
+
+	return *((unsigned long long *) pf);
+}
+
+/*
+ ***************************************************************************
+ * Set the value of a numeric field of a structure with statistics.
+ *
+ * IN:
+ * @a		Activity.
+ * @ps		Structure with statistics.
+ * @f		Field number.
+ * @value	Value to save in the field.
+ ***************************************************************************
+ */
+void set_field_value(struct activity *a, char *ps, int f, unsigned long long value)
+{
+	int ul, u;
+	char *pf = get_field_address(a, ps, f, &ul, &u);
+
+	if (ul) {
+		*((unsigned long *) pf) = (unsigned long) value;
+	}
+	else if (u) {
+		*((unsigned int *) pf) = (unsigned int) value;
+	}
+	else {
+		*((unsigned long long *) pf) = value;
+	}
+}
+
+/*
+ ***************************************************************************
+ * Allocate space for the gauges of a given number of items.
+ *
+ * IN:
+ * @a		Activity.
+ * @rg		Structure where gauges are saved.
+ * @nr		Number of items.
+ ***************************************************************************
+ */
+void allocate_rollup_gauges(struct activity *a, struct rollup_gauges *rg, int nr)
+{
+	size_t nf = a->gtypes_nr[0] + a->gtypes_nr[1] + a->gtypes_nr[2];
+
+	if (nr <= rg->nr_allocated)
+		return;
+
+	SREALLOC(rg->items, char, (size_t) a->msize * nr);
+	SREALLOC(rg->min, unsigned long long, sizeof(unsigned long long) * nf * nr);
+	SREALLOC(rg->max, unsigned long long, sizeof(unsigned long long) * nf * nr);
+	SREALLOC(rg->sum, unsigned long long, sizeof(unsigned long long) * nf * nr);
+	SREALLOC(rg->cnt, unsigned long long, sizeof(unsigned long long) * nr);
+	rg->nr_allocated = nr;
+}
+
+/*
+ ***************************************************************************
+ * Look for an item in the gauges aggregated so far. Items of activities
+ * whose number of items may vary are identified by the contents of their
+ * structure following the numeric fields (e.g. filesystem name) if any.
+ * Other items are identified by their position.
+ *
+ * IN:
+ * @a		Activity.
+ * @rg		Gauges aggregated so far.
+ * @ps		Structure of the item to look for.
+ * @j		Position of the item in current record.
+ *
+ * RETURNS:
+ * Position of the item in @rg, or -1 if not found.
+ ***************************************************************************
+ */
+int search_rollup_item(struct activity *a, struct rollup_gauges *rg, char *ps, int j)
+{
+	unsigned int kofs = MAP_SIZE(a->gtypes_nr);
+	int k;
+
+	if (!HAS_COUNT_FUNCTION(a->options) || (kofs >= a->msize))
+		return (j < rg->nr) ? j : -1;
+
+	/* Items are likely to be in the same order as in previous record */
+	if ((j < rg->nr) &&
+	    !memcmp((char *) rg->items + (size_t) j * a->msize + kofs, ps + kofs,
+		    a->msize - kofs))
+		return j;
+
+	for (k = 0; k < rg->nr; k++) {
+		if (!memcmp((char *) rg->items + (size_t) k * a->msize + kofs, ps + kofs,
+			    a->msize - kofs))
+			return k;
+	}
+
+	return -1;
+}
+
+/*
+ ***************************************************************************
+ * Aggregate the gauges of an activity read in current record with those
+ * aggregated so far. Items which are no longer present are dropped, and
+ * new ones start with current values.
+ *
+ * IN:
+ * @a		Activity.
+ * @rg		Gauges aggregated so far (entry [0]). Entry [1] is used as
+ *		a work area.
+ * @buf		Structures read for the activity in current record.
+ * @n		Number of structures in @buf.
+ *
+ * OUT:
+ * @rg		Gauges aggregated, including current values (entry [0]).
+ ***************************************************************************
+ */
+void aggregate_gauges(struct activity *a, struct rollup_gauges rg[], void *buf, int n)
+{
+	struct rollup_gauges *old = &rg[0], *new = &rg[1], tmp;
+	int nf = a->gtypes_nr[0] + a->gtypes_nr[1] + a->gtypes_nr[2];
+	int j, k, f;
+	unsigned long long v;
+	char *ps;
+
+	allocate_rollup_gauges(a, new, n);
+
+	for (j = 0; j < n; j++) {
+		ps = (char *) buf + (size_t) j * a->msize;
+		memcpy((char *) new->items + (size_t) j * a->msize, ps, a->msize);
+
+		k = search_rollup_item(a, old, ps, j);
+		new->cnt[j] = (k < 0) ? 1 : old->cnt[k] + 1;
+
+		for (f = 0; f < nf; f++) {
+			v = get_field_value(a, ps, f);
+			if (k < 0) {
+				new->min[j * nf + f] = new->max[j * nf + f] = new->sum[j * nf + f] = v;
+			}
+			else {
+				new->min[j * nf + f] = MINIMUM(old->min[k * nf + f], v);
+				new->max[j * nf + f] = MAXIMUM(old->max[k * nf + f], v);
+				new->sum[j * nf + f] = old->sum[k * nf + f] + v;
+			}
+		}
+	}
+	new->nr = n;
+
+	tmp = *old;
+	*old = *new;
+	*new = tmp;
+}
+
+/*
+ ***************************************************************************
+ * Free the gauges aggregated for all the activities.
+ *
+ * IN:
+ * @rg		Gauges aggregated for each activity.
+ ***************************************************************************
+ */
+void free_rollup_gauges(struct rollup_gauges rg[][2])
+{
+	int i, p;
+
+	for (p = 0; p < NR_ACT; p++) {
+		for (i = 0; i < 2; i++) {
+			free(rg[p][i].items);
+			free(rg[p][i].min);
+			free(rg[p][i].max);
+			free(rg[p][i].sum);
+			free(rg[p][i].cnt);
+			memset(&rg[p][i], 0, sizeof(struct rollup_gauges));
+		}
+	}
+}
+
 #ifndef SOURCE_SADC
 /*
  ***************************************************************************
@@ -561,7 +1061,7 @@ char *get_devname(unsigned int major, unsigned int minor, int pretty)
  *		LINUX RESTART (in 1/100th of a second).
  * @uptime	Current system uptime (in 1/100th of a second).
  * @reset	TRUE if @last_uptime should be reset with @uptime_ref.
- * @interval	Interval of time.
+ * @interval	Interval of time (in milliseconds).
  *
  * RETURNS:
  * 1 if we are actually close enough to desired interval, 0 otherwise.
@@ -571,17 +1071,48 @@ int next_slice(unsigned long long uptime_ref, unsigned long long uptime,
 	       int reset, long interval)
 {
 	unsigned long file_interval, entry;
-	static unsigned long long last_uptime = 0;
-	int min, max, pt1, pt2;
+	static unsigned long long last_uptime = 0, last_ref = 0, origin = 0;
+	unsigned long long elapsed;
+	int min, max, pt1, pt2, res;
 	double f;
 
 	/* uptime is expressed in 1/100th of a second */
 	if (!last_uptime || reset) {
 		last_uptime = uptime_ref;
 	}
+	if (uptime_ref != last_ref) {
+		last_ref = origin = uptime_ref;
+	}
 
 	/* Interval cannot be greater than 0xffffffff here */
-	f = ((double) ((uptime - last_uptime) & 0xffffffff)) / 100;
+	elapsed = (uptime - last_uptime) & 0xffffffff;
+
+	/*
+	 * sadc takes its first sample as soon as it starts, and the next ones
+	 * on a time boundary. So the first record following the reference
+	 * one may be less than one second after it, even though the file has
+	 * been saved every second or more: This record is displayed, and the
+	 * next ones are selected starting from it.
+	 * NB: @origin is kept as long as @uptime_ref doesn't change, so that
+	 * the same records are selected when the file is read again.
+	 */
+	if ((last_uptime == uptime_ref) && (elapsed < 95)) {
+		last_uptime = origin = uptime;
+		return 1;
+	}
+
+	/*
+	 * Work with seconds, unless the interval or the time elapsed since
+	 * previous record is not a whole number of seconds. In this case
+	 * work with hundredths of a second.
+	 */
+	res = ((interval % 1000) || (elapsed < 100)) ? 1 : 100;
+	interval /= res * 10;
+	if (!interval) {
+		interval = 1;
+	}
+
+	f = ((double) elapsed) / res;
 	file_interval = (unsigned long) f;
 	if ((f * 10) - (file_interval * 10) >= 5) {
 		file_interval++; /* Rounding to correct value */
@@ -602,7 +1133,7 @@ int next_slice(unsigned long long uptime_ref, unsigned long long uptime,
 	 *       (Pn * Iu) or (P'n * Iu) belongs to In
 	 * with  Pn = En / Iu and P'n = En / Iu + 1
 	 */
-	f = ((double) ((uptime - uptime_ref) & 0xffffffff)) / 100;
+	f = ((double) ((uptime - origin) & 0xffffffff)) / res;
 	entry = (unsigned long) f;
 	if ((f * 10) - (entry * 10) >= 5) {
 		entry++;
@@ -718,6 +1249,49 @@ int parse_timestamp(char *argv[], int *opt, struct tstamp *tse,
 	return decode_timestamp(timestamp, tse);
 }
 
+/*
+ ***************************************************************************
+ * Get interval between two uptime values, each one made of a number of
+ * hundredths of a second and of a sub-centisecond part.
+ *
+ * IN:
+ * @prev_cs	Previous uptime value in 1/100th of a second.
+ * @prev_us	Sub-centisecond part of previous uptime (in microseconds).
+ * @curr_cs	Current uptime value in 1/100th of a second.
+ * @curr_us	Sub-centisecond part of current uptime (in microseconds).
+ *
+ * RETURNS:
+ * Interval of time in 1/100th of a second.
+ ***************************************************************************
+ */
+unsigned long long get_uptime_interval(unsigned long long prev_cs, unsigned int prev_us,
+				       unsigned long long curr_cs, unsigned int curr_us)
+{
+	unsigned long long itv;
+	int us;
+
+	/* Interval value in jiffies */
+	itv = get_interval(prev_cs, curr_cs);
+
+	if (prev_cs == curr_cs)
+		return itv;
+
+	/*
+	 * Round the interval to the nearest hundredth of a second using the
+	 * sub-centisecond parts: This matters when the interval is only a few
+	 * hundredths of a second long.
+	 */
+	us = (int) curr_us - (int) prev_us;
+	if (us >= 5000) {
+		itv++;
+	}
+	else if ((us < -5000) && (itv > 1)) {
+		itv--;
+	}
+
+	return itv;
+}
+
 /*
  ***************************************************************************
  * Set interval value.
@@ -734,9 +1308,8 @@ void get_itv_value(struct record_header *record_hdr_curr,
 		   struct record_header *record_hdr_prev,
 		   unsigned long long *itv)
 {
-	/* Interval value in jiffies */
-	*itv = get_interval(record_hdr_prev->uptime_cs,
-			    record_hdr_curr->uptime_cs);
+	*itv = get_uptime_interval(record_hdr_prev->uptime_cs, record_hdr_prev->uptime_us,
+				   record_hdr_curr->uptime_cs, record_hdr_curr->uptime_us);
 }
 
 /*
@@ -1295,24 +1868,333 @@ void remap_struct(unsigned int gtypes_nr[], unsigned int ftypes_nr[],
 
 /*
  ***************************************************************************
- * Read data from a system activity data file.
+ * SIGBUS signal handler. SIGBUS is raised when a page of a mapped file is
+ * accessed beyond its end, i.e. when the data file has been truncated
+ * (e.g. by sadc) since it was mapped.
  *
  * IN:
- * @ifd		Input file descriptor.
- * @buffer	Buffer where data are read.
- * @size	Number of bytes to read.
- * @mode	If set to HARD_SIZE, indicate that an EOF should be considered
- * 		as an error.
- *
- * RETURNS:
- * 1 if EOF has been reached, 0 otherwise.
+ * @sig	Signal number.
  ***************************************************************************
  */
-int sa_fread(int ifd, void *buffer, size_t size, int mode)
+void sa_map_sigbus(int sig)
 {
-	ssize_t n;
+	if (sa_map_copying) {
+		/* Go back to sa_mread() */
+		siglongjmp(sa_map_env, 1);
+	}
 
-	if ((n = read(ifd, buffer, size)) < 0) {
+	/* Not raised while reading the mapped file */
+	sigaction(SIGBUS, &sa_map_oldact, NULL);
+	raise(sig);
+}
+
+/*
+ ***************************************************************************
+ * Map a system activity data file into memory (or map it again with its
+ * current size). Data read from this file with sa_fread() are then copied
+ * from the mapping, and the file position is handled by sa_lseek(),
+ * instead of using one read() or lseek() system call each time. If the
+ * file cannot be mapped (e.g. if it is not a regular file), it will be
+ * read the usual way, starting from current position.
+ *
+ * IN:
+ * @fd		System activity data file descriptor.
+ ***************************************************************************
+ */
+void sa_mmap_file(int fd)
+{
+	struct sigaction sa;
+	struct stat st;
+	size_t pos = 0;
+	void *addr;
+
+	if (fd == sa_map.fd) {
+		/* File mapped again: Keep current position */
+		pos = sa_map.pos;
+	}
+
+	/* Unmap previous file, if any */
+	sa_munmap_file();
+
+	if ((fstat(fd, &st) < 0) || !S_ISREG(st.st_mode) || !st.st_size ||
+	    ((unsigned long long) st.st_size > (size_t) -1) ||
+	    ((addr = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE,
+			  fd, 0)) == MAP_FAILED)) {
+		if (pos) {
+			lseek(fd, (off_t) pos, SEEK_SET);
+		}
+		return;
+	}
+
+	/* Records are read from the beginning to the end of the file */
+	madvise(addr, (size_t) st.st_size, MADV_SEQUENTIAL);
+
+	/* Catch SIGBUS, should the file be truncated while being read */
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = sa_map_sigbus;
+	sa.sa_flags = SA_NODEFER;
+	sigaction(SIGBUS, &sa, &sa_map_oldact);
+
+	sa_map.fd   = fd;
+	sa_map.addr = (char *) addr;
+	sa_map.size = (size_t) st.st_size;
+	sa_map.pos  = pos;
+}
+
+/*
+ ***************************************************************************
+ * Unmap system activity data file mapped into memory by sa_mmap_file().
+ ***************************************************************************
+ */
+void sa_munmap_file(void)
+{
+	if (sa_map.addr) {
+		munmap(sa_map.addr, sa_map.size);
+		sigaction(SIGBUS, &sa_map_oldact, NULL);
+	}
+	sa_map.fd   = -1;
+	sa_map.addr = NULL;
+	sa_map.size = 0;
+	sa_map.pos  = 0;
+}
+
+/*
+ ***************************************************************************
+ * Close a system activity data file, unmapping it from memory if needed.
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ ***************************************************************************
+ */
+void sa_close(int ifd)
+{
+	if (ifd == sa_map.fd) {
+		sa_munmap_file();
+	}
+	close(ifd);
+}
+
+/*
+ ***************************************************************************
+ * Reset the decoding state when a new data file is opened.
+ *
+ * IN:
+ * @delta_file	TRUE if the file contains delta-encoded statistics records.
+ ***************************************************************************
+ */
+void reset_delta_state(int delta_file)
+{
+	sa_dlt_file  = delta_file;
+	sa_dlt_valid = FALSE;
+}
+
+/*
+ ***************************************************************************
+ * Tell that the decoding state of a delta-encoded data file no longer
+ * matches the current position in file, which has been moved to a
+ * keyframe (e.g. using file's index). Next statistics record can be read
+ * only if it is a keyframe.
+ ***************************************************************************
+ */
+void invalidate_delta_state(void)
+{
+	sa_dlt_valid = FALSE;
+}
+
+/*
+ ***************************************************************************
+ * Save current position in a system activity data file, along with the
+ * decoding state of a delta-encoded file, before reading the same records
+ * again. Structure @fpos should be initialized to zero before its first
+ * use.
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ * @fpos	Structure where position will be saved.
+ *
+ * OUT:
+ * @fpos	Saved position and decoding state.
+ *
+ * RETURNS:
+ * Current offset in file, or -1 on error.
+ ***************************************************************************
+ */
+off_t sa_save_pos(int ifd, struct sa_fpos *fpos)
+{
+	int i;
+
+	if ((fpos->pos = sa_lseek(ifd, 0, SEEK_CUR)) < 0)
+		return -1;
+
+	fpos->dlt_valid = sa_dlt_file && sa_dlt_valid;
+	if (fpos->dlt_valid) {
+		for (i = 0; i < NR_ACT; i++) {
+			copy_delta(&fpos->dlt[i], &sa_dlt[i]);
+		}
+	}
+
+	return fpos->pos;
+}
+
+/*
+ ***************************************************************************
+ * Reposition a system activity data file at a position saved by
+ * sa_save_pos(), and restore the decoding state of a delta-encoded file
+ * saved with it.
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ * @fpos	Position and decoding state saved by sa_save_pos().
+ *
+ * RETURNS:
+ * New offset in file, or -1 on error.
+ ***************************************************************************
+ */
+off_t sa_restore_pos(int ifd, struct sa_fpos *fpos)
+{
+	int i;
+
+	if (sa_lseek(ifd, fpos->pos, SEEK_SET) < 0)
+		return -1;
+
+	if (sa_dlt_file) {
+		sa_dlt_valid = fpos->dlt_valid;
+		if (sa_dlt_valid) {
+			for (i = 0; i < NR_ACT; i++) {
+				copy_delta(&sa_dlt[i], &fpos->dlt[i]);
+			}
+		}
+	}
+
+	return fpos->pos;
+}
+
+/*
+ ***************************************************************************
+ * Reposition offset of a system activity data file. Same as lseek(2),
+ * except that no system call is made if the file has been mapped into
+ * memory.
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ * @offset	Offset value.
+ * @whence	SEEK_SET, SEEK_CUR or SEEK_END.
+ *
+ * RETURNS:
+ * Resulting offset location from the beginning of the file, or -1 on
+ * error.
+ ***************************************************************************
+ */
+off_t sa_lseek(int ifd, off_t offset, int whence)
+{
+	off_t pos;
+
+	if (ifd != sa_map.fd)
+		return lseek(ifd, offset, whence);
+
+	switch (whence) {
+
+		case SEEK_SET:
+			pos = offset;
+			break;
+
+		case SEEK_CUR:
+			pos = (off_t) sa_map.pos + offset;
+			break;
+
+		case SEEK_END:
+			pos = (off_t) sa_map.size + offset;
+			break;
+
+		default:
+			errno = EINVAL;
+			return -1;
+	}
+
+	if (pos < 0) {
+		errno = EINVAL;
+		return -1;
+	}
+	sa_map.pos = (size_t) pos;
+
+	return pos;
+}
+
+/*
+ ***************************************************************************
+ * Read data from a system activity data file. Same as read(2), except
+ * that data are copied from memory if the file has been mapped. The file
+ * is mapped again if its size has changed when the end of the mapping is
+ * reached, and is read with read(2) if it has been truncated.
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ * @buffer	Buffer where data are read.
+ * @size	Number of bytes to read.
+ *
+ * RETURNS:
+ * Number of bytes read (0 at end of file), or -1 on error.
+ ***************************************************************************
+ */
+ssize_t sa_mread(int ifd, void *buffer, size_t size)
+{
+	struct stat st;
+	size_t n = 0;
+
+	if ((ifd == sa_map.fd) && (sa_map.pos + size > sa_map.size) &&
+	    !fstat(ifd, &st) && ((size_t) st.st_size != sa_map.size)) {
+		/*
+		 * End of mapping reached, and file size has changed since
+		 * it was mapped (e.g. new records have been saved by sadc).
+		 */
+		sa_mmap_file(ifd);
+	}
+
+	if (ifd != sa_map.fd)
+		return read(ifd, buffer, size);
+
+	if (sa_map.pos < sa_map.size) {
+		n = MINIMUM(size, sa_map.size - sa_map.pos);
+
+		if (sigsetjmp(sa_map_env, 0)) {
+			/*
+			 * File has been truncated: Stop using the mapping
+			 * and read file the usual way from current position.
+			 */
+			sa_map_copying = FALSE;
+			lseek(ifd, (off_t) sa_map.pos, SEEK_SET);
+			sa_munmap_file();
+			return read(ifd, buffer, size);
+		}
+		sa_map_copying = TRUE;
+		memcpy(buffer, sa_map.addr + sa_map.pos, n);
+		sa_map_copying = FALSE;
+		sa_map.pos += n;
+	}
+
+	return (ssize_t) n;
+}
+
+/*
+ ***************************************************************************
+ * Read data from a system activity data file.
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ * @buffer	Buffer where data are read.
+ * @size	Number of bytes to read.
+ * @mode	If set to HARD_SIZE, indicate that an EOF should be considered
+ * 		as an error.
+ *
+ * RETURNS:
+ * 1 if EOF has been reached, 0 otherwise.
+ ***************************************************************************
+ */
+int sa_fread(int ifd, void *buffer, size_t size, int mode)
+{
+	ssize_t n;
+
+	if ((n = sa_mread(ifd, buffer, size)) < 0) {
 		fprintf(stderr, _("Error while reading system activity file: %s\n"),
 			strerror(errno));
 		close(ifd);
@@ -1333,43 +2215,332 @@ int sa_fread(int ifd, void *buffer, size_t size, int mode)
 
 /*
  ***************************************************************************
- * Read the record header of current sample and process it.
+ * Read the next record header from a system activity data file, whatever
+ * its type.
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ * @buffer	Buffer where data will be read.
+ * @record_hdr	Structure where record header will be saved.
+ * @file_hdr	file_hdr structure containing data read from file standard
+ *		header.
+ * @arch_64	TRUE if file's data come from a 64-bit machine.
+ * @endian_mismatch
+ *		TRUE if data read from file don't match current machine's
+ *		endianness.
+ *
+ * OUT:
+ * @record_hdr	Record header for current sample.
+ *
+ * RETURNS:
+ * 1 if EOF has been reached, 0 otherwise.
+ ***************************************************************************
+ */
+int read_any_record_hdr(int ifd, void *buffer, struct record_header *record_hdr,
+			struct file_header *file_hdr, int arch_64, int endian_mismatch)
+{
+	if (sa_fread(ifd, buffer, (size_t) file_hdr->rec_size, SOFT_SIZE))
+		/* End of sa data file */
+		return 1;
+
+	/* Remap record header structure to that expected by current version */
+	remap_struct(rec_types_nr, file_hdr->rec_types_nr, buffer, file_hdr->rec_size);
+	memcpy(record_hdr, buffer, RECORD_HEADER_SIZE);
+
+	/* Normalize endianness */
+	if (endian_mismatch) {
+		swap_struct(rec_types_nr, record_hdr, arch_64);
+	}
+
+	return 0;
+}
+
+/*
+ ***************************************************************************
+ * Read the header of a summary record (which follows its record header).
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ * @arch_64	TRUE if file's data come from a 64-bit machine.
+ * @endian_mismatch
+ *		TRUE if data read from file don't match current machine's
+ *		endianness.
+ *
+ * OUT:
+ * @sum_hdr	Summary header.
+ *
+ * RETURNS:
+ * 1 if EOF has been reached, 0 otherwise.
+ ***************************************************************************
+ */
+int read_summary_hdr(int ifd, struct summary_header *sum_hdr, int arch_64,
+		     int endian_mismatch)
+{
+	if (sa_fread(ifd, sum_hdr, SUMMARY_HEADER_SIZE, SOFT_SIZE))
+		return 1;
+
+	/* Normalize endianness */
+	if (endian_mismatch) {
+		swap_struct(sum_types_nr, sum_hdr, arch_64);
+	}
+
+	return 0;
+}
+
+/*
+ ***************************************************************************
+ * Read the record header of current sample and process it. Summary
+ * records are skipped.
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ * @buffer	Buffer where data will be read.
+ * @record_hdr	Structure where record header will be saved.
+ * @file_hdr	file_hdr structure containing data read from file standard
+ *		header.
+ * @arch_64	TRUE if file's data come from a 64-bit machine.
+ * @endian_mismatch
+ *		TRUE if data read from file don't match current machine's
+ *		endianness.
+ *
+ * OUT:
+ * @record_hdr	Record header for current sample.
+ *
+ * RETURNS:
+ * 1 if EOF has been reached, 0 otherwise.
+ ***************************************************************************
+ */
+int read_record_hdr(int ifd, void *buffer, struct record_header *record_hdr,
+		    struct file_header *file_hdr, int arch_64, int endian_mismatch)
+{
+	struct summary_header sum_hdr;
+
+	do {
+		if (read_any_record_hdr(ifd, buffer, record_hdr, file_hdr,
+					arch_64, endian_mismatch))
+			return 1;
+
+		if (record_hdr->record_type != R_SUMMARY)
+			return 0;
+
+		/* Skip summary record */
+		if (read_summary_hdr(ifd, &sum_hdr, arch_64, endian_mismatch) ||
+		    (sa_lseek(ifd, (off_t) sum_hdr.size, SEEK_CUR) < 0))
+			return 1;
+	}
+	while (TRUE);
+}
+
+/*
+ ***************************************************************************
+ * Read an entry from the index file associated with a data file.
+ *
+ * IN:
+ * @fd		Index file descriptor.
+ * @i		Entry number.
+ *
+ * OUT:
+ * @ie		Entry read from index file.
+ *
+ * RETURNS:
+ * 0 on success, -1 if the entry couldn't be read.
+ ***************************************************************************
+ */
+int read_index_entry(int fd, long i, struct index_entry *ie)
+{
+	if (pread(fd, ie, INDEX_ENTRY_SIZE,
+		  INDEX_HEADER_SIZE + i * INDEX_ENTRY_SIZE) != INDEX_ENTRY_SIZE)
+		return -1;
+
+	return 0;
+}
+
+/*
+ ***************************************************************************
+ * Get the timestamp of the record an index entry points at, expressed the
+ * same way as the timestamps compared by the caller with the time given by
+ * option -s. The record header is read from the data file, since the time
+ * of the file's creator is not saved in the index.
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ * @ie		Entry read from index file.
+ * @l_flags	Flags indicating the type of time expected by the caller
+ *		(see sa_get_record_timestamp_struct()).
+ * @file_hdr	file_hdr structure containing data read from file standard
+ *		header.
+ * @endian_mismatch
+ *		TRUE if data read from file don't match current machine's
+ *		endianness.
+ * @arch_64	TRUE if file's data come from a 64-bit machine.
+ *
+ * OUT:
+ * @rectime	Timestamp of the record.
+ *
+ * RETURNS:
+ * 0 on success, -1 if the record couldn't be read or doesn't match the
+ * index entry.
+ ***************************************************************************
+ */
+int get_index_entry_time(int ifd, struct index_entry *ie, unsigned int l_flags,
+			 struct file_header *file_hdr, int endian_mismatch,
+			 int arch_64, struct tm *rectime)
+{
+	char rec_hdr_tmp[MAX_RECORD_HEADER_SIZE];
+	struct record_header rec_hdr;
+
+	if ((sa_lseek(ifd, (off_t) ie->offset, SEEK_SET) < 0) ||
+	    read_record_hdr(ifd, rec_hdr_tmp, &rec_hdr, file_hdr, arch_64, endian_mismatch) ||
+	    (rec_hdr.ust_time != ie->ust_time) ||
+	    (rec_hdr.record_type != ie->record_type) ||
+	    sa_get_record_timestamp_struct(l_flags, &rec_hdr, rectime, NULL))
+		return -1;
+
+	return 0;
+}
+
+/*
+ ***************************************************************************
+ * Use the index file associated with a system activity data file (if any)
+ * to skip the records saved before the time given by option -s.
+ * Index is not used if it doesn't belong to the data file, or if records
+ * were not saved in chronological order within the same day: In this case
+ * the data file will be read sequentially.
  *
  * IN:
- * @ifd		Input file descriptor.
- * @buffer	Buffer where data will be read.
- * @record_hdr	Structure where record header will be saved.
+ * @ifd		Input file descriptor. File is positioned just before
+ *		the first record to read.
+ * @dfile	Name of system activity data file.
+ * @l_flags	Flags indicating the type of time used by the caller to
+ *		compare records' timestamps with @tm_start (see
+ *		sa_get_record_timestamp_struct()).
+ * @tm_start	Time given by option -s.
+ * @act		Array of activities.
  * @file_hdr	file_hdr structure containing data read from file standard
  *		header.
- * @arch_64	TRUE if file's data come from a 64-bit machine.
  * @endian_mismatch
  *		TRUE if data read from file don't match current machine's
  *		endianness.
+ * @arch_64	TRUE if file's data come from a 64-bit machine.
  *
  * OUT:
- * @record_hdr	Record header for current sample.
- *
- * RETURNS:
- * 1 if EOF has been reached, 0 otherwise.
+ * @file_hdr	file_hdr structure with number of CPU updated if a RESTART
+ *		record has been skipped.
  ***************************************************************************
  */
-int read_record_hdr(int ifd, void *buffer, struct record_header *record_hdr,
-		    struct file_header *file_hdr, int arch_64, int endian_mismatch)
+void sa_seek_index(int ifd, char *dfile, unsigned int l_flags, struct tstamp *tm_start,
+		   struct activity *act[], struct file_header *file_hdr,
+		   int endian_mismatch, int arch_64)
 {
-	if (sa_fread(ifd, buffer, (size_t) file_hdr->rec_size, SOFT_SIZE))
-		/* End of sa data file */
-		return 1;
+	char ifile[MAX_FILE_LEN + sizeof(INDEX_SUFFIX)];
+	struct index_header idx_hdr;
+	struct index_entry ie;
+	struct stat ist, dst;
+	struct tm rectime;
+	int fd;
+	long lo, hi, mid, n;
+	long long first_sec, first_ust;
+	off_t fpos;
+
+	if (!tm_start->use)
+		return;
 
-	/* Remap record header structure to that expected by current version */
-	remap_struct(rec_types_nr, file_hdr->rec_types_nr, buffer, file_hdr->rec_size);
-	memcpy(record_hdr, buffer, RECORD_HEADER_SIZE);
+	snprintf(ifile, sizeof(ifile), "%s%s", dfile, INDEX_SUFFIX);
+	if ((fd = open(ifile, O_RDONLY)) < 0)
+		return;
 
-	/* Normalize endianness */
-	if (endian_mismatch) {
-		swap_struct(rec_types_nr, record_hdr, arch_64);
+	if ((fpos = sa_lseek(ifd, 0, SEEK_CUR)) < 0)
+		goto close_index;
+
+	/* Index should belong to data file and be searchable by time */
+	if ((fstat(fd, &ist) < 0) || (fstat(ifd, &dst) < 0) ||
+	    (read(fd, &idx_hdr, INDEX_HEADER_SIZE) != INDEX_HEADER_SIZE) ||
+	    (idx_hdr.sysstat_magic != SYSSTAT_MAGIC) ||
+	    (idx_hdr.index_magic != INDEX_MAGIC) ||
+	    (idx_hdr.entry_size != INDEX_ENTRY_SIZE) ||
+	    (idx_hdr.sa_ust_time != file_hdr->sa_ust_time) ||
+	    (idx_hdr.data_offset != (unsigned long long) fpos) ||
+	    !INDEX_IS_VALID(idx_hdr.flags) ||
+	    !INDEX_IS_MONOTONIC(idx_hdr.flags))
+		goto close_index;
+
+	n = (ist.st_size - INDEX_HEADER_SIZE) / INDEX_ENTRY_SIZE;
+	if (n <= 0)
+		goto close_index;
+
+	/*
+	 * Records' time of day, expressed the same way as by the caller
+	 * (local time, UTC or time of file's creator), should increase with
+	 * their position in file: This is the case if it has increased by as
+	 * many seconds as the number of seconds since the epoch between the
+	 * first and the last record, i.e. if all the records have been saved
+	 * the same day and with the same daylight saving time setting.
+	 */
+	if (read_index_entry(fd, 0, &ie) ||
+	    get_index_entry_time(ifd, &ie, l_flags, file_hdr, endian_mismatch, arch_64, &rectime))
+		goto restore_pos;
+	first_sec = rectime.tm_hour * 3600 + rectime.tm_min * 60 + rectime.tm_sec;
+	first_ust = (long long) ie.ust_time;
+
+	if (read_index_entry(fd, n - 1, &ie) ||
+	    get_index_entry_time(ifd, &ie, l_flags, file_hdr, endian_mismatch, arch_64, &rectime) ||
+	    (rectime.tm_hour * 3600 + rectime.tm_min * 60 + rectime.tm_sec - first_sec !=
+	     (long long) ie.ust_time - first_ust))
+		goto restore_pos;
+
+	/* Look for the last record saved before @tm_start */
+	lo = -1;
+	hi = n;
+	while (hi - lo > 1) {
+		mid = lo + (hi - lo) / 2;
+		if (read_index_entry(fd, mid, &ie) ||
+		    get_index_entry_time(ifd, &ie, l_flags, file_hdr, endian_mismatch, arch_64, &rectime))
+			goto restore_pos;
+
+		if (datecmp(&rectime, tm_start) < 0) {
+			lo = mid;
+		}
+		else {
+			hi = mid;
+		}
 	}
 
-	return 0;
+	/*
+	 * Then go back to the last statistics record saved before @tm_start.
+	 * This record will be read again (and not displayed) so that
+	 * structures are filled as if the file had been read from its
+	 * beginning. If records are delta-encoded, go back to the last
+	 * keyframe, since following records cannot be decoded without it.
+	 */
+	for (; lo >= 0; lo--) {
+		if (read_index_entry(fd, lo, &ie))
+			goto restore_pos;
+		if ((ie.record_type == R_STATS) && IS_KEYFRAME(ie.flags))
+			break;
+	}
+
+	/* Make sure that the index actually points to this record */
+	if ((lo < 0) || (ie.offset + ie.size > (unsigned long long) dst.st_size) ||
+	    get_index_entry_time(ifd, &ie, l_flags, file_hdr, endian_mismatch, arch_64, &rectime))
+		goto restore_pos;
+
+	/*
+	 * Records before this one would not have been displayed: Skip them.
+	 * NB: Indexed records are keyframes in a delta-encoded file.
+	 */
+	sa_lseek(ifd, (off_t) ie.offset, SEEK_SET);
+	invalidate_delta_state();
+	if (ie.cpu_nr > 0) {
+		set_cpu_nr(act, file_hdr, ie.cpu_nr);
+	}
+	goto close_index;
+
+restore_pos:
+	/* Index cannot be used: File will be read from its first record */
+	sa_lseek(ifd, fpos, SEEK_SET);
+
+close_index:
+	close(fd);
 }
 
 /*
@@ -1401,7 +2572,79 @@ void copy_structures(struct activity *act[], unsigned int id_seq[],
 		memcpy(act[p]->buf[dest], act[p]->buf[src],
 		       (size_t) act[p]->msize * (size_t) act[p]->nr[src] * (size_t) act[p]->nr2);
 		act[p]->nr[dest] = act[p]->nr[src];
+		act[p]->unsampled[dest]  = act[p]->unsampled[src];
+		act[p]->smp_uptime[dest] = act[p]->smp_uptime[src];
+		act[p]->smp_uptime_us[dest] = act[p]->smp_uptime_us[src];
+	}
+}
+
+/*
+ ***************************************************************************
+ * Update the sampling state of an activity once its statistics have been
+ * read from a record. If the activity has not been sampled in the record,
+ * the statistics from the last record where it was sampled (which are in
+ * the buffer used for previous record) are kept.
+ *
+ * IN:
+ * @a		Activity structure.
+ * @curr	Index in array for current sample statistics.
+ * @record_hdr	Header of the record that has been read.
+ * @sampled	TRUE if the activity has been sampled in the record.
+ *
+ * OUT:
+ * @a		Activity structure with statistics to use for the record.
+ ***************************************************************************
+ */
+void set_sampling_state(struct activity *a, int curr, struct record_header *record_hdr,
+			int sampled)
+{
+	if (sampled) {
+		a->unsampled[curr]  = FALSE;
+		a->smp_uptime[curr] = record_hdr->uptime_cs;
+		a->smp_uptime_us[curr] = record_hdr->uptime_us;
+		return;
+	}
+
+	/* This activity is not sampled in every record */
+	a->options |= AO_SPARSE;
+
+	a->nr[curr] = (a->nr[!curr] > 0) ? a->nr[!curr] : 0;
+	if (a->nr[curr]) {
+		memcpy(a->buf[curr], a->buf[!curr],
+		       (size_t) a->msize * (size_t) a->nr[curr] * (size_t) a->nr2);
 	}
+	a->unsampled[curr]  = TRUE;
+	a->smp_uptime[curr] = a->smp_uptime[!curr];
+	a->smp_uptime_us[curr] = a->smp_uptime_us[!curr];
+}
+
+/*
+ ***************************************************************************
+ * Get the interval of time to use to compute the statistics of an
+ * activity. This is the interval between the two records, unless the
+ * activity is not sampled in every record: The interval is then that
+ * between the records where its statistics have actually been sampled.
+ *
+ * IN:
+ * @a		Activity structure.
+ * @prev	Index in array where stats used as reference are.
+ * @curr	Index in array for current sample statistics.
+ * @itv		Interval of time between the two records in 1/100th of
+ *		a second.
+ *
+ * RETURNS:
+ * Interval of time in 1/100th of a second.
+ ***************************************************************************
+ */
+unsigned long long get_act_itv_value(struct activity *a, int prev, int curr,
+				     unsigned long long itv)
+{
+	if (!IS_SPARSE(a->options) || !a->smp_uptime[prev] ||
+	    (a->smp_uptime[curr] <= a->smp_uptime[prev]))
+		return itv;
+
+	return get_uptime_interval(a->smp_uptime[prev], a->smp_uptime_us[prev],
+				   a->smp_uptime[curr], a->smp_uptime_us[curr]);
 }
 
 /*
@@ -1437,18 +2680,127 @@ __nr_t read_nr_value(int ifd, char *file, struct file_magic *file_magic,
 		swap_struct(nr_types_nr, &value, arch_64);
 	}
 
-	if ((non_zero && !value) || (value < 0)) {
+	if ((non_zero && (value <= 0)) || ((value < 0) && (value != NR_NOT_SAMPLED))) {
 #ifdef DEBUG
 		fprintf(stderr, "%s: Value=%d\n",
 			__FUNCTION__, value);
 #endif
-		/* Value number cannot be zero or negative */
+		/*
+		 * Value number cannot be zero or negative, except for an
+		 * activity that has not been sampled in current record.
+		 */
+		handle_invalid_sa_file(ifd, file_magic, file, 0);
+	}
+
+	return value;
+}
+
+/*
+ ***************************************************************************
+ * Read a variable-length integer from a delta-encoded data file.
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ * @file	Name of file being read.
+ * @file_magic	file_magic structure filled with file magic header data.
+ * @max		Max value expected.
+ *
+ * RETURNS:
+ * Value read from file.
+ ***************************************************************************
+ */
+unsigned long long read_varint_value(int ifd, char *file, struct file_magic *file_magic,
+				     unsigned long long max)
+{
+	unsigned char buf[VARINT_MAX_SIZE];
+	unsigned long long value;
+	int n = 0;
+
+	do {
+		sa_fread(ifd, &buf[n], 1, HARD_SIZE);
+	}
+	while ((buf[n++] & 0x80) && (n < VARINT_MAX_SIZE));
+
+	if (!get_varint(buf, n, &value) || (value > max)) {
+#ifdef DEBUG
+		fprintf(stderr, "%s: Value=%llu Max=%llu\n", __FUNCTION__, value, max);
+#endif
 		handle_invalid_sa_file(ifd, file_magic, file, 0);
 	}
 
 	return value;
 }
 
+/*
+ ***************************************************************************
+ * Read and decode the delta-encoded structures saved for an activity in
+ * a statistics record.
+ *
+ * IN:
+ * @a		Activity whose structures are read.
+ * @dlt		Structures read from previous statistics record for this
+ *		activity.
+ * @curr	Index in array for current sample statistics.
+ * @ifd		Input file descriptor.
+ * @nr_value	Number of items saved for the activity.
+ * @len		Size of the encoded structures.
+ * @keyframe	TRUE if the record is a keyframe.
+ * @endian_mismatch
+ *		TRUE if file's data don't match current machine's endianness.
+ * @dfile	Name of system activity data file.
+ * @file_magic	file_magic structure containing data read from file magic
+ *		header.
+ *
+ * OUT:
+ * @dlt		Structures read from current statistics record.
+ ***************************************************************************
+ */
+void read_delta_structures(struct activity *a, struct sa_delta *dlt, int curr, int ifd,
+			   __nr_t nr_value, size_t len, int keyframe, int endian_mismatch,
+			   char *dfile, struct file_magic *file_magic)
+{
+	int j, n, nr = nr_value * a->nr2;
+	size_t pos = 0;
+	char *prev;
+
+	if (len > sa_dlt_in.size) {
+		SREALLOC(sa_dlt_in.buf, char, len);
+		sa_dlt_in.size = len;
+	}
+	if (len) {
+		sa_fread(ifd, sa_dlt_in.buf, len, HARD_SIZE);
+	}
+
+	sa_dlt_out.len = (size_t) a->fsize * (size_t) nr;
+	if (sa_dlt_out.len > sa_dlt_out.size) {
+		SREALLOC(sa_dlt_out.buf, char, sa_dlt_out.len);
+		sa_dlt_out.size = sa_dlt_out.len;
+	}
+
+	for (j = 0; j < nr; j++) {
+		prev = (!keyframe && (j < dlt->nr)) ? dlt->buf + j * a->fsize : NULL;
+		if ((n = decode_delta_struct(sa_dlt_out.buf + j * a->fsize, prev,
+					     a->ftypes_nr, a->fsize, endian_mismatch,
+					     (unsigned char *) sa_dlt_in.buf + pos,
+					     len - pos)) < 0) {
+			handle_invalid_sa_file(ifd, file_magic, dfile, 0);
+		}
+		pos += n;
+	}
+	if (pos != len) {
+		handle_invalid_sa_file(ifd, file_magic, dfile, 0);
+	}
+
+	/* Structures will be needed to decode next record */
+	sa_dlt_out.nr = nr;
+	copy_delta(dlt, &sa_dlt_out);
+
+	for (j = 0; j < nr; j++) {
+		memcpy((char *) a->buf[curr] + j * a->msize,
+		       sa_dlt_out.buf + j * a->fsize, (size_t) a->fsize);
+	}
+}
+
 /*
  ***************************************************************************
  * Read varying part of the statistics from a daily data file.
@@ -1456,6 +2808,7 @@ __nr_t read_nr_value(int ifd, char *file, struct file_magic *file_magic,
  * IN:
  * @act		Array of activities.
  * @curr	Index in array for current sample statistics.
+ * @record_hdr	Header of current record (already read).
  * @ifd		Input file descriptor.
  * @act_nr	Number of activities in file.
  * @file_actlst	Activity list in file.
@@ -1467,26 +2820,64 @@ __nr_t read_nr_value(int ifd, char *file, struct file_magic *file_magic,
  *		header.
  ***************************************************************************
  */
-void read_file_stat_bunch(struct activity *act[], int curr, int ifd, int act_nr,
-			  struct file_activity *file_actlst, int endian_mismatch,
-			  int arch_64, char *dfile, struct file_magic *file_magic)
+void read_file_stat_bunch(struct activity *act[], int curr, struct record_header *record_hdr,
+			  int ifd, int act_nr, struct file_activity *file_actlst,
+			  int endian_mismatch, int arch_64, char *dfile,
+			  struct file_magic *file_magic)
 {
-	int i, j, p;
+	int i, j, p, sampled;
 	struct file_activity *fal = file_actlst;
 	off_t offset;
 	__nr_t nr_value;
+	size_t len = 0;
+	unsigned char frame = DELTA_KEYFRAME;
+
+	if (sa_dlt_file) {
+		/* Delta-encoded record: Can it be decoded? */
+		sa_fread(ifd, &frame, 1, HARD_SIZE);
+		if ((frame != DELTA_KEYFRAME) &&
+		    ((frame != DELTA_FRAME) || !sa_dlt_valid)) {
+#ifdef DEBUG
+			fprintf(stderr, "%s: Frame=%d Valid=%d\n",
+				__FUNCTION__, frame, sa_dlt_valid);
+#endif
+			handle_invalid_sa_file(ifd, file_magic, dfile, 0);
+		}
+	}
 
 	for (i = 0; i < act_nr; i++, fal++) {
 
 		/* Read __nr_t value preceding statistics structures if it exists */
 		if (fal->has_nr) {
-			nr_value = read_nr_value(ifd, dfile, file_magic,
-						 endian_mismatch, arch_64, FALSE);
+			if (sa_dlt_file) {
+				nr_value = (__nr_t) read_varint_value(ifd, dfile, file_magic,
+								      DELTA_NOT_SAMPLED);
+				if (nr_value == DELTA_NOT_SAMPLED) {
+					nr_value = NR_NOT_SAMPLED;
+				}
+			}
+			else {
+				nr_value = read_nr_value(ifd, dfile, file_magic,
+							 endian_mismatch, arch_64, FALSE);
+			}
 		}
 		else {
 			nr_value = fal->nr;
 		}
 
+		/* No statistics follow if the activity has not been sampled in this record */
+		sampled = (nr_value != NR_NOT_SAMPLED);
+		if (!sampled) {
+			nr_value = 0;
+		}
+
+		if (sa_dlt_file) {
+			/* Read size of encoded structures */
+			len = (size_t) read_varint_value(ifd, dfile, file_magic,
+					(unsigned long long) MINIMUM(nr_value, NR_MAX) * fal->nr2 *
+					DELTA_MAX_SIZE(fal->size));
+		}
+
 		if (nr_value > NR_MAX) {
 #ifdef DEBUG
 			fprintf(stderr, "%s: Value=%d Max=%d\n", __FUNCTION__, nr_value, NR_MAX);
@@ -1500,9 +2891,14 @@ void read_file_stat_bunch(struct activity *act[], int curr, int ifd, int act_nr,
 			 * Ignore current activity in file, which is unknown to
 			 * current sysstat version or has an unknown format.
 			 */
-			if (nr_value) {
+			if (sa_dlt_file) {
+				offset = (off_t) len;
+			}
+			else {
 				offset = (off_t) fal->size * (off_t) nr_value * (off_t) fal->nr2;
-				if (lseek(ifd, offset, SEEK_CUR) < offset) {
+			}
+			if (offset) {
+				if (sa_lseek(ifd, offset, SEEK_CUR) < offset) {
 					close(ifd);
 					perror("lseek");
 					exit(2);
@@ -1518,7 +2914,20 @@ void read_file_stat_bunch(struct activity *act[], int curr, int ifd, int act_nr,
 #endif
 			handle_invalid_sa_file(ifd, file_magic, dfile, 0);
 		}
+
+		if (!sampled) {
+			if (sa_dlt_file && (frame == DELTA_KEYFRAME)) {
+				/*
+				 * Next structures of this activity won't be encoded
+				 * against those saved before the keyframe.
+				 */
+				sa_dlt[p].nr = 0;
+			}
+			set_sampling_state(act[p], curr, record_hdr, FALSE);
+			continue;
+		}
 		act[p]->nr[curr] = nr_value;
+		set_sampling_state(act[p], curr, record_hdr, TRUE);
 
 		/* Reallocate buffers if needed */
 		if (nr_value > act[p]->nr_allocated) {
@@ -1536,7 +2945,14 @@ void read_file_stat_bunch(struct activity *act[], int curr, int ifd, int act_nr,
                 }
 
 		/* OK, this is a known activity: Read the stats structures */
-		if ((nr_value > 0) &&
+		if (sa_dlt_file) {
+			read_delta_structures(act[p], &sa_dlt[p], curr, ifd, nr_value, len,
+					      frame == DELTA_KEYFRAME, endian_mismatch,
+					      dfile, file_magic);
+			if (!nr_value)
+				continue;
+		}
+		else if ((nr_value > 0) &&
 		    ((nr_value > 1) || (act[p]->nr2 > 1)) &&
 		    (act[p]->msize > act[p]->fsize)) {
 
@@ -1572,6 +2988,100 @@ void read_file_stat_bunch(struct activity *act[], int curr, int ifd, int act_nr,
 				     (char *) act[p]->buf[curr] + j * act[p]->msize, act[p]->fsize);
 		}
 	}
+
+	if (sa_dlt_file) {
+		/* Next record may be delta-encoded against this one */
+		sa_dlt_valid = TRUE;
+	}
+}
+
+/*
+ ***************************************************************************
+ * Skip varying part of the statistics of a record from a daily data file.
+ * Statistics are not decoded. With a delta-encoded file, the record that
+ * follows can't be decoded unless it is a keyframe.
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ * @act_nr	Number of activities in file.
+ * @file_actlst	Activity list in file.
+ * @endian_mismatch
+ *		TRUE if file's data don't match current machine's endianness.
+ * @arch_64	TRUE if file's data come from a 64 bit machine.
+ * @dfile	Name of system activity data file.
+ * @file_magic	file_magic structure containing data read from file magic
+ *		header.
+ *
+ * OUT:
+ * @sampled	Set to FALSE if an activity has not been sampled in the
+ *		record (left unchanged otherwise).
+ *
+ * RETURNS:
+ * TRUE if the record can be decoded without reading the previous ones
+ * (i.e. if it is a keyframe).
+ ***************************************************************************
+ */
+int skip_file_stat_bunch(int ifd, int act_nr, struct file_activity *file_actlst,
+			 int endian_mismatch, int arch_64, char *dfile,
+			 struct file_magic *file_magic, int *sampled)
+{
+	int i;
+	struct file_activity *fal = file_actlst;
+	off_t offset;
+	__nr_t nr_value;
+	unsigned char frame = DELTA_KEYFRAME;
+
+	if (sa_dlt_file) {
+		sa_fread(ifd, &frame, 1, HARD_SIZE);
+		if ((frame != DELTA_KEYFRAME) && (frame != DELTA_FRAME)) {
+			handle_invalid_sa_file(ifd, file_magic, dfile, 0);
+		}
+		sa_dlt_valid = FALSE;
+	}
+
+	for (i = 0; i < act_nr; i++, fal++) {
+
+		if (fal->has_nr) {
+			if (sa_dlt_file) {
+				nr_value = (__nr_t) read_varint_value(ifd, dfile, file_magic,
+								      DELTA_NOT_SAMPLED);
+				if (nr_value == DELTA_NOT_SAMPLED) {
+					*sampled = FALSE;
+				}
+			}
+			else {
+				nr_value = read_nr_value(ifd, dfile, file_magic,
+							 endian_mismatch, arch_64, FALSE);
+				if (nr_value == NR_NOT_SAMPLED) {
+					*sampled = FALSE;
+					nr_value = 0;
+				}
+			}
+		}
+		else {
+			nr_value = fal->nr;
+		}
+
+		if (sa_dlt_file) {
+			offset = (off_t) read_varint_value(ifd, dfile, file_magic,
+					(unsigned long long) NR_MAX * fal->nr2 *
+					DELTA_MAX_SIZE(fal->size));
+		}
+		else {
+			if (nr_value > NR_MAX) {
+				handle_invalid_sa_file(ifd, file_magic, dfile, 0);
+			}
+			offset = (off_t) fal->size * (off_t) nr_value * (off_t) fal->nr2;
+		}
+
+		if (offset && (sa_lseek(ifd, offset, SEEK_CUR) < offset)) {
+			close(ifd);
+			perror("lseek");
+			exit(2);
+		}
+	}
+
+	return (frame == DELTA_KEYFRAME);
 }
 
 /*
@@ -1616,12 +3126,17 @@ int sa_open_read_magic(int *fd, char *dfile, struct file_magic *file_magic,
 		exit(2);
 	}
 
+	/* Map file into memory so that it can be read without system calls */
+	sa_mmap_file(*fd);
+
 	/* Read file magic data */
-	n = read(*fd, file_magic, FILE_MAGIC_SIZE);
+	n = sa_mread(*fd, file_magic, FILE_MAGIC_SIZE);
 
 	if ((n != FILE_MAGIC_SIZE) ||
 	    ((file_magic->sysstat_magic != SYSSTAT_MAGIC) && (file_magic->sysstat_magic != SYSSTAT_MAGIC_SWAPPED)) ||
-	    ((file_magic->format_magic != FORMAT_MAGIC) && (file_magic->format_magic != FORMAT_MAGIC_SWAPPED) && !ignore)) {
+	    ((file_magic->format_magic != FORMAT_MAGIC) && (file_magic->format_magic != FORMAT_MAGIC_SWAPPED) &&
+	     (file_magic->format_magic != FORMAT_MAGIC_DELTA) && (file_magic->format_magic != FORMAT_MAGIC_DELTA_SWAPPED) &&
+	     !ignore)) {
 #ifdef DEBUG
 		fprintf(stderr, "%s: Bytes read=%d sysstat_magic=%x format_magic=%x\n",
 			__FUNCTION__, n, file_magic->sysstat_magic, file_magic->format_magic);
@@ -1671,7 +3186,9 @@ int sa_open_read_magic(int *fd, char *dfile, struct file_magic *file_magic,
 	}
 
 	if ((file_magic->format_magic != FORMAT_MAGIC) &&
-	    (file_magic->format_magic != FORMAT_MAGIC_SWAPPED))
+	    (file_magic->format_magic != FORMAT_MAGIC_SWAPPED) &&
+	    (file_magic->format_magic != FORMAT_MAGIC_DELTA) &&
+	    (file_magic->format_magic != FORMAT_MAGIC_DELTA_SWAPPED))
 		/*
 		 * This is an old (or new) sa datafile format to
 		 * be read by sadf (since @ignore was set to TRUE).
@@ -1725,6 +3242,9 @@ void check_file_actlst(int *ifd, char *dfile, struct activity *act[],
 		 */
 		return;
 
+	/* Statistics records may be delta-encoded */
+	reset_delta_state(file_magic->format_magic == FORMAT_MAGIC_DELTA);
+
 	/*
 	 * We know now that we have a *compatible* sysstat datafile format
 	 * (correct FORMAT_MAGIC value), and in this case, we should have
@@ -2418,6 +3938,44 @@ double compute_ifutil(struct stats_net_dev *st_net_dev, double rx, double tx)
 	return 0;
 }
 
+/*
+ ***************************************************************************
+ * Set the number of CPU read after a RESTART record.
+ *
+ * IN:
+ * @act		Array of activities.
+ * @file_hdr	file_hdr structure containing data read from file standard
+ *		header.
+ * @cpu_nr	New number of CPU.
+ *
+ * OUT:
+ * @file_hdr	file_hdr structure with updated number of CPU.
+ ***************************************************************************
+ */
+void set_cpu_nr(struct activity *act[], struct file_header *file_hdr, __nr_t cpu_nr)
+{
+	int p;
+
+	file_hdr->sa_cpu_nr = cpu_nr;
+
+	/*
+	 * We don't know if CPU related activities will be displayed or not.
+	 * But if it is the case, @nr_ini will be used in the loop
+	 * to process all CPUs. So update their value here and
+	 * reallocate buffers if needed.
+	 * NB: We may have nr_allocated=0 here if the activity has
+	 * not been collected in file (or if it has an unknown format).
+	 */
+	for (p = 0; p < NR_ACT; p++) {
+		if (HAS_PERSISTENT_VALUES(act[p]->options)) {
+			act[p]->nr_ini = file_hdr->sa_cpu_nr;
+			if (act[p]->nr_ini > act[p]->nr_allocated) {
+				reallocate_all_buffers(act[p], act[p]->nr_ini);
+			}
+		}
+	}
+}
+
 /*
  ***************************************************************************
  * Read and replace unprintable characters in comment with ".".
@@ -2530,7 +4088,8 @@ int sa_get_record_timestamp_struct(unsigned int l_flags, struct record_header *r
  * IN:
  * @l_flags	Flags indicating the type of time expected by the user.
  * 		S_F_SEC_EPOCH means the time should be expressed in seconds
- * 		since the epoch (01/01/1970).
+ * 		since the epoch (01/01/1970). S_F_MSEC_TIME means that
+ * 		milliseconds should be added to the time.
  * @record_hdr	Record header containing the number of seconds since the
  * 		epoch.
  * @cur_date	String where timestamp's date will be saved. May be NULL.
@@ -2550,6 +4109,8 @@ int sa_get_record_timestamp_struct(unsigned int l_flags, struct record_header *r
 void set_record_timestamp_string(unsigned int l_flags, struct record_header *record_hdr,
 				 char *cur_date, char *cur_time, int len, struct tm *rectime)
 {
+	size_t n;
+
 	/* Set cur_time date value */
 	if (PRINT_SEC_EPOCH(l_flags) && cur_date) {
 		sprintf(cur_time, "%llu", record_hdr->ust_time);
@@ -2563,7 +4124,12 @@ void set_record_timestamp_string(unsigned int l_flags, struct record_header *rec
 		if (cur_date) {
 			strftime(cur_date, len, "%Y-%m-%d", rectime);
 		}
-		if (USE_PREFD_TIME_OUTPUT(l_flags)) {
+		if (PRINT_MSEC_TIME(l_flags)) {
+			/* Sub-second interval: Add milliseconds to time */
+			n = strftime(cur_time, len, "%H:%M:%S", rectime);
+			snprintf(cur_time + n, len - n, ".%03u", record_hdr->ust_msec);
+		}
+		else if (USE_PREFD_TIME_OUTPUT(l_flags)) {
 			strftime(cur_time, len, "%X", rectime);
 		}
 		else {
@@ -2618,7 +4184,6 @@ int print_special_record(struct record_header *record_hdr, unsigned int l_flags,
 {
 	char cur_date[TIMESTAMP_LEN], cur_time[TIMESTAMP_LEN];
 	int dp = 1;
-	int p;
 
 	/* Fill timestamp structure (rectime) for current record */
 	if (sa_get_record_timestamp_struct(l_flags, record_hdr, rectime, loctime))
@@ -2643,25 +4208,8 @@ int print_special_record(struct record_header *record_hdr, unsigned int l_flags,
 
 	if (rtype == R_RESTART) {
 		/* Read new cpu number following RESTART record */
-		file_hdr->sa_cpu_nr = read_nr_value(ifd, file, file_magic,
-						    endian_mismatch, arch_64, TRUE);
-
-		/*
-		 * We don't know if CPU related activities will be displayed or not.
-		 * But if it is the case, @nr_ini will be used in the loop
-		 * to process all CPUs. So update their value here and
-		 * reallocate buffers if needed.
-		 * NB: We may have nr_allocated=0 here if the activity has
-		 * not been collected in file (or if it has an unknown format).
-		 */
-		for (p = 0; p < NR_ACT; p++) {
-			if (HAS_PERSISTENT_VALUES(act[p]->options)) {
-				act[p]->nr_ini = file_hdr->sa_cpu_nr;
-				if (act[p]->nr_ini > act[p]->nr_allocated) {
-					reallocate_all_buffers(act[p], act[p]->nr_ini);
-				}
-			}
-		}
+		set_cpu_nr(act, file_hdr, read_nr_value(ifd, file, file_magic,
+							endian_mismatch, arch_64, TRUE));
 
 		if (!dp)
 			return 0;
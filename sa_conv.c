@@ -80,6 +80,8 @@ int upgrade_magic_section(char dfile[], int *fd, int stdfd, struct file_magic *f
 
 		case FORMAT_MAGIC:
 		case FORMAT_MAGIC_SWAPPED:
+		case FORMAT_MAGIC_DELTA:
+		case FORMAT_MAGIC_DELTA_SWAPPED:
 			*previous_format = FORMAT_MAGIC;
 			return 0;
 			break;
@@ -107,7 +109,7 @@ int upgrade_magic_section(char dfile[], int *fd, int stdfd, struct file_magic *f
 		 * was smaller with previous sysstat versions.
 		 * Go back 4 (unsigned int header_size) + 64 (char pad[64]) bytes.
 		 */
-		if (lseek(*fd, -68, SEEK_CUR) < 0) {
+		if (sa_lseek(*fd, -68, SEEK_CUR) < 0) {
 			fprintf(stderr, "\nlseek: %s\n", strerror(errno));
 			return -1;
 		}
@@ -1458,6 +1460,8 @@ int upgrade_record_header(int fd, int stdfd, struct old_record_header *orec_hdr,
 {
 	struct record_header rec_hdr;
 
+	memset(&rec_hdr, 0, RECORD_HEADER_SIZE);
+
 	/* Convert current record header */
 	rec_hdr.uptime_cs = orec_hdr->uptime0 * 100 / HZ;	/* Uptime in cs, not jiffies */
 	rec_hdr.ust_time = (unsigned long long) orec_hdr->ust_time;
@@ -1904,6 +1908,174 @@ int upgrade_stat_records(int fd, int stdfd, struct activity *act[], struct file_
 	return 0;
 }
 
+/*
+ ***************************************************************************
+ * Write data to the converted file.
+ *
+ * IN:
+ * @stdfd	File descriptor for STDOUT.
+ * @buf		Data to write.
+ * @size	Number of bytes to write.
+ *
+ * RETURNS:
+ * -1 on error, 0 otherwise.
+ ***************************************************************************
+ */
+int write_conv_data(int stdfd, void *buf, size_t size)
+{
+	if (write(stdfd, buf, size) != (ssize_t) size) {
+		fprintf(stderr, "\nwrite: %s\n", strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ ***************************************************************************
+ * Convert a delta-encoded (FORMAT_MAGIC_DELTA) data file to the plain
+ * up-to-date format, as if it had been created without sadc option -z.
+ * Statistics records are decoded then written with their structures as
+ * they are. Activities unknown to current sysstat version cannot be
+ * decoded and are not kept. Summary records are not kept either since the
+ * offsets they contain would no longer be valid. Data are written with the
+ * endianness of current machine.
+ *
+ * IN:
+ * @dfile	System activity data file name.
+ * @stdfd	File descriptor for STDOUT.
+ * @act		Array of activities.
+ *
+ * RETURNS:
+ * -1 on error, 0 otherwise.
+ ***************************************************************************
+ */
+int convert_delta_file(char dfile[], int stdfd, struct activity *act[])
+{
+	int fd, i, j, p, eosaf, arch_64, dlt_endian_mismatch;
+	unsigned int id_seq[NR_ACT];
+	char rec_hdr_tmp[MAX_RECORD_HEADER_SIZE];
+	char file_comment[MAX_COMMENT_LEN];
+	struct file_magic file_magic, new_magic;
+	struct file_header file_hdr, new_hdr;
+	struct file_activity *file_actlst = NULL, *fal;
+	struct record_header record_hdr;
+	__nr_t nr;
+
+	/* Every activity found in file will be converted */
+	select_all_activities(act);
+
+	check_file_actlst(&fd, dfile, act, &file_magic, &file_hdr, &file_actlst,
+			  id_seq, FALSE, &dlt_endian_mismatch, &arch_64);
+	allocate_structures(act);
+
+	/* Write file magic header */
+	new_magic = file_magic;
+	new_magic.format_magic = FORMAT_MAGIC;
+	new_magic.header_size = FILE_HEADER_SIZE;
+	for (i = 0; i < 3; i++) {
+		new_magic.hdr_types_nr[i] = hdr_types_nr[i];
+	}
+	if (write_conv_data(stdfd, &new_magic, FILE_MAGIC_SIZE) < 0)
+		goto conv_error;
+
+	/* Write file header. Only activities that can be decoded are kept */
+	new_hdr = file_hdr;
+	new_hdr.sa_act_nr = 0;
+	for (i = 0, fal = file_actlst; i < file_hdr.sa_act_nr; i++, fal++) {
+		if (((p = get_activity_position(act, fal->id, RESUME_IF_NOT_FOUND)) >= 0) &&
+		    (act[p]->magic == fal->magic)) {
+			new_hdr.sa_act_nr++;
+		}
+	}
+	new_hdr.act_size = FILE_ACTIVITY_SIZE;
+	new_hdr.rec_size = RECORD_HEADER_SIZE;
+	for (i = 0; i < 3; i++) {
+		new_hdr.act_types_nr[i] = act_types_nr[i];
+		new_hdr.rec_types_nr[i] = rec_types_nr[i];
+	}
+	if (write_conv_data(stdfd, &new_hdr, FILE_HEADER_SIZE) < 0)
+		goto conv_error;
+
+	/* Write activity list */
+	for (i = 0, fal = file_actlst; i < file_hdr.sa_act_nr; i++, fal++) {
+		if (((p = get_activity_position(act, fal->id, RESUME_IF_NOT_FOUND)) >= 0) &&
+		    (act[p]->magic == fal->magic)) {
+			if (write_conv_data(stdfd, fal, FILE_ACTIVITY_SIZE) < 0)
+				goto conv_error;
+		}
+	}
+
+	fprintf(stderr, _("Statistics:\n"));
+
+	do {
+		eosaf = read_record_hdr(fd, rec_hdr_tmp, &record_hdr, &file_hdr,
+					arch_64, dlt_endian_mismatch);
+		if (eosaf)
+			break;
+
+		if (write_conv_data(stdfd, &record_hdr, RECORD_HEADER_SIZE) < 0)
+			goto conv_error;
+
+		if (record_hdr.record_type == R_COMMENT) {
+			sa_fread(fd, file_comment, MAX_COMMENT_LEN, HARD_SIZE);
+			if (write_conv_data(stdfd, file_comment, MAX_COMMENT_LEN) < 0)
+				goto conv_error;
+			fprintf(stderr, "C");
+			continue;
+		}
+
+		if (record_hdr.record_type == R_RESTART) {
+			nr = read_nr_value(fd, dfile, &file_magic, dlt_endian_mismatch,
+					   arch_64, TRUE);
+			set_cpu_nr(act, &file_hdr, nr);
+			if (write_conv_data(stdfd, &nr, sizeof(__nr_t)) < 0)
+				goto conv_error;
+			fprintf(stderr, "R");
+			continue;
+		}
+
+		/* Decode statistics record, then write its structures */
+		read_file_stat_bunch(act, 0, &record_hdr, fd, file_hdr.sa_act_nr, file_actlst,
+				     dlt_endian_mismatch, arch_64, dfile, &file_magic);
+
+		for (i = 0, fal = file_actlst; i < file_hdr.sa_act_nr; i++, fal++) {
+			if (((p = get_activity_position(act, fal->id, RESUME_IF_NOT_FOUND)) < 0) ||
+			    (act[p]->magic != fal->magic))
+				continue;
+
+			nr = act[p]->unsampled[0] ? NR_NOT_SAMPLED : act[p]->nr[0];
+			if (fal->has_nr &&
+			    (write_conv_data(stdfd, &nr, sizeof(__nr_t)) < 0))
+				goto conv_error;
+			if (nr == NR_NOT_SAMPLED)
+				continue;
+
+			for (j = 0; j < nr * act[p]->nr2; j++) {
+				if (write_conv_data(stdfd, (char *) act[p]->buf[0] + j * act[p]->msize,
+						    (size_t) act[p]->fsize) < 0)
+					goto conv_error;
+			}
+		}
+		fprintf(stderr, ".");
+	}
+	while (!eosaf);
+
+	fprintf(stderr, "\n");
+
+	free(file_actlst);
+	free_structures(act);
+	sa_close(fd);
+
+	return 0;
+
+conv_error:
+	free(file_actlst);
+	sa_close(fd);
+
+	return -1;
+}
+
 /*
  ***************************************************************************
  * Close file descriptors and exit.
@@ -1917,7 +2089,7 @@ int upgrade_stat_records(int fd, int stdfd, struct activity *act[], struct file_
 void upgrade_exit(int fd, int stdfd, int exit_code)
 {
 	if (fd) {
-		close(fd);
+		sa_close(fd);
 	}
 	if (stdfd) {
 		close(stdfd);
@@ -1959,6 +2131,19 @@ void convert_file(char dfile[], struct activity *act[])
 				  &previous_format, &endian_mismatch) < 0) {
 		upgrade_exit(fd, stdfd, 2);
 	}
+	if ((file_magic.format_magic == FORMAT_MAGIC_DELTA) ||
+	    (file_magic.format_magic == FORMAT_MAGIC_DELTA_SWAPPED)) {
+		/* Statistics records are delta-encoded: Decode them */
+		sa_close(fd);
+		fd = 0;
+		if (convert_delta_file(dfile, stdfd, act) < 0) {
+			upgrade_exit(fd, stdfd, 2);
+		}
+		fprintf(stderr,
+			_("File successfully converted to sysstat format version %s\n"),
+			VERSION);
+		goto success;
+	}
 	if (previous_format == FORMAT_MAGIC) {
 		/* Nothing to do at the present time */
 		fprintf(stderr, _("\nFile format already up-to-date\n"));
@@ -0,0 +1,602 @@
+/*
+ * sa_out.c: Output buffer used by sadf to display statistics.
+ * (C) 2026 by the sysstat developers
+ *
+ ***************************************************************************
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published  by  the *
+ * Free Software Foundation; either version 2 of the License, or (at  your *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it  will  be  useful,  but *
+ * WITHOUT ANY WARRANTY; without the implied warranty  of  MERCHANTABILITY *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License *
+ * for more details.                                                       *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA              *
+ ***************************************************************************
+ *
+ * The statistics of a record are formatted in a buffer which is written
+ * to standard output once the whole record has been formatted (see
+ * out_flush()). Integers and values displayed with a fixed number of
+ * decimals (eg. %.2f) are converted here without calling printf(). The
+ * result is the same as with glibc's printf(): Values are rounded to the
+ * nearest (ties to even) from their exact binary value, and the decimal
+ * point is that of the current locale. Conversion specifications not
+ * handled here are passed to vsnprintf().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <locale.h>
+
+#include "common.h"
+#include "sa_out.h"
+
+/* Output buffer, number of bytes used in it, and its size */
+static char *out_buf = NULL;
+static size_t out_len = 0, out_size = 0;
+
+/* Decimal point of current locale */
+static char dec_point[8] = ".";
+static size_t dec_len = 1;
+
+/* Strings "00" to "99" used to convert integers two digits at a time */
+static const char digits2[] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+static const unsigned long long pow10_tab[OUT_MAX_PREC + 1] = {1, 10, 100, 1000};
+
+/*
+ ***************************************************************************
+ * Save the decimal point of current locale.
+ ***************************************************************************
+ */
+static void get_decimal_point(void)
+{
+	struct lconv *lc = localeconv();
+
+	if (lc && lc->decimal_point && *lc->decimal_point &&
+	    (strlen(lc->decimal_point) < sizeof(dec_point))) {
+		strcpy(dec_point, lc->decimal_point);
+	}
+	else {
+		strcpy(dec_point, ".");
+	}
+	dec_len = strlen(dec_point);
+}
+
+/*
+ ***************************************************************************
+ * Make sure that there is room for a given number of bytes in the output
+ * buffer.
+ *
+ * IN:
+ * @len		Number of bytes that will be appended to the buffer.
+ *
+ * RETURNS:
+ * Pointer on the first free byte in the buffer.
+ * The buffer is allocated when it is used for the first time, and the
+ * decimal point of current locale is then saved.
+ ***************************************************************************
+ */
+static char *out_room(size_t len)
+{
+	if (!out_buf || (out_len + len > out_size)) {
+		if (!out_buf) {
+			/* First use of the buffer */
+			get_decimal_point();
+			out_size = OUT_BUF_SIZE;
+		}
+		while (out_len + len > out_size) {
+			out_size *= 2;
+		}
+		SREALLOC(out_buf, char, out_size);
+	}
+
+	return out_buf + out_len;
+}
+
+/*
+ ***************************************************************************
+ * Convert an unsigned integer to a string. Digits are written backwards.
+ *
+ * IN:
+ * @end		Pointer on the end of the string (not written).
+ * @val		Value to convert.
+ *
+ * RETURNS:
+ * Pointer on the first character of the string.
+ ***************************************************************************
+ */
+static char *ull_to_str(char *end, unsigned long long val)
+{
+	char *p = end;
+	unsigned int d;
+
+	while (val >= 100) {
+		d = (unsigned int) (val % 100) * 2;
+		val /= 100;
+		*--p = digits2[d + 1];
+		*--p = digits2[d];
+	}
+	if (val >= 10) {
+		d = (unsigned int) val * 2;
+		*--p = digits2[d + 1];
+		*--p = digits2[d];
+	}
+	else {
+		*--p = '0' + (char) val;
+	}
+
+	return p;
+}
+
+/*
+ ***************************************************************************
+ * Convert an unsigned integer to a string (hexadecimal format, as with
+ * %x). Digits are written backwards.
+ *
+ * IN:
+ * @end		Pointer on the end of the string (not written).
+ * @val		Value to convert.
+ *
+ * RETURNS:
+ * Pointer on the first character of the string.
+ ***************************************************************************
+ */
+static char *hex_to_str(char *end, unsigned long long val)
+{
+	char *p = end;
+
+	do {
+		*--p = "0123456789abcdef"[val & 0xf];
+		val >>= 4;
+	}
+	while (val);
+
+	return p;
+}
+
+/*
+ ***************************************************************************
+ * Convert a double to a string with a fixed number of decimals, as with
+ * %.<prec>f. Characters are written backwards.
+ * The value is m * 2^-e, with m < 2^53: m * 10^prec is computed exactly
+ * as an integer, then shifted right by e bits. The bits shifted out give
+ * the rounding direction.
+ *
+ * IN:
+ * @end		Pointer on the end of the string (not written). There must
+ *		be at least OUT_NUM_LEN bytes before it.
+ * @val		Value to convert.
+ * @prec	Number of decimals (0 to OUT_MAX_PREC).
+ *
+ * RETURNS:
+ * Pointer on the first character of the string, or NULL if the value
+ * cannot be converted here (infinite, NaN, or absolute value greater
+ * than 2^52).
+ ***************************************************************************
+ */
+static char *fixed_to_str(char *end, double val, int prec)
+{
+	unsigned long long bits, m, q, r, half;
+	char *p = end;
+	int e, i;
+
+	memcpy(&bits, &val, sizeof(bits));
+	e = (int) ((bits >> 52) & 0x7ff);
+	m = bits & ((1ULL << 52) - 1);
+
+	if (e == 0x7ff)
+		/* Infinite or NaN */
+		return NULL;
+	if (e) {
+		m |= 1ULL << 52;
+	}
+	else {
+		/* Subnormal number */
+		e = 1;
+	}
+	e = 1075 - e;
+	if (e <= 0)
+		/* Value is an integer too large to be handled here */
+		return NULL;
+
+	/* m * 10^prec < 2^63 */
+	m *= pow10_tab[prec];
+
+	if (e < 64) {
+		q = m >> e;
+		r = m & ((1ULL << e) - 1);
+		half = 1ULL << (e - 1);
+		if ((r > half) || ((r == half) && (q & 1))) {
+			q++;
+		}
+	}
+	else {
+		/* Value is less than half of the last decimal */
+		q = 0;
+	}
+
+	if (prec) {
+		for (i = 0; i < prec; i++) {
+			*--p = '0' + (char) (q % 10);
+			q /= 10;
+		}
+		p -= dec_len;
+		memcpy(p, dec_point, dec_len);
+	}
+	p = ull_to_str(p, q);
+
+	if (bits >> 63) {
+		/* Negative value (printf() also displays the sign of -0.00) */
+		*--p = '-';
+	}
+
+	return p;
+}
+
+/*
+ ***************************************************************************
+ * Append a field to the output buffer, padded to a given width.
+ *
+ * IN:
+ * @str		Field to append.
+ * @len		Length of the field.
+ * @width	Min width of the field.
+ * @left	TRUE if the field should be left-justified.
+ * @zero	TRUE if the field should be padded with zeros (after its
+ *		sign if any).
+ ***************************************************************************
+ */
+static void out_field(const char *str, size_t len, int width, int left, int zero)
+{
+	size_t pad = ((size_t) width > len) ? (size_t) width - len : 0;
+	char *p = out_room(len + pad);
+
+	out_len += len + pad;
+
+	if (!pad) {
+		memcpy(p, str, len);
+	}
+	else if (left) {
+		memcpy(p, str, len);
+		memset(p + len, ' ', pad);
+	}
+	else if (zero) {
+		if (*str == '-') {
+			*p++ = *str++;
+			len--;
+		}
+		memset(p, '0', pad);
+		memcpy(p + pad, str, len);
+	}
+	else {
+		memset(p, ' ', pad);
+		memcpy(p + pad, str, len);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Append a string to the output buffer.
+ *
+ * IN:
+ * @str		String to append.
+ ***************************************************************************
+ */
+void out_puts(const char *str)
+{
+	size_t len = strlen(str);
+
+	memcpy(out_room(len), str, len);
+	out_len += len;
+}
+
+/*
+ ***************************************************************************
+ * Append an unsigned integer to the output buffer (same as %llu).
+ *
+ * IN:
+ * @val		Value to append.
+ ***************************************************************************
+ */
+void out_ull(unsigned long long val)
+{
+	char num[OUT_NUM_LEN], *end = num + OUT_NUM_LEN, *p;
+
+	p = ull_to_str(end, val);
+	memcpy(out_room(end - p), p, end - p);
+	out_len += end - p;
+}
+
+/*
+ ***************************************************************************
+ * Append a double to the output buffer with a fixed number of decimals
+ * (same as %.<prec>f).
+ *
+ * IN:
+ * @val		Value to append.
+ * @prec	Number of decimals.
+ ***************************************************************************
+ */
+void out_fixed(double val, int prec)
+{
+	char num[OUT_NUM_LEN], *end = num + OUT_NUM_LEN, *p;
+
+	/* Make sure the decimal point of current locale has been saved */
+	out_room(OUT_NUM_LEN);
+
+	if ((prec < 0) || (prec > OUT_MAX_PREC) ||
+	    ((p = fixed_to_str(end, val, prec)) == NULL)) {
+		out_printf("%.*f", prec, val);
+		return;
+	}
+	memcpy(out_buf + out_len, p, end - p);
+	out_len += end - p;
+}
+
+/*
+ ***************************************************************************
+ * printf() function writing to the output buffer.
+ * Conversions %d, %i, %u, %x (possibly with length modifiers h, l or ll),
+ * %s, %c, %% and %.<prec>f are handled here, with flags '-' and '0' and a
+ * min field width. If the format contains any other conversion
+ * specification, the whole string is formatted by vsnprintf().
+ *
+ * IN:
+ * @fmtf	printf() format.
+ * @args	Arguments.
+ ***************************************************************************
+ */
+void out_vprintf(const char *fmtf, va_list args)
+{
+	va_list args0, args1;
+	const char *c = fmtf, *s;
+	char num[OUT_NUM_LEN], *end = num + OUT_NUM_LEN, *p;
+	size_t len0, len;
+	int left, zero, width, prec, lng, n;
+	long long ival;
+	unsigned long long uval;
+
+	/* Make sure the decimal point of current locale has been saved */
+	out_room(0);
+	len0 = out_len;
+	va_copy(args0, args);
+
+	while (*c) {
+		if (*c != '%') {
+			/* Copy text up to next conversion specification */
+			for (s = c; *c && (*c != '%'); c++);
+			len = c - s;
+			memcpy(out_room(len), s, len);
+			out_len += len;
+			continue;
+		}
+
+		/* Flags, field width, precision and length modifier */
+		left = zero = FALSE;
+		for (c++; (*c == '-') || (*c == '0'); c++) {
+			if (*c == '-') {
+				left = TRUE;
+			}
+			else {
+				zero = TRUE;
+			}
+		}
+		for (width = 0; (*c >= '0') && (*c <= '9'); c++) {
+			width = width * 10 + (*c - '0');
+		}
+		prec = -1;
+		if (*c == '.') {
+			for (prec = 0, c++; (*c >= '0') && (*c <= '9'); c++) {
+				prec = prec * 10 + (*c - '0');
+			}
+		}
+		lng = 0;
+		if (*c == 'h') {
+			lng = -1;
+			c++;
+		}
+		else if (*c == 'l') {
+			lng = 1;
+			if (*(++c) == 'l') {
+				lng = 2;
+				c++;
+			}
+		}
+
+		switch (*c) {
+
+		case 'd':
+		case 'i':
+			if (prec >= 0)
+				goto fallback;
+			if (lng == 2) {
+				ival = va_arg(args, long long);
+			}
+			else if (lng == 1) {
+				ival = va_arg(args, long);
+			}
+			else if (lng < 0) {
+				ival = (short) va_arg(args, int);
+			}
+			else {
+				ival = va_arg(args, int);
+			}
+			if (ival < 0) {
+				p = ull_to_str(end, -(unsigned long long) ival);
+				*--p = '-';
+			}
+			else {
+				p = ull_to_str(end, (unsigned long long) ival);
+			}
+			break;
+
+		case 'u':
+		case 'x':
+			if (prec >= 0)
+				goto fallback;
+			if (lng == 2) {
+				uval = va_arg(args, unsigned long long);
+			}
+			else if (lng == 1) {
+				uval = va_arg(args, unsigned long);
+			}
+			else if (lng < 0) {
+				uval = (unsigned short) va_arg(args, unsigned int);
+			}
+			else {
+				uval = va_arg(args, unsigned int);
+			}
+			p = (*c == 'u') ? ull_to_str(end, uval) : hex_to_str(end, uval);
+			break;
+
+		case 'f':
+			if (lng || (prec < 0) || (prec > OUT_MAX_PREC) ||
+			    ((p = fixed_to_str(end, va_arg(args, double), prec)) == NULL))
+				goto fallback;
+			break;
+
+		case 's':
+			if (zero || lng)
+				goto fallback;
+			s = va_arg(args, char *);
+			len = (prec >= 0) ? strnlen(s, prec) : strlen(s);
+			out_field(s, len, width, left, FALSE);
+			c++;
+			continue;
+
+		case 'c':
+			if (zero || lng || (prec >= 0))
+				goto fallback;
+			num[0] = (char) va_arg(args, int);
+			out_field(num, 1, width, left, FALSE);
+			c++;
+			continue;
+
+		case '%':
+			if (left || zero || width || (prec >= 0) || lng)
+				goto fallback;
+			*out_room(1) = '%';
+			out_len++;
+			c++;
+			continue;
+
+		default:
+			goto fallback;
+		}
+
+		out_field(p, end - p, width, left, zero && !left);
+		c++;
+	}
+	va_end(args0);
+	return;
+
+fallback:
+	/* Format the whole string with vsnprintf() */
+	out_len = len0;
+	va_copy(args1, args0);
+	n = vsnprintf(NULL, 0, fmtf, args1);
+	va_end(args1);
+	if (n > 0) {
+		vsnprintf(out_room(n + 1), n + 1, fmtf, args0);
+		out_len += n;
+	}
+	va_end(args0);
+}
+
+/*
+ ***************************************************************************
+ * printf() function writing to the output buffer.
+ *
+ * IN:
+ * @fmtf	printf() format.
+ ***************************************************************************
+ */
+void out_printf(const char *fmtf, ...)
+{
+	va_list args;
+
+	va_start(args, fmtf);
+	out_vprintf(fmtf, args);
+	va_end(args);
+}
+
+/*
+ ***************************************************************************
+ * Same as xprintf0() (printf() function modified for XML-like output,
+ * without a CR at the end of the line), but writing to the output buffer.
+ *
+ * IN:
+ * @nr_tab	Number of tabs to print.
+ * @fmtf	printf() format.
+ ***************************************************************************
+ */
+void out_xprintf0(int nr_tab, const char *fmtf, ...)
+{
+	va_list args;
+
+	if (nr_tab > 0) {
+		memset(out_room(nr_tab), '\t', nr_tab);
+		out_len += nr_tab;
+	}
+
+	va_start(args, fmtf);
+	out_vprintf(fmtf, args);
+	va_end(args);
+}
+
+/*
+ ***************************************************************************
+ * Same as xprintf() (printf() function modified for XML-like output, with
+ * a CR at the end of the line), but writing to the output buffer.
+ *
+ * IN:
+ * @nr_tab	Number of tabs to print.
+ * @fmtf	printf() format.
+ ***************************************************************************
+ */
+void out_xprintf(int nr_tab, const char *fmtf, ...)
+{
+	va_list args;
+
+	if (nr_tab > 0) {
+		memset(out_room(nr_tab), '\t', nr_tab);
+		out_len += nr_tab;
+	}
+
+	va_start(args, fmtf);
+	out_vprintf(fmtf, args);
+	va_end(args);
+
+	*out_room(1) = '\n';
+	out_len++;
+}
+
+/*
+ ***************************************************************************
+ * Write the contents of the output buffer to standard output with a
+ * single call to fwrite(), then empty the buffer.
+ * The decimal point of current locale is saved again, in case the locale
+ * has been changed since the buffer was last used.
+ ***************************************************************************
+ */
+void out_flush(void)
+{
+	if (!out_len)
+		return;
+
+	fwrite(out_buf, 1, out_len, stdout);
+	out_len = 0;
+	get_decimal_point();
+}
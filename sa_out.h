@@ -0,0 +1,56 @@
+/*
+ * sa_out.h: Include file for the output buffer used by sadf.
+ * (C) 2026 by the sysstat developers
+ */
+
+#ifndef _SA_OUT_H
+#define _SA_OUT_H
+
+#include <stdarg.h>
+
+/*
+ ***************************************************************************
+ * Definitions for the output buffer where sadf formats the statistics of
+ * a record (db, ppc, XML and JSON formats). The buffer is written to
+ * standard output with a single call to fwrite() once the whole record
+ * has been formatted.
+ ***************************************************************************
+ */
+
+/* Initial size of the output buffer (bytes) */
+#define OUT_BUF_SIZE	65536
+
+/*
+ * Max length of a number formatted by the output functions.
+ * A double value formatted with %.2f uses the snprintf() fallback when
+ * its absolute value is greater than 2^52.
+ */
+#define OUT_NUM_LEN	32
+
+/* Max number of decimals handled without calling snprintf() (%.Nf) */
+#define OUT_MAX_PREC	3
+
+/*
+ ***************************************************************************
+ * Prototypes for functions used to fill the output buffer.
+ ***************************************************************************
+ */
+
+void out_puts
+	(const char *);
+void out_ull
+	(unsigned long long);
+void out_fixed
+	(double, int);
+void out_vprintf
+	(const char *, va_list);
+void out_printf
+	(const char *, ...);
+void out_xprintf0
+	(int, const char *, ...);
+void out_xprintf
+	(int, const char *, ...);
+void out_flush
+	(void);
+
+#endif  /* _SA_OUT_H */
@@ -0,0 +1,633 @@
+/*
+ * sa_rollup.c: Roll a system activity datafile up to a coarser interval.
+ * (C) 2026 by the sysstat developers
+ *
+ ***************************************************************************
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published  by  the *
+ * Free Software Foundation; either version 2 of the License, or (at  your *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it  will  be  useful,  but *
+ * WITHOUT ANY WARRANTY; without the implied warranty  of  MERCHANTABILITY *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License *
+ * for more details.                                                       *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA              *
+ ***************************************************************************
+ *
+ * Records are grouped in buckets of <interval> seconds, aligned on the
+ * epoch. The first record of each bucket is written to the new file: Its
+ * counters are kept as they are, so that rates computed between two records
+ * of the new file are the rates over the bucket. The gauges of activities
+ * flagged AO_GAUGE are replaced with their mean, min or max value over the
+ * records read since the previous record written. The last record read
+ * before a RESTART record or the end of file is also written, so that no
+ * data are lost.
+ * When the interval is a multiple of SUMMARY_SPAN and the datafile contains
+ * summary records (see sadc option --summary), the statistics records
+ * saved between two boundary records are not read: Gauges are taken from
+ * the summary record saved with the second one instead.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "version.h"
+#include "sadf.h"
+
+#ifdef USE_NLS
+# include <locale.h>
+# include <libintl.h>
+# define _(string) gettext(string)
+#else
+# define _(string) (string)
+#endif
+
+extern int endian_mismatch;
+extern int arch_64;
+extern unsigned int act_types_nr[];
+extern unsigned int rec_types_nr[];
+extern unsigned int hdr_types_nr[];
+extern unsigned int sact_types_nr[];
+
+/* Gauges aggregated for each activity. Entry [0] is the current one */
+struct rollup_gauges rgauges[NR_ACT][2];
+
+/* Gauges read from a summary record for each activity */
+struct rollup_gauges sgauges[NR_ACT];
+
+/* Buffer where a summary record is read */
+char *sum_buf = NULL;
+size_t sum_buf_size = 0;
+
+/* Buffer used to build the structures of an activity with aggregated gauges */
+void *rollup_buf = NULL;
+size_t rollup_buf_size = 0;
+
+/*
+ ***************************************************************************
+ * Write data to STDOUT, and exit on error.
+ *
+ * IN:
+ * @stdfd	File descriptor for STDOUT.
+ * @buf		Data to write.
+ * @len		Number of bytes to write.
+ ***************************************************************************
+ */
+void rollup_write(int stdfd, void *buf, size_t len)
+{
+	if (write(stdfd, buf, len) != (ssize_t) len) {
+		fprintf(stderr, "\nwrite: %s\n", strerror(errno));
+		exit(2);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Write the statistics of an activity, replacing its gauges with their
+ * aggregated value.
+ *
+ * IN:
+ * @stdfd	File descriptor for STDOUT.
+ * @a		Activity.
+ * @p		Position of the activity in array.
+ * @curr	Index in array for current sample statistics.
+ * @agg		Value saved for gauges (ROLLUP_MEAN, ROLLUP_MIN or
+ *		ROLLUP_MAX).
+ ***************************************************************************
+ */
+void write_gauges(int stdfd, struct activity *a, int p, int curr, int agg)
+{
+	struct rollup_gauges *rg = &rgauges[p][0];
+	int nf = a->gtypes_nr[0] + a->gtypes_nr[1] + a->gtypes_nr[2];
+	int j, f;
+	size_t len = (size_t) a->msize * rg->nr;
+	unsigned long long v;
+	char *ps;
+
+	if (len > rollup_buf_size) {
+		SREALLOC(rollup_buf, char, len);
+		rollup_buf_size = len;
+	}
+	memcpy(rollup_buf, rg->items, len);
+
+	for (j = 0; j < rg->nr; j++) {
+		ps = (char *) rollup_buf + (size_t) j * a->msize;
+		for (f = 0; f < nf; f++) {
+			if (agg == ROLLUP_MIN) {
+				v = rg->min[j * nf + f];
+			}
+			else if (agg == ROLLUP_MAX) {
+				v = rg->max[j * nf + f];
+			}
+			else {
+				v = (rg->sum[j * nf + f] + rg->cnt[j] / 2) / rg->cnt[j];
+			}
+			set_field_value(a, ps, f, v);
+		}
+	}
+
+	rollup_write(stdfd, rollup_buf, len);
+}
+
+/*
+ ***************************************************************************
+ * Write a statistics record.
+ *
+ * IN:
+ * @stdfd	File descriptor for STDOUT.
+ * @act		Array of activities.
+ * @pos		Position in array of the activities written to file.
+ * @has_nr	TRUE for activities whose statistics are preceded by the
+ *		number of items.
+ * @act_nr	Number of activities written to file.
+ * @sampled	TRUE for activities which have been sampled since the
+ *		previous record written.
+ * @record_hdr	Header of the record.
+ * @curr	Index in array for current sample statistics.
+ * @agg		Value saved for gauges.
+ ***************************************************************************
+ */
+void write_rollup_record(int stdfd, struct activity *act[], int pos[], int has_nr[],
+			 int act_nr, int sampled[], struct record_header *record_hdr,
+			 int curr, int agg)
+{
+	int i, p;
+	__nr_t nr_value;
+	struct record_header rec_hdr;
+
+	memcpy(&rec_hdr, record_hdr, RECORD_HEADER_SIZE);
+	rec_hdr.record_type = R_STATS;
+	rollup_write(stdfd, &rec_hdr, RECORD_HEADER_SIZE);
+
+	for (i = 0; i < act_nr; i++) {
+		p = pos[i];
+
+		if (has_nr[i]) {
+			nr_value = sampled[p] ? act[p]->nr[curr] : NR_NOT_SAMPLED;
+			rollup_write(stdfd, &nr_value, sizeof(__nr_t));
+			if (!sampled[p])
+				continue;
+		}
+
+		if (IS_GAUGE(act[p]->options)) {
+			write_gauges(stdfd, act[p], p, curr, agg);
+		}
+		else {
+			rollup_write(stdfd, act[p]->buf[curr],
+				     (size_t) act[p]->msize * (size_t) act[p]->nr[curr] *
+				     (size_t) act[p]->nr2);
+		}
+	}
+
+	/* Start a new bucket */
+	for (i = 0; i < act_nr; i++) {
+		sampled[pos[i]] = FALSE;
+		rgauges[pos[i]][0].nr = 0;
+	}
+}
+
+/*
+ ***************************************************************************
+ * Merge the gauges of an activity read from a summary record with those
+ * aggregated so far. Entries of the summary record match the items of its
+ * boundary record.
+ *
+ * IN:
+ * @a		Activity.
+ * @rg		Gauges aggregated so far (entry [0]). Entry [1] is used as
+ *		a work area.
+ * @src		Gauges read from the summary record.
+ *
+ * OUT:
+ * @rg		Gauges aggregated, including those of the summary record
+ *		(entry [0]).
+ ***************************************************************************
+ */
+void merge_gauges(struct activity *a, struct rollup_gauges rg[], struct rollup_gauges *src)
+{
+	struct rollup_gauges *old = &rg[0], *new = &rg[1], tmp;
+	int nf = a->gtypes_nr[0] + a->gtypes_nr[1] + a->gtypes_nr[2];
+	int j, k, f, i;
+	char *ps;
+
+	allocate_rollup_gauges(a, new, src->nr);
+
+	for (j = 0; j < src->nr; j++) {
+		ps = (char *) src->items + (size_t) j * a->msize;
+		memcpy((char *) new->items + (size_t) j * a->msize, ps, a->msize);
+
+		k = search_rollup_item(a, old, ps, j);
+		new->cnt[j] = (k < 0) ? src->cnt[j] : old->cnt[k] + src->cnt[j];
+
+		for (f = 0; f < nf; f++) {
+			i = j * nf + f;
+			if (k < 0) {
+				new->min[i] = src->min[i];
+				new->max[i] = src->max[i];
+				new->sum[i] = src->sum[i];
+			}
+			else {
+				new->min[i] = MINIMUM(old->min[k * nf + f], src->min[i]);
+				new->max[i] = MAXIMUM(old->max[k * nf + f], src->max[i]);
+				new->sum[i] = old->sum[k * nf + f] + src->sum[i];
+			}
+		}
+	}
+	new->nr = src->nr;
+
+	tmp = *old;
+	*old = *new;
+	*new = tmp;
+}
+
+/*
+ ***************************************************************************
+ * Read the gauges saved in a summary record for each activity.
+ *
+ * IN:
+ * @act		Array of activities.
+ * @pos		Position in array of the activities written to file.
+ * @act_nr	Number of activities written to file.
+ * @sum_hdr	Header of the summary record.
+ * @curr	Index in array for statistics of the boundary record.
+ *
+ * RETURNS:
+ * TRUE if the gauges of all the activities have been read and match the
+ * items of the boundary record.
+ ***************************************************************************
+ */
+int read_summary_gauges(struct activity *act[], int pos[], int act_nr,
+			struct summary_header *sum_hdr, int curr)
+{
+	int i, p, found[NR_ACT];
+	unsigned int k;
+	size_t n = 0, len;
+	struct summary_act sact;
+	struct rollup_gauges *sg;
+
+	memset(found, 0, sizeof(found));
+
+	for (k = 0; k < sum_hdr->act_nr; k++) {
+		if (sum_hdr->size - n < SUMMARY_ACT_SIZE)
+			return FALSE;
+		memcpy(&sact, sum_buf + n, SUMMARY_ACT_SIZE);
+		n += SUMMARY_ACT_SIZE;
+
+		if ((p = get_activity_position(act, sact.id, RESUME_IF_NOT_FOUND)) < 0)
+			return FALSE;
+		if (!IS_GAUGE(act[p]->options) || (sact.size != act[p]->msize) ||
+		    (sact.nf != act[p]->gtypes_nr[0] + act[p]->gtypes_nr[1] + act[p]->gtypes_nr[2]) ||
+		    (sact.nr != act[p]->nr[curr] * act[p]->nr2))
+			return FALSE;
+
+		len = (size_t) sact.nr * (sact.size + sizeof(unsigned long long) * (1 + 3 * sact.nf));
+		if (sum_hdr->size - n < len)
+			return FALSE;
+
+		sg = &sgauges[p];
+		allocate_rollup_gauges(act[p], sg, sact.nr);
+		len = (size_t) sact.nr * sact.size;
+		memcpy(sg->items, sum_buf + n, len);
+		n += len;
+		len = (size_t) sact.nr * sizeof(unsigned long long);
+		memcpy(sg->cnt, sum_buf + n, len);
+		n += len;
+		len *= sact.nf;
+		memcpy(sg->sum, sum_buf + n, len);
+		n += len;
+		memcpy(sg->min, sum_buf + n, len);
+		n += len;
+		memcpy(sg->max, sum_buf + n, len);
+		n += len;
+		sg->nr = sact.nr;
+		found[p] = TRUE;
+	}
+
+	/* Every activity with gauges should have been found */
+	for (i = 0; i < act_nr; i++) {
+		if (IS_GAUGE(act[pos[i]]->options) && !found[pos[i]])
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+/*
+ ***************************************************************************
+ * Skip the statistics records saved between two boundary records. The
+ * summary record saved with current boundary record (whose header has
+ * just been read) gives the position of the next boundary record. This
+ * one is read, and the gauges saved in its own summary record are merged
+ * with those aggregated so far. The file is then positioned at the
+ * beginning of this summary record.
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ * @act		Array of activities.
+ * @pos		Position in array of the activities written to file.
+ * @act_nr	Number of activities written to file.
+ * @sum_hdr	Header of the summary record saved with current boundary
+ *		record.
+ * @curr	Index in array for statistics of the next boundary record.
+ * @record_hdr	Array where the header of the next boundary record will be
+ *		saved.
+ * @rec_hdr_tmp	Temporary buffer where record headers are read.
+ * @file_hdr	File header.
+ * @file_actlst	List of activities in file.
+ * @dfile	System activity data file name.
+ * @file_magic	File magic header.
+ *
+ * RETURNS:
+ * TRUE if the next boundary record has been read. Otherwise the file is
+ * positioned after current summary record.
+ ***************************************************************************
+ */
+int read_next_boundary(int ifd, struct activity *act[], int pos[], int act_nr,
+		       struct summary_header *sum_hdr, int curr,
+		       struct record_header record_hdr[], char *rec_hdr_tmp,
+		       struct file_header *file_hdr, struct file_activity *file_actlst,
+		       char *dfile, struct file_magic *file_magic)
+{
+	static struct sa_fpos back;
+	off_t next_pos;
+	int i;
+	struct summary_header next_hdr;
+	struct record_header rec_hdr;
+
+	/* Position to go back to if the next boundary record cannot be used */
+	if ((sa_lseek(ifd, (off_t) sum_hdr->size, SEEK_CUR) < 0) ||
+	    (sa_save_pos(ifd, &back) < 0))
+		return FALSE;
+
+	if (!sum_hdr->next_offset ||
+	    (sa_lseek(ifd, (off_t) sum_hdr->next_offset, SEEK_SET) < 0))
+		goto fallback;
+
+	/* Boundary records are keyframes in a delta-encoded file */
+	invalidate_delta_state();
+	if (read_any_record_hdr(ifd, rec_hdr_tmp, &record_hdr[curr], file_hdr,
+				arch_64, endian_mismatch) ||
+	    (record_hdr[curr].record_type != R_STATS))
+		goto fallback;
+
+	read_file_stat_bunch(act, curr, &record_hdr[curr], ifd, file_hdr->sa_act_nr,
+			     file_actlst, endian_mismatch, arch_64, dfile, file_magic);
+
+	/* Make sure that the summary record of the next boundary record follows */
+	if (((next_pos = sa_lseek(ifd, 0, SEEK_CUR)) < 0) ||
+	    read_any_record_hdr(ifd, rec_hdr_tmp, &rec_hdr, file_hdr,
+				arch_64, endian_mismatch) ||
+	    (rec_hdr.record_type != R_SUMMARY) ||
+	    read_summary_hdr(ifd, &next_hdr, arch_64, endian_mismatch) ||
+	    (next_hdr.offset != sum_hdr->next_offset) ||
+	    (next_hdr.prev_offset != sum_hdr->offset))
+		goto fallback;
+
+	if (next_hdr.size > sum_buf_size) {
+		SREALLOC(sum_buf, char, next_hdr.size);
+		sum_buf_size = next_hdr.size;
+	}
+	if (sa_fread(ifd, sum_buf, next_hdr.size, SOFT_SIZE) ||
+	    !read_summary_gauges(act, pos, act_nr, &next_hdr, curr))
+		goto fallback;
+
+	for (i = 0; i < act_nr; i++) {
+		if (act[pos[i]]->unsampled[curr])
+			goto fallback;
+	}
+
+	for (i = 0; i < act_nr; i++) {
+		if (IS_GAUGE(act[pos[i]]->options)) {
+			merge_gauges(act[pos[i]], rgauges[pos[i]], &sgauges[pos[i]]);
+		}
+	}
+
+	/* Next summary record may be used to reach the following boundary record */
+	sa_lseek(ifd, next_pos, SEEK_SET);
+
+	return TRUE;
+
+fallback:
+	sa_restore_pos(ifd, &back);
+	return FALSE;
+}
+
+/*
+ ***************************************************************************
+ * Roll a system activity datafile up to a coarser interval. The new file
+ * has the up-to-date format and is written to STDOUT.
+ *
+ * IN:
+ * @dfile	System activity data file name.
+ * @act		Array of activities.
+ * @rollup_itv	Interval of the new file (in seconds).
+ * @agg		Value saved for gauges (ROLLUP_MEAN, ROLLUP_MIN or
+ *		ROLLUP_MAX).
+ ***************************************************************************
+ */
+void rollup_file(char dfile[], struct activity *act[], long rollup_itv, int agg)
+{
+	int ifd, stdfd, i, j, p, act_nr = 0, curr = 0, pending = FALSE, first = TRUE;
+	int use_summary, jumped;
+	int pos[NR_ACT], has_nr[NR_ACT], sampled[NR_ACT];
+	unsigned int id_seq[NR_ACT];
+	unsigned long long bucket = 0;
+	char rec_hdr_tmp[MAX_RECORD_HEADER_SIZE];
+	char file_comment[MAX_COMMENT_LEN];
+	__nr_t cpu_nr;
+	struct file_magic file_magic, new_magic;
+	struct file_header file_hdr, new_hdr;
+	struct file_activity *file_actlst = NULL, *fal, file_act;
+	struct record_header record_hdr[2];
+	struct summary_header sum_hdr;
+
+	/* Open stdout */
+	if ((stdfd = dup(STDOUT_FILENO)) < 0) {
+		perror("dup");
+		exit(2);
+	}
+
+	/* Prepare file for reading and read its headers */
+	check_file_actlst(&ifd, dfile, act, &file_magic, &file_hdr,
+			  &file_actlst, id_seq, FALSE, &endian_mismatch, &arch_64);
+
+	/*
+	 * Summary records may be used only if buckets are made of whole summary
+	 * spans, and if the structures read from file need no conversion.
+	 */
+	use_summary = !(rollup_itv % SUMMARY_SPAN) && !endian_mismatch;
+
+	/* Only activities known to current sysstat version are written */
+	for (i = 0, fal = file_actlst; i < file_hdr.sa_act_nr; i++, fal++) {
+		if (((p = get_activity_position(act, fal->id, RESUME_IF_NOT_FOUND)) < 0) ||
+		    (act[p]->magic != fal->magic))
+			continue;
+		pos[act_nr] = p;
+		has_nr[act_nr++] = fal->has_nr;
+
+		if ((fal->has_nr && !HAS_COUNT_FUNCTION(act[p]->options)) ||
+		    (fal->size != act[p]->msize) ||
+		    memcmp(fal->types_nr, act[p]->gtypes_nr, sizeof(fal->types_nr))) {
+			/* Activity may not have been sampled, or structures need remapping */
+			use_summary = FALSE;
+		}
+	}
+
+	/*
+	 * Write file magic header, file header and activity list.
+	 * NB: Those read from file are still needed to read its records.
+	 */
+	new_magic = file_magic;
+	new_magic.sysstat_magic = SYSSTAT_MAGIC;
+	new_magic.format_magic  = FORMAT_MAGIC;
+	enum_version_nr(&new_magic);
+	new_magic.header_size = FILE_HEADER_SIZE;
+	for (i = 0; i < 3; i++) {
+		new_magic.hdr_types_nr[i] = hdr_types_nr[i];
+	}
+	rollup_write(stdfd, &new_magic, FILE_MAGIC_SIZE);
+
+	new_hdr = file_hdr;
+	new_hdr.sa_act_nr = act_nr;
+	for (i = 0; i < 3; i++) {
+		new_hdr.act_types_nr[i] = act_types_nr[i];
+		new_hdr.rec_types_nr[i] = rec_types_nr[i];
+	}
+	new_hdr.act_size = FILE_ACTIVITY_SIZE;
+	new_hdr.rec_size = RECORD_HEADER_SIZE;
+	rollup_write(stdfd, &new_hdr, FILE_HEADER_SIZE);
+
+	for (i = 0; i < act_nr; i++) {
+		p = pos[i];
+		memset(&file_act, 0, FILE_ACTIVITY_SIZE);
+		file_act.id     = act[p]->id;
+		file_act.magic  = act[p]->magic;
+		file_act.nr     = act[p]->nr_ini;
+		file_act.nr2    = act[p]->nr2;
+		file_act.size   = act[p]->msize;
+		file_act.has_nr = has_nr[i];
+		for (j = 0; j < 3; j++) {
+			file_act.types_nr[j] = act[p]->gtypes_nr[j];
+		}
+		rollup_write(stdfd, &file_act, FILE_ACTIVITY_SIZE);
+	}
+
+	/* Perform required allocations */
+	allocate_structures(act);
+	memset(rgauges, 0, sizeof(rgauges));
+	memset(sampled, 0, sizeof(sampled));
+
+	while (!read_any_record_hdr(ifd, rec_hdr_tmp, &record_hdr[curr], &file_hdr,
+				    arch_64, endian_mismatch)) {
+
+		jumped = FALSE;
+
+		if (record_hdr[curr].record_type == R_SUMMARY) {
+			if (read_summary_hdr(ifd, &sum_hdr, arch_64, endian_mismatch))
+				break;
+			if (!use_summary) {
+				/* Skip summary record */
+				if (sa_lseek(ifd, (off_t) sum_hdr.size, SEEK_CUR) < 0)
+					break;
+				continue;
+			}
+			if (!read_next_boundary(ifd, act, pos, act_nr, &sum_hdr, curr,
+						record_hdr, rec_hdr_tmp, &file_hdr,
+						file_actlst, dfile, &file_magic))
+				/* Records up to next boundary record will be read */
+				continue;
+
+			/* Next boundary record has been read with its gauges */
+			jumped = TRUE;
+		}
+
+		else if (record_hdr[curr].record_type == R_COMMENT) {
+			/* Copy COMMENT record */
+			sa_fread(ifd, file_comment, MAX_COMMENT_LEN, HARD_SIZE);
+			file_comment[MAX_COMMENT_LEN - 1] = '\0';
+			rollup_write(stdfd, &record_hdr[curr], RECORD_HEADER_SIZE);
+			rollup_write(stdfd, file_comment, MAX_COMMENT_LEN);
+			continue;
+		}
+
+		else if (record_hdr[curr].record_type == R_RESTART) {
+			cpu_nr = read_nr_value(ifd, dfile, &file_magic,
+					       endian_mismatch, arch_64, TRUE);
+			file_hdr.sa_cpu_nr = cpu_nr;
+
+			/* Write last record read before the restart */
+			if (pending) {
+				write_rollup_record(stdfd, act, pos, has_nr, act_nr, sampled,
+						    &record_hdr[!curr], !curr, agg);
+				pending = FALSE;
+			}
+
+			/* Copy RESTART record */
+			rollup_write(stdfd, &record_hdr[curr], RECORD_HEADER_SIZE);
+			rollup_write(stdfd, &cpu_nr, sizeof(__nr_t));
+
+			/* Next record is the first one after the restart */
+			first = TRUE;
+			continue;
+		}
+
+		/* Read statistics */
+		if (!jumped) {
+			read_file_stat_bunch(act, curr, &record_hdr[curr], ifd, file_hdr.sa_act_nr,
+					     file_actlst, endian_mismatch, arch_64, dfile, &file_magic);
+		}
+
+		for (i = 0; i < act_nr; i++) {
+			p = pos[i];
+			if (act[p]->unsampled[curr])
+				continue;
+			sampled[p] = TRUE;
+			if (IS_GAUGE(act[p]->options) && !jumped) {
+				aggregate_gauges(act[p], rgauges[p], act[p]->buf[curr],
+						 act[p]->nr[curr] * act[p]->nr2);
+			}
+		}
+
+		if (first || (record_hdr[curr].ust_time / rollup_itv != bucket)) {
+			/* First record of a new bucket */
+			write_rollup_record(stdfd, act, pos, has_nr, act_nr, sampled,
+					    &record_hdr[curr], curr, agg);
+			pending = FALSE;
+		}
+		else {
+			pending = TRUE;
+		}
+		bucket = record_hdr[curr].ust_time / rollup_itv;
+		first = FALSE;
+		curr ^= 1;
+	}
+
+	/* Write last record read */
+	if (pending) {
+		write_rollup_record(stdfd, act, pos, has_nr, act_nr, sampled,
+				    &record_hdr[!curr], !curr, agg);
+	}
+
+	sa_close(ifd);
+	close(stdfd);
+
+	free_rollup_gauges(rgauges);
+	for (p = 0; p < NR_ACT; p++) {
+		free(sgauges[p].items);
+		free(sgauges[p].min);
+		free(sgauges[p].max);
+		free(sgauges[p].sum);
+		free(sgauges[p].cnt);
+	}
+	free(sum_buf);
+	free(rollup_buf);
+	free(file_actlst);
+	free_structures(act);
+}
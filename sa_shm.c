@@ -0,0 +1,460 @@
+/*
+ * sa_shm.c: Shared memory ring of statistics records published by sadc
+ * (C) 2026 by the sysstat developers
+ *
+ ***************************************************************************
+ * This program is free software; you can redistribute it and/or modify it *
+ * under the terms of the GNU General Public License as published  by  the *
+ * Free Software Foundation; either version 2 of the License, or (at  your *
+ * option) any later version.                                              *
+ *                                                                         *
+ * This program is distributed in the hope that it  will  be  useful,  but *
+ * WITHOUT ANY WARRANTY; without the implied warranty  of  MERCHANTABILITY *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License *
+ * for more details.                                                       *
+ *                                                                         *
+ * You should have received a copy of the GNU General Public License along *
+ * with this program; if not, write to the Free Software Foundation, Inc., *
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA              *
+ ***************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "sa_shm.h"
+
+/*
+ ***************************************************************************
+ * Start updating data protected by a sequence lock.
+ *
+ * IN:
+ * @seq		Sequence number.
+ ***************************************************************************
+ */
+static void seq_write_begin(unsigned int *seq)
+{
+	__atomic_store_n(seq, *seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/*
+ ***************************************************************************
+ * Finish updating data protected by a sequence lock.
+ *
+ * IN:
+ * @seq		Sequence number.
+ ***************************************************************************
+ */
+static void seq_write_end(unsigned int *seq)
+{
+	__atomic_store_n(seq, *seq + 1, __ATOMIC_RELEASE);
+}
+
+/*
+ ***************************************************************************
+ * Get address of the slot where a record is saved.
+ *
+ * IN:
+ * @shm		Shared memory segment.
+ * @rec_nr	Record number (the first one is 1).
+ *
+ * RETURNS:
+ * Address of the slot.
+ ***************************************************************************
+ */
+static struct sa_shm_slot *get_slot(struct sa_shm *shm, unsigned long long rec_nr)
+{
+	return (struct sa_shm_slot *)
+	       (shm->slots + ((rec_nr - 1) % shm->hdr->slot_nr) * shm->stride);
+}
+
+/*
+ ***************************************************************************
+ * Set the addresses of the different parts of a mapped segment.
+ *
+ * IN:
+ * @shm		Shared memory segment.
+ * @addr	Address of the mapping.
+ ***************************************************************************
+ */
+static void set_shm_layout(struct sa_shm *shm, void *addr)
+{
+	shm->hdr    = (struct sa_shm_hdr *) addr;
+	shm->area   = (char *) addr + SA_SHM_ALIGN(SA_SHM_HDR_SIZE);
+	shm->slots  = shm->area + SA_SHM_ALIGN(SA_SHM_HDR_AREA);
+	shm->stride = SA_SHM_SLOT_SIZE + shm->hdr->slot_size;
+}
+
+/*
+ ***************************************************************************
+ * Create a new shared memory segment. If a segment with the same name
+ * already exists, it is replaced with the new one. The new segment is
+ * created under a temporary name, then renamed, so that readers never
+ * see a partially initialized segment.
+ *
+ * IN:
+ * @name	Name of the segment in SA_SHM_DIR.
+ * @slot_size	Max size of a record.
+ *
+ * OUT:
+ * @shm		Shared memory segment.
+ *
+ * RETURNS:
+ * 0 on success, -1 otherwise (errno is set).
+ ***************************************************************************
+ */
+int sa_shm_create(struct sa_shm *shm, char *name, size_t slot_size)
+{
+	char tmp[MAX_FILE_LEN];
+	void *addr;
+	size_t size;
+	int fd, err;
+
+	if (slot_size < SA_SHM_SLOT_MIN) {
+		slot_size = SA_SHM_SLOT_MIN;
+	}
+	slot_size = SA_SHM_ALIGN(slot_size);
+	size = SA_SHM_ALIGN(SA_SHM_HDR_SIZE) + SA_SHM_ALIGN(SA_SHM_HDR_AREA) +
+	       SA_SHM_SLOT_NR * (SA_SHM_SLOT_SIZE + slot_size);
+
+	snprintf(shm->path, sizeof(shm->path), "%s/%s", SA_SHM_DIR, name);
+	snprintf(tmp, sizeof(tmp), "%s/.%s.%d", SA_SHM_DIR, name, (int) getpid());
+
+	if ((fd = open(tmp, O_CREAT | O_TRUNC | O_RDWR,
+		       S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)) < 0)
+		return -1;
+
+	if (ftruncate(fd, size) < 0)
+		goto err_unlink;
+
+	addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (addr == MAP_FAILED)
+		goto err_unlink;
+	close(fd);
+
+	/* The segment is filled with zeros: Set only non-zero values */
+	shm->size = size;
+	((struct sa_shm_hdr *) addr)->slot_size = slot_size;
+	set_shm_layout(shm, addr);
+	shm->hdr->magic   = SA_SHM_MAGIC;
+	shm->hdr->slot_nr = SA_SHM_SLOT_NR;
+	shm->hdr->pid     = (int) getpid();
+	__atomic_store_n(&(shm->hdr->state), SHM_ACTIVE, __ATOMIC_RELEASE);
+
+	if (rename(tmp, shm->path) < 0) {
+		err = errno;
+		munmap(addr, size);
+		unlink(tmp);
+		errno = err;
+		return -1;
+	}
+
+	return 0;
+
+err_unlink:
+	err = errno;
+	close(fd);
+	unlink(tmp);
+	errno = err;
+	return -1;
+}
+
+/*
+ ***************************************************************************
+ * Tell readers that a segment will no longer be updated, then unmap it.
+ * The segment is removed if sadc terminates.
+ *
+ * IN:
+ * @shm		Shared memory segment.
+ * @state	New state of the segment (SHM_STOPPED or SHM_MOVED).
+ ***************************************************************************
+ */
+void sa_shm_close(struct sa_shm *shm, unsigned int state)
+{
+	if (!shm->hdr)
+		return;
+
+	__atomic_store_n(&(shm->hdr->state), state, __ATOMIC_RELEASE);
+	if (state == SHM_STOPPED) {
+		unlink(shm->path);
+	}
+	munmap(shm->hdr, shm->size);
+	shm->hdr = NULL;
+}
+
+/*
+ ***************************************************************************
+ * Update the header area of a segment (file magic header, file header and
+ * activity list). The generation number of the header area is incremented.
+ *
+ * IN:
+ * @shm		Shared memory segment.
+ * @buf		Header data.
+ * @len		Length of header data (at most SA_SHM_HDR_AREA bytes).
+ ***************************************************************************
+ */
+void sa_shm_write_hdr(struct sa_shm *shm, void *buf, unsigned int len)
+{
+	seq_write_begin(&(shm->hdr->hdr_seq));
+	memcpy(shm->area, buf, len);
+	shm->hdr->hdr_len = len;
+	shm->hdr->hdr_gen++;
+	seq_write_end(&(shm->hdr->hdr_seq));
+}
+
+/*
+ ***************************************************************************
+ * Start writing a new record to a segment. The record will overwrite the
+ * oldest one. The caller should then save at most @slot_size bytes at the
+ * returned address, and call sa_shm_end_record().
+ *
+ * IN:
+ * @shm		Shared memory segment.
+ *
+ * RETURNS:
+ * Address where the record should be saved.
+ ***************************************************************************
+ */
+char *sa_shm_begin_record(struct sa_shm *shm)
+{
+	struct sa_shm_slot *slot;
+	unsigned long long rec_nr = shm->hdr->rec_nr + 1;
+
+	slot = get_slot(shm, rec_nr);
+	seq_write_begin(&(slot->seq));
+	slot->rec_nr = rec_nr;
+	slot->gen    = shm->hdr->hdr_gen;
+
+	return (char *) slot + SA_SHM_SLOT_SIZE;
+}
+
+/*
+ ***************************************************************************
+ * Finish writing a record to a segment, and make it visible to readers.
+ *
+ * IN:
+ * @shm		Shared memory segment.
+ * @len		Length of the record.
+ ***************************************************************************
+ */
+void sa_shm_end_record(struct sa_shm *shm, unsigned long long len)
+{
+	struct sa_shm_slot *slot;
+	unsigned long long rec_nr = shm->hdr->rec_nr + 1;
+
+	slot = get_slot(shm, rec_nr);
+	slot->len = len;
+	seq_write_end(&(slot->seq));
+
+	__atomic_store_n(&(shm->hdr->rec_nr), rec_nr, __ATOMIC_RELEASE);
+}
+
+/*
+ ***************************************************************************
+ * Map an existing segment in memory, read-only.
+ *
+ * IN:
+ * @name	Name of the segment in SA_SHM_DIR.
+ *
+ * OUT:
+ * @shm		Shared memory segment.
+ *
+ * RETURNS:
+ * 0 on success, -1 otherwise (errno is set).
+ ***************************************************************************
+ */
+int sa_shm_attach(struct sa_shm *shm, char *name)
+{
+	struct stat st;
+	struct sa_shm_hdr *hdr;
+	void *addr;
+	int fd, err;
+
+	snprintf(shm->path, sizeof(shm->path), "%s/%s", SA_SHM_DIR, name);
+
+	if ((fd = open(shm->path, O_RDONLY)) < 0)
+		return -1;
+
+	if (fstat(fd, &st) < 0) {
+		err = errno;
+		close(fd);
+		errno = err;
+		return -1;
+	}
+	if (st.st_size < SA_SHM_ALIGN(SA_SHM_HDR_SIZE) + SA_SHM_ALIGN(SA_SHM_HDR_AREA)) {
+		close(fd);
+		errno = EINVAL;
+		return -1;
+	}
+
+	addr = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	err = errno;
+	close(fd);
+	if (addr == MAP_FAILED) {
+		errno = err;
+		return -1;
+	}
+
+	/* Check that the segment is consistent */
+	hdr = (struct sa_shm_hdr *) addr;
+	if ((hdr->magic != SA_SHM_MAGIC) || !hdr->slot_nr ||
+	    (SA_SHM_ALIGN(SA_SHM_HDR_SIZE) + SA_SHM_ALIGN(SA_SHM_HDR_AREA) +
+	     hdr->slot_nr * (SA_SHM_SLOT_SIZE + hdr->slot_size) > st.st_size)) {
+		munmap(addr, st.st_size);
+		errno = EINVAL;
+		return -1;
+	}
+
+	shm->size = st.st_size;
+	set_shm_layout(shm, addr);
+
+	return 0;
+}
+
+/*
+ ***************************************************************************
+ * Unmap a segment mapped with sa_shm_attach().
+ *
+ * IN:
+ * @shm		Shared memory segment.
+ ***************************************************************************
+ */
+void sa_shm_detach(struct sa_shm *shm)
+{
+	if (shm->hdr) {
+		munmap(shm->hdr, shm->size);
+		shm->hdr = NULL;
+	}
+}
+
+/*
+ ***************************************************************************
+ * Get the state of a segment.
+ *
+ * IN:
+ * @shm		Shared memory segment.
+ *
+ * RETURNS:
+ * SHM_ACTIVE, SHM_STOPPED or SHM_MOVED.
+ ***************************************************************************
+ */
+unsigned int sa_shm_state(struct sa_shm *shm)
+{
+	return __atomic_load_n(&(shm->hdr->state), __ATOMIC_ACQUIRE);
+}
+
+/*
+ ***************************************************************************
+ * Get the number of the last record published in a segment.
+ *
+ * IN:
+ * @shm		Shared memory segment.
+ *
+ * RETURNS:
+ * Number of the last record, or 0 if no records have been published yet.
+ ***************************************************************************
+ */
+unsigned long long sa_shm_last_record(struct sa_shm *shm)
+{
+	return __atomic_load_n(&(shm->hdr->rec_nr), __ATOMIC_ACQUIRE);
+}
+
+/*
+ ***************************************************************************
+ * Copy the header area of a segment.
+ *
+ * IN:
+ * @shm		Shared memory segment.
+ *
+ * OUT:
+ * @buf		Buffer where header data are saved (SA_SHM_HDR_AREA bytes).
+ * @gen		Generation number of header data.
+ *
+ * RETURNS:
+ * Length of header data, or -1 if consistent data couldn't be read.
+ ***************************************************************************
+ */
+int sa_shm_read_hdr(struct sa_shm *shm, void *buf, unsigned int *gen)
+{
+	unsigned int seq, len;
+	int i;
+
+	for (i = 0; i < SA_SHM_SPIN_MAX; i++) {
+		seq = __atomic_load_n(&(shm->hdr->hdr_seq), __ATOMIC_ACQUIRE);
+		if (seq & 1)
+			continue;
+
+		len  = shm->hdr->hdr_len;
+		*gen = shm->hdr->hdr_gen;
+		if (len > SA_SHM_HDR_AREA) {
+			len = SA_SHM_HDR_AREA;
+		}
+		memcpy(buf, shm->area, len);
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&(shm->hdr->hdr_seq), __ATOMIC_RELAXED) == seq)
+			return len;
+	}
+
+	return -1;
+}
+
+/*
+ ***************************************************************************
+ * Copy a record from a segment.
+ *
+ * IN:
+ * @shm		Shared memory segment.
+ * @rec_nr	Number of the record to read.
+ *
+ * OUT:
+ * @buf		Buffer where the record is saved (@slot_size bytes).
+ * @gen		Generation number of the header area matching the record.
+ *
+ * RETURNS:
+ * Length of the record, or -1 if the record is no longer (or not yet)
+ * available, or if consistent data couldn't be read.
+ ***************************************************************************
+ */
+long long sa_shm_read_record(struct sa_shm *shm, unsigned long long rec_nr,
+			     void *buf, unsigned int *gen)
+{
+	struct sa_shm_slot *slot;
+	unsigned long long len, nr;
+	unsigned int seq;
+	int i;
+
+	if (!rec_nr)
+		return -1;
+
+	slot = get_slot(shm, rec_nr);
+
+	for (i = 0; i < SA_SHM_SPIN_MAX; i++) {
+		seq = __atomic_load_n(&(slot->seq), __ATOMIC_ACQUIRE);
+		if (seq & 1)
+			continue;
+
+		nr   = slot->rec_nr;
+		len  = slot->len;
+		*gen = slot->gen;
+		if (len > shm->hdr->slot_size) {
+			len = shm->hdr->slot_size;
+		}
+		if (nr == rec_nr) {
+			memcpy(buf, (char *) slot + SA_SHM_SLOT_SIZE, len);
+		}
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&(slot->seq), __ATOMIC_RELAXED) == seq)
+			return (nr == rec_nr) ? (long long) len : -1;
+	}
+
+	return -1;
+}
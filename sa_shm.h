@@ -0,0 +1,162 @@
+/*
+ * sa_shm.h: Include file for the shared memory ring of statistics records
+ * (C) 2026 by the sysstat developers
+ */
+
+#ifndef _SA_SHM_H
+#define _SA_SHM_H
+
+#include "sa.h"
+
+/*
+ ***************************************************************************
+ * Definitions for the shared memory segment where sadc publishes the
+ * statistics records it collects (option --shm).
+ *
+ * The segment is a file located in SA_SHM_DIR. It contains:
+ *
+ * +----------------------------------------------------------------+
+ * | struct sa_shm_hdr                                              |
+ * +----------------------------------------------------------------+
+ * | Header area (SA_SHM_HDR_AREA bytes): file_magic structure,     |
+ * | file_header structure, then file_activity list, exactly as     |
+ * | sent by sadc on its standard output.                           |
+ * +----------------------------------------------------------------+
+ * | Slot #0: struct sa_shm_slot, followed by @slot_size bytes      |
+ * | where a record is saved (record_header structure, then the     |
+ * | statistics, exactly as sent by sadc on its standard output).   |
+ * +----------------------------------------------------------------+
+ * | ...                                                            |
+ * +----------------------------------------------------------------+
+ * | Slot #(@slot_nr - 1)                                           |
+ * +----------------------------------------------------------------+
+ *
+ * Record #n (the first record is #1) is saved in slot #((n - 1) % @slot_nr).
+ * The header area and each slot are protected by a sequence lock: Their
+ * sequence number is odd while they are being updated. Readers copy data
+ * then check that the sequence number has not changed, and retry if
+ * needed. Readers never write to the segment.
+ * The generation number is incremented each time the header area is
+ * updated (i.e. when the number of items or the list of activities has
+ * changed). Each record is tagged with the generation number of the
+ * header area it matches.
+ ***************************************************************************
+ */
+
+/* Directory where shared memory segments are created */
+#define SA_SHM_DIR	"/dev/shm"
+
+#define SA_SHM_MAGIC	0xd5a5
+
+/* Number of records kept in shared memory */
+#define SA_SHM_SLOT_NR	16
+
+/* Min size of a slot, in bytes */
+#define SA_SHM_SLOT_MIN	4096
+
+/* Max number of attempts to read consistent data */
+#define SA_SHM_SPIN_MAX	1000000
+
+/* Delay between two checks for a new record (in ns) */
+#define SA_SHM_POLL_DELAY	100000000
+
+/*
+ * Tolerance (in 1/100th of a second) when checking that enough time has
+ * elapsed since last record displayed. Never more than a quarter of the
+ * interval, so that sub-second intervals are honored.
+ */
+#define SA_SHM_ITV_MARGIN	50
+
+/* Segment states */
+#define SHM_STOPPED	0	/* sadc has terminated */
+#define SHM_ACTIVE	1
+#define SHM_MOVED	2	/* Segment has been replaced with a new one */
+
+/* Max size of header area */
+#define SA_SHM_HDR_AREA	(FILE_MAGIC_SIZE + FILE_HEADER_SIZE + NR_ACT * FILE_ACTIVITY_SIZE)
+
+/* Round a size up to a multiple of 8 bytes */
+#define SA_SHM_ALIGN(s)	(((s) + 7) & ~((size_t) 7))
+
+/* Header of the shared memory segment */
+struct sa_shm_hdr {
+	unsigned int magic;
+	/* State of the segment (SHM_ACTIVE, SHM_STOPPED, SHM_MOVED) */
+	unsigned int state;
+	/* Sequence number of the header area */
+	unsigned int hdr_seq;
+	/* Generation number of the header area */
+	unsigned int hdr_gen;
+	/* Length of data saved in the header area */
+	unsigned int hdr_len;
+	/* Number of slots */
+	unsigned int slot_nr;
+	/* Size of each slot (excluding struct sa_shm_slot) */
+	unsigned long long slot_size;
+	/* Number of records published so far */
+	unsigned long long rec_nr;
+	/* PID of sadc */
+	int pid;
+};
+
+#define SA_SHM_HDR_SIZE	(sizeof(struct sa_shm_hdr))
+
+/* Header of a slot */
+struct sa_shm_slot {
+	/* Sequence number of the slot */
+	unsigned int seq;
+	/* Generation number of the header area matching the record */
+	unsigned int gen;
+	/* Number of the record saved in the slot */
+	unsigned long long rec_nr;
+	/* Length of the record */
+	unsigned long long len;
+};
+
+#define SA_SHM_SLOT_SIZE	(sizeof(struct sa_shm_slot))
+
+/* Shared memory segment, as seen from a process */
+struct sa_shm {
+	struct sa_shm_hdr *hdr;
+	char *area;
+	char *slots;
+	/* Size of the mapping */
+	size_t size;
+	/* Distance between two consecutive slots */
+	size_t stride;
+	char path[MAX_FILE_LEN];
+};
+
+/*
+ ***************************************************************************
+ * Functions prototypes.
+ ***************************************************************************
+ */
+
+/* Used by sadc */
+int sa_shm_create
+	(struct sa_shm *, char *, size_t);
+void sa_shm_close
+	(struct sa_shm *, unsigned int);
+void sa_shm_write_hdr
+	(struct sa_shm *, void *, unsigned int);
+char *sa_shm_begin_record
+	(struct sa_shm *);
+void sa_shm_end_record
+	(struct sa_shm *, unsigned long long);
+
+/* Used by readers */
+int sa_shm_attach
+	(struct sa_shm *, char *);
+void sa_shm_detach
+	(struct sa_shm *);
+unsigned int sa_shm_state
+	(struct sa_shm *);
+unsigned long long sa_shm_last_record
+	(struct sa_shm *);
+int sa_shm_read_hdr
+	(struct sa_shm *, void *, unsigned int *);
+long long sa_shm_read_record
+	(struct sa_shm *, unsigned long long, void *, unsigned int *);
+
+#endif  /* _SA_SHM_H */
@@ -20,6 +20,7 @@
  */
 
 #include <stdio.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdlib.h>
 #include <ctype.h>
@@ -31,10 +32,14 @@
 #include <dirent.h>
 #include <sys/file.h>
 #include <sys/stat.h>
+#include <sys/select.h>
 #include <sys/utsname.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 
 #include "version.h"
 #include "sa.h"
+#include "sa_shm.h"
 
 #ifdef USE_NLS
 #include <locale.h>
@@ -54,6 +59,7 @@
 char *sccsid(void) { return (SCCSID); }
 #endif
 
+/* Interval between two samples, in milliseconds */
 long interval = 0;
 unsigned int flags = 0;
 
@@ -66,8 +72,50 @@ struct record_header record_hdr;
 
 char comment[MAX_COMMENT_LEN];
 
+/* File descriptor of index file (-1 if the data file is not indexed) */
+int idx_fd = -1;
+
+/*
+ * TRUE if statistics records are delta-encoded in output file.
+ * @dlt_count is the number of records written since last keyframe, and
+ * @dlt_prev contains the structures written in previous record for
+ * each activity.
+ */
+int delta_fmt = FALSE;
+int dlt_count = 0;
+struct sa_delta dlt_prev[NR_ACT];
+struct sa_delta dlt_enc = {NULL, 0, 0, 0};
+
+/*
+ * Summary records (option --summary).
+ * @sum_due is TRUE if current statistics record is a boundary record.
+ * @sum_gauges contains the gauges aggregated since the previous boundary
+ * record, @sum_end is the size of the data file once the last statistics
+ * record has been saved (0 if none has been saved in current file yet),
+ * and @sum_boundary and @sum_offset are the offsets of the last boundary
+ * record and of its summary record.
+ */
+int sum_due = FALSE;
+struct rollup_gauges sum_gauges[NR_ACT][2];
+off_t sum_end = 0, sum_boundary = 0, sum_offset = 0;
+unsigned long long sum_hour = 0, sum_record_nr = 0;
+
 unsigned int id_seq[NR_ACT];
 
+/* Shared memory segment where records are published (option --shm) */
+struct sa_shm shm;
+char shm_name[MAX_FILE_LEN];
+
+/*
+ * System files read at each sample. They are opened once and kept open
+ * while sadc is running.
+ */
+char *sys_files[] = {STAT, UPTIME, MEMINFO, LOADAVG, VMSTAT, DISKSTATS,
+		     SERIAL, FDENTRY_STATE, FFILE_NR, FINODE_STATE, PTY_NR,
+		     NET_DEV, NET_SOCKSTAT, NET_SOCKSTAT6, NET_RPC_NFS,
+		     NET_RPC_NFSD, NET_SNMP, NET_SNMP6, NET_SOFTNET, CPUINFO,
+		     NULL};
+
 extern unsigned int hdr_types_nr[];
 extern unsigned int act_types_nr[];
 extern unsigned int rec_types_nr[];
@@ -75,9 +123,37 @@ extern unsigned int rec_types_nr[];
 extern struct activity *act[];
 extern __nr_t (*f_count[]) (struct activity *);
 
-struct sigaction alrm_act, int_act;
+struct sigaction int_act;
 int sigint_caught = 0;
 
+/* Deadlines of the samples */
+struct sched_timer sched;
+
+/* Clients connected to the Unix socket sadc listens on (option --listen) */
+char sock_path[MAX_FILE_LEN];
+int listen_fd = -1;
+struct sa_client clients[MAX_SA_CLIENTS];
+int client_nr = 0;
+/* Number of current sample (the first one is 0) */
+unsigned long long tick_nr = 0;
+/* Buffer used to build the records sent to clients */
+char *rec_buf = NULL;
+size_t rec_buf_size = 0;
+
+/* Worker threads reading slow activities, indexed by position in act[] array */
+struct sa_worker *workers[NR_ACT];
+
+/* TRUE if activity at position @p in act[] array should be sent */
+#define IS_SENT(p, want)	(IS_COLLECTED(act[p]->options) && (!(want) || (want)[p]))
+
+/*
+ * TRUE if activity at position @p in act[] array should be sampled in current
+ * record. Activities are all sampled in the last record saved in a file, so
+ * that the next file starts with a complete record.
+ */
+#define IS_DUE(p)	((act[p]->itv_mult <= 1) || !(tick_nr % act[p]->itv_mult) || \
+			 (record_hdr.record_type == R_LAST_STATS))
+
 /*
  ***************************************************************************
  * Print usage and exit.
@@ -92,7 +168,8 @@ void usage(char *progname)
 		progname);
 
 	fprintf(stderr, _("Options are:\n"
-			  "[ -C <comment> ] [ -D ] [ -F ] [ -L ] [ -V ]\n"
+			  "[ -C <comment> ] [ -D ] [ -F ] [ -I ] [ -L ] [ -V ] [ -z ]\n"
+			  "[ --listen <socket> ] [ --shm <name> ] [ --summary ]\n"
 			  "[ -S { INT | DISK | IPV6 | POWER | SNMP | XDISK | ALL | XALL } ]\n"));
 	exit(1);
 }
@@ -131,8 +208,8 @@ void collect_group_activities(unsigned int group_id, unsigned int opt_f)
  */
 void parse_sadc_S_option(char *argv[], int opt)
 {
-	char *p;
-	int i;
+	char *p, *m;
+	int i, mult;
 
 	for (p = strtok(argv[opt], ","); p; p = strtok(NULL, ",")) {
 		if (!strcmp(p, K_INT)) {
@@ -184,10 +261,28 @@ void parse_sadc_S_option(char *argv[], int opt)
 			}
 		}
 		else if (!strncmp(p, "A_", 2)) {
-			/* Select activity by name */
+			/*
+			 * Select activity by name. It may be followed by
+			 * its own interval, as a multiple of sadc's one (A_xxx:N).
+			 */
+			mult = 1;
+			if ((m = strchr(p, ':')) != NULL) {
+				*(m++) = '\0';
+				if (!*m || (strspn(m, DIGITS) != strlen(m)) ||
+				    ((mult = atoi(m)) < 1)) {
+					usage(argv[0]);
+				}
+			}
 			for (i = 0; i < NR_ACT; i++) {
 				if (!strcmp(p, act[i]->name)) {
 					act[i]->options |= AO_COLLECTED;
+					act[i]->itv_mult = mult;
+					if (mult > 1) {
+						act[i]->options |= AO_SPARSE;
+					}
+					else {
+						act[i]->options &= ~AO_SPARSE;
+					}
 					break;
 				}
 			}
@@ -203,20 +298,8 @@ void parse_sadc_S_option(char *argv[], int opt)
 
 /*
  ***************************************************************************
- * SIGALRM signal handler. No need to reset handler here.
- *
- * IN:
- * @sig	Signal number.
- ***************************************************************************
- */
-void alarm_handler(int sig)
-{
-	alarm(interval);
-}
-
-/*
- ***************************************************************************
- * SIGINT signal handler.
+ * SIGINT signal handler. Also used for SIGTERM when records are published
+ * in shared memory or sent on a socket.
  *
  * IN:
  * @sig	Signal number.
@@ -228,6 +311,13 @@ void int_handler(int sig)
 
 	sigint_caught = 1;
 
+	if (USE_SHM(flags) || USE_SOCKET(flags))
+		/*
+		 * Let the main loop stop, so that readers and clients
+		 * are told that no more records will be sent.
+		 */
+		return;
+
 	if (!optz || (ppid == 1)) {
 		/* sadc hasn't been called by sar or sar process is already dead */
 		exit(1);
@@ -292,6 +382,8 @@ void reset_stats(void)
  * If a file is rotated and structures are reallocated with a larger size,
  * additional space is not initialized: It doesn't matter as reset_stats()
  * will do it later.
+ * System files that will be read at each sample are also opened here
+ * (if not already done).
  ***************************************************************************
  */
 void sa_sys_init(void)
@@ -299,6 +391,13 @@ void sa_sys_init(void)
 	int i, idx;
 	__nr_t f_count_results[NR_F_COUNT];
 
+	/* Open system files once and for all */
+	for (i = 0; sys_files[i]; i++) {
+		open_cached_file(sys_files[i]);
+	}
+	/* Items are counted using current contents of these files */
+	invalidate_cached_files();
+
 	/* Init array. Means that no items have been counted yet */
 	for (i = 0; i < NR_F_COUNT; i++) {
 		f_count_results[i] = -1;
@@ -356,6 +455,8 @@ void sa_sys_free(void)
 {
 	int i;
 
+	close_cached_files();
+
 	for (i = 0; i < NR_ACT; i++) {
 
 		if (act[i]->nr_allocated > 0) {
@@ -454,16 +555,17 @@ int ask_for_flock(int fd, int fatal)
  *
  * IN:
  * @file_magic	System activity file magic header.
+ * @delta	TRUE if statistics records will be delta-encoded.
  ***************************************************************************
  */
-void fill_magic_header(struct file_magic *file_magic)
+void fill_magic_header(struct file_magic *file_magic, int delta)
 {
 	int i;
 
 	memset(file_magic, 0, FILE_MAGIC_SIZE);
 
 	file_magic->sysstat_magic = SYSSTAT_MAGIC;
-	file_magic->format_magic  = FORMAT_MAGIC;
+	file_magic->format_magic  = delta ? FORMAT_MAGIC_DELTA : FORMAT_MAGIC;
 
 	enum_version_nr(file_magic);
 
@@ -476,26 +578,34 @@ void fill_magic_header(struct file_magic *file_magic)
 
 /*
  ***************************************************************************
- * Fill system activity file header, then write it (or print it if stdout).
+ * Fill system activity file magic header, file header and activity list.
  *
  * IN:
- * @fd	Output file descriptor. May be stdout.
+ * @delta	TRUE if statistics records will be delta-encoded.
+ * @want	Activities to include in the list (indexed by position in
+ *		act[] array), or NULL for all the collected activities.
+ *
+ * OUT:
+ * @hbuf	Buffer where the headers and the activity list are saved
+ *		(SA_SHM_HDR_AREA bytes).
+ *
+ * RETURNS:
+ * Number of bytes saved in @hbuf.
  ***************************************************************************
  */
-void setup_file_hdr(int fd)
+int fill_file_hdr(char *hbuf, int delta, unsigned char want[])
 {
-	int i, j, p;
+	int i, j, p, len;
 	struct tm rectime;
 	struct utsname header;
 	struct file_magic file_magic;
 	struct file_activity file_act;
 
-	/* Fill then write file magic header */
-	fill_magic_header(&file_magic);
+	/* Fill file magic header */
+	fill_magic_header(&file_magic, delta);
 
-	if (write_all(fd, &file_magic, FILE_MAGIC_SIZE) != FILE_MAGIC_SIZE) {
-		p_write_error();
-	}
+	memcpy(hbuf, &file_magic, FILE_MAGIC_SIZE);
+	len = FILE_MAGIC_SIZE;
 
 	/* First reset the structure */
 	memset(&file_hdr, 0, FILE_HEADER_SIZE);
@@ -504,7 +614,16 @@ void setup_file_hdr(int fd)
 	file_hdr.sa_ust_time = (unsigned long long) get_time(&rectime, 0);
 
 	/* OK, now fill the header */
-	file_hdr.sa_act_nr      = get_activity_nr(act, AO_COLLECTED, COUNT_ACTIVITIES);
+	if (want) {
+		for (i = 0; i < NR_ACT; i++) {
+			if (IS_SENT(i, want)) {
+				file_hdr.sa_act_nr++;
+			}
+		}
+	}
+	else {
+		file_hdr.sa_act_nr = get_activity_nr(act, AO_COLLECTED, COUNT_ACTIVITIES);
+	}
 	file_hdr.sa_day         = rectime.tm_mday;
 	file_hdr.sa_month       = rectime.tm_mon;
 	file_hdr.sa_year        = rectime.tm_year;
@@ -538,12 +657,11 @@ void setup_file_hdr(int fd)
 	strncpy(file_hdr.sa_machine, header.machine, UTSNAME_LEN);
 	file_hdr.sa_machine[UTSNAME_LEN - 1]  = '\0';
 
-	/* Write file header */
-	if (write_all(fd, &file_hdr, FILE_HEADER_SIZE) != FILE_HEADER_SIZE) {
-		p_write_error();
-	}
+	/* Save file header */
+	memcpy(hbuf + len, &file_hdr, FILE_HEADER_SIZE);
+	len += FILE_HEADER_SIZE;
 
-	/* Write activity list */
+	/* Save activity list */
 	for (i = 0; i < NR_ACT; i++) {
 
 		/*
@@ -555,7 +673,7 @@ void setup_file_hdr(int fd)
 		if ((p = get_activity_position(act, id_seq[i], RESUME_IF_NOT_FOUND)) < 0)
 			continue;
 
-		if (IS_COLLECTED(act[p]->options)) {
+		if (IS_SENT(p, want)) {
 			file_act.id    = act[p]->id;
 			file_act.magic = act[p]->magic;
 			file_act.nr    = act[p]->nr_ini;
@@ -565,116 +683,1129 @@ void setup_file_hdr(int fd)
 				file_act.types_nr[j] = act[p]->gtypes_nr[j];
 			}
 
-			file_act.has_nr = HAS_COUNT_FUNCTION(act[p]->options);
+			file_act.has_nr = HAS_NR_VALUE(act[p]->options);
+
+			memcpy(hbuf + len, &file_act, FILE_ACTIVITY_SIZE);
+			len += FILE_ACTIVITY_SIZE;
+		}
+	}
+
+	return len;
+}
+
+/*
+ ***************************************************************************
+ * Fill system activity file header, then write it (or print it if stdout).
+ *
+ * IN:
+ * @fd		Output file descriptor. May be stdout.
+ * @delta	TRUE if statistics records will be delta-encoded.
+ ***************************************************************************
+ */
+void setup_file_hdr(int fd, int delta)
+{
+	char hbuf[SA_SHM_HDR_AREA];
+	int len;
+
+	len = fill_file_hdr(hbuf, delta, NULL);
+
+	if (write_all(fd, hbuf, len) != len) {
+		p_write_error();
+	}
+}
+
+/*
+ ***************************************************************************
+ * Write the new number of CPU after the RESTART record in file.
+ *
+ * IN:
+ * @ofd		Output file descriptor.
+ ***************************************************************************
+ */
+void write_new_cpu_nr(int ofd)
+{
+	int p;
+
+	p = get_activity_position(act, A_CPU, EXIT_IF_NOT_FOUND);
+
+	if (write_all(ofd, &(act[p]->nr_ini), sizeof(__nr_t)) != sizeof(__nr_t)) {
+		p_write_error();
+	}
+}
+
+/*
+ ***************************************************************************
+ * sadc called with interval and count parameters not set:
+ * Write a dummy record notifying a system restart, or insert a comment in
+ * binary data file if option -C has been used.
+ * Writing a dummy record should typically be done at boot time,
+ * before the cron daemon is started to avoid conflict with sa1/sa2 scripts.
+ *
+ * IN:
+ * @ofd		Output file descriptor.
+ * @rtype	Record type to write (dummy or comment).
+ ***************************************************************************
+ */
+void write_special_record(int ofd, int rtype)
+{
+	struct tm rectime = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, NULL};
+
+	/* Check if file is locked */
+	if (!FILE_LOCKED(flags)) {
+		ask_for_flock(ofd, FATAL);
+	}
+
+	/* Reset the structure (not compulsory, but a bit cleaner) */
+	memset(&record_hdr, 0, RECORD_HEADER_SIZE);
+
+	/* Set record type */
+	record_hdr.record_type = rtype;
+
+	/* Save time */
+	record_hdr.ust_time = (unsigned long long) get_time(&rectime, 0);
+
+	record_hdr.hour   = rectime.tm_hour;
+	record_hdr.minute = rectime.tm_min;
+	record_hdr.second = rectime.tm_sec;
+
+	/* Write record now */
+	if (write_all(ofd, &record_hdr, RECORD_HEADER_SIZE) != RECORD_HEADER_SIZE) {
+		p_write_error();
+	}
+
+	if (rtype == R_RESTART) {
+		/* Also write the new number of CPU */
+		write_new_cpu_nr(ofd);
+	}
+	else if (rtype == R_COMMENT) {
+		/* Also write the comment */
+		if (write_all(ofd, comment, MAX_COMMENT_LEN) != MAX_COMMENT_LEN) {
+			p_write_error();
+		}
+	}
+}
+
+/*
+ ***************************************************************************
+ * Delta-encode the statistics of current sample: Each structure is
+ * encoded against the same structure written in previous record, unless
+ * a keyframe is due. See the description of FORMAT_MAGIC_DELTA datafiles
+ * in sa.h.
+ *
+ * IN:
+ * @keyframe	TRUE if the record should be a keyframe.
+ *
+ * RETURNS:
+ * Number of bytes saved in @dlt_enc buffer.
+ ***************************************************************************
+ */
+size_t encode_delta_stats(int keyframe)
+{
+	int i, j, p, nr;
+	size_t n, max;
+	char *prev;
+
+	/* Get max size of encoded record */
+	max = 1;
+	for (i = 0; i < NR_ACT; i++) {
+		if (!id_seq[i])
+			continue;
+		if ((p = get_activity_position(act, id_seq[i], RESUME_IF_NOT_FOUND)) < 0)
+			continue;
+		if (IS_COLLECTED(act[p]->options)) {
+			max += 2 * VARINT_MAX_SIZE +
+			       (size_t) act[p]->_nr0 * act[p]->nr2 * DELTA_MAX_SIZE(act[p]->fsize);
+		}
+	}
+	if (max > dlt_enc.size) {
+		SREALLOC(dlt_enc.buf, char, max);
+		dlt_enc.size = max;
+	}
+
+	dlt_enc.buf[0] = keyframe ? DELTA_KEYFRAME : DELTA_FRAME;
+	dlt_enc.len = 1;
+
+	for (i = 0; i < NR_ACT; i++) {
+
+		if (!id_seq[i])
+			continue;
+		if ((p = get_activity_position(act, id_seq[i], RESUME_IF_NOT_FOUND)) < 0)
+			continue;
+		if (!IS_COLLECTED(act[p]->options))
+			continue;
+
+		if (act[p]->unsampled[0]) {
+			/* Activity not sampled: No structures are saved */
+			dlt_enc.len += put_varint((unsigned char *) dlt_enc.buf + dlt_enc.len,
+						  DELTA_NOT_SAMPLED);
+			dlt_enc.len += put_varint((unsigned char *) dlt_enc.buf + dlt_enc.len, 0);
+			continue;
+		}
+
+		nr = act[p]->_nr0 * act[p]->nr2;
+		if (HAS_NR_VALUE(act[p]->options)) {
+			dlt_enc.len += put_varint((unsigned char *) dlt_enc.buf + dlt_enc.len,
+						  (unsigned long long) act[p]->_nr0);
+		}
+
+		/* Encode structures first, then save their size before them */
+		n = 0;
+		for (j = 0; j < nr; j++) {
+			prev = (!keyframe && (j < dlt_prev[p].nr))
+			       ? dlt_prev[p].buf + j * act[p]->fsize : NULL;
+			n += encode_delta_struct((unsigned char *) dlt_enc.buf + dlt_enc.len +
+						 VARINT_MAX_SIZE + n,
+						 (char *) act[p]->_buf0 + j * act[p]->fsize, prev,
+						 act[p]->gtypes_nr, act[p]->fsize);
+		}
+		j = put_varint((unsigned char *) dlt_enc.buf + dlt_enc.len, (unsigned long long) n);
+		memmove(dlt_enc.buf + dlt_enc.len + j,
+			dlt_enc.buf + dlt_enc.len + VARINT_MAX_SIZE, n);
+		dlt_enc.len += j + n;
+	}
+
+	return dlt_enc.len;
+}
+
+/*
+ ***************************************************************************
+ * Save the structures of current sample. They will be used to
+ * delta-encode the next record.
+ *
+ * IN:
+ * @keyframe	TRUE if current record is a keyframe.
+ ***************************************************************************
+ */
+void save_delta_stats(int keyframe)
+{
+	int i, p;
+	struct sa_delta cur;
+
+	for (i = 0; i < NR_ACT; i++) {
+
+		if (!id_seq[i])
+			continue;
+		if ((p = get_activity_position(act, id_seq[i], RESUME_IF_NOT_FOUND)) < 0)
+			continue;
+		if (!IS_COLLECTED(act[p]->options))
+			continue;
+
+		if (act[p]->unsampled[0]) {
+			/*
+			 * Keep the structures from the last record where the activity
+			 * was sampled, unless a keyframe has been saved since then.
+			 */
+			if (keyframe) {
+				dlt_prev[p].nr = 0;
+			}
+			continue;
+		}
+
+		cur.buf = (char *) act[p]->_buf0;
+		cur.nr  = act[p]->_nr0 * act[p]->nr2;
+		cur.len = (size_t) cur.nr * act[p]->fsize;
+		copy_delta(&dlt_prev[p], &cur);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Write stats (or print them if stdout).
+ *
+ * IN:
+ * @ofd		Output file descriptor. May be stdout.
+ * @delta	TRUE if statistics should be delta-encoded.
+ ***************************************************************************
+ */
+void write_stats(int ofd, int delta)
+{
+	int i, p, keyframe;
+	__nr_t nr;
+	size_t len;
+
+	/* Try to lock file */
+	if (!FILE_LOCKED(flags)) {
+		if (ask_for_flock(ofd, NON_FATAL))
+			/*
+			 * Unable to lock file:
+			 * Wait for next iteration to try again to save data.
+			 */
+			return;
+	}
+
+	/* Write record header */
+	if (write_all(ofd, &record_hdr, RECORD_HEADER_SIZE) != RECORD_HEADER_SIZE) {
+		p_write_error();
+	}
+
+	if (delta) {
+		/* Write a keyframe every DELTA_KEYFRAME_NR records, and for boundary records */
+		if (sum_due) {
+			dlt_count = 0;
+		}
+		keyframe = !(dlt_count % DELTA_KEYFRAME_NR);
+		len = encode_delta_stats(keyframe);
+		if (write_all(ofd, dlt_enc.buf, len) != len) {
+			p_write_error();
+		}
+		save_delta_stats(keyframe);
+		dlt_count++;
+		return;
+	}
+
+	/* Then write all statistics */
+	for (i = 0; i < NR_ACT; i++) {
+
+		if (!id_seq[i])
+			continue;
+		if ((p = get_activity_position(act, id_seq[i], RESUME_IF_NOT_FOUND)) < 0)
+			continue;
+
+		if (IS_COLLECTED(act[p]->options)) {
+			nr = act[p]->unsampled[0] ? NR_NOT_SAMPLED : act[p]->_nr0;
+			if (HAS_NR_VALUE(act[p]->options)) {
+				if (write_all(ofd, &nr, sizeof(__nr_t)) != sizeof(__nr_t)) {
+					p_write_error();
+				}
+			}
+			if (nr <= 0)
+				continue;
+			if (write_all(ofd, act[p]->_buf0, act[p]->fsize * nr * act[p]->nr2) !=
+			    (act[p]->fsize * nr * act[p]->nr2)) {
+				p_write_error();
+			}
+		}
+	}
+}
+
+/*
+ ***************************************************************************
+ * Get the max size of a statistics record, given the number of items
+ * allocated for each activity.
+ *
+ * RETURNS:
+ * Max size of a record, in bytes.
+ ***************************************************************************
+ */
+size_t get_max_record_size(void)
+{
+	int i, p;
+	size_t size = RECORD_HEADER_SIZE;
+
+	for (i = 0; i < NR_ACT; i++) {
+
+		if (!id_seq[i])
+			continue;
+		if ((p = get_activity_position(act, id_seq[i], RESUME_IF_NOT_FOUND)) < 0)
+			continue;
+
+		if (IS_COLLECTED(act[p]->options)) {
+			if (act[p]->f_count_index >= 0) {
+				size += sizeof(__nr_t);
+			}
+			size += (size_t) act[p]->fsize * act[p]->nr_allocated * act[p]->nr2;
+		}
+	}
+
+	return size;
+}
+
+/*
+ ***************************************************************************
+ * Create the shared memory segment where records are published, or
+ * replace it with a new one, then publish the header data. The segment is
+ * replaced when the number of items or the list of activities has changed
+ * so that a record may no longer fit in a slot.
+ ***************************************************************************
+ */
+void open_shm(void)
+{
+	struct sa_shm old = shm;
+	char hbuf[SA_SHM_HDR_AREA];
+	int len;
+
+	if (sa_shm_create(&shm, shm_name, get_max_record_size()) < 0) {
+		fprintf(stderr, _("Cannot open %s: %s\n"), shm.path, strerror(errno));
+		exit(2);
+	}
+
+	len = fill_file_hdr(hbuf, FALSE, NULL);
+	sa_shm_write_hdr(&shm, hbuf, len);
+
+	/* Tell readers of previous segment to attach to the new one */
+	sa_shm_close(&old, SHM_MOVED);
+}
+
+/*
+ ***************************************************************************
+ * Update header data published in shared memory, e.g. because the number
+ * of items may have changed.
+ ***************************************************************************
+ */
+void write_shm_hdr(void)
+{
+	char hbuf[SA_SHM_HDR_AREA];
+	int len;
+
+	if (get_max_record_size() > shm.hdr->slot_size) {
+		open_shm();
+		return;
+	}
+
+	len = fill_file_hdr(hbuf, FALSE, NULL);
+	sa_shm_write_hdr(&shm, hbuf, len);
+}
+
+/*
+ ***************************************************************************
+ * Save current statistics record in a buffer, using the same layout as
+ * the records sent on STDOUT.
+ *
+ * IN:
+ * @want	Activities to include in the record (indexed by position in
+ *		act[] array), or NULL for all the collected activities.
+ *
+ * OUT:
+ * @buf		Buffer where the record is saved. Its size must be at least
+ *		that returned by get_max_record_size().
+ *
+ * RETURNS:
+ * Size of the record, in bytes.
+ ***************************************************************************
+ */
+size_t fill_stats_record(char *buf, unsigned char want[])
+{
+	int i, p;
+	__nr_t nr;
+	size_t size, len;
+
+	memcpy(buf, &record_hdr, RECORD_HEADER_SIZE);
+	len = RECORD_HEADER_SIZE;
+
+	for (i = 0; i < NR_ACT; i++) {
+
+		if (!id_seq[i])
+			continue;
+		if ((p = get_activity_position(act, id_seq[i], RESUME_IF_NOT_FOUND)) < 0)
+			continue;
+
+		if (IS_SENT(p, want)) {
+			nr = act[p]->unsampled[0] ? NR_NOT_SAMPLED : act[p]->_nr0;
+			if (HAS_NR_VALUE(act[p]->options)) {
+				memcpy(buf + len, &nr, sizeof(__nr_t));
+				len += sizeof(__nr_t);
+			}
+			if (nr <= 0)
+				continue;
+			size = (size_t) act[p]->fsize * nr * act[p]->nr2;
+			memcpy(buf + len, act[p]->_buf0, size);
+			len += size;
+		}
+	}
+
+	return len;
+}
+
+/*
+ ***************************************************************************
+ * Publish current statistics record in shared memory. The record has the
+ * same layout as the records sent on STDOUT.
+ ***************************************************************************
+ */
+void write_shm_stats(void)
+{
+	char *buf;
+
+	if (get_max_record_size() > shm.hdr->slot_size) {
+		/* Some buffers have been reallocated: Need a larger segment */
+		open_shm();
+	}
+
+	buf = sa_shm_begin_record(&shm);
+	sa_shm_end_record(&shm, fill_stats_record(buf, NULL));
+}
+
+/*
+ ***************************************************************************
+ * Create the Unix socket on which sadc listens for clients.
+ ***************************************************************************
+ */
+void open_listen_socket(void)
+{
+	struct sockaddr_un addr;
+	struct stat st;
+	size_t len;
+	int fd, err;
+
+	if ((len = strlen(sock_path)) >= sizeof(addr.sun_path)) {
+		fprintf(stderr, _("Socket name too long: %s\n"), sock_path);
+		exit(2);
+	}
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	memcpy(addr.sun_path, sock_path, len);
+
+	/*
+	 * Remove socket left by a previous sadc process, unless another
+	 * process is still listening on it.
+	 */
+	if (!lstat(sock_path, &st) && S_ISSOCK(st.st_mode) &&
+	    ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) >= 0)) {
+		err = connect(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0 ? errno : 0;
+		close(fd);
+		if (!err) {
+			fprintf(stderr, _("Cannot open %s: %s\n"), sock_path, strerror(EADDRINUSE));
+			exit(2);
+		}
+		if (err == ECONNREFUSED) {
+			unlink(sock_path);
+		}
+	}
+
+	if (((listen_fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) ||
+	    (bind(listen_fd, (struct sockaddr *) &addr, sizeof(addr)) < 0) ||
+	    (listen(listen_fd, MAX_SA_CLIENTS) < 0)) {
+		fprintf(stderr, _("Cannot open %s: %s\n"), sock_path, strerror(errno));
+		exit(2);
+	}
+	fcntl(listen_fd, F_SETFL, O_NONBLOCK);
+}
+
+/*
+ ***************************************************************************
+ * Close all client connections and remove the Unix socket.
+ ***************************************************************************
+ */
+void close_listen_socket(void)
+{
+	int i;
+
+	if (listen_fd < 0)
+		return;
+
+	for (i = 0; i < client_nr; i++) {
+		close(clients[i].fd);
+	}
+	client_nr = 0;
+	close(listen_fd);
+	listen_fd = -1;
+	unlink(sock_path);
+	free(rec_buf);
+}
+
+/*
+ ***************************************************************************
+ * Close the connection with a client.
+ *
+ * IN:
+ * @i		Index of the client in clients[] array.
+ ***************************************************************************
+ */
+void drop_client(int i)
+{
+	close(clients[i].fd);
+	clients[i] = clients[--client_nr];
+}
+
+/*
+ ***************************************************************************
+ * Send data to a client. The socket is never waited for: A client which
+ * doesn't read its data fast enough is disconnected.
+ *
+ * IN:
+ * @i		Index of the client in clients[] array.
+ * @buf		Data to send.
+ * @len		Number of bytes to send.
+ *
+ * RETURNS:
+ * 0 on success, or -1 if the client has been disconnected.
+ ***************************************************************************
+ */
+int send_client(int i, void *buf, size_t len)
+{
+	ssize_t n;
+
+	do {
+		n = send(clients[i].fd, buf, len, MSG_DONTWAIT | MSG_NOSIGNAL);
+	}
+	while ((n < 0) && (errno == EINTR));
+
+	if (n != (ssize_t) len) {
+		drop_client(i);
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ ***************************************************************************
+ * Send header data to a client, restricted to the activities it requested.
+ *
+ * IN:
+ * @i		Index of the client in clients[] array.
+ *
+ * RETURNS:
+ * 0 on success, or -1 if the client has been disconnected.
+ ***************************************************************************
+ */
+int send_client_hdr(int i)
+{
+	char hbuf[SA_SHM_HDR_AREA];
+	int len;
+
+	len = fill_file_hdr(hbuf, FALSE, clients[i].want);
+
+	return send_client(i, hbuf, len);
+}
+
+/*
+ ***************************************************************************
+ * Check the subscription request sent by a client, then send the answer,
+ * followed by header data if the request has been accepted.
+ *
+ * IN:
+ * @i		Index of the client in clients[] array.
+ ***************************************************************************
+ */
+void subscribe_client(int i)
+{
+	struct sa_client *c = &clients[i];
+	struct sa_sub_ans ans;
+	unsigned int j;
+	int p;
+
+	ans.magic    = SA_SUB_MAGIC;
+	ans.status   = SUB_OK;
+	ans.interval = (unsigned int) interval;
+
+	if ((c->req.magic != SA_SUB_MAGIC) || (c->req.act_nr > NR_ACT)) {
+		ans.status = SUB_BAD_REQUEST;
+	}
+	else if (c->req.interval % interval) {
+		ans.status = SUB_BAD_INTERVAL;
+	}
+
+	if (ans.status != SUB_OK) {
+		if (!send_client(i, &ans, SA_SUB_ANS_SIZE)) {
+			drop_client(i);
+		}
+		return;
+	}
+
+	memset(c->want, !c->req.act_nr, NR_ACT);
+	for (j = 0; j < c->req.act_nr; j++) {
+		if ((p = get_activity_position(act, c->req.act_id[j], RESUME_IF_NOT_FOUND)) >= 0) {
+			c->want[p] = TRUE;
+		}
+	}
+	c->ticks = c->req.interval ? c->req.interval / interval : 1;
+	/* First record will be sent with next sample */
+	c->next_tick = tick_nr;
+
+	if (!send_client(i, &ans, SA_SUB_ANS_SIZE)) {
+		send_client_hdr(i);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Accept a new client.
+ ***************************************************************************
+ */
+void accept_client(void)
+{
+	int fd;
+
+	if ((fd = accept(listen_fd, NULL, NULL)) < 0)
+		return;
+
+	if (client_nr >= MAX_SA_CLIENTS) {
+		struct sa_sub_ans ans = {SA_SUB_MAGIC, SUB_TOO_MANY, (unsigned int) interval};
+
+		send(fd, &ans, SA_SUB_ANS_SIZE, MSG_DONTWAIT | MSG_NOSIGNAL);
+		close(fd);
+		return;
+	}
+
+	memset(&clients[client_nr], 0, sizeof(struct sa_client));
+	clients[client_nr++].fd = fd;
+}
+
+/*
+ ***************************************************************************
+ * Read data sent by a client: Its subscription request, or the end of
+ * the connection.
+ *
+ * IN:
+ * @i		Index of the client in clients[] array.
+ ***************************************************************************
+ */
+void read_client(int i)
+{
+	struct sa_client *c = &clients[i];
+	char junk[256];
+	ssize_t n;
+
+	if (c->req_len < SA_SUB_REQ_SIZE) {
+		n = recv(c->fd, (char *) &(c->req) + c->req_len,
+			 SA_SUB_REQ_SIZE - c->req_len, MSG_DONTWAIT);
+	}
+	else {
+		/* Nothing more is expected from the client */
+		n = recv(c->fd, junk, sizeof(junk), MSG_DONTWAIT);
+	}
+
+	if (n < 0) {
+		if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) {
+			drop_client(i);
+		}
+		return;
+	}
+	if (!n) {
+		/* Client has closed the connection */
+		drop_client(i);
+		return;
+	}
+
+	if (c->req_len < SA_SUB_REQ_SIZE) {
+		c->req_len += n;
+		if (c->req_len == SA_SUB_REQ_SIZE) {
+			subscribe_client(i);
+		}
+	}
+}
+
+/*
+ ***************************************************************************
+ * Get the list of activities that should be read for current sample,
+ * i.e. those requested by the clients whose next record is due.
+ *
+ * OUT:
+ * @want	Activities to read (indexed by position in act[] array).
+ *
+ * RETURNS:
+ * TRUE if at least one client is waiting for a record.
+ ***************************************************************************
+ */
+int get_clients_want(unsigned char want[])
+{
+	int i, j, due = FALSE;
+
+	memset(want, 0, NR_ACT);
+
+	for (i = 0; i < client_nr; i++) {
+		if ((clients[i].req_len < SA_SUB_REQ_SIZE) || (clients[i].next_tick > tick_nr))
+			continue;
+		due = TRUE;
+		for (j = 0; j < NR_ACT; j++) {
+			want[j] |= clients[i].want[j];
+		}
+	}
+
+	return due;
+}
+
+/*
+ ***************************************************************************
+ * Send current statistics record to the clients whose next record is due.
+ *
+ * IN:
+ * @last	TRUE if file rotation is happening. In this case, the record
+ *		is sent to all the clients, tagged R_LAST_STATS, since the
+ *		number of items and the activity sequence may change and new
+ *		header data will have to be sent.
+ ***************************************************************************
+ */
+void send_clients_stats(int last)
+{
+	size_t len;
+	int i;
+
+	if (get_max_record_size() > rec_buf_size) {
+		rec_buf_size = get_max_record_size();
+		SREALLOC(rec_buf, char, rec_buf_size);
+	}
+	record_hdr.record_type = last ? R_LAST_STATS : R_STATS;
+
+	/* Go backwards: A client may be removed from the list */
+	for (i = client_nr - 1; i >= 0; i--) {
+
+		if ((clients[i].req_len < SA_SUB_REQ_SIZE) ||
+		    (!last && (clients[i].next_tick > tick_nr)))
+			continue;
+		clients[i].next_tick = tick_nr + clients[i].ticks;
+		clients[i].new_hdr = last;
+
+		len = fill_stats_record(rec_buf, clients[i].want);
+		send_client(i, rec_buf, len);
+	}
+	record_hdr.record_type = R_STATS;
+}
+
+/*
+ ***************************************************************************
+ * Send new header data to the clients which have been told that they
+ * would be sent (see send_clients_stats()).
+ ***************************************************************************
+ */
+void send_clients_hdr(void)
+{
+	int i;
+
+	/* Go backwards: A client may be removed from the list */
+	for (i = client_nr - 1; i >= 0; i--) {
+		if (clients[i].new_hdr) {
+			clients[i].new_hdr = FALSE;
+			send_client_hdr(i);
+		}
+	}
+}
+
+/*
+ ***************************************************************************
+ * Wait for next sample. Meanwhile, accept new clients and handle their
+ * requests.
+ ***************************************************************************
+ */
+void serve_clients(void)
+{
+	fd_set rfds;
+	struct timespec ts;
+	int i, max_fd, rc;
+
+	while (!sigint_caught) {
+
+		if (!sched_timeout(&sched, &ts)) {
+			/* Next sample is due */
+			sched_tick(&sched);
+			break;
+		}
+
+		FD_ZERO(&rfds);
+		FD_SET(listen_fd, &rfds);
+		max_fd = listen_fd;
+		for (i = 0; i < client_nr; i++) {
+			FD_SET(clients[i].fd, &rfds);
+			if (clients[i].fd > max_fd) {
+				max_fd = clients[i].fd;
+			}
+		}
+
+		if ((rc = pselect(max_fd + 1, &rfds, NULL, NULL, &ts, NULL)) < 0) {
+			if (errno == EINTR)
+				continue;
+			perror("pselect");
+			exit(2);
+		}
+		if (!rc)
+			/* Timeout: Next sample is due */
+			continue;
+
+		/* Go backwards: A client may be removed from the list */
+		for (i = client_nr - 1; i >= 0; i--) {
+			if (FD_ISSET(clients[i].fd, &rfds)) {
+				read_client(i);
+			}
+		}
+		if (FD_ISSET(listen_fd, &rfds)) {
+			accept_client();
+		}
+	}
+}
+
+/*
+ ***************************************************************************
+ * Close index file associated with current data file (if any).
+ ***************************************************************************
+ */
+void close_sa_index(void)
+{
+	if (idx_fd >= 0) {
+		close(idx_fd);
+		idx_fd = -1;
+	}
+}
+
+/*
+ ***************************************************************************
+ * Create the index file associated with a newly created data file if
+ * option -I has been used. Otherwise remove any index file that may have
+ * been left over from a previous data file with the same name.
+ *
+ * IN:
+ * @ofd		Output file descriptor. The file header and the list of
+ *		activities have just been written to it.
+ * @ofile	Name of output file.
+ ***************************************************************************
+ */
+void create_sa_index(int ofd, char *ofile)
+{
+	struct index_header idx_hdr;
+	char ifile[MAX_FILE_LEN + sizeof(INDEX_SUFFIX)];
+
+	close_sa_index();
+
+	snprintf(ifile, sizeof(ifile), "%s%s", ofile, INDEX_SUFFIX);
+
+	if (!WANT_SA_INDEX(flags)) {
+		unlink(ifile);
+		return;
+	}
+
+	if ((idx_fd = open(ifile, O_CREAT | O_TRUNC | O_RDWR,
+			   S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)) < 0) {
+		fprintf(stderr, _("Cannot open %s: %s\n"), ifile, strerror(errno));
+		exit(2);
+	}
+
+	memset(&idx_hdr, 0, INDEX_HEADER_SIZE);
+	idx_hdr.sa_ust_time   = file_hdr.sa_ust_time;
+	idx_hdr.data_offset   = (unsigned long long) lseek(ofd, 0, SEEK_CUR);
+	idx_hdr.sysstat_magic = SYSSTAT_MAGIC;
+	idx_hdr.index_magic   = INDEX_MAGIC;
+	idx_hdr.entry_size    = INDEX_ENTRY_SIZE;
+	idx_hdr.flags         = IDX_F_VALID | IDX_F_MONOTONIC;
+
+	if (write_all(idx_fd, &idx_hdr, INDEX_HEADER_SIZE) != INDEX_HEADER_SIZE) {
+		p_write_error();
+	}
+}
+
+/*
+ ***************************************************************************
+ * Open the index file associated with an existing data file, if any.
+ * The index is ignored if it doesn't belong to the data file or if it is
+ * no longer in sync with it.
+ *
+ * IN:
+ * @ofile	Name of output file.
+ ***************************************************************************
+ */
+void open_sa_index(char *ofile)
+{
+	struct index_header idx_hdr;
+	char ifile[MAX_FILE_LEN + sizeof(INDEX_SUFFIX)];
+
+	close_sa_index();
+
+	snprintf(ifile, sizeof(ifile), "%s%s", ofile, INDEX_SUFFIX);
+
+	if ((idx_fd = open(ifile, O_RDWR)) < 0)
+		/* No index for this file */
+		return;
+
+	if ((read(idx_fd, &idx_hdr, INDEX_HEADER_SIZE) != INDEX_HEADER_SIZE) ||
+	    (idx_hdr.sysstat_magic != SYSSTAT_MAGIC) ||
+	    (idx_hdr.index_magic != INDEX_MAGIC) ||
+	    (idx_hdr.entry_size != INDEX_ENTRY_SIZE) ||
+	    (idx_hdr.sa_ust_time != file_hdr.sa_ust_time) ||
+	    !INDEX_IS_VALID(idx_hdr.flags)) {
+		close_sa_index();
+	}
+}
+
+/*
+ ***************************************************************************
+ * Add an entry to the index file for the record that has just been
+ * written to the data file (the header of which is in @record_hdr).
+ * If some records have been appended to the data file without being
+ * indexed, then the index is marked as invalid and is no longer updated.
+ *
+ * IN:
+ * @ofd		Output file descriptor.
+ * @offset	Offset in data file where the record has been written.
+ ***************************************************************************
+ */
+void write_index_entry(int ofd, off_t offset)
+{
+	struct index_header idx_hdr;
+	struct index_entry ie, last;
+	struct stat ost, ist;
+	unsigned long long expected;
+	long n;
+
+	if (idx_fd < 0)
+		return;
+
+	if ((fstat(ofd, &ost) < 0) || (ost.st_size <= offset))
+		/* Nothing has been written (file may have been locked) */
+		return;
+
+	if ((fstat(idx_fd, &ist) < 0) ||
+	    (pread(idx_fd, &idx_hdr, INDEX_HEADER_SIZE, 0) != INDEX_HEADER_SIZE)) {
+		close_sa_index();
+		return;
+	}
+
+	/* Get last entry, and check that it ends where current record begins */
+	n = (ist.st_size - INDEX_HEADER_SIZE) / INDEX_ENTRY_SIZE;
+	if (n > 0) {
+		if (pread(idx_fd, &last, INDEX_ENTRY_SIZE,
+			  INDEX_HEADER_SIZE + (n - 1) * INDEX_ENTRY_SIZE) != INDEX_ENTRY_SIZE) {
+			close_sa_index();
+			return;
+		}
+		expected = last.offset + last.size;
+	}
+	else {
+		expected = idx_hdr.data_offset;
+	}
+
+	if (expected != (unsigned long long) offset) {
+		/* Index no longer in sync with data file: Invalidate it */
+		idx_hdr.flags &= ~IDX_F_VALID;
+		if (pwrite(idx_fd, &idx_hdr, INDEX_HEADER_SIZE, 0) != INDEX_HEADER_SIZE) {
+			p_write_error();
+		}
+		close_sa_index();
+		return;
+	}
+
+	memset(&ie, 0, INDEX_ENTRY_SIZE);
+	ie.ust_time    = record_hdr.ust_time;
+	ie.offset      = (unsigned long long) offset;
+	ie.size        = (unsigned int) (ost.st_size - offset);
+	ie.record_type = record_hdr.record_type;
 
-			if (write_all(fd, &file_act, FILE_ACTIVITY_SIZE) != FILE_ACTIVITY_SIZE) {
-				p_write_error();
-			}
+	/*
+	 * Tell if the record can be read without reading the previous ones
+	 * (@dlt_count has already been incremented by write_stats()).
+	 */
+	if ((ie.record_type == R_STATS) &&
+	    (!delta_fmt || !((dlt_count - 1) % DELTA_KEYFRAME_NR))) {
+		ie.flags = IDX_E_KEYFRAME;
+	}
+
+	if (ie.record_type == R_RESTART) {
+		/* Same value as that written by write_new_cpu_nr() */
+		ie.cpu_nr = act[get_activity_position(act, A_CPU, EXIT_IF_NOT_FOUND)]->nr_ini;
+	}
+	else if (n > 0) {
+		ie.cpu_nr = last.cpu_nr;
+	}
+
+	if ((n > 0) && (ie.ust_time < last.ust_time) &&
+	    INDEX_IS_MONOTONIC(idx_hdr.flags)) {
+		/* Time went backward: Index can no longer be searched by time */
+		idx_hdr.flags &= ~IDX_F_MONOTONIC;
+		if (pwrite(idx_fd, &idx_hdr, INDEX_HEADER_SIZE, 0) != INDEX_HEADER_SIZE) {
+			p_write_error();
 		}
 	}
 
-	return;
+	/* NB: A partially written entry (if any) is overwritten */
+	if (pwrite(idx_fd, &ie, INDEX_ENTRY_SIZE,
+		   INDEX_HEADER_SIZE + n * INDEX_ENTRY_SIZE) != INDEX_ENTRY_SIZE) {
+		p_write_error();
+	}
 }
 
 /*
  ***************************************************************************
- * Write the new number of CPU after the RESTART record in file.
+ * Tell if the statistics record about to be written to the data file is a
+ * boundary record, i.e. if a summary record should follow it. This is the
+ * case of the first record of a new summary span, of the first record
+ * saved by current process after another one has written to the file, and
+ * of the last record saved in the file before it is rotated.
  *
  * IN:
- * @ofd		Output file descriptor.
+ * @offset	Offset in data file where the record will be written.
+ * @last	TRUE if this is the last record saved in the file.
+ *
+ * RETURNS:
+ * TRUE if the record is a boundary record.
  ***************************************************************************
  */
-void write_new_cpu_nr(int ofd)
+int is_boundary_record(off_t offset, int last)
 {
-	int p;
-
-	p = get_activity_position(act, A_CPU, EXIT_IF_NOT_FOUND);
-
-	if (write_all(ofd, &(act[p]->nr_ini), sizeof(__nr_t)) != sizeof(__nr_t)) {
-		p_write_error();
-	}
+	return WANT_SUMMARY(flags) &&
+	       (last || (offset != sum_end) ||
+		(record_hdr.ust_time / SUMMARY_SPAN != sum_hour));
 }
 
 /*
  ***************************************************************************
- * sadc called with interval and count parameters not set:
- * Write a dummy record notifying a system restart, or insert a comment in
- * binary data file if option -C has been used.
- * Writing a dummy record should typically be done at boot time,
- * before the cron daemon is started to avoid conflict with sa1/sa2 scripts.
+ * Aggregate the gauges of the statistics record that has just been written
+ * to the data file. If this is a boundary record, then write a summary
+ * record with the gauges aggregated since the previous one, and update
+ * the summary record of the previous boundary record so that it gives the
+ * position of current one.
  *
  * IN:
  * @ofd		Output file descriptor.
- * @rtype	Record type to write (dummy or comment).
+ * @ofile	Name of output file.
+ * @offset	Offset in data file where the record has been written.
  ***************************************************************************
  */
-void write_special_record(int ofd, int rtype)
+void write_summary(int ofd, char ofile[], off_t offset)
 {
-	struct tm rectime = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, NULL};
-
-	/* Check if file is locked */
-	if (!FILE_LOCKED(flags)) {
-		ask_for_flock(ofd, FATAL);
-	}
+	struct record_header sum_rec_hdr;
+	struct summary_header sum_hdr;
+	struct summary_act sact;
+	struct rollup_gauges *sg;
+	struct stat st;
+	unsigned long long next_offset;
+	size_t len;
+	int i, p, fd;
+
+	if (!WANT_SUMMARY(flags))
+		return;
 
-	/* Reset the structure (not compulsory, but a bit cleaner) */
-	memset(&record_hdr, 0, RECORD_HEADER_SIZE);
+	if ((fstat(ofd, &st) < 0) || (st.st_size <= offset))
+		/* Nothing has been written (file may have been locked) */
+		return;
 
-	/* Set record type */
-	record_hdr.record_type = rtype;
+	if (offset != sum_end) {
+		/* Statistics aggregated so far don't precede current record */
+		sum_boundary = sum_offset = 0;
+		sum_record_nr = 0;
+		for (p = 0; p < NR_ACT; p++) {
+			sum_gauges[p][0].nr = 0;
+		}
+	}
 
-	/* Save time */
-	record_hdr.ust_time = (unsigned long long) get_time(&rectime, 0);
+	memset(&sum_hdr, 0, SUMMARY_HEADER_SIZE);
 
-	record_hdr.hour   = rectime.tm_hour;
-	record_hdr.minute = rectime.tm_min;
-	record_hdr.second = rectime.tm_sec;
+	for (i = 0; i < NR_ACT; i++) {
 
-	/* Write record now */
-	if (write_all(ofd, &record_hdr, RECORD_HEADER_SIZE) != RECORD_HEADER_SIZE) {
-		p_write_error();
-	}
+		if (!id_seq[i])
+			continue;
+		if ((p = get_activity_position(act, id_seq[i], RESUME_IF_NOT_FOUND)) < 0)
+			continue;
 
-	if (rtype == R_RESTART) {
-		/* Also write the new number of CPU */
-		write_new_cpu_nr(ofd);
-	}
-	else if (rtype == R_COMMENT) {
-		/* Also write the comment */
-		if (write_all(ofd, comment, MAX_COMMENT_LEN) != MAX_COMMENT_LEN) {
-			p_write_error();
+		if (IS_COLLECTED(act[p]->options) && IS_GAUGE(act[p]->options)) {
+			if (!act[p]->unsampled[0]) {
+				aggregate_gauges(act[p], sum_gauges[p], act[p]->_buf0,
+						 act[p]->_nr0 * act[p]->nr2);
+			}
+			sg = &sum_gauges[p][0];
+			sum_hdr.size += SUMMARY_ACT_SIZE + (size_t) sg->nr *
+					(act[p]->msize + sizeof(unsigned long long) *
+					 (1 + 3 * (act[p]->gtypes_nr[0] + act[p]->gtypes_nr[1] +
+						   act[p]->gtypes_nr[2])));
+			sum_hdr.act_nr++;
 		}
 	}
-}
+	sum_record_nr++;
+	sum_end = st.st_size;
 
-/*
- ***************************************************************************
- * Write stats (or print them if stdout).
- *
- * IN:
- * @ofd		Output file descriptor. May be stdout.
- ***************************************************************************
- */
-void write_stats(int ofd)
-{
-	int i, p;
+	if (!sum_due)
+		return;
 
-	/* Try to lock file */
-	if (!FILE_LOCKED(flags)) {
-		if (ask_for_flock(ofd, NON_FATAL))
-			/*
-			 * Unable to lock file:
-			 * Wait for next iteration to try again to save data.
-			 */
-			return;
-	}
+	/* Write summary record */
+	sum_hdr.offset      = (unsigned long long) offset;
+	sum_hdr.prev_offset = (unsigned long long) sum_boundary;
+	sum_hdr.record_nr   = sum_record_nr;
 
-	/* Write record header */
-	if (write_all(ofd, &record_hdr, RECORD_HEADER_SIZE) != RECORD_HEADER_SIZE) {
+	memcpy(&sum_rec_hdr, &record_hdr, RECORD_HEADER_SIZE);
+	sum_rec_hdr.record_type = R_SUMMARY;
+
+	if ((write_all(ofd, &sum_rec_hdr, RECORD_HEADER_SIZE) != RECORD_HEADER_SIZE) ||
+	    (write_all(ofd, &sum_hdr, SUMMARY_HEADER_SIZE) != SUMMARY_HEADER_SIZE)) {
 		p_write_error();
 	}
 
-	/* Then write all statistics */
 	for (i = 0; i < NR_ACT; i++) {
 
 		if (!id_seq[i])
@@ -682,18 +1813,57 @@ void write_stats(int ofd)
 		if ((p = get_activity_position(act, id_seq[i], RESUME_IF_NOT_FOUND)) < 0)
 			continue;
 
-		if (IS_COLLECTED(act[p]->options)) {
-			if (act[p]->f_count_index >= 0) {
-				if (write_all(ofd, &(act[p]->_nr0), sizeof(__nr_t)) != sizeof(__nr_t)) {
-					p_write_error();
-				}
-			}
-			if (write_all(ofd, act[p]->_buf0, act[p]->fsize * act[p]->_nr0 * act[p]->nr2) !=
-			    (act[p]->fsize * act[p]->_nr0 * act[p]->nr2)) {
-				p_write_error();
-			}
+		if (!IS_COLLECTED(act[p]->options) || !IS_GAUGE(act[p]->options))
+			continue;
+
+		sg = &sum_gauges[p][0];
+		sact.id   = act[p]->id;
+		sact.nr   = sg->nr;
+		sact.size = act[p]->msize;
+		sact.nf   = act[p]->gtypes_nr[0] + act[p]->gtypes_nr[1] + act[p]->gtypes_nr[2];
+		if (write_all(ofd, &sact, SUMMARY_ACT_SIZE) != SUMMARY_ACT_SIZE) {
+			p_write_error();
+		}
+		if (!sg->nr)
+			continue;
+
+		len = (size_t) sg->nr * sact.size;
+		if (write_all(ofd, sg->items, len) != len) {
+			p_write_error();
+		}
+		len = (size_t) sg->nr * sizeof(unsigned long long);
+		if (write_all(ofd, sg->cnt, len) != len) {
+			p_write_error();
+		}
+		len *= sact.nf;
+		if ((write_all(ofd, sg->sum, len) != len) ||
+		    (write_all(ofd, sg->min, len) != len) ||
+		    (write_all(ofd, sg->max, len) != len)) {
+			p_write_error();
+		}
+		sg->nr = 0;
+	}
+
+	if (sum_offset) {
+		/*
+		 * Link previous summary record to current boundary record.
+		 * NB: Data file may have been opened in append mode.
+		 */
+		next_offset = (unsigned long long) offset;
+		if (((fd = open(ofile, O_WRONLY)) < 0) ||
+		    (pwrite(fd, &next_offset, sizeof(next_offset),
+			    sum_offset + RECORD_HEADER_SIZE +
+			    offsetof(struct summary_header, next_offset)) != sizeof(next_offset))) {
+			p_write_error();
 		}
+		close(fd);
 	}
+
+	sum_boundary  = offset;
+	sum_offset    = st.st_size;
+	sum_end       = st.st_size + RECORD_HEADER_SIZE + SUMMARY_HEADER_SIZE + sum_hdr.size;
+	sum_hour      = record_hdr.ust_time / SUMMARY_SPAN;
+	sum_record_nr = 0;
 }
 
 /*
@@ -720,7 +1890,11 @@ void create_sa_file(int *ofd, char *ofile)
 	if (ftruncate(*ofd, 0) >= 0) {
 
 		/* Write file header */
-		setup_file_hdr(*ofd);
+		delta_fmt = WANT_DELTA_FORMAT(flags);
+		setup_file_hdr(*ofd, delta_fmt);
+
+		/* Create index file if requested */
+		create_sa_index(*ofd, ofile);
 
 		return;
 	}
@@ -750,7 +1924,7 @@ void open_stdout(int *stdfd)
 			exit(4);
 		}
 		/* Write file header on STDOUT */
-		setup_file_hdr(*stdfd);
+		setup_file_hdr(*stdfd, FALSE);
 	}
 }
 
@@ -782,6 +1956,13 @@ void open_ofile(int *ofd, char ofile[], int restart_mark)
 	if (!ofile[0])
 		return;
 
+	/*
+	 * First statistics record written to the file will be a keyframe,
+	 * and a boundary record if summary records are requested.
+	 */
+	dlt_count = 0;
+	sum_end = 0;
+
 	/* Try to open file and check that data can be appended to it */
 	if ((*ofd = open(ofile, O_APPEND | O_RDWR)) < 0) {
 		if (errno == ENOENT) {
@@ -805,7 +1986,8 @@ void open_ofile(int *ofd, char ofile[], int restart_mark)
 	/* Test various values ("strict writing" rule) */
 	if ((sz != FILE_MAGIC_SIZE) ||
 	    (file_magic.sysstat_magic != SYSSTAT_MAGIC) ||
-	    (file_magic.format_magic != FORMAT_MAGIC) ||
+	    ((file_magic.format_magic != FORMAT_MAGIC) &&
+	     (file_magic.format_magic != FORMAT_MAGIC_DELTA)) ||
 	    (file_magic.header_size != FILE_HEADER_SIZE) ||
 	    (file_magic.hdr_types_nr[0] != FILE_HEADER_ULL_NR) ||
 	    (file_magic.hdr_types_nr[1] != FILE_HEADER_UL_NR) ||
@@ -945,15 +2127,15 @@ void open_ofile(int *ofd, char ofile[], int restart_mark)
 			goto append_error;
 		}
 
-		if ((file_act[i].has_nr && (act[p]->f_count_index < 0)) ||
-		    (!file_act[i].has_nr && (act[p]->f_count_index >=0))) {
+		if (!file_act[i].has_nr && (act[p]->f_count_index >=0)) {
 #ifdef DEBUG
 			fprintf(stderr, "%s: %s: has_nr=%d count_index=%d\n",
 				__FUNCTION__, act[p]->name, file_act[i].has_nr, act[p]->f_count_index);
 #endif
 			/*
 			 * For every activity whose number of items is not a constant,
-			 * a value giving the number of structures to read should exist.
+			 * a value giving the number of structures to read should exist
+			 * (it may also exist for other activities: See AO_SPARSE).
 			 */
 			goto append_error;
 		}
@@ -996,8 +2178,27 @@ void open_ofile(int *ofd, char ofile[], int restart_mark)
 		/* Save activity sequence */
 		id_seq[i] = file_act[i].id;
 		act[p]->options |= AO_COLLECTED;
+
+		/*
+		 * An activity saved in file without its number of items must be
+		 * sampled at each interval. Conversely, keep saving the number of
+		 * items if it was saved before.
+		 */
+		if (!file_act[i].has_nr) {
+			act[p]->options &= ~AO_SPARSE;
+			act[p]->itv_mult = 1;
+		}
+		else if (act[p]->f_count_index < 0) {
+			act[p]->options |= AO_SPARSE;
+		}
 	}
 
+	/* Format of the file prevails over that requested by the user */
+	delta_fmt = (file_magic.format_magic == FORMAT_MAGIC_DELTA);
+
+	/* Keep index file up to date if there is one */
+	open_sa_index(ofile);
+
 	return;
 
 append_error:
@@ -1013,24 +2214,254 @@ append_error:
 	}
 }
 
+/*
+ ***************************************************************************
+ * Worker thread reading the statistics of a slow activity. Each time a
+ * reading is requested, statistics are read in the worker's own copy of
+ * the activity structure, then saved as the result of the last reading
+ * completed.
+ *
+ * IN:
+ * @arg		Worker structure.
+ ***************************************************************************
+ */
+void *slow_read_worker(void *arg)
+{
+	struct sa_worker *w = (struct sa_worker *) arg;
+	struct activity *wa = &(w->wa);
+	size_t size;
+
+	pthread_mutex_lock(&w->lock);
+
+	for (;;) {
+		while (!w->request) {
+			pthread_cond_wait(&w->cond, &w->lock);
+		}
+		w->request = FALSE;
+		pthread_mutex_unlock(&w->lock);
+
+		/* Read statistics. May take a long time or even block */
+		memset(wa->_buf0, 0,
+		       (size_t) wa->msize * (size_t) wa->nr_allocated * (size_t) wa->nr2);
+		(*wa->f_read)(wa);
+
+		pthread_mutex_lock(&w->lock);
+
+		/* Save result. Buffer may have been reallocated by the read function */
+		if (wa->nr_allocated > w->last_allocated) {
+			SREALLOC(w->last_buf, void,
+				 (size_t) wa->msize * (size_t) wa->nr_allocated * (size_t) wa->nr2);
+			w->last_allocated = wa->nr_allocated;
+		}
+		size = (size_t) wa->msize * (size_t) wa->_nr0 * (size_t) wa->nr2;
+		if (size) {
+			memcpy(w->last_buf, wa->_buf0, size);
+		}
+		w->last_nr = wa->_nr0;
+		w->busy = FALSE;
+		w->ready = TRUE;
+		pthread_cond_broadcast(&w->cond);
+	}
+
+	return NULL;
+}
+
+/*
+ ***************************************************************************
+ * Create the worker thread that will read the statistics of a slow
+ * activity.
+ *
+ * IN:
+ * @p		Position of the activity in act[] array.
+ *
+ * RETURNS:
+ * Worker structure.
+ ***************************************************************************
+ */
+struct sa_worker *start_worker(int p)
+{
+	struct sa_worker *w;
+	pthread_attr_t attr;
+	pthread_condattr_t cattr;
+	sigset_t set, oset;
+
+	if ((w = (struct sa_worker *) calloc(1, sizeof(struct sa_worker))) == NULL) {
+		perror("calloc");
+		exit(4);
+	}
+	w->a = act[p];
+
+	/* The worker reads statistics in its own copy of the activity structure */
+	w->wa = *act[p];
+	w->wa._buf0 = NULL;
+	w->wa.buf[1] = w->wa.buf[2] = NULL;
+	SREALLOC(w->wa._buf0, void,
+		 (size_t) w->wa.msize * (size_t) w->wa.nr_allocated * (size_t) w->wa.nr2);
+
+	pthread_mutex_init(&w->lock, NULL);
+	/* Deadlines are computed with sched_now(), which uses CLOCK_MONOTONIC */
+	pthread_condattr_init(&cattr);
+	pthread_condattr_setclock(&cattr, CLOCK_MONOTONIC);
+	pthread_cond_init(&w->cond, &cattr);
+	pthread_condattr_destroy(&cattr);
+
+	/*
+	 * Signals should be delivered to the main thread only.
+	 * The thread is detached: It won't be waited for when sadc terminates,
+	 * even if it is blocked reading statistics.
+	 */
+	sigfillset(&set);
+	pthread_sigmask(SIG_BLOCK, &set, &oset);
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	if (pthread_create(&w->thread, &attr, slow_read_worker, w) != 0) {
+		fprintf(stderr, _("Cannot create thread\n"));
+		exit(4);
+	}
+	pthread_attr_destroy(&attr);
+	pthread_sigmask(SIG_SETMASK, &oset, NULL);
+
+	return w;
+}
+
+/*
+ ***************************************************************************
+ * Ask worker threads to read the statistics of the slow activities.
+ * A worker that is still busy with a previous reading is left alone.
+ *
+ * IN:
+ * @want	Activities to read (indexed by position in act[] array), or
+ *		NULL for all the collected activities.
+ ***************************************************************************
+ */
+void start_slow_reads(unsigned char want[])
+{
+	int i;
+	struct sa_worker *w;
+
+	for (i = 0; i < NR_ACT; i++) {
+		if (!IS_SENT(i, want) || !IS_SLOW(act[i]->options) || act[i]->unsampled[0])
+			continue;
+
+		if (!workers[i]) {
+			workers[i] = start_worker(i);
+		}
+		w = workers[i];
+
+		pthread_mutex_lock(&w->lock);
+		if (!w->busy) {
+			w->request = TRUE;
+			w->busy = TRUE;
+			pthread_cond_broadcast(&w->cond);
+		}
+		pthread_mutex_unlock(&w->lock);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Wait for the worker threads to complete their reading, then save the
+ * statistics of the slow activities. A worker is waited for at most the
+ * timeout of its activity (and never more than half the interval). If it
+ * hasn't completed its reading by then, the result of its last reading
+ * completed is saved instead.
+ *
+ * IN:
+ * @want	Activities to read (indexed by position in act[] array), or
+ *		NULL for all the collected activities.
+ * @start	Time (as returned by sched_now()) when the readings were
+ *		requested.
+ ***************************************************************************
+ */
+void end_slow_reads(unsigned char want[], unsigned long long start)
+{
+	int i;
+	long timeout;
+	unsigned long long deadline;
+	struct sa_worker *w;
+	struct activity *a;
+	struct timespec ts;
+
+	for (i = 0; i < NR_ACT; i++) {
+		if (!IS_SENT(i, want) || !IS_SLOW(act[i]->options) || act[i]->unsampled[0] ||
+		    !workers[i])
+			continue;
+
+		w = workers[i];
+		a = act[i];
+
+		timeout = a->timeout;
+		if (interval && (interval / 2 < timeout)) {
+			timeout = interval / 2;
+		}
+		deadline = start + (unsigned long long) timeout * 1000000;
+		ts.tv_sec  = deadline / 1000000000;
+		ts.tv_nsec = deadline % 1000000000;
+
+		pthread_mutex_lock(&w->lock);
+		while (w->busy) {
+			if (pthread_cond_timedwait(&w->cond, &w->lock, &ts) == ETIMEDOUT)
+				break;
+		}
+
+		/* Save the result of the last reading completed */
+		if (!w->ready) {
+			/* No reading completed yet */
+			a->_nr0 = 0;
+		}
+		else {
+			if (w->last_allocated > a->nr_allocated) {
+				SREALLOC(a->_buf0, void,
+					 (size_t) a->msize * (size_t) w->last_allocated * (size_t) a->nr2);
+				a->nr_allocated = w->last_allocated;
+			}
+			a->_nr0 = w->last_nr;
+			if (w->last_nr) {
+				memcpy(a->_buf0, w->last_buf,
+				       (size_t) a->msize * (size_t) w->last_nr * (size_t) a->nr2);
+			}
+		}
+		pthread_mutex_unlock(&w->lock);
+	}
+}
+
 /*
  ***************************************************************************
  * Read statistics from various system files.
+ *
+ * IN:
+ * @want	Activities to read (indexed by position in act[] array), or
+ *		NULL for all the collected activities.
  ***************************************************************************
  */
-void read_stats(void)
+void read_stats(unsigned char want[])
 {
 	int i;
+	unsigned long long start;
+
+	/* Activities collected at a multiple of the interval may not be due */
+	for (i = 0; i < NR_ACT; i++) {
+		act[i]->unsampled[0] = !IS_DUE(i);
+	}
+
+	/* Slow activities are read by worker threads while others are being read */
+	start = sched_now();
+	start_slow_reads(want);
+
+	/* System files are read once per sample */
+	invalidate_cached_files();
 
-	/* Read system uptime in 1/100th of a second */
-	read_uptime(&(record_hdr.uptime_cs));
+	/* Read system uptime with a microsecond resolution */
+	read_uptime_us(&(record_hdr.uptime_cs), &(record_hdr.uptime_us));
 
 	for (i = 0; i < NR_ACT; i++) {
-		if (IS_COLLECTED(act[i]->options)) {
+		if (IS_SENT(i, want) && !IS_SLOW(act[i]->options) && !act[i]->unsampled[0]) {
 			/* Read statistics for current activity */
 			(*act[i]->f_read)(act[i]);
 		}
 	}
+
+	end_slow_reads(want, start);
 }
 
 /*
@@ -1049,15 +2480,26 @@ void read_stats(void)
 void rw_sa_stat_loop(long count, int stdfd, int ofd, char ofile[],
 		     char sa_dir[])
 {
-	int do_sa_rotat = 0;
+	int do_sa_rotat = 0, clients_only;
 	unsigned int save_flags;
+	off_t offset;
 	char new_ofile[MAX_FILE_LEN] = "";
+	unsigned char want[NR_ACT];
 	struct tm rectime = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, NULL};
 
-	/* Set a handler for SIGINT */
+	/*
+	 * If statistics are only sent to clients, read only the activities
+	 * requested by the clients whose next record is due.
+	 */
+	clients_only = USE_SOCKET(flags) && (stdfd < 0) && !ofile[0] && !USE_SHM(flags);
+
+	/* Set a handler for SIGINT (and SIGTERM if there are readers or clients) */
 	memset(&int_act, 0, sizeof(int_act));
 	int_act.sa_handler = int_handler;
 	sigaction(SIGINT, &int_act, NULL);
+	if (USE_SHM(flags) || USE_SOCKET(flags)) {
+		sigaction(SIGTERM, &int_act, NULL);
+	}
 
 	/* Main loop */
 	do {
@@ -1065,7 +2507,7 @@ void rw_sa_stat_loop(long count, int stdfd, int ofd, char ofile[],
 		reset_stats();
 
 		/* Save time */
-		record_hdr.ust_time = (unsigned long long) get_time(&rectime, 0);
+		record_hdr.ust_time = (unsigned long long) get_time_msec(&rectime, &record_hdr.ust_msec);
 		record_hdr.hour     = rectime.tm_hour;
 		record_hdr.minute   = rectime.tm_min;
 		record_hdr.second   = rectime.tm_sec;
@@ -1079,19 +2521,34 @@ void rw_sa_stat_loop(long count, int stdfd, int ofd, char ofile[],
 		}
 
 		/* Read then write stats */
-		read_stats();
+		if (!clients_only) {
+			read_stats(NULL);
+		}
+		else if (get_clients_want(want)) {
+			read_stats(want);
+		}
 
 		if (stdfd >= 0) {
 			save_flags = flags;
 			flags &= ~S_F_LOCK_FILE;
-			write_stats(stdfd);
+			write_stats(stdfd, FALSE);
 			flags = save_flags;
 		}
 
 		/* If the record type was R_LAST_STATS, tag it R_STATS before writing it */
 		record_hdr.record_type = R_STATS;
+		if (USE_SHM(flags)) {
+			write_shm_stats();
+		}
 		if (ofile[0]) {
-			write_stats(ofd);
+			offset = lseek(ofd, 0, SEEK_END);
+			sum_due = is_boundary_record(offset, do_sa_rotat);
+			write_stats(ofd, delta_fmt);
+			write_summary(ofd, ofile, offset);
+			write_index_entry(ofd, offset);
+		}
+		if (USE_SOCKET(flags)) {
+			send_clients_stats(do_sa_rotat);
 		}
 
 		if (do_sa_rotat) {
@@ -1108,6 +2565,7 @@ void rw_sa_stat_loop(long count, int stdfd, int ofd, char ofile[],
 				exit(4);
 			}
 			close(ofd);
+			close_sa_index();
 			strcpy(ofile, new_ofile);
 
 			/* Recalculate number of system items and reallocate structures */
@@ -1125,11 +2583,21 @@ void rw_sa_stat_loop(long count, int stdfd, int ofd, char ofile[],
 			 * number of items may have changed.
 			 */
 			if (stdfd >= 0) {
-				setup_file_hdr(stdfd);
+				setup_file_hdr(stdfd, FALSE);
+			}
+			if (USE_SHM(flags)) {
+				write_shm_hdr();
+			}
+			if (USE_SOCKET(flags)) {
+				send_clients_hdr();
 			}
 
 			/* Write stats to file again */
-			write_stats(ofd);
+			offset = lseek(ofd, 0, SEEK_END);
+			sum_due = is_boundary_record(offset, FALSE);
+			write_stats(ofd, delta_fmt);
+			write_summary(ofd, ofile, offset);
+			write_index_entry(ofd, offset);
 		}
 
 		/* Flush data */
@@ -1139,9 +2607,17 @@ void rw_sa_stat_loop(long count, int stdfd, int ofd, char ofile[],
 			count--;
 		}
 
+		tick_nr++;
+
 		if (count) {
-			/* Wait for a signal (probably SIGALRM or SIGINT) */
-			pause();
+			if (USE_SOCKET(flags)) {
+				/* Handle clients until next sample */
+				serve_clients();
+			}
+			else {
+				/* Wait until next sample is due (or SIGINT is caught) */
+				sched_wait(&sched);
+			}
 		}
 
 		if (sigint_caught)
@@ -1165,6 +2641,15 @@ void rw_sa_stat_loop(long count, int stdfd, int ofd, char ofile[],
 	/* Close file descriptors if they have actually been used */
 	CLOSE(stdfd);
 	CLOSE(ofd);
+	close_sa_index();
+	free_rollup_gauges(sum_gauges);
+
+	/* Tell readers that no more records will be published */
+	sa_shm_close(&shm, SHM_STOPPED);
+	close_listen_socket();
+
+	/* Display lateness of the samples if requested */
+	sched_report(&sched);
 }
 
 /*
@@ -1178,6 +2663,7 @@ int main(int argc, char **argv)
 	char ofile[MAX_FILE_LEN], sa_dir[MAX_FILE_LEN];
 	int stdfd = 0, ofd = -1;
 	int restart_mark;
+	off_t offset;
 	long count = 0;
 
 	/* Get HZ */
@@ -1218,6 +2704,10 @@ int main(int argc, char **argv)
 			flags |= S_F_FORCE_FILE;
 		}
 
+		else if (!strcmp(argv[opt], "-I")) {
+			flags |= S_F_SA_INDEX;
+		}
+
 		else if (!strcmp(argv[opt], "-L")) {
 			flags |= S_F_LOCK_FILE;
 		}
@@ -1226,6 +2716,35 @@ int main(int argc, char **argv)
 			print_version();
 		}
 
+		else if (!strcmp(argv[opt], "-z")) {
+			flags |= S_F_DELTA_FORMAT;
+		}
+
+		else if (!strcmp(argv[opt], "--shm")) {
+			/* Publish records in shared memory */
+			if (!argv[++opt] || !argv[opt][0] || strchr(argv[opt], '/') ||
+			    (strlen(argv[opt]) >= MAX_FILE_LEN - sizeof(SA_SHM_DIR) - 16)) {
+				usage(argv[0]);
+			}
+			strcpy(shm_name, argv[opt]);
+			flags |= S_F_SHM;
+		}
+
+		else if (!strcmp(argv[opt], "--summary")) {
+			/* Save summary records in data file */
+			flags |= S_F_SUMMARY;
+		}
+
+		else if (!strcmp(argv[opt], "--listen")) {
+			/* Send records to clients connected to a Unix socket */
+			if (!argv[++opt] || !argv[opt][0] ||
+			    (strlen(argv[opt]) >= MAX_FILE_LEN)) {
+				usage(argv[0]);
+			}
+			strcpy(sock_path, argv[opt]);
+			flags |= S_F_SOCKET;
+		}
+
 		else if (!strcmp(argv[opt], "-Z")) {
 			/* Set by sar command */
 			optz = 1;
@@ -1242,7 +2761,8 @@ int main(int argc, char **argv)
 			}
 		}
 
-		else if (strspn(argv[opt], DIGITS) != strlen(argv[opt])) {
+		else if ((strspn(argv[opt], DIGITS) != strlen(argv[opt])) &&
+			 (interval || (parse_interval(argv[opt]) < 0))) {
 			if (ofile[0] || WANT_SA_ROTAT(flags)) {
 				/* Outfile already specified */
 				usage(argv[0]);
@@ -1265,8 +2785,8 @@ int main(int argc, char **argv)
 
 		else if (!interval) {
 			/* Get interval */
-			interval = atol(argv[opt]);
-			if (interval < 1) {
+			interval = parse_interval(argv[opt]);
+			if (interval < MIN_INTERVAL) {
 				usage(argv[0]);
 			}
 			count = -1;
@@ -1285,6 +2805,11 @@ int main(int argc, char **argv)
 		}
 	}
 
+	/* Samples are needed to serve clients */
+	if ((USE_SOCKET(flags) || USE_SHM(flags)) && !interval) {
+		usage(argv[0]);
+	}
+
 	/* Process file entered on the command line */
 	if (WANT_SA_ROTAT(flags)) {
 		/* File name set to '-' */
@@ -1313,6 +2838,14 @@ int main(int argc, char **argv)
 		}
 	}
 
+	/*
+	 * Don't write to STDOUT if records are published in shared memory
+	 * or sent to clients.
+	 */
+	if (USE_SHM(flags) || USE_SOCKET(flags)) {
+		stdfd = -1;
+	}
+
 	/*
 	 * If option -z used, write to STDOUT even if a filename
 	 * has been entered on the command line.
@@ -1364,15 +2897,18 @@ int main(int argc, char **argv)
 			 * NB: Never write such a dummy record on stdout since
 			 * sar never expects it.
 			 */
+			offset = lseek(ofd, 0, SEEK_END);
 			if (comment[0]) {
 				write_special_record(ofd, R_COMMENT);
 			}
 			else {
 				write_special_record(ofd, R_RESTART);
 			}
+			write_index_entry(ofd, offset);
 
-			/* Close file descriptor */
+			/* Close file descriptors */
 			CLOSE(ofd);
+			close_sa_index();
 		}
 
 		/* Free structures */
@@ -1380,11 +2916,17 @@ int main(int argc, char **argv)
 		exit(0);
 	}
 
-	/* Set a handler for SIGALRM */
-	memset(&alrm_act, 0, sizeof(alrm_act));
-	alrm_act.sa_handler = alarm_handler;
-	sigaction(SIGALRM, &alrm_act, NULL);
-	alarm(interval);
+	if (USE_SHM(flags)) {
+		/* Create shared memory segment and publish header data */
+		open_shm();
+	}
+	if (USE_SOCKET(flags)) {
+		/* Listen for clients */
+		open_listen_socket();
+	}
+
+	/* Set deadlines of the samples */
+	sched_init(&sched, interval);
 
 	/* Main loop */
 	rw_sa_stat_loop(count, stdfd, ofd, ofile, sa_dir);
@@ -26,9 +26,14 @@
 #include <unistd.h>
 #include <time.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
 
 #include "version.h"
 #include "sadf.h"
+#include "sa_out.h"
+#include "sa_col.h"
 
 # include <locale.h>	/* For setlocale() */
 #ifdef USE_NLS
@@ -43,6 +48,7 @@
 char *sccsid(void) { return (SCCSID); }
 #endif
 
+/* Interval in milliseconds */
 long interval = -1, count = 0;
 
 /* TRUE if data read from file don't match current machine's endianness */
@@ -55,6 +61,38 @@ unsigned int dm_major;		/* Device-mapper major number */
 unsigned int format = 0;	/* Output format */
 unsigned int f_position = 0;	/* Output format position in array */
 unsigned int canvas_height = 0; /* SVG canvas height value set with option -O */
+unsigned int svg_points = 0;	/* Max number of columns per SVG graph set with option -O */
+
+/* Interval (in seconds) and value saved for gauges with option --rollup */
+long rollup_itv = 0;
+int rollup_agg = ROLLUP_MEAN;
+
+/* Number of processes used to display statistics (option --jobs) */
+int jobs_nr = 1;
+
+/*
+ * Processes displaying the records of current segment (see
+ * start_parallel_segment()): Number of processes (0 if the segment is
+ * not split), range of records displayed by current process, and offset
+ * in file where it stops reading records (0 if it reads them up to the
+ * end of the segment).
+ */
+int job_nr = 0, job_id = 0;
+off_t read_end = 0;
+/* Uptime of the first record of the segment (see generic_write_stats()) */
+unsigned long long job_uptime_ref = 0;
+/* Output file and process id of each process */
+FILE *job_out[MAX_JOBS];
+pid_t job_pid[MAX_JOBS];
+/*
+ * Offsets in their output file where the parts of the output of the
+ * processes end (shared between processes), and number of parts written
+ * by current process.
+ */
+off_t *job_chunks = NULL;
+int job_chunk_nr = 0;
+/* Standard output saved while the parent process writes to its output file */
+int stdout_fd = -1;
 
 /* File header */
 struct file_header file_hdr;
@@ -67,6 +105,8 @@ unsigned int id_seq[NR_ACT];
 
 /* Maximum number of items for each activity */
 __nr_t id_nr_max[NR_ACT];
+/* Number of items for which SVG graphs are allocated, for each activity */
+__nr_t svg_nr_max[NR_ACT];
 
 /* Current record header */
 struct record_header record_hdr[3];
@@ -93,9 +133,10 @@ void usage(char *progname)
 		progname);
 
 	fprintf(stderr, _("Options are:\n"
-			  "[ -C ] [ -c | -d | -g | -j | -p | -r | -x ] [ -H ] [ -h ] [ -T | -t | -U ] [ -V ]\n"
+			  "[ -C ] [ -b | -c | -d | -g | -j | -p | -r | -x ] [ -H ] [ -h ] [ -T | -t | -U ] [ -V ]\n"
 			  "[ -O <opts> [,...] ] [ -P { <cpu> [,...] | ALL } ]\n"
 			  "[ -s [ <hh:mm[:ss]> ] ] [ -e [ <hh:mm[:ss]> ] ]\n"
+			  "[ --rollup <interval>[,{ mean | min | max }] ] [ --jobs <n> ]\n"
 			  "[ -- <sar_options> ]\n"));
 	exit(1);
 }
@@ -221,7 +262,8 @@ void check_format_options(void)
  *		explicitly told to do so with the SET_TIMESTAMPS action flag.
  *
  * RETURNS:
- * TRUE if end of file has been reached.
+ * TRUE if end of file (or end of the range of records displayed by current
+ * process) has been reached.
  ***************************************************************************
  */
 int read_next_sample(int ifd, int action, int curr, char *file, int *rtype, int tab,
@@ -230,6 +272,10 @@ int read_next_sample(int ifd, int action, int curr, char *file, int *rtype, int
 {
 	char rec_hdr_tmp[MAX_RECORD_HEADER_SIZE];
 
+	if (read_end && (sa_lseek(ifd, 0, SEEK_CUR) >= read_end))
+		/* End of the range of records displayed by current process */
+		return TRUE;
+
 	/* Read current record */
 	if (read_record_hdr(ifd, rec_hdr_tmp, &record_hdr[curr], &file_hdr,
 			    arch_64, endian_mismatch))
@@ -241,7 +287,7 @@ int read_next_sample(int ifd, int action, int curr, char *file, int *rtype, int
 	if (*rtype == R_COMMENT) {
 		if (action & IGNORE_COMMENT) {
 			/* Ignore COMMENT record */
-			if (lseek(ifd, MAX_COMMENT_LEN, SEEK_CUR) < MAX_COMMENT_LEN) {
+			if (sa_lseek(ifd, MAX_COMMENT_LEN, SEEK_CUR) < MAX_COMMENT_LEN) {
 				perror("lseek");
 			}
 			if (action & SET_TIMESTAMPS) {
@@ -286,7 +332,7 @@ int read_next_sample(int ifd, int action, int curr, char *file, int *rtype, int
 		 * OK: Previous record was not a special one.
 		 * So read now the extra fields.
 		 */
-		read_file_stat_bunch(act, curr, ifd, file_hdr.sa_act_nr,
+		read_file_stat_bunch(act, curr, &record_hdr[curr], ifd, file_hdr.sa_act_nr,
 				     file_actlst, endian_mismatch, arch_64, file, file_magic);
 		sa_get_record_timestamp_struct(flags, &record_hdr[curr], rectime, loctime);
 	}
@@ -398,12 +444,12 @@ time_t get_time_ref(void)
  */
 void seek_file_position(int ifd, int action)
 {
-	static off_t fpos = -1;
+	static struct sa_fpos fpos = {-1};
 	static unsigned int save_cpu_nr = 0;
 
 	if (action == DO_SAVE) {
 		/* Save current file position */
-		if ((fpos = lseek(ifd, 0, SEEK_CUR)) < 0) {
+		if (sa_save_pos(ifd, &fpos) < 0) {
 			perror("lseek");
 			exit(2);
 		}
@@ -411,7 +457,7 @@ void seek_file_position(int ifd, int action)
 	}
 	else if (action == DO_RESTORE) {
 		/* Rewind file */
-		if ((fpos < 0) || (lseek(ifd, fpos, SEEK_SET) < fpos)) {
+		if ((fpos.pos < 0) || (sa_restore_pos(ifd, &fpos) < fpos.pos)) {
 			perror("lseek");
 			exit(2);
 		}
@@ -426,18 +472,9 @@ void seek_file_position(int ifd, int action)
  * Each activity selected may have several views. Moreover some activities
  * may have a number of items that vary within the file: In this case,
  * the number of views will depend on the highest number of items saved in
- * the file.
+ * the file (see read_svg_graphs()).
  *
  * IN:
- * @ifd			File descriptor of input file.
- * @file		Name of file being read.
- * @file_magic		file_magic structure filled with file magic header data.
- * @file_actlst		List of (known or unknown) activities in file.
- * @rectime		Structure where timestamp (expressed in local time or
- *			in UTC depending on whether options -T/-t have been
- *			used or not) can be saved for current record.
- * @loctime		Structure where timestamp (expressed in local time)
- *			can be saved for current record.
  * @views_per_row	Default number of views displayed on a single row.
  *
  * OUT:
@@ -450,56 +487,10 @@ void seek_file_position(int ifd, int action)
  * Result may be 0.
  ***************************************************************************
  */
-int get_svg_graph_nr(int ifd, char *file, struct file_magic *file_magic,
-		     struct file_activity *file_actlst, struct tm *rectime,
-		     struct tm *loctime, int *views_per_row)
+int get_svg_graph_nr(int *views_per_row)
 {
-	int i, n, p, eosaf;
-	int rtype, tot_g_nr = 0;
-
-	/* Save current file position */
-	seek_file_position(ifd, DO_SAVE);
-
-	/* Init maximum number of items for each activity */
-	for (i = 0; i < NR_ACT; i++) {
-		id_nr_max[i] = 0;
-	}
-
-	/* Look for the first record that will be displayed */
-	do {
-		eosaf = read_next_sample(ifd, IGNORE_RESTART | IGNORE_COMMENT | SET_TIMESTAMPS,
-					 0, file, &rtype, 0, file_magic, file_actlst,
-					 rectime, loctime);
-		if (eosaf)
-			/* No record to display => no graph too */
-			return 0;
-	}
-	while ((tm_start.use && (datecmp(loctime, &tm_start) < 0)) ||
-	       (tm_end.use && (datecmp(loctime, &tm_end) >= 0)));
-
-	/*
-	 * Read all the file and determine the maximum number
-	 * of items for each activity.
-	 */
-	do {
-		for (i = 0; i < NR_ACT; i++) {
-			if (act[i]->nr[0] > id_nr_max[i]) {
-				id_nr_max[i] = act[i]->nr[0];
-			}
-		}
-
-		do {
-			eosaf = read_next_sample(ifd, IGNORE_RESTART | IGNORE_COMMENT | SET_TIMESTAMPS,
-						 0, file, &rtype, 0, file_magic, file_actlst,
-						 rectime, loctime);
-			if (eosaf ||
-			    (tm_end.use && (datecmp(loctime, &tm_end) >= 0)))
-				/* End of data file or end time exceeded */
-				break;
-		}
-		while ((rtype == R_RESTART) || (rtype == R_COMMENT));
-	}
-	while (!eosaf && !(tm_end.use && (datecmp(loctime, &tm_end) >= 0)));
+	int i, n, p;
+	int tot_g_nr = 0;
 
 	for (i = 0; i < NR_ACT; i++) {
 		if (!id_seq[i])
@@ -527,9 +518,6 @@ int get_svg_graph_nr(int ifd, char *file, struct file_magic *file_magic,
 		tot_g_nr += n;
 	}
 
-	/* Rewind file */
-	seek_file_position(ifd, DO_RESTORE);
-
 	if (*views_per_row > MAX_VIEWS_ON_A_ROW) {
 		*views_per_row = MAX_VIEWS_ON_A_ROW;
 	}
@@ -574,7 +562,8 @@ int generic_write_stats(int curr, int use_tm_start, int use_tm_end, int reset,
 			struct tm *loctime, int reset_cd, unsigned int act_id)
 {
 	int i;
-	unsigned long long dt, itv;
+	unsigned int options;
+	unsigned long long dt, itv, act_itv;
 	char cur_date[TIMESTAMP_LEN], cur_time[TIMESTAMP_LEN], *pre = NULL;
 	static int cross_day = FALSE;
 
@@ -594,8 +583,16 @@ int generic_write_stats(int curr, int use_tm_start, int use_tm_end, int reset,
 	 * selects records at seconds as close as possible to the number
 	 * specified by the interval parameter.
 	 */
-	if (!next_slice(record_hdr[2].uptime_cs, record_hdr[curr].uptime_cs,
-			reset, interval))
+	if (job_id && reset) {
+		/*
+		 * The reference record isn't the first one of the segment:
+		 * Select records as if the previous ones had been read.
+		 */
+		next_slice(job_uptime_ref, record_hdr[2].uptime_cs, TRUE, interval);
+		reset = FALSE;
+	}
+	if (!next_slice(job_id ? job_uptime_ref : record_hdr[2].uptime_cs,
+			record_hdr[curr].uptime_cs, reset, interval))
 		/* Not close enough to desired interval */
 		return 0;
 
@@ -645,12 +642,27 @@ int generic_write_stats(int curr, int use_tm_start, int use_tm_end, int reset,
 							       dt, &file_hdr, flags);
 	}
 
+	if (format == F_COL_OUTPUT) {
+		/* Columnar output: Values of this record make a new row */
+		col_start_row(&record_hdr[curr], itv);
+	}
+
 	/* Display statistics */
 	for (i = 0; i < NR_ACT; i++) {
 
 		if ((act_id != ALL_ACTIVITIES) && (act[i]->id != act_id))
 			continue;
 
+		/*
+		 * An activity that has not been sampled in this record is handled
+		 * as if it wasn't selected (its markup may still have to be closed).
+		 */
+		options = act[i]->options;
+		if (act[i]->unsampled[curr]) {
+			act[i]->options &= ~AO_SELECTED;
+		}
+		act_itv = get_act_itv_value(act[i], !curr, curr, itv);
+
 		if ((TEST_MARKUP(fmt[f_position]->options) && CLOSE_MARKUP(act[i]->options)) ||
 		    (IS_SELECTED(act[i]->options) && (act[i]->nr > 0))) {
 
@@ -665,22 +677,27 @@ int generic_write_stats(int curr, int use_tm_start, int use_tm_end, int reset,
 										dt, &file_hdr, flags);
 					}
 				}
-				(*act[i]->f_json_print)(act[i], curr, *tab, itv);
+				(*act[i]->f_json_print)(act[i], curr, *tab, act_itv);
 			}
 
 			else if (format == F_XML_OUTPUT) {
 				/* XML output */
 				int *tab = (int *) parm;
 
-				(*act[i]->f_xml_print)(act[i], curr, *tab, itv);
+				(*act[i]->f_xml_print)(act[i], curr, *tab, act_itv);
 			}
 
 			else if (format == F_SVG_OUTPUT) {
 				/* SVG output */
 				struct svg_parm *svg_p = (struct svg_parm *) parm;
 
-				svg_p->dt = (unsigned long) dt;
-				(*act[i]->f_svg_print)(act[i], curr, F_MAIN, svg_p, itv, &record_hdr[curr]);
+				if (act[i]->g_nr) {
+					svg_p->dt = (unsigned long) dt;
+					svg_p->nr_max = svg_nr_max[i];
+					(*act[i]->f_svg_print)(act[i], curr, F_MAIN, svg_p, act_itv,
+							       &record_hdr[curr]);
+					svg_nr_max[i] = svg_p->nr_max;
+				}
 			}
 
 			else if (format == F_RAW_OUTPUT) {
@@ -693,11 +710,18 @@ int generic_write_stats(int curr, int use_tm_start, int use_tm_end, int reset,
 				(*act[i]->f_raw_print)(act[i], pre, curr);
 			}
 
+			else if (format == F_COL_OUTPUT) {
+				/* Columnar output: Save the values displayed in db format */
+				col_set_activity(act[i]->id);
+				(*act[i]->f_render)(act[i], TRUE, pre, curr, act_itv);
+			}
+
 			else {
 				/* Other output formats: db, ppc */
-				(*act[i]->f_render)(act[i], (format == F_DB_OUTPUT), pre, curr, itv);
+				(*act[i]->f_render)(act[i], (format == F_DB_OUTPUT), pre, curr, act_itv);
 			}
 		}
+		act[i]->options = options;
 	}
 
 	if (*fmt[f_position]->f_timestamp) {
@@ -705,9 +729,335 @@ int generic_write_stats(int curr, int use_tm_start, int use_tm_end, int reset,
 						dt, &file_hdr, flags);
 	}
 
+	/* Write the whole record (db, ppc, XML and JSON formats) at once */
+	out_flush();
+
 	return 1;
 }
 
+/*
+ ***************************************************************************
+ * Read the statistics records of current segment (i.e. up to next RESTART
+ * record) without decoding them, and look for those after which a process
+ * may start displaying statistics: These are records which can be decoded
+ * without reading the previous ones, and which are displayed.
+ *
+ * IN:
+ * @ifd		File descriptor of input file.
+ * @file	Name of file being read.
+ * @file_magic	file_magic structure filled with file magic header data.
+ * @file_actlst	List of (known or unknown) activities in file.
+ *
+ * OUT:
+ * @js		Records after which a process may start displaying
+ *		statistics.
+ * @rec_nr	Number of statistics records in segment.
+ *
+ * RETURNS:
+ * Number of records saved in @js, or -1 if the records of the segment
+ * cannot be displayed by several processes.
+ ***************************************************************************
+ */
+int scan_segment(int ifd, char *file, struct file_magic *file_magic,
+		 struct file_activity *file_actlst, struct job_start **js, long *rec_nr)
+{
+	char rec_hdr_tmp[MAX_RECORD_HEADER_SIZE];
+	struct record_header rec_hdr;
+	int js_nr = 0, js_size = 0, keyframe, next, sampled = TRUE;
+	off_t ref_offset;
+
+	*rec_nr = 0;
+
+	while (TRUE) {
+		ref_offset = sa_lseek(ifd, 0, SEEK_CUR);
+		if (read_record_hdr(ifd, rec_hdr_tmp, &rec_hdr, &file_hdr,
+				    arch_64, endian_mismatch) ||
+		    (rec_hdr.record_type == R_RESTART))
+			/* End of segment */
+			break;
+
+		if (rec_hdr.record_type == R_COMMENT) {
+			if (sa_lseek(ifd, MAX_COMMENT_LEN, SEEK_CUR) < MAX_COMMENT_LEN) {
+				perror("lseek");
+				exit(2);
+			}
+			continue;
+		}
+
+		keyframe = skip_file_stat_bunch(ifd, file_hdr.sa_act_nr, file_actlst,
+						endian_mismatch, arch_64, file, file_magic,
+						&sampled);
+		if (!sampled) {
+			/*
+			 * Statistics from an activity not sampled in every record
+			 * depend on records displayed before: A process couldn't
+			 * display them the same way.
+			 */
+			free(*js);
+			*js = NULL;
+			return -1;
+		}
+
+		/* Will this record be displayed? (see generic_write_stats()) */
+		next = next_slice(record_hdr[2].uptime_cs, rec_hdr.uptime_cs, !*rec_nr, interval);
+		(*rec_nr)++;
+
+		if (keyframe && next) {
+			if (js_nr >= js_size) {
+				js_size += 1024;
+				SREALLOC(*js, struct job_start, js_size * sizeof(struct job_start));
+			}
+			(*js)[js_nr].ref_offset = ref_offset;
+			(*js)[js_nr].offset = sa_lseek(ifd, 0, SEEK_CUR);
+			(*js)[js_nr++].rec_nr = *rec_nr;
+		}
+	}
+
+	return js_nr;
+}
+
+/*
+ ***************************************************************************
+ * Split the records of current segment into ranges displayed in parallel
+ * by several processes (option --jobs). The first range is displayed by a
+ * child process, as are the following ones, except the last one which is
+ * displayed by current process. Each process writes its output to a
+ * temporary file, then these outputs are put together by
+ * end_parallel_segment(). A process may display a range of records
+ * because it starts after a record which can be decoded without reading
+ * the previous ones: This record is read again and used as reference for
+ * the first statistics to display.
+ * This function is called after the first record of the segment has been
+ * read.
+ *
+ * IN:
+ * @ifd		File descriptor of input file.
+ * @file	Name of file being read.
+ * @file_magic	file_magic structure filled with file magic header data.
+ * @file_actlst	List of (known or unknown) activities in file.
+ * @rectime	Structure where timestamp (expressed in local time or in UTC
+ *		depending on whether options -T/-t have been used or not) can
+ *		be saved for current record.
+ * @loctime	Structure where timestamp (expressed in local time) can be
+ *		saved for current record.
+ *
+ * RETURNS:
+ * Range of records displayed by current process (0 if the segment has not
+ * been split).
+ ***************************************************************************
+ */
+int start_parallel_segment(int ifd, char *file, struct file_magic *file_magic,
+			   struct file_activity *file_actlst,
+			   struct tm *rectime, struct tm *loctime)
+{
+	static struct sa_fpos fpos;
+	struct job_start *js = NULL, *start[MAX_JOBS];
+	long rec_nr;
+	int js_nr, i, k, nr, fd, rtype;
+
+	job_nr = job_id = job_chunk_nr = 0;
+	read_end = 0;
+
+	if ((jobs_nr < 2) || tm_start.use || tm_end.use)
+		return 0;
+
+	/* Look for the records where a process may start, then go back */
+	if (sa_save_pos(ifd, &fpos) < 0) {
+		perror("lseek");
+		exit(2);
+	}
+	js_nr = scan_segment(ifd, file, file_magic, file_actlst, &js, &rec_nr);
+	if (sa_restore_pos(ifd, &fpos) < fpos.pos) {
+		perror("lseek");
+		exit(2);
+	}
+
+	/* Ranges should contain roughly the same number of records */
+	nr = MINIMUM(jobs_nr, rec_nr / MIN_JOB_RECORDS);
+	for (k = 1, i = 0; (k < nr) && (i < js_nr); k++) {
+		while ((i < js_nr) && (js[i].rec_nr < rec_nr * k / nr)) {
+			i++;
+		}
+		if (i < js_nr) {
+			start[job_nr + 1] = &js[i++];
+			job_nr++;
+		}
+	}
+	if (!job_nr) {
+		free(js);
+		return 0;
+	}
+	job_nr++;
+
+	job_chunks = (off_t *) mmap(NULL, sizeof(off_t) * job_nr * (MAX_JOB_CHUNKS + 1),
+				    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (job_chunks == MAP_FAILED) {
+		perror("mmap");
+		exit(2);
+	}
+	for (k = 0; k < job_nr; k++) {
+		if ((job_out[k] = tmpfile()) == NULL) {
+			perror("tmpfile");
+			exit(2);
+		}
+	}
+
+	fflush(stdout);
+	for (job_id = 0; job_id < job_nr - 1; job_id++) {
+		if ((job_pid[job_id] = fork()) < 0) {
+			perror("fork");
+			exit(2);
+		}
+		if (!job_pid[job_id])
+			/* Child process */
+			break;
+	}
+
+	if (job_id < job_nr - 1) {
+		/*
+		 * Open the file again: Its offset mustn't be shared with
+		 * other processes.
+		 */
+		if (((fd = open(file, O_RDONLY)) < 0) || (dup2(fd, ifd) < 0)) {
+			perror("open");
+			exit(2);
+		}
+		close(fd);
+		if (sa_lseek(ifd, fpos.pos, SEEK_SET) < fpos.pos) {
+			perror("lseek");
+			exit(2);
+		}
+		read_end = start[job_id + 1]->offset;
+	}
+	else if ((stdout_fd = dup(STDOUT_FILENO)) < 0) {
+		perror("dup");
+		exit(2);
+	}
+	if (dup2(fileno(job_out[job_id]), STDOUT_FILENO) < 0) {
+		perror("dup2");
+		exit(2);
+	}
+
+	if (job_id) {
+		job_uptime_ref = record_hdr[2].uptime_cs;
+
+		/* Read the record used as reference for the first statistics displayed */
+		if (sa_lseek(ifd, start[job_id]->ref_offset, SEEK_SET) < start[job_id]->ref_offset) {
+			perror("lseek");
+			exit(2);
+		}
+		/* This record is a keyframe if the file is delta-encoded */
+		invalidate_delta_state();
+		read_next_sample(ifd, IGNORE_NOTHING, 0, file, &rtype, 0, file_magic,
+				 file_actlst, rectime, loctime);
+		copy_structures(act, id_seq, record_hdr, 2, 0);
+	}
+	free(js);
+
+	return job_id;
+}
+
+/*
+ ***************************************************************************
+ * Save the position in current process's output file where the output
+ * of the records it displays starts (see start_parallel_segment()).
+ ***************************************************************************
+ */
+void start_job_output(void)
+{
+	if (!job_nr)
+		return;
+
+	fflush(stdout);
+	job_chunks[job_id * (MAX_JOB_CHUNKS + 1)] = lseek(STDOUT_FILENO, 0, SEEK_CUR);
+}
+
+/*
+ ***************************************************************************
+ * Save the position in current process's output file where a part of its
+ * output ends. The parts written by each process are put together in turn
+ * by end_parallel_segment().
+ ***************************************************************************
+ */
+void end_job_chunk(void)
+{
+	if (!job_nr)
+		return;
+
+	fflush(stdout);
+	if (job_chunk_nr < MAX_JOB_CHUNKS) {
+		job_chunk_nr++;
+	}
+	job_chunks[job_id * (MAX_JOB_CHUNKS + 1) + job_chunk_nr] = lseek(STDOUT_FILENO, 0, SEEK_CUR);
+}
+
+/*
+ ***************************************************************************
+ * Terminate the display of the records of current segment by several
+ * processes: Child processes exit, and the parent one writes their output
+ * to standard output in the same order as if the records had been
+ * displayed by a single process.
+ ***************************************************************************
+ */
+void end_parallel_segment(void)
+{
+	char buf[8192];
+	off_t *chunk, pos;
+	ssize_t n;
+	int j, k, status;
+
+	if (!job_nr)
+		return;
+
+	/* End of the last part of the output */
+	end_job_chunk();
+
+	if (job_id < job_nr - 1) {
+		/* Child process: All the records of its range have been displayed */
+		_exit(0);
+	}
+
+	/* Restore standard output */
+	if (dup2(stdout_fd, STDOUT_FILENO) < 0) {
+		perror("dup2");
+		exit(2);
+	}
+	close(stdout_fd);
+
+	for (k = 0; k < job_nr - 1; k++) {
+		if (waitpid(job_pid[k], &status, 0) < 0) {
+			perror("waitpid");
+			exit(2);
+		}
+		if (!WIFEXITED(status) || WEXITSTATUS(status))
+			/* An error has been reported by the child process */
+			exit(WIFEXITED(status) ? WEXITSTATUS(status) : 2);
+	}
+
+	for (j = 1; j <= job_chunk_nr; j++) {
+		for (k = 0; k < job_nr; k++) {
+			chunk = job_chunks + k * (MAX_JOB_CHUNKS + 1);
+
+			for (pos = chunk[j - 1]; pos < chunk[j]; pos += n) {
+				n = pread(fileno(job_out[k]), buf,
+					  (size_t) MINIMUM((off_t) sizeof(buf), chunk[j] - pos), pos);
+				if (n <= 0) {
+					perror("pread");
+					exit(2);
+				}
+				fwrite(buf, 1, (size_t) n, stdout);
+			}
+		}
+	}
+
+	for (k = 0; k < job_nr; k++) {
+		fclose(job_out[k]);
+	}
+	munmap(job_chunks, sizeof(off_t) * job_nr * (MAX_JOB_CHUNKS + 1));
+	job_chunks = NULL;
+	job_nr = job_id = job_chunk_nr = 0;
+}
+
 /*
  ***************************************************************************
  * Read stats for current activity from file and print them.
@@ -746,7 +1096,7 @@ void rw_curr_act_stats(int ifd, int *curr, long *cnt, int *eosaf,
 	/* Rewind file */
 	seek_file_position(ifd, DO_RESTORE);
 
-	if (DISPLAY_FIELD_LIST(fmt[f_position]->options)) {
+	if (DISPLAY_FIELD_LIST(fmt[f_position]->options) && !job_id) {
 		/* Print field list */
 		list_fields(act_id);
 	}
@@ -788,17 +1138,47 @@ void rw_curr_act_stats(int ifd, int *curr, long *cnt, int *eosaf,
 	while (*cnt && !*eosaf && (rtype != R_RESTART));
 
 	*reset = TRUE;
+
+	/* Output for this activity is followed by that of other processes */
+	end_job_chunk();
 }
 
 /*
  ***************************************************************************
- * Read stats for current activity from file and display its SVG graphs.
- * At most <count> lines of stats are taken into account.
+ * Save the maximum number of items found for each activity up to current
+ * record. Records after the end time entered with option -e are not taken
+ * into account.
+ *
+ * IN:
+ * @curr	Index in array for current sample statistics.
+ * @loctime	Timestamp (expressed in local time) of current record.
+ ***************************************************************************
+ */
+void save_svg_nr_max(int curr, struct tm *loctime)
+{
+	int i;
+
+	if (tm_end.use && (datecmp(loctime, &tm_end) >= 0))
+		return;
+
+	for (i = 0; i < NR_ACT; i++) {
+		if (act[i]->nr[curr] > id_nr_max[i]) {
+			id_nr_max[i] = act[i]->nr[curr];
+		}
+	}
+}
+
+/*
+ ***************************************************************************
+ * Read stats from file and save the SVG graphs data of all the activities
+ * to display. The file is read only once whatever the number of activities.
+ * The maximum number of items found for each activity is also saved so
+ * that the layout of the views can be computed once all the file has been
+ * read. At most <count> lines of stats are taken into account.
  *
  * IN:
  * @ifd		File descriptor of input file.
  * @curr	Index in array for current sample statistics.
- * @p		Current activity position.
  * @file_actlst	List of (known or unknown) activities in file.
  * @rectime	Structure where timestamp (expressed in local time or in UTC
  *		depending on whether options -T/-t have been used or not) can
@@ -807,27 +1187,22 @@ void rw_curr_act_stats(int ifd, int *curr, long *cnt, int *eosaf,
  *		saved for current record.
  * @file	Name of file being read.
  * @file_magic	file_magic structure filled with file magic header data.
- * @g_nr	Number of graphs already displayed (for all activities).
+ * @svg_p	SVG specific parameters.
  *
  * OUT:
- * @cnt		Number of lines of stats remaining to write.
- * @eosaf	Set to TRUE if EOF (end of file) has been reached.
- * @reset	Set to TRUE if last_uptime variable should be
- *		reinitialized (used in next_slice() function).
- * @g_nr	Total number of views displayed (including current activity).
+ * @curr	Index in array for next sample statistics.
+ * @svg_p	SVG specific parameters: Times used as start and end values
+ *		on the X axis (.@ust_time_ref and .@ust_time_end) and time
+ *		for the first sample of stats (.@ust_time_first).
  ***************************************************************************
  */
-void display_curr_act_graphs(int ifd, int *curr, long *cnt, int *eosaf,
-			     int p, int *reset, struct file_activity *file_actlst,
-			     struct tm *rectime, struct tm *loctime,
-			     char *file, struct file_magic *file_magic, int *g_nr)
+void read_svg_graphs(int ifd, int *curr, struct file_activity *file_actlst,
+		     struct tm *rectime, struct tm *loctime,
+		     char *file, struct file_magic *file_magic, struct svg_parm *svg_p)
 {
-	struct svg_parm parm;
-	int rtype;
-	int next, reset_cd;
-
-	/* Rewind file */
-	seek_file_position(ifd, DO_RESTORE);
+	int i, rtype;
+	int eosaf, next, reset = TRUE, reset_cd = 1;
+	long cnt = count;
 
 	/*
 	 * Restore the first stats collected.
@@ -835,73 +1210,77 @@ void display_curr_act_graphs(int ifd, int *curr, long *cnt, int *eosaf,
 	 */
 	copy_structures(act, id_seq, record_hdr, !*curr, 2);
 
-	parm.graph_no = *g_nr;
-	parm.ust_time_ref = (unsigned long long) get_time_ref();
-	parm.ust_time_first = record_hdr[2].ust_time;
-	parm.restart = TRUE;
-	parm.file_hdr = &file_hdr;
-	parm.nr_max = id_nr_max[p];
+	svg_p->graph_no = 0;
+	svg_p->ust_time_ref = (unsigned long long) get_time_ref();
+	svg_p->ust_time_first = record_hdr[2].ust_time;
+	svg_p->restart = TRUE;
+	svg_p->file_hdr = &file_hdr;
 
-	*cnt  = count;
-	reset_cd = 1;
+	/* Allocate graphs arrays for all the activities to display */
+	for (i = 0; i < NR_ACT; i++) {
+		id_nr_max[i] = act[i]->nr[!*curr];
+		svg_nr_max[i] = 0;
+
+		if (!IS_SELECTED(act[i]->options) || !act[i]->g_nr)
+			continue;
 
-	/* Allocate graphs arrays */
-	(*act[p]->f_svg_print)(act[p], !*curr, F_BEGIN, &parm, 0, &record_hdr[!*curr]);
+		/* Graphs are first allocated for the items of the first record */
+		svg_p->nr_max = id_nr_max[i];
+		(*act[i]->f_svg_print)(act[i], !*curr, F_BEGIN, svg_p, 0, &record_hdr[!*curr]);
+		svg_nr_max[i] = svg_p->nr_max;
+	}
 
 	do {
-		*eosaf = read_next_sample(ifd, IGNORE_RESTART | IGNORE_COMMENT | SET_TIMESTAMPS,
-					  *curr, file, &rtype, 0, file_magic,
-					  file_actlst, rectime, loctime);
+		eosaf = read_next_sample(ifd, IGNORE_RESTART | IGNORE_COMMENT | SET_TIMESTAMPS,
+					 *curr, file, &rtype, 0, file_magic,
+					 file_actlst, rectime, loctime);
 
-		if (!*eosaf && (rtype != R_COMMENT) && (rtype != R_RESTART)) {
+		if (!eosaf && (rtype != R_COMMENT) && (rtype != R_RESTART)) {
 
-			next = generic_write_stats(*curr, tm_start.use, tm_end.use, *reset, cnt,
-						   &parm, rectime, loctime, reset_cd, act[p]->id);
+			save_svg_nr_max(*curr, loctime);
+
+			next = generic_write_stats(*curr, tm_start.use, tm_end.use, reset, &cnt,
+						   svg_p, rectime, loctime, reset_cd, ALL_ACTIVITIES);
 			reset_cd = 0;
 			if (next) {
 				/*
 				 * next is set to 1 when we were close enough to desired interval.
 				 * In this case, the call to generic_write_stats() has actually
-				 * displayed a line of stats.
+				 * saved a sample of stats.
 				 */
-				parm.restart = FALSE;
-				parm.ust_time_end = record_hdr[*curr].ust_time;
+				svg_p->restart = FALSE;
+				svg_p->ust_time_end = record_hdr[*curr].ust_time;
 				*curr ^= 1;
-				if (*cnt > 0) {
-					(*cnt)--;
+				if (cnt > 0) {
+					cnt--;
 				}
 			}
-			*reset = FALSE;
+			reset = FALSE;
 		}
-		if (!*eosaf && (rtype == R_RESTART)) {
-			parm.restart = TRUE;
-			*reset = TRUE;
+		if (!eosaf && (rtype == R_RESTART)) {
+			svg_p->restart = TRUE;
+			reset = TRUE;
 			/* Go to next statistics record, if possible */
 			do {
-				*eosaf = read_next_sample(ifd, IGNORE_RESTART | IGNORE_COMMENT | SET_TIMESTAMPS,
-							  *curr, file, &rtype, 0, file_magic,
-							  file_actlst, rectime, loctime);
+				eosaf = read_next_sample(ifd, IGNORE_RESTART | IGNORE_COMMENT | SET_TIMESTAMPS,
+							 *curr, file, &rtype, 0, file_magic,
+							 file_actlst, rectime, loctime);
 			}
-			while (!*eosaf && ((rtype == R_RESTART) || (rtype == R_COMMENT)));
+			while (!eosaf && ((rtype == R_RESTART) || (rtype == R_COMMENT)));
 
+			if (!eosaf) {
+				save_svg_nr_max(*curr, loctime);
+			}
 			*curr ^= 1;
 		}
 	}
-	while (!*eosaf);
-
-	*reset = TRUE;
+	while (!eosaf);
 
 	/* Determine X axis end value */
 	if (DISPLAY_ONE_DAY(flags) &&
-	    (parm.ust_time_ref + (3600 * 24) > parm.ust_time_end)) {
-		parm.ust_time_end = parm.ust_time_ref + (3600 * 24);
+	    (svg_p->ust_time_ref + (3600 * 24) > svg_p->ust_time_end)) {
+		svg_p->ust_time_end = svg_p->ust_time_ref + (3600 * 24);
 	}
-
-	/* Actually display graphs for current activity */
-	(*act[p]->f_svg_print)(act[p], *curr, F_END, &parm, 0, &record_hdr[!*curr]);
-
-	/* Update total number of graphs already displayed */
-	*g_nr = parm.graph_no;
 }
 
 /*
@@ -949,6 +1328,9 @@ void logic1_display_loop(int ifd, struct file_activity *file_actlst, char *file,
 		(*fmt[f_position]->f_statistics)(&tab, F_BEGIN);
 	}
 
+	/* Skip records saved before the requested start time using file's index */
+	sa_seek_index(ifd, file, S_F_LOCAL_TIME, &tm_start, act, &file_hdr, endian_mismatch, arch_64);
+
 	do {
 		/*
 		 * If this record is a special (RESTART or COMMENT) one,
@@ -971,6 +1353,16 @@ void logic1_display_loop(int ifd, struct file_activity *file_actlst, char *file,
 		reset = TRUE;
 
 		if (!eosaf) {
+			/* Records of this segment may be displayed by several processes */
+			if (start_parallel_segment(ifd, file, file_magic, file_actlst,
+						   rectime, loctime)) {
+				/* Reference record has been displayed by another process */
+				if (*fmt[f_position]->f_statistics) {
+					(*fmt[f_position]->f_statistics)(&tab, F_MAIN);
+				}
+				start_job_output();
+			}
+
 			do {
 				eosaf = read_next_sample(ifd, IGNORE_COMMENT | IGNORE_RESTART, curr,
 							 file, &rtype, tab, file_magic, file_actlst,
@@ -997,6 +1389,8 @@ void logic1_display_loop(int ifd, struct file_activity *file_actlst, char *file,
 			}
 			while (cnt && !eosaf && (rtype != R_RESTART));
 
+			end_parallel_segment();
+
 			if (!cnt) {
 				/* Go to next Linux restart, if possible */
 				do {
@@ -1092,6 +1486,9 @@ void logic2_display_loop(int ifd, struct file_activity *file_actlst,
 	int eosaf = TRUE, reset = FALSE;
 	long cnt = 1;
 
+	/* Skip records saved before the requested start time using file's index */
+	sa_seek_index(ifd, file, S_F_LOCAL_TIME, &tm_start, act, &file_hdr, endian_mismatch, arch_64);
+
 	/* Read system statistics from file */
 	do {
 		/*
@@ -1115,6 +1512,9 @@ void logic2_display_loop(int ifd, struct file_activity *file_actlst,
 		/* Set flag to reset last_uptime variable. Should be done after a LINUX RESTART record */
 		reset = TRUE;
 
+		/* Records of this segment may be displayed by several processes */
+		start_parallel_segment(ifd, file, file_magic, file_actlst, rectime, loctime);
+
 		/* Save current file position */
 		seek_file_position(ifd, DO_SAVE);
 
@@ -1165,6 +1565,8 @@ void logic2_display_loop(int ifd, struct file_activity *file_actlst,
 			}
 		}
 
+		end_parallel_segment();
+
 		if (!cnt) {
 			/* Go to next Linux restart, if possible */
 			do {
@@ -1213,21 +1615,46 @@ void logic3_display_loop(int ifd, struct file_activity *file_actlst,
 			 struct file_magic *file_magic)
 {
 	struct svg_hdr_parm parm;
+	struct svg_parm svg_p;
 	int i, p;
-	int curr = 1, rtype, g_nr = 0, views_per_row = 1;
-	int eosaf = TRUE, reset = TRUE;
-	long cnt = 1;
+	int curr = 1, rtype, views_per_row = 1;
+	int eosaf;
 	int graph_nr = 0;
 
 	/* Use a decimal point to make SVG code locale independent */
 	setlocale(LC_NUMERIC, "C");
 
+	/* Skip records saved before the requested start time using file's index */
+	sa_seek_index(ifd, file, S_F_LOCAL_TIME, &tm_start, act, &file_hdr, endian_mismatch, arch_64);
+
 	/*
-	 * Calculate the number of rows and the max number of views per row to display.
-	 * Result may be 0. In this case, "No data" will be displayed instead of the graphs.
-	 */
-	graph_nr = get_svg_graph_nr(ifd, file, file_magic,
-				    file_actlst, rectime, loctime, &views_per_row);
+	* If this record is a special (RESTART or COMMENT) one, ignore it and
+	* (try to) get another one.
+	*/
+	do {
+		eosaf = read_next_sample(ifd, IGNORE_RESTART | IGNORE_COMMENT, 0,
+					 file, &rtype, 0, file_magic, file_actlst,
+					 rectime, loctime);
+	}
+	while (!eosaf &&
+	       ((rtype == R_RESTART) || (rtype == R_COMMENT) ||
+		(tm_start.use && (datecmp(loctime, &tm_start) < 0)) ||
+		(tm_end.use && (datecmp(loctime, &tm_end) >= 0))));
+
+	if (!eosaf) {
+		/* Save the first stats collected. Used for example in next_slice() function */
+		copy_structures(act, id_seq, record_hdr, 2, 0);
+
+		/* Read the whole file once and save graphs data for all activities */
+		read_svg_graphs(ifd, &curr, file_actlst, rectime, loctime, file,
+				file_magic, &svg_p);
+
+		/*
+		 * Calculate the number of rows and the max number of views per row to display.
+		 * Result may be 0. In this case, "No data" will be displayed instead of the graphs.
+		 */
+		graph_nr = get_svg_graph_nr(&views_per_row);
+	}
 
 	if (SET_CANVAS_HEIGHT(flags)) {
 		/*
@@ -1237,7 +1664,6 @@ void logic3_display_loop(int ifd, struct file_activity *file_actlst,
 		graph_nr = canvas_height;
 	}
 
-
 	parm.graph_nr = graph_nr;
 	parm.views_per_row = PACK_VIEWS(flags) ? views_per_row : 1;
 
@@ -1247,29 +1673,11 @@ void logic3_display_loop(int ifd, struct file_activity *file_actlst,
 					     &file_hdr, act, id_seq, file_actlst);
 	}
 
-	/*
-	* If this record is a special (RESTART or COMMENT) one, ignore it and
-	* (try to) get another one.
-	*/
-	do {
-		if (read_next_sample(ifd, IGNORE_RESTART | IGNORE_COMMENT, 0,
-				     file, &rtype, 0, file_magic, file_actlst,
-				     rectime, loctime))
-		{
-			/* End of sa data file: No views displayed */
-			parm.graph_nr = 0;
-			goto close_svg;
-		}
+	if (eosaf) {
+		/* End of sa data file: No views displayed */
+		parm.graph_nr = 0;
+		goto close_svg;
 	}
-	while ((rtype == R_RESTART) || (rtype == R_COMMENT) ||
-	       (tm_start.use && (datecmp(loctime, &tm_start) < 0)) ||
-	       (tm_end.use && (datecmp(loctime, &tm_end) >= 0)));
-
-	/* Save the first stats collected. Used for example in next_slice() function */
-	copy_structures(act, id_seq, record_hdr, 2, 0);
-
-	/* Save current file position */
-	seek_file_position(ifd, DO_SAVE);
 
 	/* For each requested activity, display graphs */
 	for (i = 0; i < NR_ACT; i++) {
@@ -1281,32 +1689,12 @@ void logic3_display_loop(int ifd, struct file_activity *file_actlst,
 		if (!IS_SELECTED(act[p]->options) || !act[p]->g_nr)
 			continue;
 
-		if (!HAS_MULTIPLE_OUTPUTS(act[p]->options)) {
-			display_curr_act_graphs(ifd, &curr, &cnt, &eosaf,
-						p, &reset, file_actlst,
-						rectime, loctime, file,
-						file_magic, &g_nr);
-		}
-		else {
-			unsigned int optf, msk;
-
-			optf = act[p]->opt_flags;
-
-			for (msk = 1; msk < 0x100; msk <<= 1) {
-				if ((act[p]->opt_flags & 0xff) & msk) {
-					act[p]->opt_flags &= (0xffffff00 + msk);
-					display_curr_act_graphs(ifd, &curr, &cnt, &eosaf,
-								p, &reset, file_actlst,
-								rectime, loctime, file,
-								file_magic, &g_nr);
-					act[p]->opt_flags = optf;
-				}
-			}
-		}
+		svg_p.nr_max = svg_nr_max[p];
+		(*act[p]->f_svg_print)(act[p], curr, F_END, &svg_p, 0, &record_hdr[!curr]);
 	}
 
 	/* Real number of graphs that have been displayed */
-	parm.graph_nr = g_nr;
+	parm.graph_nr = svg_p.graph_no;
 
 close_svg:
 	/* Print SVG trailer */
@@ -1364,7 +1752,7 @@ void read_stats_from_file(char dfile[])
 				    &file_magic, &rectime, &loctime);
 	}
 
-	close(ifd);
+	sa_close(ifd);
 
 	free(file_actlst);
 	free_structures(act);
@@ -1433,6 +1821,44 @@ int main(int argc, char **argv)
 			}
 		}
 
+		else if (!strcmp(argv[opt], "--rollup")) {
+			/* Roll datafile up to a coarser interval */
+			if (!argv[++opt] || sar_options || format) {
+				usage(argv[0]);
+			}
+			t = strtok(argv[opt], ",");
+			if (!t || !strlen(t) || (strspn(t, DIGITS) != strlen(t)) ||
+			    ((rollup_itv = atol(t)) < 1)) {
+				usage(argv[0]);
+			}
+			if ((t = strtok(NULL, ",")) != NULL) {
+				if (!strcmp(t, K_MIN)) {
+					rollup_agg = ROLLUP_MIN;
+				}
+				else if (!strcmp(t, K_MAX)) {
+					rollup_agg = ROLLUP_MAX;
+				}
+				else if (strcmp(t, K_MEAN)) {
+					usage(argv[0]);
+				}
+				if (strtok(NULL, ",")) {
+					usage(argv[0]);
+				}
+			}
+			format = F_ROLLUP_OUTPUT;
+			opt++;
+		}
+
+		else if (!strcmp(argv[opt], "--jobs")) {
+			/* Display statistics using several processes */
+			if (!argv[++opt] || sar_options ||
+			    (strspn(argv[opt], DIGITS) != strlen(argv[opt])) ||
+			    ((jobs_nr = atoi(argv[opt])) < 1) || (jobs_nr > MAX_JOBS)) {
+				usage(argv[0]);
+			}
+			opt++;
+		}
+
 		else if (!strcmp(argv[opt], "-O")) {
 			/* Parse output options */
 			if (!argv[++opt] || sar_options) {
@@ -1468,6 +1894,13 @@ int main(int argc, char **argv)
 				else if (!strcmp(t, K_PACKED)) {
 					flags |= S_F_SVG_PACKED;
 				}
+				else if (!strncmp(t, K_POINTS, strlen(K_POINTS))) {
+					v = t + strlen(K_POINTS);
+					if (!strlen(v) || (strspn(v, DIGITS) != strlen(v)) ||
+					    ((svg_points = atoi(v)) < 2)) {
+						usage(argv[0]);
+					}
+				}
 				else {
 					usage(argv[0]);
 				}
@@ -1527,6 +1960,13 @@ int main(int argc, char **argv)
 
 					switch (*(argv[opt] + i)) {
 
+					case 'b':
+						if (format) {
+							usage(argv[0]);
+						}
+						format = F_COL_OUTPUT;
+						break;
+
 					case 'C':
 						flags |= S_F_COMMENT;
 						break;
@@ -1613,7 +2053,8 @@ int main(int argc, char **argv)
 		}
 
 		/* Get data file name */
-		else if (strspn(argv[opt], DIGITS) != strlen(argv[opt])) {
+		else if ((strspn(argv[opt], DIGITS) != strlen(argv[opt])) &&
+			 ((interval >= 0) || (parse_interval(argv[opt]) < 0))) {
 			if (dfile[0] || day_offset) {
 				/* File already specified */
 				usage(argv[0]);
@@ -1627,11 +2068,12 @@ int main(int argc, char **argv)
 
 		else if (interval < 0) {
 			/* Get interval */
-			if (strspn(argv[opt], DIGITS) != strlen(argv[opt])) {
-				usage(argv[0]);
-			}
-			interval = atol(argv[opt++]);
-			if (interval <= 0) {
+			interval = parse_interval(argv[opt++]);
+			/*
+			 * Timestamps and intervals displayed by sadf have a
+			 * one second resolution.
+			 */
+			if ((interval < 1000) || (interval % 1000)) {
 				usage(argv[0]);
 			}
 		}
@@ -1674,6 +2116,15 @@ int main(int argc, char **argv)
 		usage(argv[0]);
 	}
 
+	/*
+	 * Records are displayed by several processes only if the number of
+	 * lines to display is not limited. Columnar output blocks contain
+	 * consecutive records and are written by a single process.
+	 */
+	if ((count > 0) || (format == F_SVG_OUTPUT) || (format == F_COL_OUTPUT)) {
+		jobs_nr = 1;
+	}
+
 	/*
 	 * Display all the contents of the daily data file if the count parameter
 	 * was not set on the command line.
@@ -1689,13 +2140,17 @@ int main(int argc, char **argv)
 	check_format_options();
 
 	if (interval < 0) {
-		interval = 1;
+		interval = 1000;
 	}
 
 	if (format == F_CONV_OUTPUT) {
 		/* Convert file to current format */
 		convert_file(dfile, act);
 	}
+	else if (format == F_ROLLUP_OUTPUT) {
+		/* Roll file up to a coarser interval */
+		rollup_file(dfile, act, rollup_itv, rollup_agg);
+	}
 	else {
 		/* Read stats from file */
 		read_stats_from_file(dfile);
@@ -28,7 +28,7 @@
  */
 
 /* Number of output formats */
-#define NR_FMT	8
+#define NR_FMT	10
 
 /* Output formats */
 #define F_DB_OUTPUT	1
@@ -39,6 +39,8 @@
 #define F_CONV_OUTPUT	6
 #define F_SVG_OUTPUT	7
 #define F_RAW_OUTPUT	8
+#define F_ROLLUP_OUTPUT	9
+#define F_COL_OUTPUT	10
 
 /* Format options */
 
@@ -117,6 +119,51 @@
 #define REJECT_TRUE_TIME(m)		(((m) & FO_NO_TRUE_TIME)	== FO_NO_TRUE_TIME)
 
 
+/*
+ ***************************************************************************
+ * Definitions for sadf --rollup.
+ ***************************************************************************
+ */
+
+/* Keywords used to select the value saved for gauges */
+#define K_MEAN	"mean"
+#define K_MIN	"min"
+#define K_MAX	"max"
+
+/* Value saved for gauges */
+#define ROLLUP_MEAN	0
+#define ROLLUP_MIN	1
+#define ROLLUP_MAX	2
+
+/*
+ ***************************************************************************
+ * Definitions for sadf --jobs.
+ ***************************************************************************
+ */
+
+/* Maximum number of processes used to display statistics */
+#define MAX_JOBS		64
+/* Minimum number of statistics records displayed by each process */
+#define MIN_JOB_RECORDS		64
+/*
+ * Maximum number of parts in the output of each process
+ * (one per activity and output of the activity, plus one).
+ */
+#define MAX_JOB_CHUNKS		(NR_ACT * 8 + 1)
+
+/* Record after which a process starts displaying statistics */
+struct job_start {
+	/*
+	 * Offset of the record (a statistics one which can be decoded
+	 * without reading the previous ones).
+	 */
+	off_t ref_offset;
+	/* Offset of the record following it */
+	off_t offset;
+	/* Number of statistics records in segment up to (and including) this one */
+	long rec_nr;
+};
+
 /*
  ***************************************************************************
  * Various function prototypes
@@ -125,6 +172,8 @@
 
 void convert_file
 	(char [], struct activity *[]);
+void rollup_file
+	(char [], struct activity *[], long, int);
 
 /*
  * Prototypes used to display restart messages
@@ -193,5 +242,8 @@ __printf_funct_t print_hdr_header
 __printf_funct_t print_svg_header
 	(void *, int, char *, struct file_magic *, struct file_header *,
 	 struct activity * [], unsigned int [], struct file_activity *);
+__printf_funct_t print_col_header
+	(void *, int, char *, struct file_magic *, struct file_header *,
+	 struct activity * [], unsigned int [], struct file_activity *);
 
 #endif  /* _SADF_H */
@@ -23,6 +23,7 @@
 #include <string.h>
 
 #include "sadf.h"
+#include "sa_out.h"
 
 #ifdef USE_NLS
 #include <locale.h>
@@ -491,7 +492,7 @@ char *print_dbppc_timestamp(int fmt, struct file_header *file_hdr, char *cur_dat
 	pre[79] = '\0';
 
 	if (DISPLAY_HORIZONTALLY(flags)) {
-		printf("%s", pre);
+		out_puts(pre);
 	}
 
 	return pre;
@@ -525,7 +526,7 @@ __tm_funct_t print_ppc_timestamp(void *parm, int action, char *cur_date,
 	}
 	if (action & F_END) {
 		if (DISPLAY_HORIZONTALLY(flags)) {
-			printf("\n");
+			out_puts("\n");
 		}
 	}
 
@@ -560,7 +561,7 @@ __tm_funct_t print_db_timestamp(void *parm, int action, char *cur_date,
 	}
 	if (action & F_END) {
 		if (DISPLAY_HORIZONTALLY(flags)) {
-			printf("\n");
+			out_puts("\n");
 		}
 	}
 
@@ -589,11 +590,11 @@ __tm_funct_t print_xml_timestamp(void *parm, int action, char *cur_date,
 	int *tab = (int *) parm;
 
 	if (action & F_BEGIN) {
-		xprintf((*tab)++, "<timestamp date=\"%s\" time=\"%s\" utc=\"%d\" interval=\"%llu\">",
-			cur_date, cur_time, utc ? 1 : 0, itv);
+		out_xprintf((*tab)++, "<timestamp date=\"%s\" time=\"%s\" utc=\"%d\" interval=\"%llu\">",
+			    cur_date, cur_time, utc ? 1 : 0, itv);
 	}
 	if (action & F_END) {
-		xprintf(--(*tab), "</timestamp>");
+		out_xprintf(--(*tab), "</timestamp>");
 	}
 
 	return NULL;
@@ -621,16 +622,16 @@ __tm_funct_t print_json_timestamp(void *parm, int action, char *cur_date,
 	int *tab = (int *) parm;
 
 	if (action & F_BEGIN) {
-		xprintf0(*tab,
-			 "\"timestamp\": {\"date\": \"%s\", \"time\": \"%s\", "
-			 "\"utc\": %d, \"interval\": %llu}",
-			 cur_date, cur_time, utc ? 1 : 0, itv);
+		out_xprintf0(*tab,
+			     "\"timestamp\": {\"date\": \"%s\", \"time\": \"%s\", "
+			     "\"utc\": %d, \"interval\": %llu}",
+			     cur_date, cur_time, utc ? 1 : 0, itv);
 	}
 	if (action & F_MAIN) {
-		printf(",\n");
+		out_puts(",\n");
 	}
 	if (action & F_END) {
-		printf("\n");
+		out_puts("\n");
 	}
 
 	return NULL;
@@ -831,7 +832,8 @@ __printf_funct_t print_hdr_header(void *parm, int action, char *dfile,
 
 		display_sa_file_version(stdout, file_magic);
 
-		if (file_magic->format_magic != FORMAT_MAGIC) {
+		if ((file_magic->format_magic != FORMAT_MAGIC) &&
+		    (file_magic->format_magic != FORMAT_MAGIC_DELTA)) {
 			return;
 		}
 
@@ -27,9 +27,12 @@
 #include <errno.h>
 #include <signal.h>
 #include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 
 #include "version.h"
 #include "sa.h"
+#include "sa_shm.h"
 
 #ifdef USE_NLS
 #include <locale.h>
@@ -45,6 +48,7 @@ char *sccsid(void) { return (SCCSID); }
 #endif
 
 /* Interval and count parameters */
+/* Interval in milliseconds */
 long interval = -1, count = 0;
 
 /* TRUE if a header line must be printed */
@@ -87,6 +91,28 @@ extern struct report_format sar_fmt;
 struct sigaction int_act;
 int sigint_caught = 0;
 
+/* Outputs displayed in a single pass when reading stats from a file */
+struct sar_track trk[MAX_NR_TRACKS];
+int trk_nr = 0;
+/* Duplicate of stdout file descriptor, used while outputs are rendered */
+int stdout_fd = -1;
+
+/*
+ * Shared memory segment where sadc publishes its records (option --shm).
+ * Header data and records are copied to @shm_buf, then read from there
+ * by sa_read(). @shm_rec_nr is the number of the last record read from
+ * the segment and @shm_uptime the uptime of the last record displayed.
+ */
+struct sa_shm shm;
+char shm_name[MAX_FILE_LEN];
+
+/* Unix socket sadc listens on (option --connect) */
+char sock_path[MAX_FILE_LEN];
+char *shm_buf = NULL;
+size_t shm_len = 0, shm_pos = 0;
+unsigned int shm_gen = 0;
+unsigned long long shm_rec_nr = 0, shm_uptime = 0;
+
 /*
  ***************************************************************************
  * Print usage title message.
@@ -116,6 +142,7 @@ void usage(char *progname)
 			  "[ -A ] [ -B ] [ -b ] [ -C ] [ -D ] [ -d ] [ -F [ MOUNT ] ] [ -H ] [ -h ]\n"
 			  "[ -p ] [ -q ] [ -r [ ALL ] ] [ -S ] [ -t ] [ -u [ ALL ] ] [ -V ]\n"
 			  "[ -v ] [ -W ] [ -w ] [ -y ] [ -z ] [ --help ] [ --human ] [ --sadc ]\n"
+			  "[ --connect <socket> ] [ --shm <name> ]\n"
 			  "[ -I { <int_list> | SUM | ALL } ] [ -P { <cpu_list> | ALL } ]\n"
 			  "[ -m { <keyword> [,...] | ALL } ] [ -n { <keyword> [,...] | ALL } ]\n"
 			  "[ -j { ID | LABEL | PATH | UUID | ... } ]\n"
@@ -342,6 +369,191 @@ int check_line_hdr(void)
 	return rc;
 }
 
+/*
+ ***************************************************************************
+ * Close temporary files used to render outputs.
+ ***************************************************************************
+ */
+void free_tracks(void)
+{
+	int i;
+
+	for (i = 0; i < trk_nr; i++) {
+		if (trk[i].fp) {
+			fclose(trk[i].fp);
+			trk[i].fp = NULL;
+		}
+	}
+	trk_nr = 0;
+
+	CLOSE(stdout_fd);
+	stdout_fd = -1;
+}
+
+/*
+ ***************************************************************************
+ * Build the list of outputs to display when reading stats from a file,
+ * and allocate a temporary file for each of them. This list is used to
+ * read the file only once even if several activities have been selected.
+ *
+ * RETURNS:
+ * Number of outputs in list. 0 is returned if there is only one output
+ * to display, or if temporary files couldn't be created (in which case
+ * activities will be displayed by reading the file once per output).
+ ***************************************************************************
+ */
+int init_tracks(void)
+{
+	int i, p;
+	unsigned int msk;
+
+	trk_nr = 0;
+
+	for (i = 0; i < NR_ACT; i++) {
+
+		if (!id_seq[i])
+			continue;
+
+		p = get_activity_position(act, id_seq[i], EXIT_IF_NOT_FOUND);
+		if (!IS_SELECTED(act[p]->options))
+			continue;
+
+		for (msk = 1; msk < 0x100; msk <<= 1) {
+			if (HAS_MULTIPLE_OUTPUTS(act[p]->options) &&
+			    !((act[p]->opt_flags & 0xff) & msk))
+				continue;
+
+			trk[trk_nr].p = p;
+			trk[trk_nr].opt_flags = act[p]->opt_flags;
+			if (HAS_MULTIPLE_OUTPUTS(act[p]->options)) {
+				trk[trk_nr].opt_flags &= (0xffffff00 + msk);
+			}
+			trk[trk_nr].inc = 0;
+			if (act[p]->bitmap) {
+				trk[trk_nr].inc = count_bits(act[p]->bitmap->b_array,
+							     BITMAP_SIZE(act[p]->bitmap->b_size));
+			}
+			trk[trk_nr++].fp = NULL;
+
+			if (!HAS_MULTIPLE_OUTPUTS(act[p]->options))
+				break;
+		}
+	}
+
+	if (trk_nr < 2) {
+		trk_nr = 0;
+		return 0;
+	}
+
+	if ((stdout_fd = dup(STDOUT_FILENO)) < 0)
+		goto no_tracks;
+
+	for (i = 0; i < trk_nr; i++) {
+		if ((trk[i].fp = tmpfile()) == NULL)
+			goto no_tracks;
+	}
+
+	return trk_nr;
+
+no_tracks:
+	free_tracks();
+	return 0;
+}
+
+/*
+ ***************************************************************************
+ * Redirect stdout to the temporary file of an output, and set the
+ * activity's output flags and header line flag to those of this output.
+ *
+ * IN:
+ * @t		Index of output in track list.
+ ***************************************************************************
+ */
+void select_track(int t)
+{
+	fflush(stdout);
+	if (dup2(fileno(trk[t].fp), STDOUT_FILENO) < 0) {
+		perror("dup2");
+		exit(4);
+	}
+	act[trk[t].p]->opt_flags = trk[t].opt_flags;
+	dis = trk[t].dis;
+}
+
+/*
+ ***************************************************************************
+ * Restore stdout, then copy the contents of every output's temporary
+ * file to it, in order. Temporary files are emptied so that they can be
+ * used again for the next set of statistics (after a LINUX RESTART).
+ ***************************************************************************
+ */
+void flush_tracks(void)
+{
+	int i;
+	ssize_t n;
+	char buf[8192];
+
+	fflush(stdout);
+	if (dup2(stdout_fd, STDOUT_FILENO) < 0) {
+		perror("dup2");
+		exit(4);
+	}
+
+	for (i = 0; i < trk_nr; i++) {
+		if (lseek(fileno(trk[i].fp), 0, SEEK_SET) < 0) {
+			perror("lseek");
+			exit(2);
+		}
+		while ((n = read(fileno(trk[i].fp), buf, sizeof(buf))) > 0) {
+			fwrite(buf, 1, n, stdout);
+		}
+		if ((n < 0) || (ftruncate(fileno(trk[i].fp), 0) < 0) ||
+		    (lseek(fileno(trk[i].fp), 0, SEEK_SET) < 0)) {
+			perror("tmpfile");
+			exit(2);
+		}
+	}
+	fflush(stdout);
+}
+
+/*
+ ***************************************************************************
+ * Display current or average statistics for every output of the track
+ * list, each output being saved into its own temporary file.
+ *
+ * IN:
+ * @prev	Index in array where stats used as reference are.
+ * @curr	Index in array for current sample statistics.
+ * @itv		Interval of time in 1/100th of a second.
+ * @dispavg	TRUE if displaying average statistics.
+ ***************************************************************************
+ */
+void print_tracks(int prev, int curr, unsigned long long itv, int dispavg)
+{
+	int t, p;
+	unsigned int optf;
+
+	for (t = 0; t < trk_nr; t++) {
+		p = trk[t].p;
+
+		if ((act[p]->nr[curr] <= 0) || (!dispavg && act[p]->unsampled[curr]))
+			continue;
+
+		optf = act[p]->opt_flags;
+		select_track(t);
+
+		if (dispavg) {
+			(*act[p]->f_print_avg)(act[p], prev, curr,
+					       get_act_itv_value(act[p], prev, curr, itv));
+		}
+		else {
+			(*act[p]->f_print)(act[p], prev, curr,
+					   get_act_itv_value(act[p], prev, curr, itv));
+		}
+		act[p]->opt_flags = optf;
+	}
+}
+
 /*
  ***************************************************************************
  * Print statistics average.
@@ -352,7 +564,8 @@ int check_line_hdr(void)
  * 			data file.
  * @act_id		Activity that can be displayed, or ~0 for all.
  *			Remember that when reading stats from a file, only
- *			one activity can be displayed at a time.
+ *			one activity can be displayed at a time, unless
+ *			ALL_TRACKS is used (see handle_all_act_stats()).
  ***************************************************************************
  */
 void write_stats_avg(int curr, int read_from_file, unsigned int act_id)
@@ -363,21 +576,34 @@ void write_stats_avg(int curr, int read_from_file, unsigned int act_id)
 	/* Interval value in 1/100th of a second */
 	itv = get_interval(record_hdr[2].uptime_cs, record_hdr[curr].uptime_cs);
 
-	strncpy(timestamp[curr], _("Average:"), TIMESTAMP_LEN);
-	timestamp[curr][TIMESTAMP_LEN - 1] = '\0';
+	if (PRINT_MSEC_TIME(flags)) {
+		/* Keep columns aligned with time displayed with milliseconds */
+		snprintf(timestamp[curr], TIMESTAMP_LEN, "%-12s", _("Average:"));
+	}
+	else {
+		strncpy(timestamp[curr], _("Average:"), TIMESTAMP_LEN);
+		timestamp[curr][TIMESTAMP_LEN - 1] = '\0';
+	}
 	strcpy(timestamp[!curr], timestamp[curr]);
 
 	/* Test stdout */
 	TEST_STDOUT(STDOUT_FILENO);
 
-	for (i = 0; i < NR_ACT; i++) {
+	if (act_id == ALL_TRACKS) {
+		/* Display average statistics for every output in track list */
+		print_tracks(2, curr, itv, TRUE);
+	}
+	else {
+		for (i = 0; i < NR_ACT; i++) {
 
-		if ((act_id != ALL_ACTIVITIES) && (act[i]->id != act_id))
-			continue;
+			if ((act_id != ALL_ACTIVITIES) && (act[i]->id != act_id))
+				continue;
 
-		if (IS_SELECTED(act[i]->options) && (act[i]->nr[curr] > 0)) {
-			/* Display current average activity statistics */
-			(*act[i]->f_print_avg)(act[i], 2, curr, itv);
+			if (IS_SELECTED(act[i]->options) && (act[i]->nr[curr] > 0)) {
+				/* Display current average activity statistics */
+				(*act[i]->f_print_avg)(act[i], 2, curr,
+						       get_act_itv_value(act[i], 2, curr, itv));
+			}
 		}
 	}
 
@@ -405,7 +631,8 @@ void write_stats_avg(int curr, int read_from_file, unsigned int act_id)
  * 			reinitialized (used in next_slice() function).
  * @act_id		Activity that can be displayed or ~0 for all.
  *			Remember that when reading stats from a file, only
- *			one activity can be displayed at a time.
+ *			one activity can be displayed at a time, unless
+ *			ALL_TRACKS is used (see handle_all_act_stats()).
  * @reset_cd		TRUE if static cross_day variable should be reset
  * 			(see below).
  *
@@ -437,8 +664,8 @@ int write_stats(int curr, int read_from_file, long *cnt, int use_tm_start,
 		cross_day = 0;
 	}
 
-	/* Check time (1) */
-	if (read_from_file) {
+	/* Check time (1). Every record is displayed if no interval has been entered */
+	if (read_from_file && interval) {
 		if (!next_slice(record_hdr[2].uptime_cs, record_hdr[curr].uptime_cs,
 				reset, interval))
 			/* Not close enough to desired interval */
@@ -498,14 +725,22 @@ int write_stats(int curr, int read_from_file, long *cnt, int use_tm_start,
 	/* Test stdout */
 	TEST_STDOUT(STDOUT_FILENO);
 
+	if (act_id == ALL_TRACKS) {
+		/* Display statistics for every output in track list */
+		print_tracks(!curr, curr, itv, FALSE);
+		return 1;
+	}
+
 	for (i = 0; i < NR_ACT; i++) {
 
 		if ((act_id != ALL_ACTIVITIES) && (act[i]->id != act_id))
 			continue;
 
-		if (IS_SELECTED(act[i]->options) && (act[i]->nr[curr] > 0)) {
+		if (IS_SELECTED(act[i]->options) && (act[i]->nr[curr] > 0) &&
+		    !act[i]->unsampled[curr]) {
 			/* Display current activity statistics */
-			(*act[i]->f_print)(act[i], !curr, curr, itv);
+			(*act[i]->f_print)(act[i], !curr, curr,
+					   get_act_itv_value(act[i], !curr, curr, itv));
 		}
 	}
 
@@ -573,9 +808,21 @@ int sa_read(void *buffer, size_t size)
 {
 	ssize_t n;
 
+	if (USE_SHM(flags)) {
+		/* Data are read from the copy of shared memory */
+		if (shm_pos + size > shm_len)
+			return 1;
+		memcpy(buffer, shm_buf + shm_pos, size);
+		shm_pos += size;
+		return 0;
+	}
+
 	while (size) {
 
 		if ((n = read(STDIN_FILENO, buffer, size)) < 0) {
+			if ((errno == EINTR) && sigint_caught)
+				/* SIGINT caught while waiting for sadc */
+				return 1;
 			perror("read");
 			exit(2);
 		}
@@ -590,6 +837,187 @@ int sa_read(void *buffer, size_t size)
 	return 0;
 }
 
+/*
+ ***************************************************************************
+ * Connect to a running sadc command listening on a Unix socket, and
+ * subscribe to the selected activities. Data sent by sadc are then read
+ * from STDIN.
+ ***************************************************************************
+ */
+void connect_sadc(void)
+{
+	struct sockaddr_un addr;
+	struct sa_sub_req req;
+	struct sa_sub_ans ans;
+	size_t len;
+	int fd, i;
+
+	if ((len = strlen(sock_path)) >= sizeof(addr.sun_path)) {
+		fprintf(stderr, _("Socket name too long: %s\n"), sock_path);
+		exit(2);
+	}
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	memcpy(addr.sun_path, sock_path, len);
+
+	if (((fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) ||
+	    (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0)) {
+		fprintf(stderr, _("Cannot open %s: %s\n"), sock_path, strerror(errno));
+		exit(2);
+	}
+	if (dup2(fd, STDIN_FILENO) < 0) {
+		perror("dup2");
+		exit(4);
+	}
+	close(fd);
+
+	/* Send subscription request */
+	memset(&req, 0, SA_SUB_REQ_SIZE);
+	req.magic    = SA_SUB_MAGIC;
+	req.interval = (unsigned int) interval;
+	for (i = 0; i < NR_ACT; i++) {
+		if (IS_SELECTED(act[i]->options)) {
+			req.act_id[req.act_nr++] = act[i]->id;
+		}
+	}
+	if (write(STDIN_FILENO, &req, SA_SUB_REQ_SIZE) != SA_SUB_REQ_SIZE) {
+		perror("write");
+		exit(2);
+	}
+
+	/* Read answer */
+	if (sa_read(&ans, SA_SUB_ANS_SIZE) || (ans.magic != SA_SUB_MAGIC)) {
+		print_read_error(END_OF_DATA_UNEXPECTED);
+	}
+
+	switch (ans.status) {
+
+	case SUB_OK:
+		break;
+
+	case SUB_BAD_INTERVAL:
+		fprintf(stderr, _("Interval must be a multiple of %u.%03u seconds\n"),
+			ans.interval / 1000, ans.interval % 1000);
+		exit(1);
+
+	case SUB_TOO_MANY:
+		fprintf(stderr, _("Too many clients connected to data collector\n"));
+		exit(1);
+
+	default:
+		print_read_error(INCONSISTENT_INPUT_DATA);
+	}
+}
+
+/*
+ ***************************************************************************
+ * Map the shared memory segment where sadc publishes its records.
+ ***************************************************************************
+ */
+void attach_shm(void)
+{
+	if (sa_shm_attach(&shm, shm_name) < 0) {
+		fprintf(stderr, _("Cannot open %s: %s\n"), shm.path, strerror(errno));
+		exit(2);
+	}
+
+	/* Header data are copied just before the record in the buffer */
+	SREALLOC(shm_buf, char, SA_SHM_HDR_AREA + shm.hdr->slot_size);
+	shm_gen = 0;
+	shm_rec_nr = 0;
+}
+
+/*
+ ***************************************************************************
+ * Wait for a new record published by sadc in shared memory, then copy it
+ * so that it can be read with sa_read(). If the header data published by
+ * sadc have changed since last record, they are copied first.
+ * A record is skipped if less than <interval> seconds have elapsed since
+ * last record displayed.
+ *
+ * RETURNS:
+ * 0 if a record has been copied, 1 if header data then a record have
+ * been copied, and -1 if no more records will be published (or if
+ * SIGINT has been caught).
+ ***************************************************************************
+ */
+int read_shm_record(void)
+{
+	struct record_header *rec_hdr;
+	struct timespec ts = {0, SA_SHM_POLL_DELAY};
+	char *rec = shm_buf + SA_SHM_HDR_AREA;
+	unsigned long long last;
+	unsigned int gen, hgen;
+	long long len;
+	int hlen;
+
+	/* Check for new records more often if interval is short */
+	if (interval && (interval < SA_SHM_POLL_DELAY / 500000)) {
+		ts.tv_nsec = interval * 500000;
+	}
+
+	shm_pos = shm_len = 0;
+
+	while (!sigint_caught) {
+
+		switch (sa_shm_state(&shm)) {
+
+		case SHM_STOPPED:
+			return -1;
+
+		case SHM_MOVED:
+			/* sadc has replaced the segment: Attach to the new one */
+			sa_shm_detach(&shm);
+			attach_shm();
+			rec = shm_buf + SA_SHM_HDR_AREA;
+			continue;
+		}
+
+		last = sa_shm_last_record(&shm);
+		if ((last > shm_rec_nr) &&
+		    ((len = sa_shm_read_record(&shm, last, rec, &gen)) >= RECORD_HEADER_SIZE)) {
+			shm_rec_nr = last;
+			rec_hdr = (struct record_header *) rec;
+
+			if (gen && (!shm_uptime || !interval ||
+			    (rec_hdr->uptime_cs + MINIMUM(SA_SHM_ITV_MARGIN, interval / 40) >=
+			     shm_uptime + interval / 10))) {
+
+				if (gen == shm_gen) {
+					shm_pos = SA_SHM_HDR_AREA;
+					shm_len = SA_SHM_HDR_AREA + len;
+					shm_uptime = rec_hdr->uptime_cs;
+					return 0;
+				}
+
+				/*
+				 * Header data have changed. Ignore the record if it doesn't
+				 * match current header data (which are being updated).
+				 */
+				if (((hlen = sa_shm_read_hdr(&shm, shm_buf, &hgen)) > 0) &&
+				    (hgen == gen)) {
+					memmove(shm_buf + SA_SHM_HDR_AREA - hlen, shm_buf, hlen);
+					shm_pos = SA_SHM_HDR_AREA - hlen;
+					shm_len = SA_SHM_HDR_AREA + len;
+					shm_gen = gen;
+					shm_uptime = rec_hdr->uptime_cs;
+					return 1;
+				}
+			}
+			continue;
+		}
+
+		if ((kill(shm.hdr->pid, 0) < 0) && (errno == ESRCH))
+			/* sadc has been killed */
+			return -1;
+
+		/* Wait for next record */
+		nanosleep(&ts, NULL);
+	}
+
+	return -1;
+}
+
 /*
  ***************************************************************************
  * Display a restart message (contents of a R_RESTART record).
@@ -670,13 +1098,18 @@ void read_sadc_stat_bunch(int curr)
 			continue;
 		p = get_activity_position(act, id_seq[i], EXIT_IF_NOT_FOUND);
 
-		if (HAS_COUNT_FUNCTION(act[p]->options)) {
+		if (HAS_NR_VALUE(act[p]->options)) {
 			if (sa_read(&(act[p]->nr[curr]), sizeof(__nr_t))) {
 #ifdef DEBUG
 				fprintf(stderr, "%s: Nb of items\n", __FUNCTION__);
 #endif
 				print_read_error(END_OF_DATA_UNEXPECTED);
 			}
+			if (act[p]->nr[curr] == NR_NOT_SAMPLED) {
+				/* Activity not sampled in this record: No statistics follow */
+				set_sampling_state(act[p], curr, &record_hdr[curr], FALSE);
+				continue;
+			}
 			if ((act[p]->nr[curr] > act[p]->nr_max) || (act[p]->nr[curr] < 0)) {
 #ifdef DEBUG
 				fprintf(stderr, "%s: %s: nr=%d nr_max=%d\n",
@@ -699,6 +1132,8 @@ void read_sadc_stat_bunch(int curr)
                                    (size_t) act[p]->fsize * (size_t) act[p]->nr_ini * (size_t) act[p]->nr2);
                         }
                 }
+		set_sampling_state(act[p], curr, &record_hdr[curr], TRUE);
+
 		if (sa_read(act[p]->buf[curr],
 			    (size_t) act[p]->fsize * (size_t) act[p]->nr[curr] * (size_t) act[p]->nr2)) {
 #ifdef DEBUG
@@ -715,7 +1150,8 @@ void read_sadc_stat_bunch(int curr)
  *
  * IN:
  * @ifd		Input file descriptor.
- * @fpos	Position in file where reading must start.
+ * @fpos	Position in file where reading must start (and decoding state
+ *		of a delta-encoded file at that position).
  * @curr	Index in array for current sample statistics.
  * @rows	Number of rows of screen.
  * @act_id	Activity to display.
@@ -735,7 +1171,7 @@ void read_sadc_stat_bunch(int curr)
  *		(used in next_slice() function).
  ***************************************************************************
  */
-void handle_curr_act_stats(int ifd, off_t fpos, int *curr, long *cnt, int *eosaf,
+void handle_curr_act_stats(int ifd, struct sa_fpos *fpos, int *curr, long *cnt, int *eosaf,
 			   int rows, unsigned int act_id, int *reset,
 			   struct file_activity *file_actlst, char *file,
 			   struct file_magic *file_magic, void *rec_hdr_tmp,
@@ -746,7 +1182,7 @@ void handle_curr_act_stats(int ifd, off_t fpos, int *curr, long *cnt, int *eosaf
 	unsigned char rtype;
 	int davg = 0, next, inc = 0;
 
-	if (lseek(ifd, fpos, SEEK_SET) < fpos) {
+	if (sa_restore_pos(ifd, fpos) < fpos->pos) {
 		perror("lseek");
 		exit(2);
 	}
@@ -778,7 +1214,8 @@ void handle_curr_act_stats(int ifd, off_t fpos, int *curr, long *cnt, int *eosaf
 
 		if (!*eosaf && (rtype != R_RESTART) && (rtype != R_COMMENT)) {
 			/* Read the extra fields since it's not a special record */
-			read_file_stat_bunch(act, *curr, ifd, file_hdr.sa_act_nr, file_actlst,
+			read_file_stat_bunch(act, *curr, &record_hdr[*curr], ifd,
+					     file_hdr.sa_act_nr, file_actlst,
 					     endian_mismatch, arch_64, file, file_magic);
 		}
 
@@ -817,7 +1254,10 @@ void handle_curr_act_stats(int ifd, off_t fpos, int *curr, long *cnt, int *eosaf
 				davg++;
 				*curr ^= 1;
 
-				if (inc) {
+				if (act[p]->unsampled[!*curr]) {
+					/* Activity not sampled: Nothing displayed */
+				}
+				else if (inc) {
 					lines += inc;
 				}
 				else {
@@ -836,6 +1276,149 @@ void handle_curr_act_stats(int ifd, off_t fpos, int *curr, long *cnt, int *eosaf
 	*reset = TRUE;
 }
 
+/*
+ ***************************************************************************
+ * Read stats for all the outputs of the track list from file and display
+ * them. Each record is read only once, and the output of each activity is
+ * saved into its own temporary file. Temporary files are copied to stdout
+ * when a LINUX RESTART record, the end of file or the requested number of
+ * lines is reached, so that the report is identical to the one obtained
+ * when reading the file once per activity (see handle_curr_act_stats()).
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ * @curr	Index in array for current sample statistics.
+ * @rows	Number of rows of screen.
+ * @file_actlst	List of activities in file.
+ * @file	Name of file being read.
+ * @file_magic	file_magic structure filled with file magic header data.
+ * @rec_hdr_tmp	Temporary buffer where current record header will be saved.
+ * @endian_mismatch
+ *		TRUE if file's data don't match current machine's endianness.
+ * @arch_64	TRUE if file's data come from a 64 bit machine.
+ *
+ * OUT:
+ * @curr	Index in array for next sample statistics.
+ * @cnt		Number of remaining lines of stats to write.
+ * @eosaf	Set to TRUE if EOF (end of file) has been reached.
+ * @reset	Set to TRUE if last_uptime variable should be reinitialized
+ *		(used in next_slice() function).
+ ***************************************************************************
+ */
+void handle_all_act_stats(int ifd, int *curr, long *cnt, int *eosaf, int rows,
+			  int *reset, struct file_activity *file_actlst, char *file,
+			  struct file_magic *file_magic, void *rec_hdr_tmp,
+			  int endian_mismatch, int arch_64)
+{
+	int t, reset_cd;
+	unsigned char rtype;
+	int davg = 0, next;
+	off_t cpos;
+
+	/*
+	 * Restore the first stats collected.
+	 * Used to compute the rate displayed on the first line.
+	 */
+	copy_structures(act, id_seq, record_hdr, !*curr, 2);
+
+	*cnt  = count;
+
+	for (t = 0; t < trk_nr; t++) {
+		trk[t].lines = 0;
+	}
+	reset_cd = 1;
+
+	do {
+		/*
+		 * Display <count> lines of stats.
+		 * Start with reading current sample's record header.
+		 */
+		*eosaf = read_record_hdr(ifd, rec_hdr_tmp, &record_hdr[*curr],
+					 &file_hdr, arch_64, endian_mismatch);
+		rtype = record_hdr[*curr].record_type;
+
+		if (!*eosaf && (rtype != R_RESTART) && (rtype != R_COMMENT)) {
+			/* Read the extra fields since it's not a special record */
+			read_file_stat_bunch(act, *curr, &record_hdr[*curr], ifd,
+					     file_hdr.sa_act_nr, file_actlst,
+					     endian_mismatch, arch_64, file, file_magic);
+		}
+
+		for (t = 0; t < trk_nr; t++) {
+			if ((trk[t].lines >= rows) || !trk[t].lines) {
+				trk[t].lines = 0;
+				trk[t].dis = 1;
+			}
+			else
+				trk[t].dis = 0;
+		}
+
+		if (!*eosaf && (rtype != R_RESTART)) {
+
+			if (rtype == R_COMMENT) {
+				/* Display comment for each output */
+				if ((cpos = sa_lseek(ifd, 0, SEEK_CUR)) < 0) {
+					perror("lseek");
+					exit(2);
+				}
+				for (t = 0; t < trk_nr; t++) {
+					if (sa_lseek(ifd, cpos, SEEK_SET) < cpos) {
+						perror("lseek");
+						exit(2);
+					}
+					select_track(t);
+					next = print_special_record(&record_hdr[*curr], flags + S_F_LOCAL_TIME,
+								    &tm_start, &tm_end, R_COMMENT, ifd,
+								    &rectime, NULL, file, 0,
+								    file_magic, &file_hdr, act, &sar_fmt,
+								    endian_mismatch, arch_64);
+					if (next) {
+						/* A line of comment was actually displayed */
+						trk[t].lines++;
+					}
+				}
+				continue;
+			}
+
+			/* next is set to 1 when we were close enough to desired interval */
+			next = write_stats(*curr, USE_SA_FILE, cnt, tm_start.use, tm_end.use,
+					   *reset, ALL_TRACKS, reset_cd);
+			reset_cd = 0;
+			if (next && (*cnt > 0)) {
+				(*cnt)--;
+			}
+
+			if (next) {
+				davg++;
+				*curr ^= 1;
+
+				for (t = 0; t < trk_nr; t++) {
+					if (act[trk[t].p]->unsampled[!*curr])
+						/* Nothing displayed for this output */
+						continue;
+					if (trk[t].inc) {
+						trk[t].lines += trk[t].inc;
+					}
+					else {
+						trk[t].lines += act[trk[t].p]->nr[*curr];
+					}
+				}
+			}
+			*reset = FALSE;
+		}
+	}
+	while (*cnt && !*eosaf && (rtype != R_RESTART));
+
+	if (davg) {
+		write_stats_avg(!*curr, USE_SA_FILE, ALL_TRACKS);
+	}
+
+	/* Now display the outputs */
+	flush_tracks();
+
+	*reset = TRUE;
+}
+
 /*
  ***************************************************************************
  * Read header data sent by sadc.
@@ -945,6 +1528,11 @@ void read_header_data(void)
 		id_seq[i]      = file_act.id;	/* We necessarily have "i < NR_ACT" */
 		act[p]->nr_ini = file_act.nr;
 		act[p]->nr2    = file_act.nr2;
+
+		if (file_act.has_nr && !HAS_COUNT_FUNCTION(act[p]->options)) {
+			/* Activity not sampled by sadc at each interval */
+			act[p]->options |= AO_SPARSE;
+		}
 	}
 
 	while (i < NR_ACT) {
@@ -957,6 +1545,65 @@ void read_header_data(void)
 	return;
 }
 
+/*
+ ***************************************************************************
+ * Tell whether sadc has saved statistics at sub-second intervals in a
+ * file, using the interval between the two statistics records following
+ * current one. The interval between current record (the first one of the
+ * file, or following a restart) and the next one isn't used when another
+ * one is available, since the first sample is taken as soon as sadc starts,
+ * and the next one on a deadline aligned on the interval. The file position
+ * is left unchanged.
+ *
+ * IN:
+ * @ifd		Input file descriptor.
+ * @rec_hdr	Header of current statistics record.
+ * @rec_hdr_tmp	Temporary buffer where next record headers will be saved.
+ * @file_actlst	List of activities in file.
+ * @file	Name of file being read.
+ * @file_magic	file_magic structure filled with file magic header data.
+ *
+ * RETURNS:
+ * TRUE if statistics have been saved less than one second apart.
+ ***************************************************************************
+ */
+int is_sub_second_record(int ifd, struct record_header *rec_hdr, void *rec_hdr_tmp,
+			 struct file_activity *file_actlst, char *file,
+			 struct file_magic *file_magic)
+{
+	static struct sa_fpos fpos;
+	struct record_header prev_hdr, next_hdr;
+	unsigned long long itv = 0;
+	int nr = 0;
+
+	if (sa_save_pos(ifd, &fpos) < 0)
+		return FALSE;
+
+	prev_hdr = *rec_hdr;
+	while (!read_record_hdr(ifd, rec_hdr_tmp, &next_hdr, &file_hdr,
+				arch_64, endian_mismatch) &&
+	       (next_hdr.record_type == R_STATS)) {
+
+		itv = get_uptime_interval(prev_hdr.uptime_cs, prev_hdr.uptime_us,
+					  next_hdr.uptime_cs, next_hdr.uptime_us);
+		if (++nr == 2)
+			break;
+
+		/* Skip statistics of next record (read in buffers for next sample) */
+		read_file_stat_bunch(act, 1, &next_hdr, ifd, file_hdr.sa_act_nr,
+				     file_actlst, endian_mismatch, arch_64, file, file_magic);
+		prev_hdr = next_hdr;
+	}
+
+	if (sa_restore_pos(ifd, &fpos) < fpos.pos) {
+		perror("lseek");
+		exit(2);
+	}
+
+	/* Allow for a few hundredths of a second of lateness */
+	return nr && (itv < 95);
+}
+
 /*
  ***************************************************************************
  * Read statistics from a system activity data file.
@@ -967,6 +1614,7 @@ void read_header_data(void)
  */
 void read_stats_from_file(char from_file[])
 {
+	static struct sa_fpos fpos;
 	struct file_magic file_magic;
 	struct file_activity *file_actlst = NULL;
 	char rec_hdr_tmp[MAX_RECORD_HEADER_SIZE];
@@ -974,7 +1622,6 @@ void read_stats_from_file(char from_file[])
 	int ifd, rtype;
 	int rows, eosaf = TRUE, reset = FALSE;
 	long cnt = 1;
-	off_t fpos;
 
 	/* Get window size */
 	rows = get_win_height();
@@ -986,9 +1633,15 @@ void read_stats_from_file(char from_file[])
 	/* Perform required allocations */
 	allocate_structures(act);
 
+	/* Build the list of outputs to display in a single pass */
+	init_tracks();
+
 	/* Print report header */
 	print_report_hdr(flags, &rectime, &file_hdr);
 
+	/* Skip records saved before the requested start time using file's index */
+	sa_seek_index(ifd, from_file, flags + S_F_LOCAL_TIME, &tm_start, act, &file_hdr, endian_mismatch, arch_64);
+
 	/* Read system statistics from file */
 	do {
 		/*
@@ -999,6 +1652,7 @@ void read_stats_from_file(char from_file[])
 			if (read_record_hdr(ifd, rec_hdr_tmp, &record_hdr[0], &file_hdr,
 					    arch_64, endian_mismatch)) {
 				/* End of sa data file */
+				free_tracks();
 				return;
 			}
 
@@ -1014,8 +1668,9 @@ void read_stats_from_file(char from_file[])
 				 * OK: Previous record was not a special one.
 				 * So read now the extra fields.
 				 */
-				read_file_stat_bunch(act, 0, ifd, file_hdr.sa_act_nr,
-						     file_actlst, endian_mismatch, arch_64,
+				read_file_stat_bunch(act, 0, &record_hdr[0], ifd,
+						     file_hdr.sa_act_nr, file_actlst,
+						     endian_mismatch, arch_64,
 						     from_file, &file_magic);
 				if (sa_get_record_timestamp_struct(flags + S_F_LOCAL_TIME,
 								   &record_hdr[0],
@@ -1031,13 +1686,24 @@ void read_stats_from_file(char from_file[])
 		       (tm_start.use && (datecmp(&rectime, &tm_start) < 0)) ||
 		       (tm_end.use && (datecmp(&rectime, &tm_end) >=0)));
 
+		/*
+		 * Every record is displayed if no interval has been entered:
+		 * Display time with milliseconds if they have been saved at
+		 * sub-second intervals.
+		 */
+		if (!interval && !PRINT_MSEC_TIME(flags) &&
+		    is_sub_second_record(ifd, &record_hdr[0], rec_hdr_tmp, file_actlst,
+					 from_file, &file_magic)) {
+			flags |= S_F_MSEC_TIME;
+		}
+
 		/* Save the first stats collected. Will be used to compute the average */
 		copy_structures(act, id_seq, record_hdr, 2, 0);
 
 		reset = TRUE;	/* Set flag to reset last_uptime variable */
 
 		/* Save current file position */
-		if ((fpos = lseek(ifd, 0, SEEK_CUR)) < 0) {
+		if (sa_save_pos(ifd, &fpos) < 0) {
 			perror("lseek");
 			exit(2);
 		}
@@ -1049,36 +1715,45 @@ void read_stats_from_file(char from_file[])
 		 * activity before displaying the next activity.
 		 * id_seq[] has been created in check_file_actlst(), retaining only
 		 * activities known by current sysstat version.
+		 * If several outputs are to be displayed, the file is read only
+		 * once and each output is saved until all of them can be displayed.
 		 */
-		for (i = 0; i < NR_ACT; i++) {
+		if (trk_nr) {
+			handle_all_act_stats(ifd, &curr, &cnt, &eosaf, rows, &reset,
+					     file_actlst, from_file, &file_magic, rec_hdr_tmp,
+					     endian_mismatch, arch_64);
+		}
+		else {
+			for (i = 0; i < NR_ACT; i++) {
 
-			if (!id_seq[i])
-				continue;
+				if (!id_seq[i])
+					continue;
 
-			p = get_activity_position(act, id_seq[i], EXIT_IF_NOT_FOUND);
-			if (!IS_SELECTED(act[p]->options))
-				continue;
+				p = get_activity_position(act, id_seq[i], EXIT_IF_NOT_FOUND);
+				if (!IS_SELECTED(act[p]->options))
+					continue;
 
-			if (!HAS_MULTIPLE_OUTPUTS(act[p]->options)) {
-				handle_curr_act_stats(ifd, fpos, &curr, &cnt, &eosaf, rows,
-						      act[p]->id, &reset, file_actlst,
-						      from_file, &file_magic, rec_hdr_tmp,
-						      endian_mismatch, arch_64);
-			}
-			else {
-				unsigned int optf, msk;
+				if (!HAS_MULTIPLE_OUTPUTS(act[p]->options)) {
+					handle_curr_act_stats(ifd, &fpos, &curr, &cnt, &eosaf, rows,
+							      act[p]->id, &reset, file_actlst,
+							      from_file, &file_magic, rec_hdr_tmp,
+							      endian_mismatch, arch_64);
+				}
+				else {
+					unsigned int optf, msk;
 
-				optf = act[p]->opt_flags;
+					optf = act[p]->opt_flags;
 
-				for (msk = 1; msk < 0x100; msk <<= 1) {
-					if ((act[p]->opt_flags & 0xff) & msk) {
-						act[p]->opt_flags &= (0xffffff00 + msk);
+					for (msk = 1; msk < 0x100; msk <<= 1) {
+						if ((act[p]->opt_flags & 0xff) & msk) {
+							act[p]->opt_flags &= (0xffffff00 + msk);
 
-						handle_curr_act_stats(ifd, fpos, &curr, &cnt, &eosaf,
-								      rows, act[p]->id, &reset, file_actlst,
-								      from_file, &file_magic, rec_hdr_tmp,
-								      endian_mismatch, arch_64);
-						act[p]->opt_flags = optf;
+							handle_curr_act_stats(ifd, &fpos, &curr, &cnt, &eosaf,
+									      rows, act[p]->id, &reset, file_actlst,
+									      from_file, &file_magic, rec_hdr_tmp,
+									      endian_mismatch, arch_64);
+							act[p]->opt_flags = optf;
+						}
 					}
 				}
 			}
@@ -1093,8 +1768,9 @@ void read_stats_from_file(char from_file[])
 				rtype = record_hdr[curr].record_type;
 
 				if (!eosaf && (rtype != R_RESTART) && (rtype != R_COMMENT)) {
-					read_file_stat_bunch(act, curr, ifd, file_hdr.sa_act_nr,
-							     file_actlst, endian_mismatch, arch_64,
+					read_file_stat_bunch(act, curr, &record_hdr[curr], ifd,
+							     file_hdr.sa_act_nr, file_actlst,
+							     endian_mismatch, arch_64,
 							     from_file, &file_magic);
 				}
 				else if (!eosaf && (rtype == R_COMMENT)) {
@@ -1120,8 +1796,9 @@ void read_stats_from_file(char from_file[])
 	}
 	while (!eosaf);
 
-	close(ifd);
+	sa_close(ifd);
 
+	free_tracks();
 	free(file_actlst);
 }
 
@@ -1132,7 +1809,7 @@ void read_stats_from_file(char from_file[])
  */
 void read_stats(void)
 {
-	int curr = 1;
+	int curr = 1, rc;
 	unsigned long lines;
 	unsigned int rows;
 	int dis_hdr = 0;
@@ -1140,6 +1817,14 @@ void read_stats(void)
 	/* Don't buffer data if redirected to a pipe... */
 	setbuf(stdout, NULL);
 
+	if (USE_SHM(flags)) {
+		/* Get header data and first record published by sadc */
+		attach_shm();
+		if (read_shm_record() < 0) {
+			print_read_error(END_OF_DATA_UNEXPECTED);
+		}
+	}
+
 	/* Read stats header */
 	read_header_data();
 
@@ -1173,13 +1858,29 @@ void read_stats(void)
 	/* Set a handler for SIGINT */
 	memset(&int_act, 0, sizeof(int_act));
 	int_act.sa_handler = int_handler;
-	int_act.sa_flags = SA_RESTART;
+	/*
+	 * When connected to a sadc listening on a socket, SIGINT is received
+	 * by sar only: Don't wait for next record to stop.
+	 */
+	int_act.sa_flags = USE_SOCKET(flags) ? 0 : SA_RESTART;
 	sigaction(SIGINT, &int_act, NULL);
 
 	/* Main loop */
 	do {
 
 		/* Get stats */
+		if (USE_SHM(flags)) {
+			if ((rc = read_shm_record()) < 0) {
+				/* SIGINT caught or sadc stopped: Display average stats */
+				curr ^= 1;
+				break;
+			}
+			if (rc) {
+				/* Number of items may have changed: Re-read header data */
+				read_header_data();
+				allocate_structures(act);
+			}
+		}
 		read_sadc_stat_bunch(curr);
 		if (sigint_caught) {
 			/*
@@ -1279,6 +1980,26 @@ int main(int argc, char **argv)
 			opt++;
 		}
 
+		else if (!strcmp(argv[opt], "--connect")) {
+			/* Read records sent by sadc listening on a Unix socket */
+			if (!argv[++opt] || !argv[opt][0] ||
+			    (strlen(argv[opt]) >= MAX_FILE_LEN)) {
+				usage(argv[0]);
+			}
+			strcpy(sock_path, argv[opt++]);
+			flags |= S_F_SOCKET;
+		}
+
+		else if (!strcmp(argv[opt], "--shm")) {
+			/* Read records published by sadc in shared memory */
+			if (!argv[++opt] || !argv[opt][0] || strchr(argv[opt], '/') ||
+			    (strlen(argv[opt]) >= MAX_FILE_LEN - sizeof(SA_SHM_DIR) - 1)) {
+				usage(argv[0]);
+			}
+			strcpy(shm_name, argv[opt++]);
+			flags |= S_F_SHM;
+		}
+
 		else if (!strcmp(argv[opt], "-I")) {
 			/* Parse -I option */
 			if (parse_sar_I_opt(argv, &opt, act)) {
@@ -1348,11 +2069,11 @@ int main(int argc, char **argv)
 		}
 
 		else if (!strcmp(argv[opt], "-i")) {
-			if (!argv[++opt] || (strspn(argv[opt], DIGITS) != strlen(argv[opt]))) {
+			if (!argv[++opt]) {
 				usage(argv[0]);
 			}
-			interval = atol(argv[opt++]);
-			if (interval < 1) {
+			interval = parse_interval(argv[opt++]);
+			if (interval < MIN_INTERVAL) {
 				usage(argv[0]);
 			}
 			flags |= S_F_INTERVAL_SET;
@@ -1402,11 +2123,8 @@ int main(int argc, char **argv)
 
 		else if (interval < 0) {
 			/* Get interval */
-			if (strspn(argv[opt], DIGITS) != strlen(argv[opt])) {
-				usage(argv[0]);
-			}
-			interval = atol(argv[opt++]);
-			if (interval < 0) {
+			interval = parse_interval(argv[opt++]);
+			if ((interval < 0) || (interval && (interval < MIN_INTERVAL))) {
 				usage(argv[0]);
 			}
 		}
@@ -1430,7 +2148,8 @@ int main(int argc, char **argv)
 
 	/* 'sar' is equivalent to 'sar -f' */
 	if ((argc == 1) ||
-	    ((interval < 0) && !from_file[0] && !to_file[0])) {
+	    ((interval < 0) && !from_file[0] && !to_file[0] &&
+	     !USE_SHM(flags) && !USE_SOCKET(flags))) {
 		set_default_file(from_file, day_offset, -1);
 	}
 
@@ -1457,6 +2176,18 @@ int main(int argc, char **argv)
 		usage(argv[0]);
 	}
 
+	/*
+	 * Records published in shared memory or sent on a socket are neither
+	 * read from nor saved to a file.
+	 */
+	if ((USE_SHM(flags) || USE_SOCKET(flags)) &&
+	    (from_file[0] || to_file[0] || day_offset || (interval < 0))) {
+		usage(argv[0]);
+	}
+	if (USE_SHM(flags) && USE_SOCKET(flags)) {
+		usage(argv[0]);
+	}
+
 	/* Cannot enter a day shift with -o option */
 	if (to_file[0] && day_offset) {
 		usage(argv[0]);
@@ -1474,13 +2205,19 @@ int main(int argc, char **argv)
 		count = -1;
 	}
 
+	if ((interval > 0) && (interval % 1000)) {
+		/* Sub-second interval: Display time with milliseconds */
+		flags |= S_F_MSEC_TIME;
+	}
+
 	/* Default is CPU activity... */
 	select_default_activity(act);
 
 	/* Reading stats from file: */
 	if (from_file[0]) {
 		if (interval < 0) {
-			interval = 1;
+			/* Display all the records */
+			interval = 0;
 		}
 
 		/* Read stats from file */
@@ -1493,6 +2230,29 @@ int main(int argc, char **argv)
 		return 0;
 	}
 
+	if (USE_SHM(flags)) {
+		/* Read stats published by sadc in shared memory */
+		read_stats();
+
+		sa_shm_detach(&shm);
+		free(shm_buf);
+		free_bitmaps(act);
+		free_structures(act);
+
+		return 0;
+	}
+
+	if (USE_SOCKET(flags)) {
+		/* Read stats sent by sadc listening on a socket */
+		connect_sadc();
+		read_stats();
+
+		free_bitmaps(act);
+		free_structures(act);
+
+		return 0;
+	}
+
 	/* Reading stats from sadc: */
 
 	/* Create anonymous pipe */
@@ -1534,7 +2294,7 @@ int main(int argc, char **argv)
 			salloc(args_idx++, ltemp);
 		}
 		else {
-			sprintf(ltemp, "%ld", interval);
+			sprintf(ltemp, "%ld.%03ld", interval / 1000, interval % 1000);
 		}
 		salloc(args_idx++, ltemp);
 
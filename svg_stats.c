@@ -39,6 +39,7 @@
 
 extern unsigned int flags;
 extern unsigned int dm_major;
+extern unsigned int svg_points;
 
 unsigned int svg_colors[] = {0x00cc00, 0xff00bf, 0x00ffff, 0xff0000,
 			     0xe85f00, 0x0000ff, 0x006020, 0x7030a0,
@@ -196,7 +197,7 @@ void get_global_extrema(int pos, int n, double *spmin, double *spmax,
  * array is returned. This is equivalent to "char data[][n]" where each
  * element is of indeterminate size and will contain the graph data (eg.
  * << path d="M12,14 L13,16..." ... >>.
- * The size of element data[i] is given by outsize[i].
+ * The size and length of element data[i] are given by outsize[i].
  * Also allocate an array to save min values (equivalent to "double spmin[n]")
  * and an array for max values (equivalent to "double spmax[n]").
  *
@@ -204,9 +205,9 @@ void get_global_extrema(int pos, int n, double *spmin, double *spmax,
  * @n		Number of graphs to draw for current activity.
  *
  * OUT:
- * @outsize	Array that will contain the sizes of each element in array
- *		of chars. Equivalent to "int outsize[n]" with
- * 		outsize[n] = sizeof(data[][n]).
+ * @outsize	Array that will contain the sizes and lengths of each element
+ *		in array of chars. Equivalent to "struct svg_data outsize[n]"
+ *		with outsize[n].size = sizeof(data[][n]).
  * @spmin	Array that will contain min values for current activity.
  * @spmax	Array that will contain max values for current activity.
  *
@@ -217,7 +218,7 @@ void get_global_extrema(int pos, int n, double *spmin, double *spmax,
  * in the statistics structure.
  ***************************************************************************
  */
-char **allocate_graph_lines(int n, int **outsize, double **spmin, double **spmax)
+char **allocate_graph_lines(int n, struct svg_data **outsize, double **spmin, double **spmax)
 {
 	char **out;
 	char *out_p;
@@ -231,8 +232,8 @@ char **allocate_graph_lines(int n, int **outsize, double **spmin, double **spmax
 		perror("malloc");
 		exit(4);
 	}
-	/* Allocate array that will contain the size of each array of chars */
-	if ((*outsize = (int *) malloc(n * sizeof(int))) == NULL) {
+	/* Allocate array that will contain the size and length of each array of chars */
+	if ((*outsize = (struct svg_data *) malloc(n * sizeof(struct svg_data))) == NULL) {
 		perror("malloc");
 		exit(4);
 	}
@@ -253,8 +254,14 @@ char **allocate_graph_lines(int n, int **outsize, double **spmin, double **spmax
 			exit(4);
 		}
 		*(out + i) = out_p;
-		*out_p = '\0';			/* Reset string so that it can be safely strncat()'d later */
-		*(*outsize + i) = CHUNKSIZE;	/* Each array of chars has a default size of CHUNKSIZE */
+		*out_p = '\0';			/* Reset string so that data can be appended later */
+		(*outsize + i)->size = CHUNKSIZE;	/* Each array of chars has a default size of CHUNKSIZE */
+		(*outsize + i)->len = 0;
+		(*outsize + i)->bkt = NULL;
+		(*outsize + i)->bkt_nr = (*outsize + i)->bkt_size = 0;
+		(*outsize + i)->bkt_width = 1;
+		(*outsize + i)->bar = FALSE;
+		(*outsize + i)->dp = 2;
 		*(*spmin + i) = DBL_MAX;	/* Init min and max values */
 		*(*spmax + i) = -DBL_MAX;
 	}
@@ -264,49 +271,64 @@ char **allocate_graph_lines(int n, int **outsize, double **spmin, double **spmax
 
 /*
  ***************************************************************************
- * Reallocate all the arrays used to save graphs data, min and max values.
- * The new size is the double of the original one.
+ * Reallocate all the arrays used to save graphs data, min and max values,
+ * so that they can contain the graphs of @nr items. Nothing is done if
+ * they are already large enough.
  *
  * IN:
- * @n		Number of slots currently allocated.
+ * @nr		Number of items whose graphs should fit in the arrays.
+ * @g_nr	Number of graphs for each item.
+ * @svg_p	SVG specific parameters: Number of items for which the arrays
+ *		are currently allocated (.@nr_max).
  * @out		Current pointer on arrays containing the graphs data.
- * @outsize	Current pointer on array containing the size of each element
- *		in array of chars.
+ * @outsize	Current pointer on array containing the size and length of
+ *		each element in array of chars.
  * @spmin	Current pointer on array containing min values.
  * @spmax	Current pointer on array containing max values.
  *
  * OUT:
+ * @svg_p	Number of items for which the arrays are now allocated.
  * @out		New pointer on arrays containing the graphs data.
- * @outsize	New pointer on array containing the size of each element
- *		in array of chars.
+ * @outsize	New pointer on array containing the size and length of each
+ *		element in array of chars.
  * @spmin	New pointer on array containing min values.
  * @spmax	New pointer on array containing max values.
  ***************************************************************************
  */
-void reallocate_all_graph_lines(int n, char ***out, int **outsize,
-				double **spmin, double **spmax)
+void reallocate_all_graph_lines(int nr, int g_nr, struct svg_parm *svg_p, char ***out,
+				struct svg_data **outsize, double **spmin, double **spmax)
 {
 	char *out_p;
-	int i;
+	int i, n = svg_p->nr_max * g_nr;
+
+	if (nr <= svg_p->nr_max)
+		return;
 
 	/* Reallocate all the arrays */
-	SREALLOC(*out, char *, n * sizeof(char *) * 2);
-	SREALLOC(*outsize, int, n * sizeof(int) * 2);
-	SREALLOC(*spmin, double, n * sizeof(double) * 2);
-	SREALLOC(*spmax, double, n * sizeof(double) * 2);
+	SREALLOC(*out, char *, nr * g_nr * sizeof(char *));
+	SREALLOC(*outsize, struct svg_data, nr * g_nr * sizeof(struct svg_data));
+	SREALLOC(*spmin, double, nr * g_nr * sizeof(double));
+	SREALLOC(*spmax, double, nr * g_nr * sizeof(double));
 
 	/* Allocate arrays of chars that will contain graphs data for the newly allocated slots */
-	for (i = 0; i < n; i++) {
+	for (i = n; i < nr * g_nr; i++) {
 		if ((out_p = (char *) malloc(CHUNKSIZE * sizeof(char))) == NULL) {
 			perror("malloc");
 			exit(4);
 		}
-		*(*out + n + i) = out_p;
+		*(*out + i) = out_p;
 		*out_p = '\0';
-		*(*outsize + n + i) = CHUNKSIZE;
-		*(*spmin + n + i) = DBL_MAX;
-		*(*spmax + n + i) = -DBL_MAX;
+		(*outsize + i)->size = CHUNKSIZE;
+		(*outsize + i)->len = 0;
+		(*outsize + i)->bkt = NULL;
+		(*outsize + i)->bkt_nr = (*outsize + i)->bkt_size = 0;
+		(*outsize + i)->bkt_width = 1;
+		(*outsize + i)->bar = FALSE;
+		(*outsize + i)->dp = 2;
+		*(*spmin + i) = DBL_MAX;
+		*(*spmax + i) = -DBL_MAX;
 	}
+	svg_p->nr_max = nr;
 }
 
 /*
@@ -316,61 +338,354 @@ void reallocate_all_graph_lines(int n, char ***out, int **outsize,
  * IN:
  * @data	SVG code to append to current graph definition.
  * @out		Pointer on array of chars for current graph definition.
- * @outsize	Size of array of chars for current graph definition.
+ * @outsize	Size and length of array of chars for current graph definition.
  *
  * OUT:
  * @out		Pointer on array of chars for current graph definition that
  *		has been updated with the addition of current sample data.
- * @outsize	Array that containing the (possibly new) sizes of each
- *		element in array of chars.
+ * @outsize	Array that containing the (possibly new) sizes and lengths
+ *		of each element in array of chars.
  ***************************************************************************
  */
-void save_svg_data(char *data, char **out, int *outsize)
+void save_svg_data(char *data, char **out, struct svg_data *outsize)
 {
-	char *out_p;
-	int len;
+	int len = strlen(data);
 
-	out_p = *out;
-	/* Determine space left in array */
-	len = *outsize - strlen(out_p) - 1;
-	if (strlen(data) >= len) {
+	if (outsize->len + len >= outsize->size) {
 		/*
 		 * If current array of chars doesn't have enough space left
-		 * then reallocate it with CHUNKSIZE more bytes.
+		 * then reallocate it with twice its size.
+		 */
+		do {
+			outsize->size *= 2;
+		}
+		while (outsize->len + len >= outsize->size);
+
+		SREALLOC(*out, char, outsize->size);
+	}
+	memcpy(*out + outsize->len, data, len + 1);
+	outsize->len += len;
+}
+
+/*
+ ***************************************************************************
+ * Merge adjacent columns of current graph that now fall into the same
+ * column, the width of the columns having just been doubled. Columns
+ * separated by a RESTART record are never merged.
+ *
+ * IN:
+ * @outsize	Size and length of array of chars for current graph
+ *		definition, and columns where samples are saved.
+ *
+ * OUT:
+ * @outsize	Updated array of columns.
+ *
+ * RETURNS:
+ * Number of adjacent columns which are still distinct and which may be
+ * merged if the width of the columns is doubled again.
+ ***************************************************************************
+ */
+int merge_svg_buckets(struct svg_data *outsize)
+{
+	struct svg_bucket *bp, *bq;
+	int i, n = 0, mergeable = 0;
+
+	bp = outsize->bkt;
+	for (i = 1; i < outsize->bkt_nr; i++) {
+		bq = outsize->bkt + i;
+
+		if (!bq->restart &&
+		    (bq->x[0] / outsize->bkt_width == bp->x[0] / outsize->bkt_width)) {
+			/* Merge column bq into column bp */
+			if (bq->y[1] < bp->y[1]) {
+				bp->x[1] = bq->x[1];
+				bp->y[1] = bq->y[1];
+			}
+			if (bq->y[2] > bp->y[2]) {
+				bp->x[2] = bq->x[2];
+				bp->y[2] = bq->y[2];
+			}
+			bp->x[3] = bq->x[3];
+			bp->y[3] = bq->y[3];
+			bp->area += bq->area;
+			bp->oarea += bq->oarea;
+			if (bq->xs < bp->xs) {
+				bp->xs = bq->xs;
+			}
+			continue;
+		}
+		if (!bq->restart) {
+			mergeable++;
+		}
+		bp = outsize->bkt + ++n;
+		if (bp != bq) {
+			*bp = *bq;
+		}
+	}
+	outsize->bkt_nr = n + 1;
+
+	return mergeable;
+}
+
+/*
+ ***************************************************************************
+ * Get the column of current graph where a new sample should be saved. This
+ * is the last column if the sample falls into it, else a new column is
+ * added. There can be at most @svg_points columns: When they are all used,
+ * their width is doubled and adjacent columns are merged, so that memory
+ * usage and output size depend on the number of columns, not on the number
+ * of samples.
+ *
+ * IN:
+ * @timetag	Timestamp in seconds since the epoch for current sample
+ *		stats. Will be used as X coordinate.
+ * @outsize	Size and length of array of chars for current graph
+ *		definition, and columns where samples are saved.
+ * @restart	Set to TRUE if a RESTART record has been read since the last
+ * 		statistics sample.
+ *
+ * OUT:
+ * @outsize	Updated array of columns.
+ * @new		Set to TRUE if a new column has been added.
+ *
+ * RETURNS:
+ * Pointer on the column where the sample should be saved.
+ ***************************************************************************
+ */
+struct svg_bucket *get_svg_bucket(unsigned long long timetag, struct svg_data *outsize,
+				  int restart, int *new)
+{
+	struct svg_bucket *bp;
+	int mergeable = TRUE;
+
+	while (TRUE) {
+		if (outsize->bkt_nr && !restart) {
+			bp = outsize->bkt + outsize->bkt_nr - 1;
+			if (timetag / outsize->bkt_width == bp->x[0] / outsize->bkt_width) {
+				*new = FALSE;
+				return bp;
+			}
+		}
+		if ((outsize->bkt_nr < svg_points) || !mergeable)
+			break;
+
+		/* All columns are used: Make them twice as wide */
+		outsize->bkt_width *= 2;
+		mergeable = merge_svg_buckets(outsize);
+	}
+
+	if (outsize->bkt_nr >= outsize->bkt_size) {
+		/*
+		 * Array may be full only if too many RESTART records
+		 * prevent columns from being merged.
 		 */
-		SREALLOC(out_p, char, *outsize + CHUNKSIZE);
-		*out = out_p;
-		*outsize += CHUNKSIZE;
-		len += CHUNKSIZE;
+		outsize->bkt_size = outsize->bkt_size ? outsize->bkt_size * 2 : svg_points;
+		SREALLOC(outsize->bkt, struct svg_bucket,
+			 outsize->bkt_size * sizeof(struct svg_bucket));
 	}
-	strncat(out_p, data, len);
+	bp = outsize->bkt + outsize->bkt_nr++;
+	*new = TRUE;
+
+	return bp;
+}
+
+/*
+ ***************************************************************************
+ * Save a new point of a line graph in its column. Only the first, min, max
+ * and last points of each column are kept.
+ *
+ * IN:
+ * @timetag	Timestamp in seconds since the epoch for current sample
+ *		stats. Will be used as X coordinate.
+ * @value	Value of current sample metric. Will be used as Y coordinate.
+ * @outsize	Size and length of array of chars for current graph
+ *		definition, and columns where samples are saved.
+ * @restart	Set to TRUE if a RESTART record has been read since the last
+ * 		statistics sample.
+ *
+ * OUT:
+ * @outsize	Updated array of columns.
+ ***************************************************************************
+ */
+void add_svg_point(unsigned long long timetag, double value, struct svg_data *outsize,
+		   int restart)
+{
+	struct svg_bucket *bp;
+	int i, new;
+
+	bp = get_svg_bucket(timetag, outsize, restart, &new);
+
+	if (new) {
+		for (i = 0; i < 4; i++) {
+			bp->x[i] = timetag;
+			bp->y[i] = value;
+		}
+		bp->area = bp->oarea = 0.0;
+		bp->xs = timetag;
+		bp->restart = restart;
+		return;
+	}
+
+	if (value < bp->y[1]) {
+		bp->x[1] = timetag;
+		bp->y[1] = value;
+	}
+	if (value > bp->y[2]) {
+		bp->x[2] = timetag;
+		bp->y[2] = value;
+	}
+	bp->x[3] = timetag;
+	bp->y[3] = value;
+}
+
+/*
+ ***************************************************************************
+ * Save a new rectangle of a bar graph in its column. The rectangles of a
+ * column are replaced with a single rectangle covering the same area.
+ *
+ * IN:
+ * @timetag	Timestamp in seconds since the epoch for current sample
+ *		stats. Will be used as X coordinate.
+ * @offset	Offset for Y coordinate.
+ * @value	Value of current sample metric. Will be used as rectangle
+ *		height.
+ * @outsize	Size and length of array of chars for current graph
+ *		definition, and columns where samples are saved.
+ * @dt		Interval of time in seconds between current and previous
+ * 		sample.
+ *
+ * OUT:
+ * @outsize	Updated array of columns.
+ ***************************************************************************
+ */
+void add_svg_rect(unsigned long long timetag, double offset, double value,
+		  struct svg_data *outsize, unsigned long long dt)
+{
+	struct svg_bucket *bp;
+	int i, new;
+
+	bp = get_svg_bucket(timetag, outsize, FALSE, &new);
+
+	if (new) {
+		for (i = 0; i < 4; i++) {
+			bp->x[i] = timetag;
+			bp->y[i] = 0.0;
+		}
+		bp->area = bp->oarea = 0.0;
+		bp->xs = timetag - dt;
+		bp->restart = FALSE;
+	}
+	else {
+		if (timetag - dt < bp->xs) {
+			bp->xs = timetag - dt;
+		}
+		bp->x[3] = timetag;
+	}
+	bp->area += value * dt;
+	bp->oarea += offset * dt;
+}
+
+/*
+ ***************************************************************************
+ * Create the definition of current graph from the columns where its samples
+ * have been saved (option -O points=), then free these columns.
+ *
+ * IN:
+ * @out		Pointer on array of chars for current graph definition.
+ * @outsize	Size and length of array of chars for current graph
+ *		definition, and columns where samples are saved.
+ *
+ * OUT:
+ * @out		Pointer on array of chars for current graph definition.
+ * @outsize	Size and length of array of chars for current graph
+ *		definition.
+ ***************************************************************************
+ */
+void flush_svg_buckets(char **out, struct svg_data *outsize)
+{
+	struct svg_bucket *bp;
+	unsigned long long w, px = 0;
+	double py = 0.0;
+	char data[128];
+	int i, j, k, p[4], cnt = 0;
+
+	for (i = 0; i < outsize->bkt_nr; i++) {
+		bp = outsize->bkt + i;
+
+		if (outsize->bar) {
+			w = bp->x[3] - bp->xs;
+			if ((bp->area == 0.0) || !w)
+				/* Don't draw a flat rectangle! */
+				continue;
+
+			snprintf(data, 128, "<rect x=\"%llu\" y=\"%.2f\" height=\"%.2f\" width=\"%llu\"/>",
+				 bp->xs, bp->oarea / w, bp->area / w, w);
+			data[127] = '\0';
+			save_svg_data(data, out, outsize);
+			continue;
+		}
+
+		/* Append first, min, max and last points in time order */
+		p[0] = 0;
+		p[1] = bp->x[1] <= bp->x[2] ? 1 : 2;
+		p[2] = 3 - p[1];
+		p[3] = 3;
+		for (j = 0; j < 4; j++) {
+			k = p[j];
+			if (j && (bp->x[k] == px) && (bp->y[k] == py))
+				/* Same point as the previous one */
+				continue;
+
+			snprintf(data, 128, " %c%llu,%.*f",
+				 !j && (bp->restart || !cnt) ? 'M' : 'L',
+				 bp->x[k], outsize->dp, bp->y[k]);
+			data[127] = '\0';
+			save_svg_data(data, out, outsize);
+			px = bp->x[k];
+			py = bp->y[k];
+			cnt++;
+		}
+	}
+
+	if (outsize->bkt) {
+		free(outsize->bkt);
+		outsize->bkt = NULL;
+	}
+	outsize->bkt_nr = outsize->bkt_size = 0;
 }
 
 /*
  ***************************************************************************
  * Update line graph definition by appending current X,Y coordinates.
+ * With option -O points=, the point is saved in its column instead (see
+ * add_svg_point()).
  *
  * IN:
  * @timetag	Timestamp in seconds since the epoch for current sample
  *		stats. Will be used as X coordinate.
  * @value	Value of current sample metric. Will be used as Y coordinate.
  * @out		Pointer on array of chars for current graph definition.
- * @outsize	Size of array of chars for current graph definition.
+ * @outsize	Size and length of array of chars for current graph definition.
  * @restart	Set to TRUE if a RESTART record has been read since the last
  * 		statistics sample.
  *
  * OUT:
  * @out		Pointer on array of chars for current graph definition that
  *		has been updated with the addition of current sample data.
- * @outsize	Array that containing the (possibly new) sizes of each
- *		element in array of chars.
+ * @outsize	Array that containing the (possibly new) sizes and lengths
+ *		of each element in array of chars.
  ***************************************************************************
  */
-void lnappend(unsigned long long timetag, double value, char **out, int *outsize,
+void lnappend(unsigned long long timetag, double value, char **out, struct svg_data *outsize,
 	      int restart)
 {
 	char data[128];
 
+	if (svg_points) {
+		add_svg_point(timetag, value, outsize, restart);
+		return;
+	}
+
 	/* Prepare additional graph definition data */
 	snprintf(data, 128, " %c%llu,%.2f", restart ? 'M' : 'L', timetag, value);
 	data[127] = '\0';
@@ -388,22 +703,28 @@ void lnappend(unsigned long long timetag, double value, char **out, int *outsize
  *		stats. Will be used as X coordinate.
  * @value	Value of current sample metric. Will be used as Y coordinate.
  * @out		Pointer on array of chars for current graph definition.
- * @outsize	Size of array of chars for current graph definition.
+ * @outsize	Size and length of array of chars for current graph definition.
  * @restart	Set to TRUE if a RESTART record has been read since the last
  * 		statistics sample.
  *
  * OUT:
  * @out		Pointer on array of chars for current graph definition that
  *		has been updated with the addition of current sample data.
- * @outsize	Array that containing the (possibly new) sizes of each
- *		element in array of chars.
+ * @outsize	Array that containing the (possibly new) sizes and lengths
+ *		of each element in array of chars.
  ***************************************************************************
  */
 void lniappend(unsigned long long timetag, unsigned long long value, char **out,
-	       int *outsize, int restart)
+	       struct svg_data *outsize, int restart)
 {
 	char data[128];
 
+	if (svg_points) {
+		outsize->dp = 0;
+		add_svg_point(timetag, (double) value, outsize, restart);
+		return;
+	}
+
 	/* Prepare additional graph definition data */
 	snprintf(data, 128, " %c%llu,%llu", restart ? 'M' : 'L', timetag, value);
 	data[127] = '\0';
@@ -414,6 +735,8 @@ void lniappend(unsigned long long timetag, unsigned long long value, char **out,
 /*
  ***************************************************************************
  * Update bar graph definition by adding a new rectangle.
+ * With option -O points=, the rectangle is saved in its column instead (see
+ * add_svg_rect()).
  *
  * IN:
  * @timetag	Timestamp in seconds since the epoch for current sample
@@ -422,19 +745,19 @@ void lniappend(unsigned long long timetag, unsigned long long value, char **out,
  *		height.
  * @offset	Offset for Y coordinate.
  * @out		Pointer on array of chars for current graph definition.
- * @outsize	Size of array of chars for current graph definition.
+ * @outsize	Size and length of array of chars for current graph definition.
  * @dt		Interval of time in seconds between current and previous
  * 		sample.
  *
  * OUT:
  * @out		Pointer on array of chars for current graph definition that
  *		has been updated with the addition of current sample data.
- * @outsize	Array that containing the (possibly new) sizes of each
- *		element in array of chars.
+ * @outsize	Array that containing the (possibly new) sizes and lengths
+ *		of each element in array of chars.
  ***************************************************************************
  */
 void brappend(unsigned long long timetag, double offset, double value, char **out,
-	      int *outsize, unsigned long long dt)
+	      struct svg_data *outsize, unsigned long long dt)
 {
 	char data[128];
 
@@ -443,6 +766,13 @@ void brappend(unsigned long long timetag, double offset, double value, char **ou
 		/* Don't draw a flat rectangle! */
 		return;
 
+	if (svg_points) {
+		outsize->bar = TRUE;
+		add_svg_rect(timetag, MINIMUM(offset, 100.0), MINIMUM(value, (100.0 - offset)),
+			     outsize, dt);
+		return;
+	}
+
 	snprintf(data, 128, "<rect x=\"%llu\" y=\"%.2f\" height=\"%.2f\" width=\"%llu\"/>",
 		 timetag - dt, MINIMUM(offset, 100.0), MINIMUM(value, (100.0 - offset)), dt);
 	data[127] = '\0';
@@ -462,7 +792,7 @@ void brappend(unsigned long long timetag, double offset, double value, char **ou
  * @value	Value of current CPU metric. Will be used as rectangle
  *		height.
  * @out		Pointer on array of chars for current graph definition.
- * @outsize	Size of array of chars for current graph definition.
+ * @outsize	Size and length of array of chars for current graph definition.
  * @dt		Interval of time in seconds between current and previous
  * 		sample.
  * @spmin	Min value already found for this CPU metric.
@@ -472,12 +802,12 @@ void brappend(unsigned long long timetag, double offset, double value, char **ou
  * @offset	New offset value, to use to draw next rectangle
  * @out		Pointer on array of chars for current graph definition that
  *		has been updated with the addition of current sample data.
- * @outsize	Array that containing the (possibly new) sizes of each
- *		element in array of chars.
+ * @outsize	Array that containing the (possibly new) sizes and lengths
+ *		of each element in array of chars.
  ***************************************************************************
  */
 void cpuappend(unsigned long long timetag, double *offset, double value, char **out,
-	       int *outsize, unsigned long long dt, double *spmin, double *spmax)
+	       struct svg_data *outsize, unsigned long long dt, double *spmin, double *spmax)
 {
 	/* Save min and max values */
 	if (value < *spmin) {
@@ -502,7 +832,7 @@ void cpuappend(unsigned long long timetag, double *offset, double value, char **
  * @p_value	Metric value for previous sample
  * @value	Metric value for current sample.
  * @out		Pointer on array of chars for current graph definition.
- * @outsize	Size of array of chars for current graph definition.
+ * @outsize	Size and length of array of chars for current graph definition.
  * @restart	Set to TRUE if a RESTART record has been read since the last
  * 		statistics sample.
  * @dt		Interval of time in seconds between current and previous
@@ -513,14 +843,14 @@ void cpuappend(unsigned long long timetag, double *offset, double value, char **
  * OUT:
  * @out		Pointer on array of chars for current graph definition that
  *		has been updated with the addition of current sample data.
- * @outsize	Array that containing the (possibly new) sizes of each
- *		element in array of chars.
+ * @outsize	Array that containing the (possibly new) sizes and lengths
+ *		of each element in array of chars.
  * @spmin	Min value for this metric.
  * @spmax	Max value for this metric.
  ***************************************************************************
  */
 void recappend(unsigned long long timetag, double p_value, double value, char **out,
-	       int *outsize, int restart, unsigned long long dt,
+	       struct svg_data *outsize, int restart, unsigned long long dt,
 	       double *spmin, double *spmax)
 {
 	char data[128], data1[128], data2[128];
@@ -532,6 +862,17 @@ void recappend(unsigned long long timetag, double p_value, double value, char **
 	if (value > *spmax) {
 		*spmax = value;
 	}
+	if (svg_points) {
+		if (restart) {
+			add_svg_point(timetag - dt, p_value, outsize, TRUE);
+		}
+		add_svg_point(timetag, p_value, outsize, FALSE);
+		if (p_value != value) {
+			add_svg_point(timetag, value, outsize, FALSE);
+		}
+		return;
+	}
+
 	/* Prepare additional graph definition data */
 	if (restart) {
 		snprintf(data1, 128, " M%llu,%.2f", timetag - dt, p_value);
@@ -779,12 +1120,12 @@ long int xgrid(unsigned long timestart, unsigned long timeend, int v_gridnr)
  *
  * IN:
  * @out		Pointer on array of chars for each graph definition.
- * @outsize	Size of array of chars for each graph definition.
+ * @outsize	Size and length of array of chars for each graph definition.
  * @spmin	Array containing min values for graphs.
  * @spmax	Array containing max values for graphs.
  ***************************************************************************
  */
-void free_graphs(char **out, int *outsize, double *spmin, double *spmax)
+void free_graphs(char **out, struct svg_data *outsize, double *spmin, double *spmax)
 {
 	if (out) {
 		free(out);
@@ -808,6 +1149,7 @@ void free_graphs(char **out, int *outsize, double *spmin, double *spmax)
  *
  * IN:
  * @out		Pointer on array of chars for each graph definition.
+ * @outsize	Size and length of array of chars for each graph definition.
  * @pos		Position of current view in the array of graphs definitions.
  * @group	Number of graphs in current view.
  *
@@ -815,7 +1157,7 @@ void free_graphs(char **out, int *outsize, double *spmin, double *spmax)
  * @pos		Position of next view in the array of graphs definitions.
  ***************************************************************************
  */
-void skip_current_view(char **out, int *pos, int group)
+void skip_current_view(char **out, struct svg_data *outsize, int *pos, int group)
 {
 	int j;
 	char *out_p;
@@ -826,6 +1168,9 @@ void skip_current_view(char **out, int *pos, int group)
 			/* Even if not displayed, current graph data have to be freed */
 			free(out_p);
 		}
+		if ((outsize + *pos + j)->bkt) {
+			free((outsize + *pos + j)->bkt);
+		}
 	}
 	*pos += group;
 }
@@ -844,7 +1189,7 @@ void skip_current_view(char **out, int *pos, int group)
  * @spmin	Array containing min values for graphs.
  * @spmax	Array containing max values for graphs.
  * @out		Pointer on array of chars for each graph definition.
- * @outsize	Size of array of chars for each graph definition.
+ * @outsize	Size and length of array of chars for each graph definition.
  * @svg_p	SVG specific parameters: Current views row number (.@graph_no),
  *		time for the first sample of stats (.@ust_time_first), and
  *		times used as start and end values on the X axis
@@ -856,7 +1201,7 @@ void skip_current_view(char **out, int *pos, int group)
  ***************************************************************************
  */
 void draw_activity_graphs(int g_nr, int g_type[], char *title[], char *g_title[], char *item_name,
-			  int group[], double *spmin, double *spmax, char **out, int *outsize,
+			  int group[], double *spmin, double *spmax, char **out, struct svg_data *outsize,
 			  struct svg_parm *svg_p, struct record_header *record_hdr, int skip_void)
 {
 	char *out_p;
@@ -880,7 +1225,7 @@ void draw_activity_graphs(int g_nr, int g_type[], char *title[], char *g_title[]
 
 		/* Don't display empty views if requested */
 		if (SKIP_EMPTY_VIEWS(flags) && (gmax < 0.005)) {
-			skip_current_view(out, &pos, group[i]);
+			skip_current_view(out, outsize, &pos, group[i]);
 			continue;
 		}
 		/* Skip void graphs */
@@ -924,7 +1269,7 @@ void draw_activity_graphs(int g_nr, int g_type[], char *title[], char *g_title[]
 			/* No data found */
 			printf("<text x=\"%d\" y=\"%d\" style=\"fill: red; stroke: none\">No data</text>\n",
 			       xv, yv + SVG_M_YSIZE);
-			skip_current_view(out, &pos, group[i]);
+			skip_current_view(out, outsize, &pos, group[i]);
 			continue;
 		}
 
@@ -1018,6 +1363,10 @@ void draw_activity_graphs(int g_nr, int g_type[], char *title[], char *g_title[]
 
 		/* Draw current graphs set */
 		for (j = 0; j < group[i]; j++) {
+			if (svg_points) {
+				/* Create graph definition from saved columns */
+				flush_svg_buckets(out + pos + j, outsize + pos + j);
+			}
 			out_p = *(out + pos + j);
 			if (g_type[i] == SVG_LINE_GRAPH) {
 				/* Line graphs */
@@ -1079,7 +1428,7 @@ __print_funct_t svg_print_cpu_stats(struct activity *a, int curr, int action, st
 	char *g_title2[] = {"%usr", "%nice", "%sys", "%iowait", "%steal", "%irq", "%soft", "%guest", "%gnice", "%idle"};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 	char item_name[8];
 	double offset, val;
 	int i, j, k, pos;
@@ -1099,6 +1448,9 @@ __print_funct_t svg_print_cpu_stats(struct activity *a, int curr, int action, st
 			a->nr_ini = a->nr[curr];
 		}
 
+		/* Make sure there are graphs for all the CPU */
+		reallocate_all_graph_lines(a->nr_ini, 10, svg_p, &out, &outsize, &spmin, &spmax);
+
 		/*
 		 * Compute CPU "all" as sum of all individual CPU (on SMP machines)
 		 * and look for offline CPU.
@@ -1351,7 +1703,7 @@ __print_funct_t svg_print_pcsw_stats(struct activity *a, int curr, int action, s
 			   "cswch/s"};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -1413,7 +1765,7 @@ __print_funct_t svg_print_swap_stats(struct activity *a, int curr, int action, s
 	int g_fields[] = {0, 1};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -1477,7 +1829,7 @@ __print_funct_t svg_print_paging_stats(struct activity *a, int curr, int action,
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -1564,7 +1916,7 @@ __print_funct_t svg_print_io_stats(struct activity *a, int curr, int action, str
 	int g_fields[] = {0, 1, 2, 3, 4};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -1661,7 +2013,7 @@ __print_funct_t svg_print_memory_stats(struct activity *a, int curr, int action,
 	int g_fields[] = {0, 4, 5, 21, 16, 22, 18, 6, 8, 9, 10, 11, 12, 13, 14, 15, 1};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 	double tval;
 	int i;
 
@@ -1877,7 +2229,7 @@ __print_funct_t svg_print_ktables_stats(struct activity *a, int curr, int action
 	int g_fields[] = {1, 2, 0, 3};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -1948,7 +2300,7 @@ __print_funct_t svg_print_queue_stats(struct activity *a, int curr, int action,
 	int g_fields[] = {0, 1, 2, 3, 4, 5};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -2038,7 +2390,7 @@ __print_funct_t svg_print_disk_stats(struct activity *a, int curr, int action, s
 	unsigned int local_types_nr[] = {1, 0, 0};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 	char *item_name, *persist_dev_name;
 	double rkB, wkB, aqusz;
 	int i, j, k, pos, restart, *unregistered;
@@ -2050,7 +2402,7 @@ __print_funct_t svg_print_disk_stats(struct activity *a, int curr, int action, s
 		 * Also allocate one additional array (#8) for each disk device:
 		 * spmax + 8 will contain the device major number,
 		 * spmin + 8 will contain the device minor number,
-		 * outsize + 8 will contain a positive value (TRUE) if the device
+		 * (outsize + 8)->size will contain a positive value (TRUE) if the device
 		 * has either still not been registered, or has been unregistered.
 		 */
 		out = allocate_graph_lines(9 * svg_p->nr_max, &outsize, &spmin, &spmax);
@@ -2064,7 +2416,7 @@ __print_funct_t svg_print_disk_stats(struct activity *a, int curr, int action, s
 		 * possibly unregistered for all graphs.
 		 */
 		for (k = 0; k < svg_p->nr_max; k++) {
-			unregistered = outsize + k * 9 + 8;
+			unregistered = &(outsize + k * 9 + 8)->size;
 			if (*unregistered == FALSE) {
 				*unregistered = MAYBE;
 			}
@@ -2089,13 +2441,12 @@ __print_funct_t svg_print_disk_stats(struct activity *a, int curr, int action, s
 				}
 				if (k == svg_p->nr_max) {
 					/* No free graph entry: Extend all buffers */
-					reallocate_all_graph_lines(svg_p->nr_max,
+					reallocate_all_graph_lines(MAXIMUM(svg_p->nr_max * 2, 1), 9, svg_p,
 								   &out, &outsize, &spmin, &spmax);
-					svg_p->nr_max *= 2;
 				}
 			}
 			pos = k * 9;
-			unregistered = outsize + pos + 8;
+			unregistered = &(outsize + pos + 8)->size;
 
 			j = check_disk_reg(a, curr, !curr, i);
 			if (j < 0) {
@@ -2210,7 +2561,7 @@ __print_funct_t svg_print_disk_stats(struct activity *a, int curr, int action, s
 
 		/* Mark devices not seen here as now unregistered */
 		for (k = 0; k < svg_p->nr_max; k++) {
-			unregistered = outsize + k * 9 + 8;
+			unregistered = &(outsize + k * 9 + 8)->size;
 			if (*unregistered != FALSE) {
 				*unregistered = TRUE;
 			}
@@ -2221,7 +2572,7 @@ __print_funct_t svg_print_disk_stats(struct activity *a, int curr, int action, s
 		for (i = 0; i < svg_p->nr_max; i++) {
 			/* Check if there is something to display */
 			pos = i * 9;
-			if (!**(out + pos))
+			if (!**(out + pos) && !(outsize + pos)->bkt_nr)
 				continue;
 
 			item_name = NULL;
@@ -2290,7 +2641,7 @@ __print_funct_t svg_print_net_dev_stats(struct activity *a, int curr, int action
 	unsigned int local_types_nr[] = {7, 0, 0};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 	char *item_name;
 	double rxkb, txkb, ifutil;
 	int i, j, k, pos, restart, *unregistered;
@@ -2301,7 +2652,7 @@ __print_funct_t svg_print_net_dev_stats(struct activity *a, int curr, int action
 		 * and the min/max values.
 		 * Also allocate one additional array (#8) for each interface:
 		 * out + 8 will contain the interface name,
-		 * outsize + 8 will contain a positive value (TRUE) if the interface
+		 * (outsize + 8)->size will contain a positive value (TRUE) if the interface
 		 * has either still not been registered, or has been unregistered.
 		 */
 		out = allocate_graph_lines(9 * svg_p->nr_max, &outsize, &spmin, &spmax);
@@ -2315,7 +2666,7 @@ __print_funct_t svg_print_net_dev_stats(struct activity *a, int curr, int action
 		 * possibly unregistered for all graphs.
 		 */
 		for (k = 0; k < svg_p->nr_max; k++) {
-			unregistered = outsize + k * 9 + 8;
+			unregistered = &(outsize + k * 9 + 8)->size;
 			if (*unregistered == FALSE) {
 				*unregistered = MAYBE;
 			}
@@ -2341,14 +2692,14 @@ __print_funct_t svg_print_net_dev_stats(struct activity *a, int curr, int action
 				}
 				if (k == svg_p->nr_max) {
 					/* No free graph entry: Extend all buffers */
-					reallocate_all_graph_lines(svg_p->nr_max,
+					reallocate_all_graph_lines(MAXIMUM(svg_p->nr_max * 2, 1), 9, svg_p,
 								   &out, &outsize, &spmin, &spmax);
-					svg_p->nr_max *= 2;
+					item_name = *(out + k * 9 + 8);
 				}
 			}
 
 			pos = k * 9;
-			unregistered = outsize + pos + 8;
+			unregistered = &(outsize + pos + 8)->size;
 
 			j = check_net_dev_reg(a, curr, !curr, i);
 			if (j < 0) {
@@ -2425,7 +2776,7 @@ __print_funct_t svg_print_net_dev_stats(struct activity *a, int curr, int action
 
 		/* Mark interfaces not seen here as now unregistered */
 		for (k = 0; k < svg_p->nr_max; k++) {
-			unregistered = outsize + k * 9 + 8;
+			unregistered = &(outsize + k * 9 + 8)->size;
 			if (*unregistered != FALSE) {
 				*unregistered = TRUE;
 			}
@@ -2440,7 +2791,7 @@ __print_funct_t svg_print_net_dev_stats(struct activity *a, int curr, int action
 			 * interface has been registered later.
 			 */
 			pos = i * 9;
-			if (!**(out + pos))
+			if (!**(out + pos) && !(outsize + pos)->bkt_nr)
 				continue;
 
 			/* Recalculate min and max values in kB, not in B */
@@ -2493,7 +2844,7 @@ __print_funct_t svg_print_net_edev_stats(struct activity *a, int curr, int actio
 	int g_fields[] = {6, 0, 1, 2, 3, 4, 5, 8, 7};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 	char *item_name;
 	int i, j, k, pos, restart, *unregistered;
 
@@ -2503,7 +2854,7 @@ __print_funct_t svg_print_net_edev_stats(struct activity *a, int curr, int actio
 		 * and the min/max values.
 		 * Also allocate one additional array (#9) for each interface:
 		 * out + 9 will contain the interface name,
-		 * outsize + 9 will contain a positive value (TRUE) if the interface
+		 * (outsize + 9)->size will contain a positive value (TRUE) if the interface
 		 * has either still not been registered, or has been unregistered.
 		 */
 		out = allocate_graph_lines(10 * svg_p->nr_max, &outsize, &spmin, &spmax);
@@ -2517,7 +2868,7 @@ __print_funct_t svg_print_net_edev_stats(struct activity *a, int curr, int actio
 		 * possibly unregistered for all graphs.
 		 */
 		for (k = 0; k < svg_p->nr_max; k++) {
-			unregistered = outsize + k * 10 + 9;
+			unregistered = &(outsize + k * 10 + 9)->size;
 			if (*unregistered == FALSE) {
 				*unregistered = MAYBE;
 			}
@@ -2546,14 +2897,14 @@ __print_funct_t svg_print_net_edev_stats(struct activity *a, int curr, int actio
 				}
 				if (k == svg_p->nr_max) {
 					/* No free graph entry: Extend all buffers */
-					reallocate_all_graph_lines(svg_p->nr_max,
+					reallocate_all_graph_lines(MAXIMUM(svg_p->nr_max * 2, 1), 10, svg_p,
 								   &out, &outsize, &spmin, &spmax);
-					svg_p->nr_max *= 2;
+					item_name = *(out + k * 10 + 9);
 				}
 			}
 
 			pos = k * 10;
-			unregistered = outsize + pos + 9;
+			unregistered = &(outsize + pos + 9)->size;
 
 			j = check_net_edev_reg(a, curr, !curr, i);
 			if (j < 0) {
@@ -2624,7 +2975,7 @@ __print_funct_t svg_print_net_edev_stats(struct activity *a, int curr, int actio
 
 		/* Mark interfaces not seen here as now unregistered */
 		for (k = 0; k < svg_p->nr_max; k++) {
-			unregistered = outsize + k * 10 + 9;
+			unregistered = &(outsize + k * 10 + 9)->size;
 			if (*unregistered != FALSE) {
 				*unregistered = TRUE;
 			}
@@ -2639,7 +2990,7 @@ __print_funct_t svg_print_net_edev_stats(struct activity *a, int curr, int actio
 			 * interface has been registered later.
 			 */
 			pos = i * 10;
-			if (!**(out + pos))
+			if (!**(out + pos) && !(outsize + pos)->bkt_nr)
 				continue;
 
 			item_name = *(out + pos + 9);
@@ -2686,7 +3037,7 @@ __print_funct_t svg_print_net_nfs_stats(struct activity *a, int curr, int action
 	int g_fields[] = {0, 1, 2, 3, 4, 5};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -2772,7 +3123,7 @@ __print_funct_t svg_print_net_nfsd_stats(struct activity *a, int curr, int actio
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -2871,7 +3222,7 @@ __print_funct_t svg_print_net_sock_stats(struct activity *a, int curr, int actio
 	int g_fields[] = {0, 1, 5, 2, 3, 4};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -2951,7 +3302,7 @@ __print_funct_t svg_print_net_ip_stats(struct activity *a, int curr, int action,
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -3041,7 +3392,7 @@ __print_funct_t svg_print_net_eip_stats(struct activity *a, int curr, int action
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -3133,7 +3484,7 @@ __print_funct_t svg_print_net_icmp_stats(struct activity *a, int curr, int actio
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -3252,7 +3603,7 @@ __print_funct_t svg_print_net_eicmp_stats(struct activity *a, int curr, int acti
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -3356,7 +3707,7 @@ __print_funct_t svg_print_net_tcp_stats(struct activity *a, int curr, int action
 	int g_fields[] = {0, 1, 2, 3};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -3428,7 +3779,7 @@ __print_funct_t svg_print_net_etcp_stats(struct activity *a, int curr, int actio
 	int g_fields[] = {0, 1, 2, 3, 4};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -3504,7 +3855,7 @@ __print_funct_t svg_print_net_udp_stats(struct activity *a, int curr, int action
 	int g_fields[] = {0, 1, 2, 3};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -3574,7 +3925,7 @@ __print_funct_t svg_print_net_sock6_stats(struct activity *a, int curr, int acti
 	int g_fields[] = {0, 1, 2, 3};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -3649,7 +4000,7 @@ __print_funct_t svg_print_net_ip6_stats(struct activity *a, int curr, int action
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -3750,7 +4101,7 @@ __print_funct_t svg_print_net_eip6_stats(struct activity *a, int curr, int actio
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -3856,7 +4207,7 @@ __print_funct_t svg_print_net_icmp6_stats(struct activity *a, int curr, int acti
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -3987,7 +4338,7 @@ __print_funct_t svg_print_net_eicmp6_stats(struct activity *a, int curr, int act
 	int g_fields[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -4087,7 +4438,7 @@ __print_funct_t svg_print_net_udp6_stats(struct activity *a, int curr, int actio
 	int g_fields[] = {0, 1, 2, 3};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 
 	if (action & F_BEGIN) {
 		/*
@@ -4155,7 +4506,7 @@ __print_funct_t svg_print_pwr_cpufreq_stats(struct activity *a, int curr, int ac
 	char *g_title[] = {"MHz"};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 	char item_name[8];
 	int i;
 
@@ -4168,6 +4519,9 @@ __print_funct_t svg_print_pwr_cpufreq_stats(struct activity *a, int curr, int ac
 	}
 
 	if (action & F_MAIN) {
+		/* Make sure there are graphs for all the CPU */
+		reallocate_all_graph_lines(a->nr[curr], 1, svg_p, &out, &outsize, &spmin, &spmax);
+
 		/* For each CPU */
 		for (i = 0; (i < a->nr[curr]) && (i < a->bitmap->b_size + 1); i++) {
 
@@ -4254,7 +4608,7 @@ __print_funct_t svg_print_pwr_fan_stats(struct activity *a, int curr, int action
 	char *g_title[] = {"~rpm"};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 	char item_name[MAX_SENSORS_DEV_LEN + 8];
 	int i;
 
@@ -4267,6 +4621,9 @@ __print_funct_t svg_print_pwr_fan_stats(struct activity *a, int curr, int action
 	}
 
 	if (action & F_MAIN) {
+		/* Make sure there are graphs for all the fans */
+		reallocate_all_graph_lines(a->nr[curr], 1, svg_p, &out, &outsize, &spmin, &spmax);
+
 		/* For each fan */
 		for (i = 0; i < a->nr[curr]; i++) {
 
@@ -4329,7 +4686,7 @@ __print_funct_t svg_print_pwr_temp_stats(struct activity *a, int curr, int actio
 			   "%temp"};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 	char item_name[MAX_SENSORS_DEV_LEN + 8];
 	int i;
 	double tval;
@@ -4343,6 +4700,9 @@ __print_funct_t svg_print_pwr_temp_stats(struct activity *a, int curr, int actio
 	}
 
 	if (action & F_MAIN) {
+		/* Make sure there are graphs for all the devices */
+		reallocate_all_graph_lines(a->nr[curr], 2, svg_p, &out, &outsize, &spmin, &spmax);
+
 		/* For each temperature sensor */
 		for (i = 0; i < a->nr[curr]; i++) {
 
@@ -4423,7 +4783,7 @@ __print_funct_t svg_print_pwr_in_stats(struct activity *a, int curr, int action,
 			   "%in"};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 	char item_name[MAX_SENSORS_DEV_LEN + 8];
 	int i;
 	double tval;
@@ -4437,6 +4797,9 @@ __print_funct_t svg_print_pwr_in_stats(struct activity *a, int curr, int action,
 	}
 
 	if (action & F_MAIN) {
+		/* Make sure there are graphs for all the devices */
+		reallocate_all_graph_lines(a->nr[curr], 2, svg_p, &out, &outsize, &spmin, &spmax);
+
 		/* For each voltage input sensor */
 		for (i = 0; i < a->nr[curr]; i++) {
 
@@ -4520,7 +4883,7 @@ __print_funct_t svg_print_huge_stats(struct activity *a, int curr, int action, s
 	unsigned int local_types_nr[] = {0, 1, 0};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 	double tval;
 
 	if (action & F_BEGIN) {
@@ -4605,10 +4968,11 @@ __print_funct_t svg_print_filesystem_stats(struct activity *a, int curr, int act
 			   "%Iused"};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
-	char *item_name = NULL;
+	static struct svg_data *outsize;
+	char *item_name = NULL, *out_cp[7];
 	double tval;
-	int i, k, pos, restart;
+	int i, k, pos, restart, again;
+	unsigned int msk;
 
 	if (action & F_BEGIN) {
 		/*
@@ -4643,9 +5007,9 @@ __print_funct_t svg_print_filesystem_stats(struct activity *a, int curr, int act
 				}
 				if (k == svg_p->nr_max) {
 					/* No free graph entry: Extend all buffers */
-					reallocate_all_graph_lines(svg_p->nr_max,
+					reallocate_all_graph_lines(MAXIMUM(svg_p->nr_max * 2, 1), 9, svg_p,
 								   &out, &outsize, &spmin, &spmax);
-					svg_p->nr_max *= 2;
+					item_name = *(out + k * 9 + 7);
 				}
 			}
 
@@ -4774,7 +5138,7 @@ __print_funct_t svg_print_filesystem_stats(struct activity *a, int curr, int act
 
 			/* Check if there is something to display */
 			pos = i * 9;
-			if (!**(out + pos))
+			if (!**(out + pos) && !(outsize + pos)->bkt_nr)
 				continue;
 
 			/* Conversion B -> MB and inodes/1000 */
@@ -4784,17 +5148,51 @@ __print_funct_t svg_print_filesystem_stats(struct activity *a, int curr, int act
 				*(spmin + pos + 4 + k) /= 1000;
 				*(spmax + pos + 4 + k) /= 1000;
 			}
+		}
 
-			if (DISPLAY_MOUNT(a->opt_flags)) {
-				item_name = *(out + pos + 8);
-			}
-			else {
-				item_name = *(out + pos + 7);
-			}
+		/*
+		 * Graphs are displayed once with filesystem names and/or
+		 * once with mount points, depending on options entered.
+		 */
+		for (msk = AO_F_FILESYSTEM; msk <= AO_F_MOUNT; msk <<= 1) {
 
-			draw_activity_graphs(a->g_nr, g_type, title, g_title, item_name, group,
-					     spmin + pos, spmax + pos, out + pos, outsize + pos,
-					     svg_p, record_hdr, FALSE);
+			if (!(a->opt_flags & msk))
+				continue;
+
+			/* Are graphs to be displayed again with mount points? */
+			again = (msk == AO_F_FILESYSTEM) && DISPLAY_MOUNT(a->opt_flags);
+
+			for (i = 0; i < svg_p->nr_max; i++) {
+
+				/* Check if there is something to display */
+				pos = i * 9;
+				if (!**(out + pos) && !(outsize + pos)->bkt_nr)
+					continue;
+
+				item_name = *(out + pos + (msk == AO_F_MOUNT ? 8 : 7));
+
+				if (!again) {
+					draw_activity_graphs(a->g_nr, g_type, title, g_title, item_name, group,
+							     spmin + pos, spmax + pos, out + pos, outsize + pos,
+							     svg_p, record_hdr, FALSE);
+					continue;
+				}
+
+				/* Graphs data are freed once drawn: Draw a copy of them */
+				for (k = 0; k < 7; k++) {
+					if (svg_points) {
+						flush_svg_buckets(out + pos + k, outsize + pos + k);
+					}
+					if ((out_cp[k] = (char *) malloc(strlen(*(out + pos + k)) + 1)) == NULL) {
+						perror("malloc");
+						exit(4);
+					}
+					strcpy(out_cp[k], *(out + pos + k));
+				}
+				draw_activity_graphs(a->g_nr, g_type, title, g_title, item_name, group,
+						     spmin + pos, spmax + pos, out_cp, outsize + pos,
+						     svg_p, record_hdr, FALSE);
+			}
 		}
 
 		/* Free remaining structures */
@@ -4830,7 +5228,7 @@ __print_funct_t svg_print_fchost_stats(struct activity *a, int curr, int action,
 	int g_fields[] = {0, 1, 2, 3};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 	char *item_name;
 	int i, j, j0, k, found, pos, restart, *unregistered;
 
@@ -4853,7 +5251,7 @@ __print_funct_t svg_print_fchost_stats(struct activity *a, int curr, int action,
 		 * possibly unregistered for all graphs.
 		 */
 		for (k = 0; k < svg_p->nr_max; k++) {
-			unregistered = outsize + k * 5 + 4;
+			unregistered = &(outsize + k * 5 + 4)->size;
 			if (*unregistered == FALSE) {
 				*unregistered = MAYBE;
 			}
@@ -4883,14 +5281,14 @@ __print_funct_t svg_print_fchost_stats(struct activity *a, int curr, int action,
 					}
 					if (k == svg_p->nr_max) {
 						/* No free graph entry: Extend all buffers */
-						reallocate_all_graph_lines(svg_p->nr_max,
+						reallocate_all_graph_lines(MAXIMUM(svg_p->nr_max * 2, 1), 5, svg_p,
 									   &out, &outsize, &spmin, &spmax);
-						svg_p->nr_max *= 2;
+						item_name = *(out + k * 5 + 4);
 					}
 				}
 
 				pos = k * 5;
-				unregistered = outsize + pos + 4;
+				unregistered = &(outsize + pos + 4)->size;
 
 				/* Look for corresponding structure in previous iteration */
 				j = i;
@@ -4958,7 +5356,7 @@ __print_funct_t svg_print_fchost_stats(struct activity *a, int curr, int action,
 
 		/* Mark interfaces not seen here as now unregistered */
 		for (k = 0; k < svg_p->nr_max; k++) {
-			unregistered = outsize + k * 5 + 4;
+			unregistered = &(outsize + k * 5 + 4)->size;
 			if (*unregistered != FALSE) {
 				*unregistered = TRUE;
 			}
@@ -4970,7 +5368,7 @@ __print_funct_t svg_print_fchost_stats(struct activity *a, int curr, int action,
 
 			/* Check if there is something to display */
 			pos = i * 5;
-			if (!**(out + pos))
+			if (!**(out + pos) && !(outsize + pos)->bkt_nr)
 				continue;
 
 			item_name = *(out + pos + 4);
@@ -5014,7 +5412,7 @@ __print_funct_t svg_print_softnet_stats(struct activity *a, int curr, int action
 	int g_fields[] = {0, 1, 2, 3, 4};
 	static double *spmin, *spmax;
 	static char **out;
-	static int *outsize;
+	static struct svg_data *outsize;
 	char item_name[8];
 	unsigned char offline_cpu_bitmap[BITMAP_SIZE(NR_CPUS)] = {0};
 	int i, pos;
@@ -5033,6 +5431,9 @@ __print_funct_t svg_print_softnet_stats(struct activity *a, int curr, int action
 			a->nr_ini = a->nr[curr];
 		}
 
+		/* Make sure there are graphs for all the CPU */
+		reallocate_all_graph_lines(a->nr_ini, 5, svg_p, &out, &outsize, &spmin, &spmax);
+
 		/* Compute statistics for CPU "all" */
 		get_global_soft_statistics(a, !curr, curr, flags, offline_cpu_bitmap);
 